@@ -13,7 +13,9 @@
 #include <QtWidgets/QAction>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QButtonGroup>
+#include <QtWidgets/QCheckBox>
 #include <QtWidgets/QComboBox>
+#include <QtWidgets/QDockWidget>
 #include <QtWidgets/QDoubleSpinBox>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QLabel>
@@ -24,8 +26,10 @@
 #include <QtWidgets/QSpinBox>
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QTabWidget>
+#include <QtWidgets/QTableView>
 #include <QtWidgets/QTableWidget>
 #include <QtWidgets/QToolBar>
+#include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QWidget>
 #include <qvtkwidget.h>
 
@@ -64,9 +68,23 @@ public:
     QAction *_kinfuTestBoundingBoxAction;
     QAction *_removeNANAction;
     QAction *_ignoreResetKinfuAction;
+    QAction *_setCaptureRateAction;
+    QAction *_processPoseGraphAction;
+    QAction *_cancelJobsAction;
+    QAction *_liveOutlierRemovalAction;
+    QAction *_recordScanAction;
+    QAction *_startReplayAction;
+    QAction *_stepReplayAction;
+    QAction *_stopReplayAction;
+    QAction *_showStatsAction;
+    QAction *_startTraceAction;
+    QAction *_exportTraceAction;
+    QAction *_openSessionAction;
+    QAction *_saveSessionAction;
+    QAction *_startMultiCameraAction;
     QWidget *centralWidget;
     QVTKWidget *_qvtkWidget;
-    QTableWidget *_pointCloudTable;
+    QTableView *_pointCloudTable;
     QTabWidget *_processingTabWidget;
     QWidget *tab;
     QTabWidget *_baseTabWidget;
@@ -95,6 +113,8 @@ public:
     QDoubleSpinBox *_voxelGridZSpinBox;
     QDoubleSpinBox *_voxelGridXSpinBox;
     QLabel *_voxelGridZLabel;
+    QCheckBox *_voxelGridHashCheckBox;
+    QCheckBox *_voxelGridKeepOrganizedCheckBox;
     QWidget *_boundingBoxTab;
     QDoubleSpinBox *_boundingBoxMinYSpinBox;
     QLabel *_boundingBoxZLabel;
@@ -233,6 +253,7 @@ public:
     QMenu *menuPico_Flexx;
     QMenu *menuIntel_Realsense;
     QMenu *menuXtion_Pro;
+    QMenu *menuReplay;
     QMenu *menuArduino;
     QMenu *menucommunicate;
     QMenu *menuControl_Motor;
@@ -247,6 +268,10 @@ public:
     QMenu *menuSet_Background_Color;
     QToolBar *mainToolBar;
     QStatusBar *statusBar;
+    QDockWidget *_statsDock;
+    QWidget *_statsDockContents;
+    QVBoxLayout *_statsDockLayout;
+    QTableWidget *_statsTable;
 
     void setupUi(QMainWindow *MainWindowForm)
     {
@@ -313,12 +338,40 @@ public:
         _removeNANAction->setObjectName(QStringLiteral("_removeNANAction"));
         _ignoreResetKinfuAction = new QAction(MainWindowForm);
         _ignoreResetKinfuAction->setObjectName(QStringLiteral("_ignoreResetKinfuAction"));
+        _setCaptureRateAction = new QAction(MainWindowForm);
+        _setCaptureRateAction->setObjectName(QStringLiteral("_setCaptureRateAction"));
+        _processPoseGraphAction = new QAction(MainWindowForm);
+        _processPoseGraphAction->setObjectName(QStringLiteral("_processPoseGraphAction"));
+        _cancelJobsAction = new QAction(MainWindowForm);
+        _cancelJobsAction->setObjectName(QStringLiteral("_cancelJobsAction"));
+        _liveOutlierRemovalAction = new QAction(MainWindowForm);
+        _liveOutlierRemovalAction->setObjectName(QStringLiteral("_liveOutlierRemovalAction"));
+        _recordScanAction = new QAction(MainWindowForm);
+        _recordScanAction->setObjectName(QStringLiteral("_recordScanAction"));
+        _startReplayAction = new QAction(MainWindowForm);
+        _startReplayAction->setObjectName(QStringLiteral("_startReplayAction"));
+        _stepReplayAction = new QAction(MainWindowForm);
+        _stepReplayAction->setObjectName(QStringLiteral("_stepReplayAction"));
+        _stopReplayAction = new QAction(MainWindowForm);
+        _stopReplayAction->setObjectName(QStringLiteral("_stopReplayAction"));
+        _showStatsAction = new QAction(MainWindowForm);
+        _showStatsAction->setObjectName(QStringLiteral("_showStatsAction"));
+        _startTraceAction = new QAction(MainWindowForm);
+        _startTraceAction->setObjectName(QStringLiteral("_startTraceAction"));
+        _exportTraceAction = new QAction(MainWindowForm);
+        _exportTraceAction->setObjectName(QStringLiteral("_exportTraceAction"));
+        _openSessionAction = new QAction(MainWindowForm);
+        _openSessionAction->setObjectName(QStringLiteral("_openSessionAction"));
+        _saveSessionAction = new QAction(MainWindowForm);
+        _saveSessionAction->setObjectName(QStringLiteral("_saveSessionAction"));
+        _startMultiCameraAction = new QAction(MainWindowForm);
+        _startMultiCameraAction->setObjectName(QStringLiteral("_startMultiCameraAction"));
         centralWidget = new QWidget(MainWindowForm);
         centralWidget->setObjectName(QStringLiteral("centralWidget"));
         _qvtkWidget = new QVTKWidget(centralWidget);
         _qvtkWidget->setObjectName(QStringLiteral("_qvtkWidget"));
         _qvtkWidget->setGeometry(QRect(30, 30, 730, 730));
-        _pointCloudTable = new QTableWidget(centralWidget);
+        _pointCloudTable = new QTableView(centralWidget);
         _pointCloudTable->setObjectName(QStringLiteral("_pointCloudTable"));
         _pointCloudTable->setGeometry(QRect(790, 30, 460, 200));
         _processingTabWidget = new QTabWidget(centralWidget);
@@ -477,6 +530,15 @@ public:
         _voxelGridZLabel->setObjectName(QStringLiteral("_voxelGridZLabel"));
         _voxelGridZLabel->setGeometry(QRect(10, 120, 50, 30));
         _voxelGridZLabel->setFont(font);
+        _voxelGridHashCheckBox = new QCheckBox(_voxelGridTab);
+        _voxelGridHashCheckBox->setObjectName(QStringLiteral("_voxelGridHashCheckBox"));
+        _voxelGridHashCheckBox->setGeometry(QRect(10, 170, 250, 30));
+        _voxelGridHashCheckBox->setFont(font);
+        _voxelGridKeepOrganizedCheckBox = new QCheckBox(_voxelGridTab);
+        _voxelGridKeepOrganizedCheckBox->setObjectName(QStringLiteral("_voxelGridKeepOrganizedCheckBox"));
+        _voxelGridKeepOrganizedCheckBox->setEnabled(false);
+        _voxelGridKeepOrganizedCheckBox->setGeometry(QRect(10, 220, 250, 30));
+        _voxelGridKeepOrganizedCheckBox->setFont(font);
         _filterTabWidget->addTab(_voxelGridTab, QString());
         _boundingBoxTab = new QWidget();
         _boundingBoxTab->setObjectName(QStringLiteral("_boundingBoxTab"));
@@ -1107,6 +1169,8 @@ public:
         menuIntel_Realsense->setObjectName(QStringLiteral("menuIntel_Realsense"));
         menuXtion_Pro = new QMenu(menuCamera);
         menuXtion_Pro->setObjectName(QStringLiteral("menuXtion_Pro"));
+        menuReplay = new QMenu(menuCamera);
+        menuReplay->setObjectName(QStringLiteral("menuReplay"));
         menuArduino = new QMenu(menuBar);
         menuArduino->setObjectName(QStringLiteral("menuArduino"));
         menucommunicate = new QMenu(menuArduino);
@@ -1138,6 +1202,21 @@ public:
         statusBar = new QStatusBar(MainWindowForm);
         statusBar->setObjectName(QStringLiteral("statusBar"));
         MainWindowForm->setStatusBar(statusBar);
+        _statsDock = new QDockWidget(MainWindowForm);
+        _statsDock->setObjectName(QStringLiteral("_statsDock"));
+        _statsDockContents = new QWidget();
+        _statsDockContents->setObjectName(QStringLiteral("_statsDockContents"));
+        _statsDockLayout = new QVBoxLayout(_statsDockContents);
+        _statsDockLayout->setSpacing(6);
+        _statsDockLayout->setContentsMargins(11, 11, 11, 11);
+        _statsDockLayout->setObjectName(QStringLiteral("_statsDockLayout"));
+        _statsTable = new QTableWidget(_statsDockContents);
+        _statsTable->setObjectName(QStringLiteral("_statsTable"));
+
+        _statsDockLayout->addWidget(_statsTable);
+
+        _statsDock->setWidget(_statsDockContents);
+        MainWindowForm->addDockWidget(static_cast<Qt::DockWidgetArea>(2), _statsDock);
 
         menuBar->addAction(menuFile->menuAction());
         menuBar->addAction(menuViewer->menuAction());
@@ -1149,6 +1228,10 @@ public:
         menuCamera->addAction(menuPico_Flexx->menuAction());
         menuCamera->addAction(menuIntel_Realsense->menuAction());
         menuCamera->addAction(menuXtion_Pro->menuAction());
+        menuCamera->addAction(menuReplay->menuAction());
+        menuCamera->addAction(_startMultiCameraAction);
+        menuCamera->addAction(_setCaptureRateAction);
+        menuCamera->addAction(_liveOutlierRemovalAction);
         menuPico_Flexx->addAction(_startFlexxAction);
         menuPico_Flexx->addAction(_stopFlexxAction);
         menuPico_Flexx->addAction(_setConfidenceAction);
@@ -1156,6 +1239,9 @@ public:
         menuIntel_Realsense->addAction(_stopRSAction);
         menuXtion_Pro->addAction(_startXtionProAction);
         menuXtion_Pro->addAction(_stopXtionProAction);
+        menuReplay->addAction(_startReplayAction);
+        menuReplay->addAction(_stepReplayAction);
+        menuReplay->addAction(_stopReplayAction);
         menuArduino->addAction(menucommunicate->menuAction());
         menuArduino->addAction(menuControl_Motor->menuAction());
         menucommunicate->addAction(_getNumberOfBytesAction);
@@ -1164,6 +1250,8 @@ public:
         menuControl_Motor->addAction(_controlMotorAction);
         menuFile->addAction(_openFileAction);
         menuFile->addAction(_saveFileAction);
+        menuFile->addAction(_openSessionAction);
+        menuFile->addAction(_saveSessionAction);
         menuPointCloud->addAction(menuKeep_PointCloud->menuAction());
         menuPointCloud->addAction(menuRemove_PointCloud->menuAction());
         menuPointCloud->addAction(menuSelectPointCloud->menuAction());
@@ -1172,6 +1260,7 @@ public:
         menuPointCloud->addAction(_removeNANAction);
         menuKeep_PointCloud->addAction(_keepOneFrameAction);
         menuKeep_PointCloud->addAction(_keepContinueFrameAction);
+        menuKeep_PointCloud->addAction(_recordScanAction);
         menuRemove_PointCloud->addAction(_removeSelectedPointCloudsAction);
         menuRemove_PointCloud->addAction(_removeAllPointCloudsAction);
         menuSelectPointCloud->addAction(_selectAllPointCloudsAction);
@@ -1179,10 +1268,15 @@ public:
         menuProcess->addAction(_processICP1Action);
         menuProcess->addAction(_processICP2Action);
         menuProcess->addAction(_processICP3Action);
+        menuProcess->addAction(_processPoseGraphAction);
+        menuProcess->addAction(_cancelJobsAction);
         menuKinect_Fusion->addAction(_kinfuTestBoundingBoxAction);
         menuKinect_Fusion->addAction(_segmentedKinfuAction);
         menuKinect_Fusion->addAction(_ignoreResetKinfuAction);
         menuViewer->addAction(menuSet_Background_Color->menuAction());
+        menuViewer->addAction(_showStatsAction);
+        menuViewer->addAction(_startTraceAction);
+        menuViewer->addAction(_exportTraceAction);
         menuSet_Background_Color->addAction(_setViewBackgroundToBlackAction);
         menuSet_Background_Color->addAction(_setViewBackgroundToWhiteAction);
 
@@ -1234,6 +1328,20 @@ public:
         _kinfuTestBoundingBoxAction->setText(QApplication::translate("MainWindowForm", "Test Bounding Box", Q_NULLPTR));
         _removeNANAction->setText(QApplication::translate("MainWindowForm", "Remove NAN", Q_NULLPTR));
         _ignoreResetKinfuAction->setText(QApplication::translate("MainWindowForm", "Ignore Reset Kinfu", Q_NULLPTR));
+        _setCaptureRateAction->setText(QApplication::translate("MainWindowForm", "Set Capture Rate", Q_NULLPTR));
+        _processPoseGraphAction->setText(QApplication::translate("MainWindowForm", "Pose Graph ICP", Q_NULLPTR));
+        _cancelJobsAction->setText(QApplication::translate("MainWindowForm", "Cancel Running Jobs", Q_NULLPTR));
+        _liveOutlierRemovalAction->setText(QApplication::translate("MainWindowForm", "Live Outlier Removal", Q_NULLPTR));
+        _recordScanAction->setText(QApplication::translate("MainWindowForm", "Record Scan", Q_NULLPTR));
+        _startReplayAction->setText(QApplication::translate("MainWindowForm", "Start", Q_NULLPTR));
+        _stepReplayAction->setText(QApplication::translate("MainWindowForm", "Step", Q_NULLPTR));
+        _stopReplayAction->setText(QApplication::translate("MainWindowForm", "Stop", Q_NULLPTR));
+        _showStatsAction->setText(QApplication::translate("MainWindowForm", "Show Stats", Q_NULLPTR));
+        _startTraceAction->setText(QApplication::translate("MainWindowForm", "Start Trace", Q_NULLPTR));
+        _exportTraceAction->setText(QApplication::translate("MainWindowForm", "Export Trace", Q_NULLPTR));
+        _openSessionAction->setText(QApplication::translate("MainWindowForm", "Open Session", Q_NULLPTR));
+        _saveSessionAction->setText(QApplication::translate("MainWindowForm", "Save Session", Q_NULLPTR));
+        _startMultiCameraAction->setText(QApplication::translate("MainWindowForm", "Start Multi Camera", Q_NULLPTR));
         _shiftXLabel->setText(QApplication::translate("MainWindowForm", "X\357\274\232", Q_NULLPTR));
         _shiftYLabel->setText(QApplication::translate("MainWindowForm", "Y\357\274\232", Q_NULLPTR));
         _shiftZLabel->setText(QApplication::translate("MainWindowForm", "Z\357\274\232", Q_NULLPTR));
@@ -1248,6 +1356,8 @@ public:
         _voxelGridXLabel->setText(QApplication::translate("MainWindowForm", "X\357\274\232", Q_NULLPTR));
         _voxelGridYLabel->setText(QApplication::translate("MainWindowForm", "Y\357\274\232", Q_NULLPTR));
         _voxelGridZLabel->setText(QApplication::translate("MainWindowForm", "Z\357\274\232", Q_NULLPTR));
+        _voxelGridHashCheckBox->setText(QApplication::translate("MainWindowForm", "Hash (large clouds)", Q_NULLPTR));
+        _voxelGridKeepOrganizedCheckBox->setText(QApplication::translate("MainWindowForm", "Keep Organized", Q_NULLPTR));
         _filterTabWidget->setTabText(_filterTabWidget->indexOf(_voxelGridTab), QApplication::translate("MainWindowForm", "Voxel Grid", Q_NULLPTR));
         _boundingBoxZLabel->setText(QApplication::translate("MainWindowForm", "Z\357\274\232", Q_NULLPTR));
         _boundingBoxXLabel->setText(QApplication::translate("MainWindowForm", "X\357\274\232", Q_NULLPTR));
@@ -1339,6 +1449,7 @@ public:
         menuPico_Flexx->setTitle(QApplication::translate("MainWindowForm", "Pico Flexx", Q_NULLPTR));
         menuIntel_Realsense->setTitle(QApplication::translate("MainWindowForm", "Intel Realsense", Q_NULLPTR));
         menuXtion_Pro->setTitle(QApplication::translate("MainWindowForm", "OpenNI Device", Q_NULLPTR));
+        menuReplay->setTitle(QApplication::translate("MainWindowForm", "Replay", Q_NULLPTR));
         menuArduino->setTitle(QApplication::translate("MainWindowForm", "Arduino", Q_NULLPTR));
         menucommunicate->setTitle(QApplication::translate("MainWindowForm", "Communicate", Q_NULLPTR));
         menuControl_Motor->setTitle(QApplication::translate("MainWindowForm", "Control Motor", Q_NULLPTR));
@@ -1350,6 +1461,7 @@ public:
         menuProcess->setTitle(QApplication::translate("MainWindowForm", "Process", Q_NULLPTR));
         menuKinect_Fusion->setTitle(QApplication::translate("MainWindowForm", "Kinect Fusion", Q_NULLPTR));
         menuViewer->setTitle(QApplication::translate("MainWindowForm", "Viewer", Q_NULLPTR));
+        _statsDock->setWindowTitle(QApplication::translate("MainWindowForm", "Stats", Q_NULLPTR));
         menuSet_Background_Color->setTitle(QApplication::translate("MainWindowForm", "Set Background Color", Q_NULLPTR));
     } // retranslateUi
 
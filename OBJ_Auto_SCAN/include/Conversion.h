@@ -3,6 +3,9 @@
 
 #include "Typedef.h"
 
+#include <iomanip>
+#include <sstream>
+
 #include <QVTKWidget.h>
 #include<QMessageBox>
 #include <QFileDialog>
@@ -25,6 +28,22 @@ public:
 		return str;
 	}
 
+	//		1536 -> "1.5 KB"
+	static std::string Bytes2String(std::size_t bytes)
+	{
+		const char* units[] = { "B", "KB", "MB", "GB" };
+		double size = (double)bytes;
+		int unit = 0;
+		while (size >= 1024 && unit < 3)
+		{
+			size /= 1024;
+			unit++;
+		}
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << size << " " << units[unit];
+		return stream.str();
+	}
+
 	static std::string QString2String(QString qs)
 	{
 		std::string str = qs.toLocal8Bit().constData();
@@ -0,0 +1,36 @@
+#include <iostream>
+#include "batch/BatchPipeline.h"
+#include "trace/Tracer.h"
+
+//		OBJ_Auto_SCAN_Batch <pipeline file> [input dir] [output dir] [trace file]
+//		input/output dir override the dir= of the load/save stages, so one pipeline can be run over many captures
+//		trace file gets the Chrome trace JSON of the run
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <pipeline file> [input dir] [output dir] [trace file]" << std::endl;
+		return 1;
+	}
+	try
+	{
+		BatchPipeline pipeline;
+		pipeline.LoadPipeline(argv[1]);
+		if (argc > 2)
+			pipeline.SetInputDirectory(argv[2]);
+		if (argc > 3)
+			pipeline.SetOutputDirectory(argv[3]);
+		Tracer::GetInstance()->SetEnabled(argc > 4);
+		pipeline.Run();
+		std::cout << std::endl;
+		pipeline.PrintTimings(std::cout);
+		if (argc > 4)
+			Tracer::GetInstance()->ExportChromeTrace(std::string(argv[4]));
+	}
+	catch (std::string& message)
+	{
+		std::cerr << message << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,622 @@
+#include "batch/BatchPipeline.h"
+
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <pcl/filters/filter.h>
+#include "pointCloudProcessing/transform/TransformKernels.h"
+#include "kinfuApp/CpuKinfuApp.h"
+#include "file/FrameFiles.h"
+#include "grabber/replay/ReplayGrabber.h"
+
+static std::string ToLower(std::string str)
+{
+	std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)tolower(c); });
+	return str;
+}
+
+//		Keeps what the replay delivers, on the FrameBus worker thread
+class BatchReplayObserver : public IObserver
+{
+public:
+	void Update(pcl::PointCloud<PointT>::Ptr pointCloud)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_pointClouds.push_back(pointCloud);
+	}
+
+	std::vector<pcl::PointCloud<PointT>::Ptr> GetPointClouds()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		return _pointClouds;
+	}
+
+private:
+	std::mutex _mutex;
+	std::vector<pcl::PointCloud<PointT>::Ptr> _pointClouds;
+};
+
+BatchPipeline::BatchPipeline()
+{
+}
+
+//		*****************************************************************
+//				Pipeline Description
+//		*****************************************************************
+
+void BatchPipeline::LoadPipeline(std::string path)
+{
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		throw std::string("BatchPipeline: Cannot open pipeline ") + path;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+		AddStage(line, ++lineNumber);
+}
+
+void BatchPipeline::AddStage(std::string line, int lineNumber)
+{
+	std::size_t comment = line.find('#');
+	if (comment != std::string::npos)
+		line = line.substr(0, comment);
+	std::istringstream tokens(line);
+	BatchStage stage;
+	stage.line = lineNumber;
+	if (!(tokens >> stage.type))
+		return;
+	stage.type = ToLower(stage.type);
+	std::string token;
+	while (tokens >> token)
+	{
+		std::size_t equal = token.find('=');
+		if (equal == std::string::npos || equal == 0)
+		{
+			std::ostringstream message;
+			message << "BatchPipeline: line " << lineNumber << ": expected key=value, got " << token;
+			throw message.str();
+		}
+		stage.parameters[token.substr(0, equal)] = token.substr(equal + 1);
+	}
+	_stages.push_back(stage);
+}
+
+void BatchPipeline::SetInputDirectory(std::string dir)
+{
+	_inputDirectory = dir;
+}
+
+void BatchPipeline::SetOutputDirectory(std::string dir)
+{
+	_outputDirectory = dir;
+}
+
+//		*****************************************************************
+//				Run
+//		*****************************************************************
+
+void BatchPipeline::Run()
+{
+	_timings.clear();
+	for (int counter = 0; counter < _stages.size(); counter++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		RunStage(_stages[counter]);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		BatchTiming timing;
+		timing.stage = Describe(_stages[counter]);
+		timing.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+		timing.frames = _frames.size();
+		timing.points = 0;
+		for (int frameIndex = 0; frameIndex < _frames.size(); frameIndex++)
+			timing.points += _frames[frameIndex].cloud->size();
+		_timings.push_back(timing);
+		std::cout << "[" << counter + 1 << "/" << _stages.size() << "] " << timing.stage << " : " << timing.frames << " frames, " << timing.points << " points, " << timing.milliseconds << " ms" << std::endl;
+	}
+}
+
+void BatchPipeline::RunStage(BatchStage& stage)
+{
+	if (stage.type == "load")
+		Load(stage);
+	else if (stage.type == "replay")
+		Replay(stage);
+	else if (stage.type == "filter")
+		Filter(stage);
+	else if (stage.type == "removenan")
+		RemoveNaN(stage);
+	else if (stage.type == "register")
+		Register(stage);
+	else if (stage.type == "kinfu")
+		Kinfu(stage);
+	else if (stage.type == "merge")
+		Merge(stage);
+	else if (stage.type == "reconstruct")
+		Reconstruct(stage);
+	else if (stage.type == "smooth")
+		Smooth(stage);
+	else if (stage.type == "save")
+		Save(stage);
+	else
+	{
+		std::ostringstream message;
+		message << "BatchPipeline: line " << stage.line << ": unknown stage " << stage.type;
+		throw message.str();
+	}
+}
+
+std::vector<BatchTiming> BatchPipeline::GetTimings()
+{
+	return _timings;
+}
+
+void BatchPipeline::PrintTimings(std::ostream& out)
+{
+	double total = 0;
+	out << std::left << std::setw(48) << "Stage" << std::right << std::setw(8) << "Frames" << std::setw(12) << "Points" << std::setw(14) << "Time (ms)" << std::endl;
+	for (int counter = 0; counter < _timings.size(); counter++)
+	{
+		out << std::left << std::setw(48) << _timings[counter].stage << std::right << std::setw(8) << _timings[counter].frames << std::setw(12) << _timings[counter].points
+			<< std::setw(14) << std::fixed << std::setprecision(1) << _timings[counter].milliseconds << std::endl;
+		total += _timings[counter].milliseconds;
+	}
+	out << std::left << std::setw(68) << "Total" << std::right << std::setw(14) << std::fixed << std::setprecision(1) << total << std::endl;
+}
+
+//		*****************************************************************
+//				Stages
+//		*****************************************************************
+
+void BatchPipeline::Load(BatchStage& stage)
+{
+	std::string dir = _inputDirectory.empty() ? GetString(stage, "dir", ".") : _inputDirectory;
+	std::string extension = ToLower(GetString(stage, "ext", ".obj"));
+	if (!boost::filesystem::is_directory(dir))
+		throw std::string("BatchPipeline: Not a directory ") + dir;
+	std::vector<std::string> paths = ListFrameFiles(dir, extension);
+	_frames.clear();
+	for (int counter = 0; counter < paths.size(); counter++)
+	{
+		MyFile* file = NULL;
+		if (extension == ".obj")
+			file = _fileFactory.GetObjFile(paths[counter]);
+		else if (extension == ".ply")
+			file = _fileFactory.GetPlyFile(paths[counter]);
+		else if (extension == ".pcd")
+			file = _fileFactory.GetPcdFile(paths[counter]);
+		else
+			throw std::string("BatchPipeline: Unsupported extension ") + extension;
+		file->LoadFile();
+		BatchFrame frame;
+		frame.name = boost::filesystem::path(paths[counter]).stem().string();
+		frame.cloud = file->GetPointCloud();
+		_frames.push_back(frame);
+		delete file;
+	}
+	if (_frames.empty())
+		throw std::string("BatchPipeline: No ") + extension + std::string(" files in ") + dir;
+}
+
+//		Feeds the frames through a ReplayGrabber and a FrameBus like a live camera,
+//		the frames the observer received replace the current ones
+void BatchPipeline::Replay(BatchStage& stage)
+{
+	std::string source = GetString(stage, "source", _inputDirectory.empty() ? std::string(".") : _inputDirectory);
+	std::string mode = ToLower(GetString(stage, "mode", "fast"));
+	std::string policy = ToLower(GetString(stage, "policy", "block"));
+	OverflowPolicy overflowPolicy;
+	if (policy == "block")
+		overflowPolicy = OverflowPolicy::Block;
+	else if (policy == "dropoldest")
+		overflowPolicy = OverflowPolicy::DropOldest;
+	else if (policy == "dropnewest")
+		overflowPolicy = OverflowPolicy::DropNewest;
+	else
+		throw std::string("BatchPipeline: Unknown overflow policy ") + policy;
+
+	BatchReplayObserver observer;				//	outlives the bus workers
+	GrabberSubject grabberSubject;
+	ISubject* subject = (ISubject*)&grabberSubject;
+	subject->RegisterObserver(&observer, overflowPolicy);
+	ReplayGrabber replay(subject);
+	replay.SetSource(source);
+	if (mode == "fast")
+		replay.SetMode(ReplayMode::AsFastAsPossible);
+	else if (mode == "realtime")
+		replay.SetMode(ReplayMode::RealTime);
+	else
+		throw std::string("BatchPipeline: Unknown replay mode ") + mode;
+	replay.SetSpeed(GetDouble(stage, "speed", 1));
+	double fps = GetDouble(stage, "fps", 30);
+	if (fps <= 0)
+		throw std::string("BatchPipeline: fps must be positive");
+	replay.SetFramePeriod(1.0 / fps);
+	replay.StartCamera();
+	replay.WaitUntilFinished();
+	replay.StopCamera();
+	if (!replay.GetError().empty())
+		throw replay.GetError();
+
+	//		Publishing is done, wait for the worker to hand over the last frames
+	FrameBusStats stats = subject->GetObserverStats(&observer);
+	while (stats.delivered + stats.dropped < stats.published)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		stats = subject->GetObserverStats(&observer);
+	}
+	std::cout << "replay " << source << " : " << stats.published << " published, " << stats.delivered << " delivered, " << stats.dropped << " dropped" << std::endl;
+
+	std::vector<pcl::PointCloud<PointT>::Ptr> pointClouds = observer.GetPointClouds();
+	_frames.clear();
+	for (int counter = 0; counter < pointClouds.size(); counter++)
+	{
+		BatchFrame frame;
+		frame.name = GetString(stage, "name", "replay") + "_" + std::to_string(counter);
+		frame.cloud = pointClouds[counter];
+		_frames.push_back(frame);
+	}
+	if (_frames.empty())
+		throw std::string("BatchPipeline: Nothing replayed from ") + source;
+}
+
+void BatchPipeline::Filter(BatchStage& stage)
+{
+	std::string method = GetString(stage, "method", "voxel");
+	FilterProcessing* filter = NULL;
+	if (method == "voxel")
+	{
+		filter = _filterFactory.GetVoixelGridFilter();
+		float leaf = (float)GetDouble(stage, "leaf", 0.01);
+		filter->SetLeafSize((float)GetDouble(stage, "leafX", leaf), (float)GetDouble(stage, "leafY", leaf), (float)GetDouble(stage, "leafZ", leaf));
+	}
+	else if (method == "hashvoxel")
+	{
+		filter = _filterFactory.GetHashVoxelGridFilter();
+		float leaf = (float)GetDouble(stage, "leaf", 0.01);
+		filter->SetLeafSize((float)GetDouble(stage, "leafX", leaf), (float)GetDouble(stage, "leafY", leaf), (float)GetDouble(stage, "leafZ", leaf));
+		filter->SetKeepOrganized(GetInt(stage, "keepOrganized", 0) != 0);
+	}
+	else if (method == "box")
+	{
+		filter = _filterFactory.GetBoundingBoxFilter();
+		filter->SetBoundingBox((float)GetDouble(stage, "minX", -1), (float)GetDouble(stage, "maxX", 1), (float)GetDouble(stage, "minY", -1),
+			(float)GetDouble(stage, "maxY", 1), (float)GetDouble(stage, "minZ", -1), (float)GetDouble(stage, "maxZ", 1));
+	}
+	else if (method == "outlier")
+	{
+		filter = _filterFactory.GetOutlierRemovalFilter();
+		filter->SetMeanK(GetInt(stage, "meanK", 50));
+		filter->SetStddevMulThresh((float)GetDouble(stage, "stddev", 1.0));
+	}
+	else
+		throw std::string("BatchPipeline: Unknown filter method ") + method;
+	for (int counter = 0; counter < _frames.size(); counter++)
+	{
+		filter->Processing(_frames[counter].cloud);
+		//		The filter reuses its result buffer on the next call
+		_frames[counter].cloud.reset(new pcl::PointCloud<PointT>(*filter->GetResult()));
+	}
+}
+
+void BatchPipeline::RemoveNaN(BatchStage& stage)
+{
+	for (int counter = 0; counter < _frames.size(); counter++)
+	{
+		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>());
+		std::vector<int> map;
+		pcl::removeNaNFromPointCloud(*_frames[counter].cloud, *temp, map);
+		_frames[counter].cloud = temp;
+	}
+}
+
+//		mode=chain       : pairwise ICP between neighbours, every frame moved into the first frame (ICP_1)
+//		mode=accumulate  : register every frame onto the growing result, leaves one frame (ICP_2)
+//		mode=posegraph   : pairwise ICP to the next "neighbours" frames plus a last -> first loop
+//		                   closure (loop=0 to disable), then one global solve
+void BatchPipeline::Register(BatchStage& stage)
+{
+	if (_frames.size() < 2)
+		return;
+	RegestrationProcessing* icp = _regestrationFactory.GetICP();
+	if (stage.parameters.count("distance"))
+		icp->SetCorrespondenceDistance((float)GetDouble(stage, "distance", 0));
+	if (stage.parameters.count("outlier"))
+		icp->SetRansacOutlierRejectionThreshold((float)GetDouble(stage, "outlier", 0));
+	if (stage.parameters.count("epsilon"))
+		icp->SetEuclideanFitnessEpsilon((float)GetDouble(stage, "epsilon", 0));
+	if (stage.parameters.count("iterations"))
+		icp->SetMaximumIterations(GetInt(stage, "iterations", 0));
+	std::string mode = GetString(stage, "mode", "chain");
+	if (mode == "chain")
+	{
+		std::vector<Eigen::Matrix4f> matrices;
+		for (int counter = 1; counter < _frames.size(); counter++)
+		{
+			icp->Processing(_frames[counter - 1].cloud, _frames[counter].cloud);
+			matrices.push_back(icp->GetMatrix().inverse());
+			if (!icp->HasConverged())
+				std::cout << "  ICP did not converge : " << _frames[counter - 1].name << " -> " << _frames[counter].name << std::endl;
+		}
+		Eigen::Matrix4f globalTransform = Eigen::Matrix4f::Identity();
+		for (int counter = 0; counter < matrices.size(); counter++)
+		{
+			globalTransform *= matrices[counter];
+			TransformKernels::Transform(*_frames[counter + 1].cloud, globalTransform);
+		}
+	}
+	else if (mode == "accumulate")
+	{
+		pcl::PointCloud<PointT>::Ptr result(new pcl::PointCloud<PointT>(*_frames[0].cloud));
+		for (int counter = 1; counter < _frames.size(); counter++)
+		{
+			icp->Processing(result, _frames[counter].cloud);
+			result.reset(new pcl::PointCloud<PointT>(*icp->GetResult()));
+			if (!icp->HasConverged())
+				std::cout << "  ICP did not converge : " << _frames[counter].name << std::endl;
+		}
+		BatchFrame frame;
+		frame.name = GetString(stage, "name", "registered");
+		frame.cloud = result;
+		_frames.clear();
+		_frames.push_back(frame);
+	}
+	else if (mode == "posegraph")
+	{
+		PoseGraphRegestration* poseGraph = _regestrationFactory.GetPoseGraph();
+		if (stage.parameters.count("distance"))
+			poseGraph->SetCorrespondenceDistance((float)GetDouble(stage, "distance", 0));
+		if (stage.parameters.count("outlier"))
+			poseGraph->SetRansacOutlierRejectionThreshold((float)GetDouble(stage, "outlier", 0));
+		if (stage.parameters.count("epsilon"))
+			poseGraph->SetEuclideanFitnessEpsilon((float)GetDouble(stage, "epsilon", 0));
+		if (stage.parameters.count("iterations"))
+			poseGraph->SetMaximumIterations(GetInt(stage, "iterations", 0));
+		poseGraph->SetNeighbourRange(GetInt(stage, "neighbours", 2));
+		poseGraph->SetLoopClosure(GetInt(stage, "loop", 1) != 0);
+		std::vector<pcl::PointCloud<PointT>::Ptr> views;
+		for (int counter = 0; counter < _frames.size(); counter++)
+			views.push_back(_frames[counter].cloud);
+		poseGraph->Processing(views);
+		std::vector<PoseGraphEdge> edges = poseGraph->GetEdges();
+		for (int counter = 0; counter < edges.size(); counter++)
+		{
+			if (!edges[counter].hasConverged)
+				std::cout << "  ICP did not converge : " << _frames[edges[counter].from].name << " -> " << _frames[edges[counter].to].name << std::endl;
+		}
+		std::cout << "  " << edges.size() << " edges, error " << poseGraph->GetError() << std::endl;
+		std::vector<Eigen::Matrix4f> poses = poseGraph->GetPoses();
+		for (int counter = 1; counter < _frames.size(); counter++)
+			TransformKernels::Transform(*_frames[counter].cloud, poses[counter]);
+	}
+	else
+		throw std::string("BatchPipeline: Unknown register mode ") + mode;
+}
+
+//		TSDF fusion on the CPU (same steps as ProcessSegmentedKinfuCloudSlot), the frames must still
+//		be organized so it runs before filter / removenan. Tracking losses split the sequence, every
+//		segment becomes one frame with the fused cloud and mesh.
+//		volume=1 (meters), icp=1, threads=0 (all cores)
+void BatchPipeline::Kinfu(BatchStage& stage)
+{
+	float volumeSize = (float)GetDouble(stage, "volume", 1.0);
+	int icp = GetInt(stage, "icp", 1);
+	unsigned int numberOfThreads = (unsigned int)GetInt(stage, "threads", 0);
+	std::vector<int> resetFrames;
+	resetFrames.push_back(-1);
+	if (icp)
+	{
+		bool firstFrame = true;
+		CpuKinFuApp kinfu(volumeSize, icp, 0);
+		kinfu.SetNumberOfThreads(numberOfThreads);
+		for (int counter = 0; counter < _frames.size(); counter++)
+		{
+			kinfu.source_cb3(_frames[counter].cloud);
+			if (kinfu.execute())
+				continue;
+			if (firstFrame)
+				firstFrame = false;
+			else
+			{
+				std::cout << "  Tracking lost : " << _frames[counter].name << std::endl;
+				resetFrames.push_back(counter);
+				firstFrame = true;
+			}
+		}
+	}
+	resetFrames.push_back((int)_frames.size());
+
+	std::vector<BatchFrame> fused;
+	for (int resetIndex = 0; resetIndex + 1 < resetFrames.size(); resetIndex++)
+	{
+		if (resetFrames[resetIndex] + 1 == resetFrames[resetIndex + 1])
+			continue;
+		CpuKinFuApp kinfu(volumeSize, icp, 0);
+		kinfu.SetNumberOfThreads(numberOfThreads);
+		for (int counter = resetFrames[resetIndex] + 1; counter < resetFrames[resetIndex + 1]; counter++)
+		{
+			if (counter == resetFrames[resetIndex + 1] - 1)
+			{
+				kinfu.scan_ = true;
+				kinfu.scan_mesh_ = true;
+			}
+			kinfu.source_cb3(_frames[counter].cloud);
+			kinfu.execute();
+		}
+		BatchFrame frame;
+		frame.name = GetString(stage, "name", "kinfu") + "_" + std::to_string(fused.size());
+		frame.cloud = kinfu.GetPointCloud();
+		frame.mesh = kinfu.GetMesh();
+		fused.push_back(frame);
+	}
+	_frames = fused;
+}
+
+void BatchPipeline::Merge(BatchStage& stage)
+{
+	BatchFrame frame;
+	frame.name = GetString(stage, "name", "merged");
+	frame.cloud.reset(new pcl::PointCloud<PointT>);
+	for (int counter = 0; counter < _frames.size(); counter++)
+		*frame.cloud += *_frames[counter].cloud;
+	_frames.clear();
+	_frames.push_back(frame);
+}
+
+void BatchPipeline::Reconstruct(BatchStage& stage)
+{
+	std::string method = GetString(stage, "method", "greedy");
+	ReconstructProcessing* reconstruct = NULL;
+	if (method == "greedy")
+		reconstruct = _reconstructFactory.GetGreedyProjection();
+	else if (method == "marchingcubes")
+		reconstruct = _reconstructFactory.GetMarchingCubes();
+	else if (method == "poisson")
+		reconstruct = _reconstructFactory.GetPoisson();
+	else if (method == "concavehull")
+		reconstruct = _reconstructFactory.GetConcaveHull();
+	else
+		throw std::string("BatchPipeline: Unknown reconstruct method ") + method;
+	if (stage.parameters.count("searchRadius"))
+		reconstruct->SetSearchRadius(GetDouble(stage, "searchRadius", 0));
+	if (stage.parameters.count("mu"))
+		reconstruct->SetMu(GetDouble(stage, "mu", 0));
+	if (stage.parameters.count("maxNeighbors"))
+		reconstruct->SetMaxNearestNeighbors(GetInt(stage, "maxNeighbors", 0));
+	if (stage.parameters.count("maxSurfaceAngle"))
+		reconstruct->SetMaxSurfaceAngle(GetDouble(stage, "maxSurfaceAngle", 0));
+	if (stage.parameters.count("minAngle"))
+		reconstruct->SetMinAngle(GetDouble(stage, "minAngle", 0));
+	if (stage.parameters.count("maxAngle"))
+		reconstruct->SetMaxAngle(GetDouble(stage, "maxAngle", 0));
+	if (stage.parameters.count("grid"))
+		reconstruct->SetGridResolution(GetInt(stage, "grid", 0), GetInt(stage, "grid", 0), GetInt(stage, "grid", 0));
+	if (stage.parameters.count("isoLevel"))
+		reconstruct->SetIsoLevel((float)GetDouble(stage, "isoLevel", 0));
+	if (stage.parameters.count("normalRadius"))
+		reconstruct->SetNormalSearchRadius(GetDouble(stage, "normalRadius", 0));
+	if (stage.parameters.count("depth"))
+		reconstruct->SetReconstructDepth(GetInt(stage, "depth", 0));
+	if (stage.parameters.count("alpha"))
+		reconstruct->SetReconstructAlpha(GetDouble(stage, "alpha", 0));
+	for (int counter = 0; counter < _frames.size(); counter++)
+	{
+		reconstruct->Processing(_frames[counter].cloud);
+		pcl::PolygonMeshPtr mesh = reconstruct->GetMesh();
+		if (mesh != NULL)
+			_frames[counter].mesh.reset(new pcl::PolygonMesh(*mesh));
+		else
+			_frames[counter].cloud.reset(new pcl::PointCloud<PointT>(*reconstruct->GetCloud()));
+	}
+}
+
+void BatchPipeline::Smooth(BatchStage& stage)
+{
+	std::string method = GetString(stage, "method", "laplacian");
+	SmoothingProcessing* smoothing = NULL;
+	if (method == "laplacian")
+		smoothing = _smoothingFactory.GetMeshSmoothingLaplacian();
+	else if (method == "resampling")
+		smoothing = _smoothingFactory.GetResampling();
+	else
+		throw std::string("BatchPipeline: Unknown smooth method ") + method;
+	if (stage.parameters.count("iterations"))
+		smoothing->SetNumIter(GetInt(stage, "iterations", 0));
+	if (stage.parameters.count("convergence"))
+		smoothing->SetConvergence(GetDouble(stage, "convergence", 0));
+	if (stage.parameters.count("relaxation"))
+		smoothing->SetRelaxationFactor(GetDouble(stage, "relaxation", 0));
+	if (stage.parameters.count("featureAngle"))
+		smoothing->SetFeatureAngle(GetInt(stage, "featureAngle", 0));
+	if (stage.parameters.count("searchRadius"))
+		smoothing->SetSearchRadius(GetDouble(stage, "searchRadius", 0));
+	for (int counter = 0; counter < _frames.size(); counter++)
+	{
+		if (method == "laplacian")
+		{
+			if (_frames[counter].mesh == NULL)
+				throw std::string("BatchPipeline: Laplacian smoothing needs a reconstructed mesh, ") + _frames[counter].name;
+			smoothing->Processing(_frames[counter].mesh);
+			_frames[counter].mesh.reset(new pcl::PolygonMesh(*smoothing->GetMesh()));
+		}
+		else
+		{
+			smoothing->Processing(_frames[counter].cloud);
+			_frames[counter].cloud.reset(new pcl::PointCloud<PointT>(*smoothing->GetCloud()));
+		}
+	}
+}
+
+void BatchPipeline::Save(BatchStage& stage)
+{
+	std::string dir = _outputDirectory.empty() ? GetString(stage, "dir", "output") : _outputDirectory;
+	std::string format = ToLower(GetString(stage, "format", "ply"));
+	boost::filesystem::create_directories(dir);
+	for (int counter = 0; counter < _frames.size(); counter++)
+	{
+		std::string path = (boost::filesystem::path(dir) / (_frames[counter].name + "." + format)).string();
+		MyFile* file = NULL;
+		if (format == "obj")
+			file = _fileFactory.GetObjFile(path);
+		else if (format == "ply")
+			file = _fileFactory.GetPlyFile(path);
+		else if (format == "pcd")
+			file = _fileFactory.GetPcdFile(path);
+		else
+			throw std::string("BatchPipeline: Unsupported format ") + format;
+		if (_frames[counter].mesh != NULL)
+			file->SaveFile(_frames[counter].mesh);
+		else
+			file->SaveFile(_frames[counter].cloud);
+		delete file;
+	}
+}
+
+//		*****************************************************************
+//				Parameters
+//		*****************************************************************
+
+std::string BatchPipeline::GetString(BatchStage& stage, std::string key, std::string defaultValue)
+{
+	std::map<std::string, std::string>::iterator it = stage.parameters.find(key);
+	return it == stage.parameters.end() ? defaultValue : it->second;
+}
+
+double BatchPipeline::GetDouble(BatchStage& stage, std::string key, double defaultValue)
+{
+	std::map<std::string, std::string>::iterator it = stage.parameters.find(key);
+	if (it == stage.parameters.end())
+		return defaultValue;
+	char* end = NULL;
+	double value = std::strtod(it->second.c_str(), &end);
+	if (end == it->second.c_str() || *end != '\0')
+	{
+		std::ostringstream message;
+		message << "BatchPipeline: line " << stage.line << ": " << key << " is not a number";
+		throw message.str();
+	}
+	return value;
+}
+
+int BatchPipeline::GetInt(BatchStage& stage, std::string key, int defaultValue)
+{
+	return (int)GetDouble(stage, key, defaultValue);
+}
+
+std::string BatchPipeline::Describe(BatchStage& stage)
+{
+	std::string description = stage.type;
+	for (std::map<std::string, std::string>::iterator it = stage.parameters.begin(); it != stage.parameters.end(); ++it)
+	{
+		if (it->first == "dir")
+			continue;
+		description += " " + it->first + "=" + it->second;
+	}
+	return description;
+}
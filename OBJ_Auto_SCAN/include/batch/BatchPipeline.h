@@ -0,0 +1,88 @@
+#ifndef BATCH_PIPELINE
+#define BATCH_PIPELINE
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <pcl/PolygonMesh.h>
+#include "Typedef.h"
+#include "file/FileFactory.h"
+#include "pointCloudProcessing/filter/FilterFactory.h"
+#include "pointCloudProcessing/regestration/RegestrationFactory.h"
+#include "pointCloudProcessing/reconstruct/ReconstructFactory.h"
+#include "pointCloudProcessing/smoothing/SmoothingFactory.h"
+
+//		One line of a pipeline file, e.g. "filter method=voxel leaf=0.005"
+struct BatchStage
+{
+	std::string type;
+	std::map<std::string, std::string> parameters;
+	int line;
+};
+
+//		A frame flowing through the pipeline, mesh is set once it has been reconstructed
+struct BatchFrame
+{
+	std::string name;
+	pcl::PointCloud<PointT>::Ptr cloud;
+	pcl::PolygonMeshPtr mesh;
+};
+
+struct BatchTiming
+{
+	std::string stage;
+	double milliseconds;
+	std::size_t frames;
+	std::size_t points;
+};
+
+//		*****************************************************************
+//				Batch Pipeline
+//				Runs the same processing as the MainWindow slots without any UI.
+//				Stages: load, replay, filter, removenan, register, kinfu, merge, reconstruct, smooth, save
+//		*****************************************************************
+class BatchPipeline
+{
+public:
+	BatchPipeline();
+	void LoadPipeline(std::string path);
+	void AddStage(std::string line, int lineNumber = 0);
+	void SetInputDirectory(std::string dir);
+	void SetOutputDirectory(std::string dir);
+	void Run();
+	std::vector<BatchTiming> GetTimings();
+	void PrintTimings(std::ostream& out);
+
+private:
+	void RunStage(BatchStage& stage);
+	void Load(BatchStage& stage);
+	void Replay(BatchStage& stage);
+	void Filter(BatchStage& stage);
+	void RemoveNaN(BatchStage& stage);
+	void Register(BatchStage& stage);
+	void Kinfu(BatchStage& stage);
+	void Merge(BatchStage& stage);
+	void Reconstruct(BatchStage& stage);
+	void Smooth(BatchStage& stage);
+	void Save(BatchStage& stage);
+
+	std::string GetString(BatchStage& stage, std::string key, std::string defaultValue);
+	double GetDouble(BatchStage& stage, std::string key, double defaultValue);
+	int GetInt(BatchStage& stage, std::string key, int defaultValue);
+	std::string Describe(BatchStage& stage);
+
+	std::vector<BatchStage> _stages;
+	std::vector<BatchFrame> _frames;
+	std::vector<BatchTiming> _timings;
+	std::string _inputDirectory;
+	std::string _outputDirectory;
+
+	FileFactory _fileFactory;
+	FilterFactory _filterFactory;
+	RegestrationFactory _regestrationFactory;
+	ReconstructFactory _reconstructFactory;
+	SmoothingFactory _smoothingFactory;
+};
+
+#endif
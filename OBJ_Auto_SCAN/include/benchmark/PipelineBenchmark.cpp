@@ -0,0 +1,416 @@
+#include "benchmark/PipelineBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <pcl/filters/filter.h>
+#include "file/FrameFiles.h"
+#include "file/ParallelFileLoader.h"
+#include "pointCloud/SpatialIndexCache.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
+#include "pointCloudProcessing/transform/TransformKernels.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//		Nearest rank, samples must be sorted
+static double Percentile(const std::vector<double>& samples, double percent)
+{
+	if (samples.empty())
+		return 0;
+	std::size_t rank = (std::size_t)std::ceil(percent / 100 * samples.size());
+	return samples[std::min(samples.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+static std::string JsonString(const std::string& str)
+{
+	std::string result("\"");
+	for (std::size_t counter = 0; counter < str.size(); counter++)
+	{
+		if (str[counter] == '"' || str[counter] == '\\')
+			result += '\\';
+		result += str[counter];
+	}
+	return result + "\"";
+}
+
+PipelineBenchmark::PipelineBenchmark() : _repeats(1), _sampleLeaf(0.005f)
+{
+	InitialStages();
+}
+
+unsigned long long PipelineBenchmark::GetPeakRssBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return (unsigned long long)usage.ru_maxrss * 1024;
+#endif
+}
+
+//		*****************************************************************
+//				Datasets
+//		*****************************************************************
+
+void PipelineBenchmark::AddDataset(std::string name, std::string dir, int maxFrames)
+{
+	std::vector<std::string> paths = ListFrameFiles(dir, ".obj");
+	if (maxFrames > 0 && paths.size() > maxFrames)
+		paths.resize(maxFrames);
+	if (paths.empty())
+		throw std::string("PipelineBenchmark: No .obj files in ") + dir;
+	ParallelFileLoader loader(&_fileFactory);
+	std::vector<LoadedFile> files = loader.Load(paths, "OBJ(*.obj)");
+	BenchmarkDataset dataset;
+	dataset.name = name;
+	for (int counter = 0; counter < files.size(); counter++)
+	{
+		if (!files[counter].error.empty())
+			throw std::string("PipelineBenchmark: ") + files[counter].path + std::string(" : ") + files[counter].error;
+		dataset.frames.push_back(files[counter].cloud);
+	}
+	_datasets.push_back(dataset);
+}
+
+void PipelineBenchmark::SetRepeats(int repeats)
+{
+	if (repeats < 1)
+		throw std::string("PipelineBenchmark: repeats must be positive");
+	_repeats = repeats;
+}
+
+void PipelineBenchmark::SetSampleLeaf(float leaf)
+{
+	if (leaf <= 0)
+		throw std::string("PipelineBenchmark: leaf must be positive");
+	_sampleLeaf = leaf;
+}
+
+//		The inputs are built outside the timed calls, with the same factories
+void PipelineBenchmark::PrepareSampled(BenchmarkDataset& dataset)
+{
+	if (!dataset.sampled.empty())
+		return;
+	FilterProcessing* filter = _filterFactory.GetVoixelGridFilter();
+	filter->SetLeafSize(_sampleLeaf, _sampleLeaf, _sampleLeaf);
+	for (int counter = 0; counter < dataset.frames.size(); counter++)
+	{
+		pcl::PointCloud<PointT>::Ptr cloud(new pcl::PointCloud<PointT>());
+		std::vector<int> map;
+		pcl::removeNaNFromPointCloud(*dataset.frames[counter], *cloud, map);
+		filter->Processing(cloud);
+		dataset.sampled.push_back(pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>(*filter->GetResult())));
+	}
+}
+
+void PipelineBenchmark::PrepareKeypoints(BenchmarkDataset& dataset)
+{
+	if (!dataset.keypoints.empty())
+		return;
+	PrepareSampled(dataset);
+	KeypointProcessing* sift = _keypointFactory.GetSIFT();
+	for (int counter = 0; counter < dataset.sampled.size(); counter++)
+	{
+		sift->Processing(dataset.sampled[counter]);
+		dataset.keypoints.push_back(pcl::PointCloud<KeypointT>::Ptr(new pcl::PointCloud<KeypointT>(*sift->GetResult())));
+	}
+}
+
+void PipelineBenchmark::PrepareMeshes(BenchmarkDataset& dataset)
+{
+	if (!dataset.meshes.empty())
+		return;
+	PrepareSampled(dataset);
+	ReconstructProcessing* greedy = _reconstructFactory.GetGreedyProjection();
+	for (int counter = 0; counter < dataset.sampled.size(); counter++)
+	{
+		greedy->Processing(dataset.sampled[counter]);
+		dataset.meshes.push_back(pcl::PolygonMeshPtr(new pcl::PolygonMesh(*greedy->GetMesh())));
+	}
+}
+
+//		*****************************************************************
+//				Stages
+//		*****************************************************************
+
+void PipelineBenchmark::InitialStages()
+{
+	std::function<void(BenchmarkDataset&)> none = [](BenchmarkDataset& dataset) {};
+	std::function<void(BenchmarkDataset&)> sampled = [this](BenchmarkDataset& dataset) { PrepareSampled(dataset); };
+	std::function<void(BenchmarkDataset&)> keypoints = [this](BenchmarkDataset& dataset) { PrepareKeypoints(dataset); };
+	std::function<void(BenchmarkDataset&)> meshes = [this](BenchmarkDataset& dataset) { PrepareMeshes(dataset); };
+	std::function<void(BenchmarkDataset&, int)> noSetup = [](BenchmarkDataset& dataset, int index) {};
+	std::function<void(BenchmarkDataset&, int)> copyKeypoints = [this](BenchmarkDataset& dataset, int index) { CopyKeypoints(dataset, index); };
+	Stage stage;
+	stage.isPair = false;
+	stage.prepare = none;
+	stage.setup = noSetup;
+
+	stage.name = "voxel";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		FilterProcessing* filter = _filterFactory.GetVoixelGridFilter();
+		filter->SetLeafSize(_sampleLeaf, _sampleLeaf, _sampleLeaf);
+		filter->Processing(dataset.frames[index]);
+		return dataset.frames[index]->size();
+	};
+	_stages.push_back(stage);
+
+	//		Keeps the middle half of the frame on every axis
+	stage.name = "box";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		Eigen::Vector3f minPoint;
+		Eigen::Vector3f maxPoint;
+		TransformKernels::GetMinMax(*dataset.frames[index], minPoint, maxPoint);
+		Eigen::Vector3f quarter = (maxPoint - minPoint) / 4;
+		FilterProcessing* filter = _filterFactory.GetBoundingBoxFilter();
+		filter->SetBoundingBox(minPoint.x() + quarter.x(), maxPoint.x() - quarter.x(), minPoint.y() + quarter.y(), maxPoint.y() - quarter.y(),
+			minPoint.z() + quarter.z(), maxPoint.z() - quarter.z());
+		filter->Processing(dataset.frames[index]);
+		return dataset.frames[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.name = "outlier";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		FilterProcessing* filter = _filterFactory.GetOutlierRemovalFilter();
+		filter->SetMeanK(50);
+		filter->SetStddevMulThresh(1.0f);
+		filter->Processing(dataset.frames[index]);
+		return dataset.frames[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.prepare = sampled;
+	stage.name = "sift";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_keypointFactory.GetSIFT()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.name = "harris";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_keypointFactory.GetHarris()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.isPair = true;
+	stage.prepare = keypoints;
+	stage.setup = copyKeypoints;
+	stage.name = "fpfh";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		return RunDescriptor(_correspondencesFactory.GetFPFH(), dataset, index);
+	};
+	_stages.push_back(stage);
+
+	stage.name = "pfh";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		return RunDescriptor(_correspondencesFactory.GetPFH(), dataset, index);
+	};
+	_stages.push_back(stage);
+
+	stage.name = "shot";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		return RunDescriptor(_correspondencesFactory.GetSHOTRGB(), dataset, index);
+	};
+	_stages.push_back(stage);
+
+	stage.prepare = sampled;
+	stage.setup = noSetup;
+	stage.name = "icp";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		RegestrationProcessing* icp = _regestrationFactory.GetICP();
+		icp->SetCorrespondenceDistance(0.05f);
+		icp->SetMaximumIterations(50);
+		icp->Processing(dataset.sampled[index - 1], dataset.sampled[index]);
+		return dataset.sampled[index - 1]->size() + dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.isPair = false;
+	stage.name = "poisson";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_reconstructFactory.GetPoisson()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.name = "marchingcubes";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_reconstructFactory.GetMarchingCubes()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	stage.name = "greedy";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_reconstructFactory.GetGreedyProjection()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+
+	//		Points of a mesh are its vertices
+	stage.prepare = meshes;
+	stage.name = "laplacian";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_smoothingFactory.GetMeshSmoothingLaplacian()->Processing(dataset.meshes[index]);
+		return (std::size_t)dataset.meshes[index]->cloud.width * dataset.meshes[index]->cloud.height;
+	};
+	_stages.push_back(stage);
+
+	stage.prepare = sampled;
+	stage.name = "mls";
+	stage.run = [this](BenchmarkDataset& dataset, int index)
+	{
+		_smoothingFactory.GetResampling()->Processing(dataset.sampled[index]);
+		return dataset.sampled[index]->size();
+	};
+	_stages.push_back(stage);
+}
+
+void PipelineBenchmark::CopyKeypoints(BenchmarkDataset& dataset, int index)
+{
+	_sourceKeypoints.reset(new pcl::PointCloud<KeypointT>(*dataset.keypoints[index - 1]));
+	_targetKeypoints.reset(new pcl::PointCloud<KeypointT>(*dataset.keypoints[index]));
+}
+
+std::size_t PipelineBenchmark::RunDescriptor(CorrespondencesProcessing* descriptor, BenchmarkDataset& dataset, int index)
+{
+	std::size_t points = _sourceKeypoints->size() + _targetKeypoints->size();
+	descriptor->Processing(dataset.sampled[index - 1], _sourceKeypoints, dataset.sampled[index], _targetKeypoints);
+	return points;
+}
+
+std::vector<std::string> PipelineBenchmark::GetStageNames()
+{
+	std::vector<std::string> names;
+	for (int counter = 0; counter < _stages.size(); counter++)
+		names.push_back(_stages[counter].name);
+	return names;
+}
+
+//		*****************************************************************
+//				Run
+//		*****************************************************************
+
+void PipelineBenchmark::Run(std::string stage)
+{
+	bool isFound = stage.empty();
+	for (int stageIndex = 0; stageIndex < _stages.size(); stageIndex++)
+	{
+		if (!stage.empty() && _stages[stageIndex].name != stage)
+			continue;
+		isFound = true;
+		for (int datasetIndex = 0; datasetIndex < _datasets.size(); datasetIndex++)
+			RunStage(_stages[stageIndex], _datasets[datasetIndex]);
+	}
+	if (!isFound)
+		throw std::string("PipelineBenchmark: Unknown stage ") + stage;
+}
+
+//		Every call starts with empty normal / index caches, so a repeat does not reuse the previous one's work
+void PipelineBenchmark::RunStage(Stage& stage, BenchmarkDataset& dataset)
+{
+	stage.prepare(dataset);
+	std::vector<double> samples;
+	std::size_t points = 0;
+	for (int repeat = 0; repeat < _repeats; repeat++)
+	{
+		for (int index = stage.isPair ? 1 : 0; index < dataset.frames.size(); index++)
+		{
+			SpatialIndexCache::GetInstance()->Clear();
+			NormalsService::GetInstance()->Clear();
+			stage.setup(dataset, index);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			points += stage.run(dataset, index);
+			samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+	}
+	std::sort(samples.begin(), samples.end());
+	BenchmarkResult result;
+	result.stage = stage.name;
+	result.dataset = dataset.name;
+	result.samples = samples.size();
+	result.points = points;
+	result.totalMilliseconds = 0;
+	for (int counter = 0; counter < samples.size(); counter++)
+		result.totalMilliseconds += samples[counter];
+	result.p50 = Percentile(samples, 50);
+	result.p90 = Percentile(samples, 90);
+	result.p99 = Percentile(samples, 99);
+	result.max = samples.empty() ? 0 : samples.back();
+	result.framesPerSecond = result.totalMilliseconds > 0 ? samples.size() * 1000.0 / result.totalMilliseconds : 0;
+	result.pointsPerSecond = result.totalMilliseconds > 0 ? points * 1000.0 / result.totalMilliseconds : 0;
+	result.peakRssBytes = GetPeakRssBytes();
+	_results.push_back(result);
+	std::cout << stage.name << " / " << dataset.name << " : " << result.samples << " samples, p50 " << std::fixed << std::setprecision(1) << result.p50 << " ms" << std::endl;
+}
+
+std::vector<BenchmarkResult> PipelineBenchmark::GetResults()
+{
+	return _results;
+}
+
+void PipelineBenchmark::PrintResults(std::ostream& out)
+{
+	out << std::left << std::setw(14) << "Stage" << std::setw(24) << "Dataset" << std::right << std::setw(8) << "Samples"
+		<< std::setw(10) << "p50 (ms)" << std::setw(10) << "p90 (ms)" << std::setw(10) << "p99 (ms)" << std::setw(12) << "Frame/s"
+		<< std::setw(10) << "Mpt/s" << std::setw(12) << "Peak (MB)" << std::endl;
+	for (int counter = 0; counter < _results.size(); counter++)
+	{
+		BenchmarkResult& result = _results[counter];
+		out << std::left << std::setw(14) << result.stage << std::setw(24) << result.dataset << std::right << std::setw(8) << result.samples
+			<< std::fixed << std::setprecision(1) << std::setw(10) << result.p50 << std::setw(10) << result.p90 << std::setw(10) << result.p99
+			<< std::setprecision(2) << std::setw(12) << result.framesPerSecond << std::setprecision(3) << std::setw(10) << result.pointsPerSecond / 1e6
+			<< std::setprecision(1) << std::setw(12) << result.peakRssBytes / 1048576.0 << std::endl;
+	}
+}
+
+//		One object per stage and dataset, times in milliseconds
+void PipelineBenchmark::WriteJson(std::ostream& out)
+{
+	out.unsetf(std::ios::floatfield);
+	out << std::setprecision(9) << "{" << std::endl;
+	out << "  \"instructionSet\": " << JsonString(TransformKernels::GetInstructionSetName(TransformKernels::GetInstructionSet())) << "," << std::endl;
+	out << "  \"repeats\": " << _repeats << "," << std::endl;
+	out << "  \"sampleLeaf\": " << _sampleLeaf << "," << std::endl;
+	out << "  \"results\": [" << std::endl;
+	for (int counter = 0; counter < _results.size(); counter++)
+	{
+		BenchmarkResult& result = _results[counter];
+		out << "    { \"stage\": " << JsonString(result.stage) << ", \"dataset\": " << JsonString(result.dataset)
+			<< ", \"samples\": " << result.samples << ", \"points\": " << result.points
+			<< ", \"totalMs\": " << result.totalMilliseconds << ", \"p50Ms\": " << result.p50 << ", \"p90Ms\": " << result.p90
+			<< ", \"p99Ms\": " << result.p99 << ", \"maxMs\": " << result.max
+			<< ", \"framesPerSecond\": " << result.framesPerSecond << ", \"pointsPerSecond\": " << result.pointsPerSecond
+			<< ", \"peakRssBytes\": " << result.peakRssBytes << " }" << (counter + 1 < _results.size() ? "," : "") << std::endl;
+	}
+	out << "  ]" << std::endl;
+	out << "}" << std::endl;
+}
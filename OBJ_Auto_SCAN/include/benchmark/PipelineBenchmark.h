@@ -0,0 +1,104 @@
+#ifndef PIPELINE_BENCHMARK
+#define PIPELINE_BENCHMARK
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <pcl/PolygonMesh.h>
+#include "Typedef.h"
+#include "file/FileFactory.h"
+#include "pointCloudProcessing/filter/FilterFactory.h"
+#include "pointCloudProcessing/keypoint/KeypointFactory.h"
+#include "pointCloudProcessing/correspondences/CorrespondencesFactory.h"
+#include "pointCloudProcessing/regestration/RegestrationFactory.h"
+#include "pointCloudProcessing/reconstruct/ReconstructFactory.h"
+#include "pointCloudProcessing/smoothing/SmoothingFactory.h"
+
+//		One frame set of model/, with the inputs the later stages need built on first use
+struct BenchmarkDataset
+{
+	std::string name;
+	std::vector<pcl::PointCloud<PointT>::Ptr> frames;			//	as loaded
+	std::vector<pcl::PointCloud<PointT>::Ptr> sampled;			//	voxel grid, no NaN : input of keypoints and later
+	std::vector<pcl::PointCloud<KeypointT>::Ptr> keypoints;		//	SIFT of sampled : input of the descriptors
+	std::vector<pcl::PolygonMeshPtr> meshes;					//	greedy projection of sampled : input of laplacian
+};
+
+struct BenchmarkResult
+{
+	std::string stage;
+	std::string dataset;
+	std::size_t samples;
+	std::size_t points;						//	input points over all samples
+	double totalMilliseconds;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double framesPerSecond;
+	double pointsPerSecond;
+	unsigned long long peakRssBytes;		//	process peak once the stage is done
+};
+
+//		*****************************************************************
+//				Pipeline Benchmark
+//				Runs every processing factory over the bundled scans and
+//				records the latency of each call. Pair stages (descriptors, ICP)
+//				take frame i - 1 and i as one sample.
+//				Stages: voxel, box, outlier, sift, harris, fpfh, pfh, shot, icp,
+//				poisson, marchingcubes, greedy, laplacian, mls
+//		*****************************************************************
+class PipelineBenchmark
+{
+public:
+	PipelineBenchmark();
+	void AddDataset(std::string name, std::string dir, int maxFrames = 0);
+	void SetRepeats(int repeats);
+	void SetSampleLeaf(float leaf);
+	std::vector<std::string> GetStageNames();
+	//		Empty stage runs all of them
+	void Run(std::string stage = std::string());
+	std::vector<BenchmarkResult> GetResults();
+	void PrintResults(std::ostream& out);
+	void WriteJson(std::ostream& out);
+
+	static unsigned long long GetPeakRssBytes();
+
+private:
+	struct Stage
+	{
+		std::string name;
+		bool isPair;
+		std::function<void(BenchmarkDataset&)> prepare;					//	builds the inputs, not timed
+		std::function<void(BenchmarkDataset&, int)> setup;				//	before every sample, not timed
+		std::function<std::size_t(BenchmarkDataset&, int)> run;		//	returns the input points of the sample
+	};
+
+	void InitialStages();
+	void RunStage(Stage& stage, BenchmarkDataset& dataset);
+	void PrepareSampled(BenchmarkDataset& dataset);
+	void PrepareKeypoints(BenchmarkDataset& dataset);
+	void PrepareMeshes(BenchmarkDataset& dataset);
+	void CopyKeypoints(BenchmarkDataset& dataset, int index);
+	std::size_t RunDescriptor(CorrespondencesProcessing* descriptor, BenchmarkDataset& dataset, int index);
+
+	std::vector<Stage> _stages;
+	std::vector<BenchmarkDataset> _datasets;
+	std::vector<BenchmarkResult> _results;
+	int _repeats;
+	float _sampleLeaf;
+	//		The descriptors drop the keypoints without a descriptor in place, each sample gets its own copy
+	pcl::PointCloud<KeypointT>::Ptr _sourceKeypoints;
+	pcl::PointCloud<KeypointT>::Ptr _targetKeypoints;
+
+	FileFactory _fileFactory;
+	FilterFactory _filterFactory;
+	KeypointFactory _keypointFactory;
+	CorrespondencesFactory _correspondencesFactory;
+	RegestrationFactory _regestrationFactory;
+	ReconstructFactory _reconstructFactory;
+	SmoothingFactory _smoothingFactory;
+};
+
+#endif
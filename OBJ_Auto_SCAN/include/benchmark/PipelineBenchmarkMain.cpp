@@ -0,0 +1,64 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "benchmark/PipelineBenchmark.h"
+
+//		OBJ_Auto_SCAN_PipelineBenchmark [--model dir] [--frames N] [--repeats N] [--leaf size] [--stage name] [--json file]
+//		Peak RSS only grows within a process, run one --stage per process to compare the memory of stages
+int main(int argc, char* argv[])
+{
+	std::string modelDirectory = "../OBJ_Auto_SCAN/model";
+	std::string stage;
+	std::string jsonPath = "benchmark.json";
+	int frames = 0;
+	int repeats = 1;
+	float leaf = 0.005f;
+	for (int counter = 1; counter < argc; counter++)
+	{
+		std::string option = argv[counter];
+		if (counter + 1 >= argc)
+		{
+			std::cerr << "Usage: " << argv[0] << " [--model dir] [--frames N] [--repeats N] [--leaf size] [--stage name] [--json file]" << std::endl;
+			return 1;
+		}
+		std::string value = argv[++counter];
+		if (option == "--model")
+			modelDirectory = value;
+		else if (option == "--frames")
+			frames = std::atoi(value.c_str());
+		else if (option == "--repeats")
+			repeats = std::atoi(value.c_str());
+		else if (option == "--leaf")
+			leaf = (float)std::atof(value.c_str());
+		else if (option == "--stage")
+			stage = value;
+		else if (option == "--json")
+			jsonPath = value;
+		else
+		{
+			std::cerr << "Unknown option " << option << std::endl;
+			return 1;
+		}
+	}
+	try
+	{
+		PipelineBenchmark benchmark;
+		benchmark.SetRepeats(repeats);
+		benchmark.SetSampleLeaf(leaf);
+		benchmark.AddDataset("doll_1_3sec", modelDirectory + "/doll_1_3sec/original", frames);
+		benchmark.AddDataset("kinect v1", modelDirectory + "/kinect v1/1sec/boundingBox/doll-1", frames);
+		benchmark.Run(stage);
+		std::cout << std::endl;
+		benchmark.PrintResults(std::cout);
+		std::ofstream json(jsonPath.c_str());
+		if (!json.is_open())
+			throw std::string("Cannot create ") + jsonPath;
+		benchmark.WriteJson(json);
+	}
+	catch (std::string& message)
+	{
+		std::cerr << message << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,195 @@
+//		*****************************************************************
+//				Transform Kernel Benchmark
+//				Compares TransformKernels with the per-point loops MainWindow
+//				used before (copy + loop, pcl::transformPointCloud).
+//				Usage : OBJ_Auto_SCAN_Benchmark [points] [repeats]
+//		*****************************************************************
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <Eigen/Geometry>
+#include <pcl/common/transforms.h>
+#include "pointCloudProcessing/transform/TransformKernels.h"
+
+static double Measure(int repeats, std::function<void()> run)
+{
+	run();		//	warm up
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int counter = 0; counter < repeats; counter++)
+		run();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+static void Report(std::string name, double milliseconds, double baseline, std::size_t points)
+{
+	std::cout << "  " << std::left << std::setw(28) << name << std::right
+		<< std::fixed << std::setprecision(3) << std::setw(10) << milliseconds << " ms"
+		<< std::setprecision(1) << std::setw(10) << points / milliseconds / 1000 << " Mpt/s"
+		<< std::setprecision(2) << std::setw(8) << baseline / milliseconds << "x" << std::endl;
+}
+
+//		Largest coordinate difference, NaN points must stay NaN
+static float Compare(const pcl::PointCloud<PointT>& a, const pcl::PointCloud<PointT>& b)
+{
+	float error = 0;
+	for (std::size_t counter = 0; counter < a.size(); counter++)
+	{
+		for (int axis = 0; axis < 4; axis++)
+		{
+			float x = a.points[counter].data[axis];
+			float y = b.points[counter].data[axis];
+			if (std::isnan(x) != std::isnan(y))
+				return std::numeric_limits<float>::infinity();
+			if (!std::isnan(x))
+				error = std::max(error, std::fabs(x - y));
+		}
+		if (a.points[counter].rgba != b.points[counter].rgba)
+			return std::numeric_limits<float>::infinity();
+	}
+	return error;
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t numberOfPoints = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 1000000;
+	int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+
+	//		A flexx-like cloud : random points, every 50th one invalid
+	pcl::PointCloud<PointT>::Ptr source(new pcl::PointCloud<PointT>());
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	for (std::size_t counter = 0; counter < numberOfPoints; counter++)
+	{
+		PointT point;
+		point.x = distribution(generator);
+		point.y = distribution(generator);
+		point.z = distribution(generator) + 2.0f;
+		point.rgba = 0xffffffff;
+		if (counter % 50 == 0)
+			point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN();
+		source->push_back(point);
+	}
+	source->is_dense = false;
+	Eigen::Affine3f affine = Eigen::Translation3f(0.1f, -0.2f, 0.3f) * Eigen::AngleAxisf(0.5f, Eigen::Vector3f(1, 2, 3).normalized());
+	Eigen::Matrix4f matrix = affine.matrix();
+
+	InstructionSet supported = TransformKernels::GetSupportedInstructionSet();
+	std::cout << "Points : " << numberOfPoints << ", repeats : " << repeats << ", CPU : " << TransformKernels::GetInstructionSetName(supported) << std::endl;
+
+	pcl::PointCloud<PointT> reference;
+	pcl::PointCloud<PointT> output;
+
+	std::cout << "Translate" << std::endl;
+	double baseline = Measure(repeats, [&]()
+	{
+		output = *source;
+		for (int pointCounter = 0; pointCounter < output.size(); pointCounter++)
+		{
+			output.points[pointCounter].x += 0.1f;
+			output.points[pointCounter].y += 0.2f;
+			output.points[pointCounter].z += 0.3f;
+		}
+	});
+	reference = output;
+	Report("copy + loop", baseline, baseline, numberOfPoints);
+	for (int set = 0; set <= (int)supported; set++)
+	{
+		TransformKernels::SetInstructionSet((InstructionSet)set);
+		double time = Measure(repeats, [&]()
+		{
+			output = *source;
+			TransformKernels::Translate(output, 0.1f, 0.2f, 0.3f);
+		});
+		Report(std::string("copy + ") + TransformKernels::GetInstructionSetName((InstructionSet)set), time, baseline, numberOfPoints);
+		if (Compare(reference, output) > 1e-5f)
+			std::cout << "  mismatch" << std::endl;
+	}
+
+	std::cout << "Scale" << std::endl;
+	baseline = Measure(repeats, [&]()
+	{
+		output = *source;
+		for (int pointIndex = 0; pointIndex < output.points.size(); pointIndex++)
+		{
+			output.points[pointIndex].x *= 1.5f;
+			output.points[pointIndex].y *= 2.0f;
+			output.points[pointIndex].z *= 0.5f;
+		}
+	});
+	reference = output;
+	Report("copy + loop", baseline, baseline, numberOfPoints);
+	for (int set = 0; set <= (int)supported; set++)
+	{
+		TransformKernels::SetInstructionSet((InstructionSet)set);
+		double time = Measure(repeats, [&]()
+		{
+			output = *source;
+			TransformKernels::Scale(output, 1.5f, 2.0f, 0.5f);
+		});
+		Report(std::string("copy + ") + TransformKernels::GetInstructionSetName((InstructionSet)set), time, baseline, numberOfPoints);
+		if (Compare(reference, output) > 1e-5f)
+			std::cout << "  mismatch" << std::endl;
+	}
+
+	std::cout << "Affine 4x4" << std::endl;
+	baseline = Measure(repeats, [&]()
+	{
+		pcl::transformPointCloud(*source, output, matrix);
+	});
+	reference = output;
+	Report("pcl::transformPointCloud", baseline, baseline, numberOfPoints);
+	for (int set = 0; set <= (int)supported; set++)
+	{
+		TransformKernels::SetInstructionSet((InstructionSet)set);
+		double time = Measure(repeats, [&]()
+		{
+			TransformKernels::Transform(*source, output, matrix);
+		});
+		Report(std::string("copy + ") + TransformKernels::GetInstructionSetName((InstructionSet)set), time, baseline, numberOfPoints);
+		if (Compare(reference, output) > 1e-4f)
+			std::cout << "  mismatch" << std::endl;
+		//		The in-place form used on buffers that are already private
+		output = *source;
+		time = Measure(repeats, [&]()
+		{
+			TransformKernels::Transform(output, matrix);
+		});
+		Report(std::string("in place ") + TransformKernels::GetInstructionSetName((InstructionSet)set), time, baseline, numberOfPoints);
+	}
+
+	std::cout << "Min / Max" << std::endl;
+	float minimum = 0;
+	baseline = Measure(repeats, [&]()
+	{
+		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>(*source));
+		minimum = 0;
+		for (int pointCounter = 0; pointCounter < temp->size(); pointCounter++)
+		{
+			minimum = std::min(minimum, temp->points[pointCounter].x);
+			minimum = std::min(minimum, temp->points[pointCounter].y);
+			minimum = std::min(minimum, temp->points[pointCounter].z);
+		}
+	});
+	Report("copy + loop", baseline, baseline, numberOfPoints);
+	for (int set = 0; set <= (int)supported; set++)
+	{
+		TransformKernels::SetInstructionSet((InstructionSet)set);
+		Eigen::Vector3f minPoint;
+		Eigen::Vector3f maxPoint;
+		double time = Measure(repeats, [&]()
+		{
+			TransformKernels::GetMinMax(*source, minPoint, maxPoint);
+		});
+		Report(TransformKernels::GetInstructionSetName((InstructionSet)set), time, baseline, numberOfPoints);
+		if (std::fabs(std::min(0.0f, minPoint.minCoeff()) - minimum) > 1e-6f)
+			std::cout << "  mismatch" << std::endl;
+	}
+	TransformKernels::SetInstructionSet(supported);
+	return 0;
+}
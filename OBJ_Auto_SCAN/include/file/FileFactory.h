@@ -2,9 +2,9 @@
 #define FILE_FACTORY
 
 #include "file/MyFile.h";
-#include "file/objFile.h";
-#include "file/plyFile.h";
-#include "file/pcdFile.h";
+#include "file/ObjFile.h";
+#include "file/PlyFile.h";
+#include "file/PcdFile.h";
 
 class FileFactory
 {
@@ -0,0 +1,55 @@
+#include "file/FrameFiles.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+static std::string ToLower(std::string str)
+{
+	std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)tolower(c); });
+	return str;
+}
+
+bool NaturalLess(const std::string& a, const std::string& b)
+{
+	std::size_t i = 0;
+	std::size_t j = 0;
+	while (i < a.size() && j < b.size())
+	{
+		if (isdigit((unsigned char)a[i]) && isdigit((unsigned char)b[j]))
+		{
+			std::size_t iEnd = i;
+			std::size_t jEnd = j;
+			while (iEnd < a.size() && isdigit((unsigned char)a[iEnd]))	iEnd++;
+			while (jEnd < b.size() && isdigit((unsigned char)b[jEnd]))	jEnd++;
+			unsigned long long x = std::strtoull(a.substr(i, iEnd - i).c_str(), NULL, 10);
+			unsigned long long y = std::strtoull(b.substr(j, jEnd - j).c_str(), NULL, 10);
+			if (x != y)
+				return x < y;
+			i = iEnd;
+			j = jEnd;
+		}
+		else
+		{
+			if (a[i] != b[j])
+				return a[i] < b[j];
+			i++;
+			j++;
+		}
+	}
+	return a.size() - i < b.size() - j;
+}
+
+std::vector<std::string> ListFrameFiles(std::string dir, std::string extension)
+{
+	extension = ToLower(extension);
+	std::vector<std::string> paths;
+	for (boost::filesystem::directory_iterator it(dir), end; it != end; ++it)
+	{
+		if (boost::filesystem::is_regular_file(it->path()) && ToLower(it->path().extension().string()) == extension)
+			paths.push_back(it->path().string());
+	}
+	std::sort(paths.begin(), paths.end(), NaturalLess);
+	return paths;
+}
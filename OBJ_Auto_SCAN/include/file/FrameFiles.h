@@ -0,0 +1,13 @@
+#ifndef FRAME_FILES
+#define FRAME_FILES
+
+#include <string>
+#include <vector>
+
+//		"doll_2" < "doll_10", so frames are processed in capture order
+bool NaturalLess(const std::string& a, const std::string& b);
+
+//		Regular files of dir with the given extension (".obj", case-insensitive), in capture order
+std::vector<std::string> ListFrameFiles(std::string dir, std::string extension);
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <pcl/io/io.h>
+#include "Typedef.h"
 
 class MyFile
 {
@@ -11,6 +12,10 @@ public:
 	{
 	}
 
+	virtual ~MyFile()
+	{
+	}
+
 	virtual void LoadFile() = 0;
 	virtual void SaveFile(pcl::PointCloud<PointT>::Ptr cloud) = 0;
 	virtual void SaveFile(pcl::PolygonMeshPtr mesh) = 0;
@@ -7,6 +7,8 @@
 #include <pcl/io/obj_io.h>
 #include <pcl/io/vtk_lib_io.h>
 #include "file/MyFile.h";
+#include "file/ObjParser.h"
+#include "trace/Tracer.h"
 
 class ObjFile : MyFile
 {
@@ -18,19 +20,13 @@ public:
 
 	void LoadFile()
 	{
-		pcl::OBJReader reader;
-		reader.read(_dir, *_cloud);
-		for (int counter = 0; counter < _cloud->points.size(); counter++)
-		{
-			_cloud->points[counter].r = 255;
-			_cloud->points[counter].g = 255;
-			_cloud->points[counter].b = 255;
-			_cloud->points[counter].a = 255;
-		}
+		TRACE_SCOPE("ObjFile::LoadFile", "file");
+		ObjParser::Parse(_dir, *_cloud);		//	vertices only, already white
 	}
 
 	void SaveFile(pcl::PointCloud<PointT>::Ptr cloud)
 	{
+		TRACE_SCOPE("ObjFile::SaveFile", "file");
 		pcl::PolygonMesh mesh;
 		toPCLPointCloud2(*cloud, mesh.cloud);
 		pcl::io::saveOBJFile(_dir, mesh);
@@ -43,7 +39,8 @@ public:
 
 	void SaveFile(pcl::PolygonMeshPtr mesh)
 	{
-
+		TRACE_SCOPE("ObjFile::SaveFile", "file");
+		pcl::io::saveOBJFile(_dir, *mesh);
 	}
 
 private:
@@ -0,0 +1,212 @@
+#include "file/ObjParser.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+static const double POW10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+void ObjParser::Parse(std::string path, pcl::PointCloud<PointT>& cloud, pcl::PointCloud<NormalT>* normals, std::vector<pcl::Vertices>* faces)
+{
+	boost::system::error_code error;
+	boost::uintmax_t size = boost::filesystem::file_size(path, error);
+	if (error)
+		throw std::string("ObjParser: Cannot open ") + path;
+	if (size == 0)
+	{
+		Parse(NULL, NULL, cloud, normals, faces);
+		return;
+	}
+	boost::iostreams::mapped_file_source file;
+	try
+	{
+		file.open(path);
+	}
+	catch (std::exception&)
+	{
+		throw std::string("ObjParser: Cannot map ") + path;
+	}
+	Parse(file.data(), file.data() + file.size(), cloud, normals, faces);
+}
+
+void ObjParser::Parse(const char* begin, const char* end, pcl::PointCloud<PointT>& cloud, pcl::PointCloud<NormalT>* normals, std::vector<pcl::Vertices>* faces)
+{
+	cloud.clear();
+	cloud.points.reserve((end - begin) / 32);		//	"v -0.123456 0.123456 0.123456\n" is about 32 bytes
+	if (normals != NULL)
+		normals->clear();
+	if (faces != NULL)
+		faces->clear();
+
+	PointT point;
+	point.rgba = 0xffffffff;
+	NormalT normal;
+	const char* p = begin;
+	while (p < end)
+	{
+		const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (lineEnd == NULL)
+			lineEnd = end;
+		p = SkipSpaces(p, lineEnd);
+		if (lineEnd - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+		{
+			const char* q = ParseFloat(SkipSpaces(p + 2, lineEnd), lineEnd, point.x);
+			q = ParseFloat(SkipSpaces(q, lineEnd), lineEnd, point.y);
+			q = ParseFloat(SkipSpaces(q, lineEnd), lineEnd, point.z);
+			if (q == NULL)
+				throw std::string("ObjParser: Bad vertex record");
+			cloud.points.push_back(point);
+		}
+		else if (normals != NULL && lineEnd - p > 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t'))
+		{
+			const char* q = ParseFloat(SkipSpaces(p + 3, lineEnd), lineEnd, normal.normal_x);
+			q = ParseFloat(SkipSpaces(q, lineEnd), lineEnd, normal.normal_y);
+			q = ParseFloat(SkipSpaces(q, lineEnd), lineEnd, normal.normal_z);
+			if (q == NULL)
+				throw std::string("ObjParser: Bad normal record");
+			normal.curvature = 0;
+			normals->points.push_back(normal);
+		}
+		else if (faces != NULL && lineEnd - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+		{
+			//		f v, f v/vt, f v/vt/vn, f v//vn ; only the vertex index is kept
+			pcl::Vertices face;
+			const char* q = SkipSpaces(p + 2, lineEnd);
+			while (q < lineEnd && *q != '\r')
+			{
+				int index = 0;
+				q = ParseInt(q, lineEnd, index);
+				if (q == NULL)
+					throw std::string("ObjParser: Bad face record");
+				//		1-based, negative indices count back from the last vertex
+				face.vertices.push_back(index > 0 ? index - 1 : (int)cloud.points.size() + index);
+				while (q < lineEnd && *q != ' ' && *q != '\t' && *q != '\r')
+					q++;
+				q = SkipSpaces(q, lineEnd);
+			}
+			faces->push_back(face);
+		}
+		p = lineEnd + 1;
+	}
+	cloud.width = (uint32_t)cloud.points.size();
+	cloud.height = 1;
+	cloud.is_dense = true;
+	if (normals != NULL)
+	{
+		normals->width = (uint32_t)normals->points.size();
+		normals->height = 1;
+	}
+}
+
+//		Decimal and scientific notation; keeps up to 19 significant digits, enough for float
+const char* ObjParser::ParseFloat(const char* p, const char* end, float& value)
+{
+	if (p == NULL || p >= end)
+		return NULL;
+	const char* start = p;
+	bool isNegative = false;
+	if (*p == '-' || *p == '+')
+	{
+		isNegative = *p == '-';
+		p++;
+	}
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool hasDigit = false;
+	for (; p < end && IsDigit(*p); p++)
+	{
+		hasDigit = true;
+		if (digits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa != 0)
+				digits++;
+		}
+		else
+			exponent++;
+	}
+	if (p < end && *p == '.')
+	{
+		for (p++; p < end && IsDigit(*p); p++)
+		{
+			hasDigit = true;
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0)
+					digits++;
+				exponent--;
+			}
+		}
+	}
+	if (!hasDigit)
+	{
+		//		nan, inf, ... are rare enough to leave to strtod
+		char buffer[64];
+		std::size_t length = 0;
+		while (start + length < end && length < sizeof(buffer) - 1 && start[length] != ' ' && start[length] != '\t' && start[length] != '\r')
+			length++;
+		memcpy(buffer, start, length);
+		buffer[length] = '\0';
+		char* parsedEnd = NULL;
+		value = (float)strtod(buffer, &parsedEnd);
+		return parsedEnd == buffer ? NULL : start + (parsedEnd - buffer);
+	}
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		int power = 0;
+		const char* q = ParseInt(p + 1, end, power);
+		if (q != NULL)
+		{
+			exponent += power;
+			p = q;
+		}
+	}
+	double result = (double)mantissa;
+	if (exponent < 0)
+		result = -exponent <= 22 ? result / POW10[-exponent] : result * std::pow(10.0, exponent);
+	else if (exponent > 0)
+		result = exponent <= 22 ? result * POW10[exponent] : result * std::pow(10.0, exponent);
+	value = (float)(isNegative ? -result : result);
+	return p;
+}
+
+const char* ObjParser::ParseInt(const char* p, const char* end, int& value)
+{
+	if (p == NULL || p >= end)
+		return NULL;
+	bool isNegative = false;
+	if (*p == '-' || *p == '+')
+	{
+		isNegative = *p == '-';
+		p++;
+	}
+	if (p >= end || !IsDigit(*p))
+		return NULL;
+	int result = 0;
+	for (; p < end && IsDigit(*p); p++)
+		result = result * 10 + (*p - '0');
+	value = isNegative ? -result : result;
+	return p;
+}
+
+const char* ObjParser::SkipSpaces(const char* p, const char* end)
+{
+	if (p == NULL)
+		return NULL;
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+	return p;
+}
@@ -0,0 +1,30 @@
+#ifndef OBJ_PARSER
+#define OBJ_PARSER
+
+#include <string>
+#include <vector>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/Vertices.h>
+#include "Typedef.h"
+
+//		*****************************************************************
+//				Obj Parser
+//				Reads v / vn / f records straight out of a memory-mapped file,
+//				other records (vt, g, usemtl, ...) are skipped.
+//				Replaces pcl::OBJReader, which splits and lexical_casts every token.
+//		*****************************************************************
+class ObjParser
+{
+public:
+	//		normals and faces are optional, pass NULL to skip them
+	static void Parse(std::string path, pcl::PointCloud<PointT>& cloud, pcl::PointCloud<NormalT>* normals = NULL, std::vector<pcl::Vertices>* faces = NULL);
+	static void Parse(const char* begin, const char* end, pcl::PointCloud<PointT>& cloud, pcl::PointCloud<NormalT>* normals = NULL, std::vector<pcl::Vertices>* faces = NULL);
+
+private:
+	static const char* ParseFloat(const char* p, const char* end, float& value);
+	static const char* ParseInt(const char* p, const char* end, int& value);
+	static const char* SkipSpaces(const char* p, const char* end);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "file/ParallelFileLoader.h"
+
+#include <atomic>
+#include <thread>
+
+ParallelFileLoader::ParallelFileLoader(FileFactory* fileFactory, unsigned int numberOfThreads) : _fileFactory(fileFactory), _numberOfThreads(numberOfThreads)
+{
+	if (_numberOfThreads == 0)
+		_numberOfThreads = std::thread::hardware_concurrency();
+	if (_numberOfThreads == 0)
+		_numberOfThreads = 4;
+}
+
+std::vector<LoadedFile> ParallelFileLoader::Load(const std::vector<std::string>& paths, std::string filter)
+{
+	std::vector<LoadedFile> results(paths.size());
+	std::atomic<std::size_t> next(0);
+	//		Every worker takes the next unread path, so one large file does not hold up the rest
+	auto worker = [&]()
+	{
+		for (std::size_t index = next++; index < paths.size(); index = next++)
+		{
+			results[index].path = paths[index];
+			MyFile* file = _fileFactory->GetFileByFilter(paths[index], filter);
+			if (file == NULL)
+			{
+				results[index].error = std::string("Unknown filter ") + filter;
+				continue;
+			}
+			try
+			{
+				file->LoadFile();
+				results[index].cloud = file->GetPointCloud();
+			}
+			catch (std::string& message)
+			{
+				results[index].error = message;
+			}
+			catch (std::exception& exception)
+			{
+				results[index].error = exception.what();
+			}
+			delete file;
+		}
+	};
+	std::size_t numberOfThreads = std::min<std::size_t>(_numberOfThreads, paths.size());
+	std::vector<std::thread> threads;
+	for (std::size_t counter = 1; counter < numberOfThreads; counter++)
+		threads.push_back(std::thread(worker));
+	worker();
+	for (std::size_t counter = 0; counter < threads.size(); counter++)
+		threads[counter].join();
+	return results;
+}
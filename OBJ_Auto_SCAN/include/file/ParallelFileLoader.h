@@ -0,0 +1,32 @@
+#ifndef PARALLEL_FILE_LOADER
+#define PARALLEL_FILE_LOADER
+
+#include <string>
+#include <vector>
+#include "Typedef.h"
+#include "file/FileFactory.h"
+
+struct LoadedFile
+{
+	std::string path;
+	pcl::PointCloud<PointT>::Ptr cloud;
+	std::string error;					//	empty when the file was read
+};
+
+//		*****************************************************************
+//				Parallel File Loader
+//				Reads a whole file selection on a small pool of threads.
+//				Results come back in the order of the given paths.
+//		*****************************************************************
+class ParallelFileLoader
+{
+public:
+	ParallelFileLoader(FileFactory* fileFactory, unsigned int numberOfThreads = 0);
+	std::vector<LoadedFile> Load(const std::vector<std::string>& paths, std::string filter);
+
+private:
+	FileFactory* _fileFactory;
+	unsigned int _numberOfThreads;
+};
+
+#endif
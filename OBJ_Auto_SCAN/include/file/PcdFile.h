@@ -4,6 +4,7 @@
 #include <pcl/io/io.h>
 #include <pcl/io/pcd_io.h>
 #include "file/MyFile.h";
+#include "trace/Tracer.h"
 
 class PcdFile : MyFile
 {
@@ -15,6 +16,7 @@ public:
 
 	void LoadFile()
 	{
+		TRACE_SCOPE("PcdFile::LoadFile", "file");
 		pcl::PCDReader reader;
 		reader.read(_dir, *_cloud);
 		for (int counter = 0; counter < _cloud->size(); counter++)
@@ -28,11 +30,13 @@ public:
 
 	void SaveFile(pcl::PointCloud<PointT>::Ptr cloud)
 	{
+		TRACE_SCOPE("PcdFile::SaveFile", "file");
 		pcl::io::savePCDFile(_dir, *cloud, false);
 	}
 
 	void SaveFile(pcl::PolygonMeshPtr mesh)
 	{
+		TRACE_SCOPE("PcdFile::SaveFile", "file");
 		pcl::io::savePLYFile(_dir, *mesh);
 	}
 
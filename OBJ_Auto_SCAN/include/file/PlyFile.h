@@ -4,6 +4,7 @@
 #include <pcl/io/io.h>
 #include <pcl/io/ply_io.h>
 #include "file/MyFile.h";
+#include "trace/Tracer.h"
 
 class PlyFile : MyFile
 {
@@ -15,6 +16,7 @@ public:
 
 	void LoadFile()
 	{
+		TRACE_SCOPE("PlyFile::LoadFile", "file");
 		pcl::PLYReader* reader = new pcl::PLYReader();
 		reader->read(_dir, *_cloud);
 		for (int counter = 0; counter < _cloud->size(); counter++)
@@ -28,12 +30,14 @@ public:
 
 	void SaveFile(pcl::PointCloud<PointT>::Ptr cloud)
 	{
+		TRACE_SCOPE("PlyFile::SaveFile", "file");
 		pcl::PLYWriter writer;
 		writer.write(_dir, *cloud);
 	}
 
 	void SaveFile(pcl::PolygonMeshPtr mesh)
 	{
+		TRACE_SCOPE("PlyFile::SaveFile", "file");
 		pcl::io::savePLYFile(_dir, *mesh);
 	}
 
@@ -0,0 +1,219 @@
+#include "file/ScanLog.h"
+
+#include <cstring>
+#include <limits>
+#include <pcl/io/lzf.h>
+#include "trace/Tracer.h"
+
+static const int PLANE_BYTES_PER_POINT = 16;		//	x, y, z, rgba
+
+template <typename T>
+static void WriteValue(std::ofstream& file, const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& value)
+{
+	file.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return file.gcount() == sizeof(T);
+}
+
+//		*****************************************************************
+//				Scan Log Writer
+//		*****************************************************************
+
+ScanLogWriter::ScanLogWriter()
+{
+	std::memset(&_stats, 0, sizeof(_stats));
+}
+
+ScanLogWriter::~ScanLogWriter()
+{
+	Close();
+}
+
+void ScanLogWriter::Open(std::string path)
+{
+	Close();
+	_file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_file.is_open())
+		throw std::string("ScanLogWriter: Cannot create ") + path;
+	std::memset(&_stats, 0, sizeof(_stats));
+	_file.write(SCAN_LOG_MAGIC, 8);
+	WriteValue(_file, (unsigned int)SCAN_LOG_VERSION);
+	_stats.writtenBytes = 8 + sizeof(unsigned int);
+}
+
+void ScanLogWriter::Append(const pcl::PointCloud<PointT>& pointCloud, unsigned long long timestamp, float angle)
+{
+	TRACE_SCOPE("ScanLogWriter::Append", "file");
+	if (!_file.is_open())
+		throw std::string("ScanLogWriter: Log is not open");
+	std::size_t size = pointCloud.size();
+	if (size > std::numeric_limits<unsigned int>::max() / PLANE_BYTES_PER_POINT)
+		throw std::string("ScanLogWriter: Frame too large");
+	unsigned int rawBytes = (unsigned int)(size * PLANE_BYTES_PER_POINT);
+
+	//		Planes compress far better than interleaved points (NaN runs, smooth depth)
+	_planes.resize(rawBytes);
+	float* x = reinterpret_cast<float*>(_planes.data());
+	float* y = x + size;
+	float* z = y + size;
+	uint32_t* rgba = reinterpret_cast<uint32_t*>(z + size);
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		const PointT& point = pointCloud.points[counter];
+		x[counter] = point.x;
+		y[counter] = point.y;
+		z[counter] = point.z;
+		rgba[counter] = point.rgba;
+	}
+	_compressed.resize(rawBytes + rawBytes / 16 + 64);
+	unsigned int storedBytes = rawBytes == 0 ? 0 : pcl::lzfCompress(_planes.data(), rawBytes, _compressed.data(), (unsigned int)_compressed.size());
+	const char* stored = _compressed.data();
+	if (storedBytes == 0 || storedBytes >= rawBytes)
+	{
+		storedBytes = rawBytes;
+		stored = _planes.data();
+	}
+
+	WriteValue(_file, (unsigned int)SCAN_LOG_FRAME_MAGIC);
+	WriteValue(_file, (unsigned int)pointCloud.width);
+	WriteValue(_file, (unsigned int)pointCloud.height);
+	WriteValue(_file, (unsigned char)pointCloud.is_dense);
+	WriteValue(_file, timestamp);
+	WriteValue(_file, angle);
+	WriteValue(_file, rawBytes);
+	WriteValue(_file, storedBytes);
+	_file.write(stored, storedBytes);
+	if (!_file.good())
+		throw std::string("ScanLogWriter: Write failed (disk full?)");
+	_stats.frames++;
+	_stats.rawBytes += rawBytes;
+	_stats.writtenBytes += 3 * sizeof(unsigned int) + 1 + sizeof(timestamp) + sizeof(angle) + 2 * sizeof(unsigned int) + storedBytes;
+	TRACE_COUNT("ScanLog written bytes", "file", storedBytes);
+}
+
+void ScanLogWriter::Close()
+{
+	if (_file.is_open())
+		_file.close();
+	std::vector<char>().swap(_planes);
+	std::vector<char>().swap(_compressed);
+}
+
+bool ScanLogWriter::IsOpen()
+{
+	return _file.is_open();
+}
+
+ScanLogStats ScanLogWriter::GetStats()
+{
+	return _stats;
+}
+
+//		*****************************************************************
+//				Scan Log Reader
+//		*****************************************************************
+
+ScanLogReader::ScanLogReader()
+{
+}
+
+//		Walks the chunk headers once; a truncated last chunk is left out
+void ScanLogReader::Open(std::string path)
+{
+	Close();
+	_file.open(path.c_str(), std::ios::in | std::ios::binary);
+	if (!_file.is_open())
+		throw std::string("ScanLogReader: Cannot open ") + path;
+	char magic[8];
+	unsigned int version = 0;
+	_file.read(magic, 8);
+	if (_file.gcount() != 8 || std::memcmp(magic, SCAN_LOG_MAGIC, 8) != 0 || !ReadValue(_file, version))
+		throw std::string("ScanLogReader: Not a scan log ") + path;
+	if (version != SCAN_LOG_VERSION)
+		throw std::string("ScanLogReader: Unsupported scan log version");
+	_file.seekg(0, std::ios::end);
+	std::streamoff end = _file.tellg();
+	_file.seekg(8 + sizeof(unsigned int), std::ios::beg);
+	while (true)
+	{
+		unsigned int frameMagic = 0;
+		unsigned char isDense = 0;
+		Chunk chunk;
+		if (!ReadValue(_file, frameMagic) || frameMagic != SCAN_LOG_FRAME_MAGIC)
+			break;
+		if (!ReadValue(_file, chunk.width) || !ReadValue(_file, chunk.height) || !ReadValue(_file, isDense) || !ReadValue(_file, chunk.timestamp) ||
+			!ReadValue(_file, chunk.angle) || !ReadValue(_file, chunk.rawBytes) || !ReadValue(_file, chunk.storedBytes))
+			break;
+		chunk.isDense = isDense != 0;
+		chunk.offset = _file.tellg();
+		if ((unsigned long long)chunk.width * chunk.height * PLANE_BYTES_PER_POINT != chunk.rawBytes || chunk.storedBytes > chunk.rawBytes ||
+			chunk.offset + (std::streamoff)chunk.storedBytes > end)
+			break;
+		_chunks.push_back(chunk);
+		_file.seekg(chunk.storedBytes, std::ios::cur);
+	}
+	_file.clear();
+}
+
+void ScanLogReader::Close()
+{
+	if (_file.is_open())
+		_file.close();
+	_file.clear();
+	_chunks.clear();
+}
+
+int ScanLogReader::GetNumberOfFrames()
+{
+	return (int)_chunks.size();
+}
+
+ScanLogFrame ScanLogReader::ReadFrame(int index)
+{
+	TRACE_SCOPE("ScanLogReader::ReadFrame", "file");
+	if (index < 0 || index >= (int)_chunks.size())
+		throw std::string("ScanLogReader: Frame out of range");
+	const Chunk& chunk = _chunks[index];
+	_stored.resize(chunk.storedBytes);
+	_file.seekg(chunk.offset, std::ios::beg);
+	_file.read(_stored.data(), chunk.storedBytes);
+	if (_file.gcount() != (std::streamsize)chunk.storedBytes)
+		throw std::string("ScanLogReader: Read failed");
+	const char* planes = _stored.data();
+	if (chunk.storedBytes < chunk.rawBytes)
+	{
+		_planes.resize(chunk.rawBytes);
+		if (pcl::lzfDecompress(_stored.data(), chunk.storedBytes, _planes.data(), chunk.rawBytes) != chunk.rawBytes)
+			throw std::string("ScanLogReader: Corrupted frame");
+		planes = _planes.data();
+	}
+
+	ScanLogFrame frame;
+	frame.timestamp = chunk.timestamp;
+	frame.angle = chunk.angle;
+	frame.pointCloud.reset(new pcl::PointCloud<PointT>());
+	std::size_t size = (std::size_t)chunk.width * chunk.height;
+	frame.pointCloud->points.resize(size);
+	frame.pointCloud->width = chunk.width;
+	frame.pointCloud->height = chunk.height;
+	frame.pointCloud->is_dense = chunk.isDense;
+	frame.pointCloud->header.stamp = chunk.timestamp;
+	const float* x = reinterpret_cast<const float*>(planes);
+	const float* y = x + size;
+	const float* z = y + size;
+	const uint32_t* rgba = reinterpret_cast<const uint32_t*>(z + size);
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		PointT& point = frame.pointCloud->points[counter];
+		point.x = x[counter];
+		point.y = y[counter];
+		point.z = z[counter];
+		point.rgba = rgba[counter];
+	}
+	return frame;
+}
@@ -0,0 +1,86 @@
+#ifndef SCAN_LOG
+#define SCAN_LOG
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Typedef.h"
+
+#define SCAN_LOG_MAGIC "OASCNLOG"
+#define SCAN_LOG_VERSION 1
+#define SCAN_LOG_FRAME_MAGIC 0x4d415246			//	"FRAM"
+
+struct ScanLogFrame
+{
+	unsigned long long timestamp;			//	microseconds
+	float angle;							//	turntable (degree)
+	pcl::PointCloud<PointT>::Ptr pointCloud;
+};
+
+struct ScanLogStats
+{
+	unsigned long long frames;
+	unsigned long long rawBytes;			//	points as x / y / z / rgba
+	unsigned long long writtenBytes;		//	file size
+};
+
+//		*****************************************************************
+//				Scan Log
+//				Append only file of camera frames : a header, then one chunk
+//				per frame (size, timestamp, turntable angle, LZF compressed
+//				x[] y[] z[] rgba[] planes; stored raw when LZF does not pay).
+//				A log cut short by a crash is read up to its last whole frame.
+//		*****************************************************************
+class ScanLogWriter
+{
+public:
+	ScanLogWriter();
+	~ScanLogWriter();
+	void Open(std::string path);
+	void Append(const pcl::PointCloud<PointT>& pointCloud, unsigned long long timestamp, float angle);
+	void Close();
+	bool IsOpen();
+	ScanLogStats GetStats();
+
+private:
+	ScanLogWriter(const ScanLogWriter&);
+	ScanLogWriter& operator=(const ScanLogWriter&);
+
+	std::ofstream _file;
+	std::vector<char> _planes;				//	reused for every frame
+	std::vector<char> _compressed;
+	ScanLogStats _stats;
+};
+
+class ScanLogReader
+{
+public:
+	ScanLogReader();
+	void Open(std::string path);
+	void Close();
+	int GetNumberOfFrames();
+	ScanLogFrame ReadFrame(int index);
+
+private:
+	struct Chunk
+	{
+		std::streamoff offset;				//	payload
+		unsigned int width;
+		unsigned int height;
+		bool isDense;
+		unsigned long long timestamp;
+		float angle;
+		unsigned int rawBytes;
+		unsigned int storedBytes;
+	};
+
+	ScanLogReader(const ScanLogReader&);
+	ScanLogReader& operator=(const ScanLogReader&);
+
+	std::ifstream _file;
+	std::vector<Chunk> _chunks;
+	std::vector<char> _planes;
+	std::vector<char> _stored;
+};
+
+#endif
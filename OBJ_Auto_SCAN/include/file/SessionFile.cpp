@@ -0,0 +1,570 @@
+#include "file/SessionFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include "trace/Tracer.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+//		*****************************************************************
+//				Layout
+//				header (SESSION_ALIGNMENT bytes) : magic, version, records,
+//				table offset, table bytes
+//				sections, each aligned to SESSION_ALIGNMENT
+//				record table : type, flags, name, transform, then per type the
+//				shape of the buffer and the sections holding it
+//		*****************************************************************
+
+enum class SessionRecordType
+{
+	PointCloud = 1,
+	Keypoint = 2,
+	Mesh = 3,
+	Correspondences = 4
+};
+
+static const unsigned int SESSION_SELECTED = 1;
+static const unsigned int SESSION_HIDDEN = 2;			//	keypoints only reached through correspondences
+
+struct SessionSection
+{
+	unsigned long long offset;
+	unsigned long long bytes;
+};
+
+//		Shape of a point cloud / keypoint section
+struct SessionCloud
+{
+	unsigned int width;
+	unsigned int height;
+	bool isDense;
+	float origin[4];
+	float orientation[4];			//	w, x, y, z
+	SessionSection points;
+};
+
+struct SessionMesh
+{
+	unsigned int width;
+	unsigned int height;
+	unsigned int pointStep;
+	unsigned int rowStep;
+	unsigned char isBigendian;
+	unsigned char isDense;
+	std::vector<pcl::PCLPointField> fields;
+	SessionSection data;
+	SessionSection polygonSizes;	//	one uint32 per polygon
+	SessionSection indices;			//	uint32, all polygons in a row
+};
+
+struct SessionCorrespondence
+{
+	int indexQuery;
+	int indexMatch;
+	float distance;
+};
+
+typedef boost::shared_ptr<boost::iostreams::mapped_file_source> SessionMapping;
+
+//		*****************************************************************
+//				Writer
+//		*****************************************************************
+
+class SessionWriter
+{
+public:
+	SessionWriter(std::string path) : _position(0)
+	{
+		_file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!_file.is_open())
+			throw std::string("SessionFile: Cannot create ") + path;
+		Pad(SESSION_ALIGNMENT);
+	}
+
+	SessionSection WriteSection(const void* data, unsigned long long bytes)
+	{
+		Pad(Align(_position));
+		SessionSection section = { _position, bytes };
+		if (bytes > 0)
+			_file.write(static_cast<const char*>(data), bytes);
+		_position += bytes;
+		return section;
+	}
+
+	template <typename T>
+	void Put(const T& value)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		_table.insert(_table.end(), bytes, bytes + sizeof(T));
+	}
+
+	void PutString(const std::string& text)
+	{
+		Put((unsigned int)text.size());
+		_table.insert(_table.end(), text.begin(), text.end());
+	}
+
+	void PutSection(const SessionSection& section)
+	{
+		Put(section.offset);
+		Put(section.bytes);
+	}
+
+	void Finish(unsigned int numberOfRecords)
+	{
+		SessionSection table = WriteSection(_table.data(), _table.size());
+		_file.seekp(0, std::ios::beg);
+		_file.write(SESSION_MAGIC, 8);
+		unsigned int version = SESSION_VERSION;
+		_file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		_file.write(reinterpret_cast<const char*>(&numberOfRecords), sizeof(numberOfRecords));
+		_file.write(reinterpret_cast<const char*>(&table.offset), sizeof(table.offset));
+		_file.write(reinterpret_cast<const char*>(&table.bytes), sizeof(table.bytes));
+		_file.close();
+		if (_file.fail())
+			throw std::string("SessionFile: Write failed (disk full?)");
+	}
+
+private:
+	static unsigned long long Align(unsigned long long position)
+	{
+		return (position + SESSION_ALIGNMENT - 1) / SESSION_ALIGNMENT * SESSION_ALIGNMENT;
+	}
+
+	void Pad(unsigned long long position)
+	{
+		static const char zeros[SESSION_ALIGNMENT] = { 0 };
+		_file.write(zeros, position - _position);
+		_position = position;
+	}
+
+	std::ofstream _file;
+	unsigned long long _position;
+	std::vector<char> _table;
+};
+
+template <typename PointType>
+static void PutCloud(SessionWriter& writer, const pcl::PointCloud<PointType>& cloud)
+{
+	writer.Put((unsigned int)sizeof(PointType));
+	writer.Put((unsigned int)cloud.width);
+	writer.Put((unsigned int)cloud.height);
+	writer.Put((unsigned char)cloud.is_dense);
+	for (int counter = 0; counter < 4; counter++)
+		writer.Put(cloud.sensor_origin_[counter]);
+	writer.Put(cloud.sensor_orientation_.w());
+	writer.Put(cloud.sensor_orientation_.x());
+	writer.Put(cloud.sensor_orientation_.y());
+	writer.Put(cloud.sensor_orientation_.z());
+	writer.PutSection(writer.WriteSection(cloud.points.data(), cloud.points.size() * sizeof(PointType)));
+}
+
+static void PutMesh(SessionWriter& writer, const pcl::PolygonMesh& mesh)
+{
+	writer.Put((unsigned int)mesh.cloud.width);
+	writer.Put((unsigned int)mesh.cloud.height);
+	writer.Put((unsigned int)mesh.cloud.point_step);
+	writer.Put((unsigned int)mesh.cloud.row_step);
+	writer.Put((unsigned char)mesh.cloud.is_bigendian);
+	writer.Put((unsigned char)mesh.cloud.is_dense);
+	writer.Put((unsigned int)mesh.cloud.fields.size());
+	for (std::size_t counter = 0; counter < mesh.cloud.fields.size(); counter++)
+	{
+		writer.PutString(mesh.cloud.fields[counter].name);
+		writer.Put((unsigned int)mesh.cloud.fields[counter].offset);
+		writer.Put((unsigned char)mesh.cloud.fields[counter].datatype);
+		writer.Put((unsigned int)mesh.cloud.fields[counter].count);
+	}
+	writer.PutSection(writer.WriteSection(mesh.cloud.data.data(), mesh.cloud.data.size()));
+	std::vector<unsigned int> sizes(mesh.polygons.size());
+	std::vector<unsigned int> indices;
+	for (std::size_t counter = 0; counter < mesh.polygons.size(); counter++)
+	{
+		sizes[counter] = (unsigned int)mesh.polygons[counter].vertices.size();
+		indices.insert(indices.end(), mesh.polygons[counter].vertices.begin(), mesh.polygons[counter].vertices.end());
+	}
+	writer.PutSection(writer.WriteSection(sizes.data(), sizes.size() * sizeof(unsigned int)));
+	writer.PutSection(writer.WriteSection(indices.data(), indices.size() * sizeof(unsigned int)));
+}
+
+static void PutCorrespondences(SessionWriter& writer, const pcl::Correspondences& correspondences, unsigned int source, unsigned int target)
+{
+	std::vector<SessionCorrespondence> records(correspondences.size());
+	for (std::size_t counter = 0; counter < correspondences.size(); counter++)
+	{
+		records[counter].indexQuery = correspondences[counter].index_query;
+		records[counter].indexMatch = correspondences[counter].index_match;
+		records[counter].distance = correspondences[counter].distance;
+	}
+	writer.Put(source);
+	writer.Put(target);
+	writer.PutSection(writer.WriteSection(records.data(), records.size() * sizeof(SessionCorrespondence)));
+}
+
+//		One step replace, the old file stays as it was if the move fails. Windows refuses it
+//		while the old file is still mapped by a session element.
+static bool MoveOver(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+//		Written next to the old file first, a failed save leaves the old session intact
+void SessionFile::Save(std::string path, PointCloudElements& elements)
+{
+	TRACE_SCOPE("SessionFile::Save", "file");
+	struct Record
+	{
+		PointCloudElement* element;
+		unsigned int flags;
+	};
+	std::vector<Record> records;
+	std::map<MyKeyPoint*, unsigned int> keypointRecords;
+	for (int counter = 0; counter < elements.GetNumberOfElements(); counter++)
+	{
+		PointCloudElement* element = elements.GetPointCloudElementById(counter);
+		Record record = { element, element->GetIsSelected() ? SESSION_SELECTED : 0 };
+		if (dynamic_cast<MyKeyPoint*>(element) != NULL)
+			keypointRecords[(MyKeyPoint*)element] = (unsigned int)records.size();
+		records.push_back(record);
+	}
+	for (int counter = 0; counter < elements.GetNumberOfElements(); counter++)
+	{
+		MyCorrespondences* correspondences = dynamic_cast<MyCorrespondences*>(elements.GetPointCloudElementById(counter));
+		if (correspondences == NULL)
+			continue;
+		MyKeyPoint* keypoints[] = { correspondences->GetSource(), correspondences->GetTarget() };
+		for (int side = 0; side < 2; side++)
+		{
+			if (keypointRecords.count(keypoints[side]) != 0)
+				continue;
+			keypointRecords[keypoints[side]] = (unsigned int)records.size();
+			Record record = { keypoints[side], SESSION_HIDDEN };
+			records.push_back(record);
+		}
+	}
+
+	std::string temporaryPath = path + ".tmp";
+	{
+		SessionWriter writer(temporaryPath);
+		for (std::size_t counter = 0; counter < records.size(); counter++)
+		{
+			PointCloudElement* element = records[counter].element;
+			MyPointCloud* cloud = dynamic_cast<MyPointCloud*>(element);
+			MyKeyPoint* keypoint = dynamic_cast<MyKeyPoint*>(element);
+			MySurface* surface = dynamic_cast<MySurface*>(element);
+			MyCorrespondences* correspondences = dynamic_cast<MyCorrespondences*>(element);
+			SessionRecordType type = cloud != NULL ? SessionRecordType::PointCloud : keypoint != NULL ? SessionRecordType::Keypoint :
+				surface != NULL ? SessionRecordType::Mesh : SessionRecordType::Correspondences;
+			if (cloud == NULL && keypoint == NULL && surface == NULL && correspondences == NULL)
+				throw std::string("SessionFile: Unknown element ") + element->GetName();
+			writer.Put((unsigned int)type);
+			writer.Put(records[counter].flags);
+			writer.PutString(element->GetName());
+			Eigen::Matrix4f transform = element->GetTransform();
+			for (int index = 0; index < 16; index++)
+				writer.Put(transform.data()[index]);
+			if (cloud != NULL)
+				PutCloud(writer, *cloud->GetPointCloud());
+			else if (keypoint != NULL)
+				PutCloud(writer, *keypoint->GetKeyPoint());
+			else if (surface != NULL)
+				PutMesh(writer, *surface->GetMesh());
+			else
+				PutCorrespondences(writer, *correspondences->GetSharedCorrespondences().Read(),
+					keypointRecords[correspondences->GetSource()], keypointRecords[correspondences->GetTarget()]);
+		}
+		writer.Finish((unsigned int)records.size());
+	}
+	if (!MoveOver(temporaryPath, path))
+		throw std::string("SessionFile: Cannot replace ") + path + std::string(", saved as ") + temporaryPath;
+}
+
+//		*****************************************************************
+//				Reader
+//		*****************************************************************
+
+class SessionTable
+{
+public:
+	SessionTable(const char* begin, const char* end, unsigned long long fileSize) : _cursor(begin), _end(end), _fileSize(fileSize)
+	{
+	}
+
+	template <typename T>
+	T Get()
+	{
+		if (_end - _cursor < (std::ptrdiff_t)sizeof(T))
+			throw std::string("SessionFile: Truncated record table");
+		T value;
+		std::memcpy(&value, _cursor, sizeof(T));
+		_cursor += sizeof(T);
+		return value;
+	}
+
+	std::string GetString()
+	{
+		unsigned int length = Get<unsigned int>();
+		if ((unsigned long long)(_end - _cursor) < length)
+			throw std::string("SessionFile: Truncated record table");
+		std::string text(_cursor, length);
+		_cursor += length;
+		return text;
+	}
+
+	//		elementSize > 0 : the section must hold a whole number of elements
+	SessionSection GetSection(unsigned long long elementSize)
+	{
+		SessionSection section;
+		section.offset = Get<unsigned long long>();
+		section.bytes = Get<unsigned long long>();
+		if (section.offset % SESSION_ALIGNMENT != 0 || section.offset < SESSION_ALIGNMENT || section.offset > _fileSize ||
+			section.bytes > _fileSize - section.offset || (elementSize > 0 && section.bytes % elementSize != 0))
+			throw std::string("SessionFile: Corrupted section");
+		return section;
+	}
+
+	SessionCloud GetCloud(unsigned int pointSize)
+	{
+		if (Get<unsigned int>() != pointSize)
+			throw std::string("SessionFile: Point layout differs from this build");
+		SessionCloud cloud;
+		cloud.width = Get<unsigned int>();
+		cloud.height = Get<unsigned int>();
+		cloud.isDense = Get<unsigned char>() != 0;
+		for (int counter = 0; counter < 4; counter++)
+			cloud.origin[counter] = Get<float>();
+		for (int counter = 0; counter < 4; counter++)
+			cloud.orientation[counter] = Get<float>();
+		cloud.points = GetSection(pointSize);
+		return cloud;
+	}
+
+	SessionMesh GetMesh()
+	{
+		SessionMesh mesh;
+		mesh.width = Get<unsigned int>();
+		mesh.height = Get<unsigned int>();
+		mesh.pointStep = Get<unsigned int>();
+		mesh.rowStep = Get<unsigned int>();
+		mesh.isBigendian = Get<unsigned char>();
+		mesh.isDense = Get<unsigned char>();
+		unsigned int numberOfFields = Get<unsigned int>();
+		for (unsigned int counter = 0; counter < numberOfFields; counter++)
+		{
+			pcl::PCLPointField field;
+			field.name = GetString();
+			field.offset = Get<unsigned int>();
+			field.datatype = Get<unsigned char>();
+			field.count = Get<unsigned int>();
+			mesh.fields.push_back(field);
+		}
+		mesh.data = GetSection(0);
+		mesh.polygonSizes = GetSection(sizeof(unsigned int));
+		mesh.indices = GetSection(sizeof(unsigned int));
+		return mesh;
+	}
+
+private:
+	const char* _cursor;
+	const char* _end;
+	unsigned long long _fileSize;
+};
+
+template <typename PointType>
+static SharedCloud<pcl::PointCloud<PointType> > DeferCloud(SessionMapping mapping, SessionCloud info)
+{
+	return SharedCloud<pcl::PointCloud<PointType> >::Defer([mapping, info]()
+	{
+		TRACE_SCOPE("SessionFile::LoadCloud", "file");
+		boost::shared_ptr<pcl::PointCloud<PointType> > cloud(new pcl::PointCloud<PointType>());
+		std::size_t size = (std::size_t)(info.points.bytes / sizeof(PointType));
+		cloud->points.resize(size);
+		if (size > 0)
+			std::memcpy(&cloud->points[0], mapping->data() + info.points.offset, info.points.bytes);
+		cloud->width = info.width;
+		cloud->height = info.height;
+		if ((std::size_t)cloud->width * cloud->height != size)
+		{
+			cloud->width = (uint32_t)size;
+			cloud->height = 1;
+		}
+		cloud->is_dense = info.isDense;
+		cloud->sensor_origin_ = Eigen::Vector4f(info.origin[0], info.origin[1], info.origin[2], info.origin[3]);
+		cloud->sensor_orientation_ = Eigen::Quaternionf(info.orientation[0], info.orientation[1], info.orientation[2], info.orientation[3]);
+		return cloud;
+	});
+}
+
+static SharedMesh DeferMesh(SessionMapping mapping, SessionMesh info)
+{
+	return SharedMesh::Defer([mapping, info]()
+	{
+		TRACE_SCOPE("SessionFile::LoadMesh", "file");
+		const char* begin = mapping->data();
+		pcl::PolygonMeshPtr mesh(new pcl::PolygonMesh());
+		mesh->cloud.width = info.width;
+		mesh->cloud.height = info.height;
+		mesh->cloud.point_step = info.pointStep;
+		mesh->cloud.row_step = info.rowStep;
+		mesh->cloud.is_bigendian = info.isBigendian;
+		mesh->cloud.is_dense = info.isDense;
+		mesh->cloud.fields = info.fields;
+		mesh->cloud.data.assign(begin + info.data.offset, begin + info.data.offset + info.data.bytes);
+		const unsigned int* sizes = reinterpret_cast<const unsigned int*>(begin + info.polygonSizes.offset);
+		const unsigned int* indices = reinterpret_cast<const unsigned int*>(begin + info.indices.offset);
+		std::size_t numberOfIndices = (std::size_t)(info.indices.bytes / sizeof(unsigned int));
+		std::size_t used = 0;
+		mesh->polygons.resize((std::size_t)(info.polygonSizes.bytes / sizeof(unsigned int)));
+		for (std::size_t counter = 0; counter < mesh->polygons.size(); counter++)
+		{
+			std::size_t size = std::min<std::size_t>(sizes[counter], numberOfIndices - used);
+			mesh->polygons[counter].vertices.assign(indices + used, indices + used + size);
+			used += size;
+		}
+		return mesh;
+	});
+}
+
+static SharedCorrespondences DeferCorrespondences(SessionMapping mapping, SessionSection section)
+{
+	return SharedCorrespondences::Defer([mapping, section]()
+	{
+		TRACE_SCOPE("SessionFile::LoadCorrespondences", "file");
+		const SessionCorrespondence* records = reinterpret_cast<const SessionCorrespondence*>(mapping->data() + section.offset);
+		pcl::CorrespondencesPtr correspondences(new pcl::Correspondences((std::size_t)(section.bytes / sizeof(SessionCorrespondence))));
+		for (std::size_t counter = 0; counter < correspondences->size(); counter++)
+			(*correspondences)[counter] = pcl::Correspondence(records[counter].indexQuery, records[counter].indexMatch, records[counter].distance);
+		return correspondences;
+	});
+}
+
+int SessionFile::Load(std::string path, PointCloudElements& elements)
+{
+	TRACE_SCOPE("SessionFile::Load", "file");
+	SessionMapping mapping(new boost::iostreams::mapped_file_source());
+	try
+	{
+		mapping->open(path);
+	}
+	catch (std::exception&)
+	{
+		throw std::string("SessionFile: Cannot map ") + path;
+	}
+	const char* begin = mapping->data();
+	unsigned long long fileSize = mapping->size();
+	unsigned int version = 0;
+	unsigned int numberOfRecords = 0;
+	SessionSection table = { 0, 0 };
+	if (fileSize < SESSION_ALIGNMENT || std::memcmp(begin, SESSION_MAGIC, 8) != 0)
+		throw std::string("SessionFile: Not a session ") + path;
+	std::memcpy(&version, begin + 8, sizeof(version));
+	std::memcpy(&numberOfRecords, begin + 12, sizeof(numberOfRecords));
+	std::memcpy(&table.offset, begin + 16, sizeof(table.offset));
+	std::memcpy(&table.bytes, begin + 24, sizeof(table.bytes));
+	if (version != SESSION_VERSION)
+		throw std::string("SessionFile: Unsupported session version");
+	if (table.offset > fileSize || table.bytes > fileSize - table.offset)
+		throw std::string("SessionFile: Corrupted record table");
+
+	struct Record
+	{
+		PointCloudElement* element;
+		unsigned int flags;
+		Eigen::Matrix4f transform;
+		unsigned int source;			//	correspondences : keypoint records
+		unsigned int target;
+		SessionSection correspondences;
+		std::string name;
+	};
+	std::vector<Record, Eigen::aligned_allocator<Record> > records(numberOfRecords);
+	SessionTable reader(begin + table.offset, begin + table.offset + table.bytes, fileSize);
+	try
+	{
+		for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+		{
+			Record& record = records[counter];
+			record.element = NULL;
+			SessionRecordType type = (SessionRecordType)reader.Get<unsigned int>();
+			record.flags = reader.Get<unsigned int>();
+			record.name = reader.GetString();
+			for (int index = 0; index < 16; index++)
+				record.transform.data()[index] = reader.Get<float>();
+			if (type == SessionRecordType::PointCloud)
+				record.element = new MyPointCloud(DeferCloud<PointT>(mapping, reader.GetCloud(sizeof(PointT))), record.name);
+			else if (type == SessionRecordType::Keypoint)
+				record.element = new MyKeyPoint(DeferCloud<KeypointT>(mapping, reader.GetCloud(sizeof(KeypointT))), record.name);
+			else if (type == SessionRecordType::Mesh)
+				record.element = new MySurface(DeferMesh(mapping, reader.GetMesh()), record.name);
+			else if (type == SessionRecordType::Correspondences)
+			{
+				record.source = reader.Get<unsigned int>();
+				record.target = reader.Get<unsigned int>();
+				record.correspondences = reader.GetSection(sizeof(SessionCorrespondence));
+			}
+			else
+				throw std::string("SessionFile: Unknown record type");
+		}
+		//		Keypoint records may follow the correspondences using them
+		for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+		{
+			Record& record = records[counter];
+			if (record.element != NULL)
+				continue;
+			MyKeyPoint* source = record.source < numberOfRecords ? dynamic_cast<MyKeyPoint*>(records[record.source].element) : NULL;
+			MyKeyPoint* target = record.target < numberOfRecords ? dynamic_cast<MyKeyPoint*>(records[record.target].element) : NULL;
+			if (source == NULL || target == NULL)
+				throw std::string("SessionFile: Correspondences without keypoints");
+			record.element = new MyCorrespondences(source, target, DeferCorrespondences(mapping, record.correspondences), record.name);
+		}
+	}
+	catch (std::string&)
+	{
+		for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+			delete records[counter].element;
+		throw;
+	}
+
+	//		Hidden keypoints are not in the element list, the correspondences using them own them
+	std::vector<boost::shared_ptr<PointCloudElement> > owners(numberOfRecords);
+	for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+	{
+		if ((records[counter].flags & SESSION_HIDDEN) != 0)
+			owners[counter].reset(records[counter].element);
+	}
+	for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+	{
+		MyCorrespondences* correspondences = dynamic_cast<MyCorrespondences*>(records[counter].element);
+		if (correspondences == NULL)
+			continue;
+		if (owners[records[counter].source] != NULL)
+			correspondences->AdoptKeyPoint(owners[records[counter].source]);
+		if (owners[records[counter].target] != NULL)
+			correspondences->AdoptKeyPoint(owners[records[counter].target]);
+	}
+
+	int added = 0;
+	for (unsigned int counter = 0; counter < numberOfRecords; counter++)
+	{
+		Record& record = records[counter];
+		record.element->SetIsSelected((record.flags & SESSION_SELECTED) != 0);
+		record.element->SetTransform(record.transform);
+		if ((record.flags & SESSION_HIDDEN) != 0)
+			continue;
+		elements.AddPointCloudElement(record.element);
+		added++;
+	}
+	return added;
+}
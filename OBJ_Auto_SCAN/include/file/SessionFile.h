@@ -0,0 +1,28 @@
+#ifndef SESSION_FILE
+#define SESSION_FILE
+
+#include <string>
+#include "pointCloud/PointCloudElements.h"
+
+#define SESSION_MAGIC "OASCSESS"
+#define SESSION_VERSION 1
+#define SESSION_ALIGNMENT 64
+
+//		*****************************************************************
+//				Session File
+//				Every element of the table in one binary file : point clouds,
+//				meshes, keypoints, correspondences with their keypoints,
+//				transforms and selection. Buffers are raw sections aligned to
+//				SESSION_ALIGNMENT bytes, described by a record table at the end.
+//				Load maps the file and only reads the table; an element copies
+//				its section out of the mapping the first time it is used.
+//		*****************************************************************
+class SessionFile
+{
+public:
+	static void Save(std::string path, PointCloudElements& elements);
+	//		Appends the elements of the session, returns how many were added
+	static int Load(std::string path, PointCloudElements& elements);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef CAPTURE_GOVERNOR
+#define CAPTURE_GOVERNOR
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+enum class CaptureMode
+{
+	Unlimited,				//	pass every frame
+	TargetFps,				//	pass frames on a fixed schedule, e.g. 10 fps
+	KeepEveryNth,			//	pass frame 0, N, 2N, ...
+	TimePitch				//	pass a frame once at least pitch seconds since the last one
+};
+
+//		*****************************************************************
+//				Capture Governor
+//				Decides per frame whether it is passed on. Admit() only reads the
+//				clock and updates atomics, it never sleeps on the driver thread.
+//		*****************************************************************
+class CaptureGovernor
+{
+public:
+	CaptureGovernor()
+	{
+		_mode.store((int)CaptureMode::Unlimited);
+		_periodNs.store(0);
+		_nth.store(1);
+		_nextNs.store(0);
+		_frameCounter.store(0);
+		_admitted.store(0);
+		_rejected.store(0);
+	}
+
+	void SetUnlimited()
+	{
+		Reset(CaptureMode::Unlimited);
+	}
+
+	void SetTargetFps(double fps)
+	{
+		if (fps <= 0)
+			throw std::string("CaptureGovernor: fps must be positive");
+		_periodNs.store((long long)(1e9 / fps));
+		Reset(CaptureMode::TargetFps);
+	}
+
+	void SetKeepEveryNth(unsigned int nth)
+	{
+		if (nth == 0)
+			throw std::string("CaptureGovernor: N must be positive");
+		_nth.store(nth);
+		Reset(CaptureMode::KeepEveryNth);
+	}
+
+	void SetTimePitch(double seconds)
+	{
+		if (seconds < 0)
+			throw std::string("CaptureGovernor: pitch must not be negative");
+		_periodNs.store((long long)(seconds * 1e9));
+		Reset(CaptureMode::TimePitch);
+	}
+
+	CaptureMode GetMode()
+	{
+		return (CaptureMode)_mode.load();
+	}
+
+	//		Call once per arrived frame, true if the frame should be kept
+	bool Admit()
+	{
+		bool isAdmitted = true;
+		switch ((CaptureMode)_mode.load())
+		{
+		case CaptureMode::KeepEveryNth:
+			isAdmitted = _frameCounter.fetch_add(1) % _nth.load() == 0;
+			break;
+		case CaptureMode::TargetFps:
+		case CaptureMode::TimePitch:
+			isAdmitted = AdmitByClock((CaptureMode)_mode.load() == CaptureMode::TargetFps);
+			break;
+		default:
+			break;
+		}
+		if (isAdmitted)
+			_admitted++;
+		else
+			_rejected++;
+		return isAdmitted;
+	}
+
+	unsigned long long GetAdmitted()
+	{
+		return _admitted.load();
+	}
+
+	unsigned long long GetRejected()
+	{
+		return _rejected.load();
+	}
+
+private:
+	void Reset(CaptureMode mode)
+	{
+		_nextNs.store(0);
+		_frameCounter.store(0);
+		_mode.store((int)mode);
+	}
+
+	//		TargetFps advances the deadline by one period so the average rate holds,
+	//		TimePitch restarts it from now (the old FRAME_PITCH behaviour)
+	bool AdmitByClock(bool isScheduled)
+	{
+		long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		long long period = _periodNs.load();
+		long long next = _nextNs.load();
+		if (now < next)
+			return false;
+		long long following = now + period;
+		if (isScheduled && next != 0 && now - next < period)
+			following = next + period;
+		//		Only one concurrent caller wins the slot
+		return _nextNs.compare_exchange_strong(next, following);
+	}
+
+	std::atomic<int> _mode;
+	std::atomic<long long> _periodNs;
+	std::atomic<unsigned int> _nth;
+	std::atomic<long long> _nextNs;
+	std::atomic<unsigned long long> _frameCounter;
+	std::atomic<unsigned long long> _admitted;
+	std::atomic<unsigned long long> _rejected;
+};
+
+#endif
@@ -0,0 +1,353 @@
+#include "grabber/CaptureSession.h"
+#include "grabber/FrameClock.h"
+#include "trace/Tracer.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+static unsigned long long Spread(const std::vector<unsigned long long>& stamps)
+{
+	return *std::max_element(stamps.begin(), stamps.end()) - *std::min_element(stamps.begin(), stamps.end());
+}
+
+void CaptureSession::DeviceObserver::Update(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	int deviceIndex = index.load();
+	if (deviceIndex >= 0)
+		session->Push(deviceIndex, pointCloud);
+}
+
+CaptureSession::CaptureSession()
+{
+	_tolerance = CAPTURE_SESSION_DEFAULT_TOLERANCE;
+	_isRunning = false;
+	_hasLatest = false;
+	_stats.sets = 0;
+	_stats.unmatchedFrames = 0;
+	_stats.maxSkew = 0;
+}
+
+//		The observers stay registered on their subjects, detached they ignore every frame
+CaptureSession::~CaptureSession()
+{
+	Stop();
+	for (std::size_t counter = 0; counter < _observers.size(); counter++)
+		_observers[counter]->index.store(-1);
+}
+
+void CaptureSession::AddDevice(std::string name, IGrabber* grabber, ISubject* subject)
+{
+	if (grabber == NULL || subject == NULL)
+		throw std::string("CaptureSession: No grabber");
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_isRunning)
+		throw std::string("CaptureSession: Cannot add a device while running");
+	DeviceObserver* observer = NULL;
+	for (std::size_t counter = 0; counter < _observers.size(); counter++)
+	{
+		if (_observers[counter]->subject == subject)
+			observer = _observers[counter];
+	}
+	if (observer == NULL)
+	{
+		observer = new DeviceObserver(this, subject);
+		_observers.push_back(observer);
+		subject->RegisterObserver(observer);
+	}
+	if (observer->index.load() >= 0)
+		throw std::string("CaptureSession: Device is already added");
+	Device device;
+	device.name = name;
+	device.grabber = grabber;
+	device.observer = observer;
+	_devices.push_back(device);
+	observer->index.store((int)_devices.size() - 1);
+}
+
+void CaptureSession::RemoveAllDevices()
+{
+	Stop();
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		_devices[counter].observer->index.store(-1);
+	_devices.clear();
+	_hasLatest = false;
+	_latest.frames.clear();
+}
+
+int CaptureSession::GetNumberOfDevices()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return (int)_devices.size();
+}
+
+std::string CaptureSession::GetDeviceName(int index)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (index < 0 || index >= (int)_devices.size())
+		throw std::string("CaptureSession: Device index out of range");
+	return _devices[index].name;
+}
+
+void CaptureSession::SetTolerance(unsigned long long tolerance)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_tolerance = tolerance;
+}
+
+void CaptureSession::SetFrameSetCallback(std::function<void(const FrameSet&)> callback)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_frameSetCallback = callback;
+}
+
+//		Opening a device can take seconds, every StartCamera runs on its own thread.
+//		If one fails the others are stopped again and the errors are thrown together.
+void CaptureSession::Start()
+{
+	std::vector<IGrabber*> grabbers;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_isRunning)
+			return;
+		if (_devices.empty())
+			throw std::string("CaptureSession: No device");
+		for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		{
+			_devices[counter].frames.clear();
+			grabbers.push_back(_devices[counter].grabber);
+		}
+		_hasLatest = false;
+		_latest.frames.clear();
+		_stats.sets = 0;
+		_stats.unmatchedFrames = 0;
+		_stats.maxSkew = 0;
+		_isRunning = true;
+	}
+
+	TRACE_SCOPE("CaptureSession::Start", "grabber");
+	std::vector<std::string> errors(grabbers.size());
+	std::vector<std::thread> threads;
+	for (std::size_t counter = 0; counter < grabbers.size(); counter++)
+	{
+		threads.push_back(std::thread([&grabbers, &errors, counter]()
+		{
+			try
+			{
+				grabbers[counter]->StartCamera();
+			}
+			catch (std::string& error)
+			{
+				errors[counter] = error;
+			}
+			catch (std::exception& error)
+			{
+				errors[counter] = error.what();
+			}
+			catch (...)
+			{
+				errors[counter] = "Unknown error";
+			}
+		}));
+	}
+	for (std::size_t counter = 0; counter < threads.size(); counter++)
+		threads[counter].join();
+
+	std::string error;
+	for (std::size_t counter = 0; counter < errors.size(); counter++)
+	{
+		if (!errors[counter].empty())
+			error += _devices[counter].name + ": " + errors[counter] + "\n";
+	}
+	if (!error.empty())
+	{
+		Stop();
+		throw std::string("CaptureSession: Cannot start\n") + error;
+	}
+}
+
+void CaptureSession::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (!_isRunning)
+			return;
+		_isRunning = false;
+	}
+	StopDevices();
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		_devices[counter].frames.clear();
+}
+
+//		Devices are only added while stopped, no lock needed to walk them
+void CaptureSession::StopDevices()
+{
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+	{
+		try
+		{
+			_devices[counter].grabber->StopCamera();
+		}
+		//		Stop runs from closeEvent and from a failed Start, a device that cannot stop must not abort either
+		catch (std::string&)
+		{
+		}
+		catch (std::exception&)
+		{
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+bool CaptureSession::IsRunning()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _isRunning;
+}
+
+bool CaptureSession::TakeLatestFrameSet(FrameSet& frameSet)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_hasLatest)
+		return false;
+	frameSet = _latest;
+	_latest.frames.clear();
+	_hasLatest = false;
+	return true;
+}
+
+CaptureSessionStats CaptureSession::GetStats()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+void CaptureSession::Push(int index, pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	std::vector<FrameSet> frameSets;
+	std::function<void(const FrameSet&)> callback;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (!_isRunning || index >= (int)_devices.size())
+			return;
+		Frame frame;
+		frame.stamp = pointCloud->header.stamp != 0 ? pointCloud->header.stamp : FrameClock::Now();
+		frame.pointCloud = pointCloud;
+		std::deque<Frame>& frames = _devices[index].frames;
+		frames.push_back(frame);
+		//		A device without partners must not hold the grabber's pool buffers
+		if (frames.size() > CAPTURE_SESSION_QUEUE_SIZE)
+		{
+			frames.pop_front();
+			_stats.unmatchedFrames++;
+			TRACE_COUNT("CaptureSession unmatched frames", "grabber", 1);
+		}
+		FrameSet frameSet;
+		while (Match(frameSet))
+		{
+			_latest = frameSet;
+			_hasLatest = true;
+			if (_frameSetCallback)
+				frameSets.push_back(frameSet);
+		}
+		callback = _frameSetCallback;
+	}
+	for (std::size_t counter = 0; counter < frameSets.size(); counter++)
+		callback(frameSets[counter]);
+}
+
+//		The pivot is the latest of the oldest queued frames : every set to come holds a frame
+//		of the pivot's device, which is not older than the pivot. Frames older than the pivot
+//		by more than the tolerance can never be paired and are dropped, of the rest each device
+//		gives its latest frame not newer than the pivot, or the next one if that is closer. A drop
+//		can move a device past the pivot, then the pivot is taken again. Called with the lock held.
+bool CaptureSession::Match(FrameSet& frameSet)
+{
+	if (_devices.empty())
+		return false;
+	unsigned long long pivot = 0;
+	while (true)
+	{
+		for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		{
+			if (_devices[counter].frames.empty())
+				return false;
+			pivot = std::max(pivot, _devices[counter].frames.front().stamp);
+		}
+		unsigned long long unmatched = 0;
+		bool isPivotMoved = false;
+		for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		{
+			std::deque<Frame>& frames = _devices[counter].frames;
+			while (!frames.empty() && frames.front().stamp + _tolerance < pivot)
+			{
+				frames.pop_front();
+				unmatched++;
+			}
+			while (frames.size() > 1 && frames[1].stamp <= pivot)
+			{
+				frames.pop_front();
+				unmatched++;
+			}
+			if (!frames.empty() && frames.front().stamp > pivot)
+				isPivotMoved = true;
+		}
+		if (unmatched > 0)
+		{
+			_stats.unmatchedFrames += unmatched;
+			TRACE_COUNT("CaptureSession unmatched frames", "grabber", unmatched);
+		}
+		if (!isPivotMoved)
+			break;
+	}
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+	{
+		if (_devices[counter].frames.empty())
+			return false;
+	}
+
+	//		The frame just after the pivot is taken instead when it is queued, closer to the pivot
+	//		and the set stays within the tolerance
+	std::vector<unsigned long long> stamps;
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+		stamps.push_back(_devices[counter].frames.front().stamp);
+	std::vector<std::size_t> chosen(_devices.size(), 0);
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+	{
+		std::deque<Frame>& frames = _devices[counter].frames;
+		if (frames.size() < 2 || frames[1].stamp - pivot >= pivot - frames[0].stamp)
+			continue;
+		unsigned long long before = stamps[counter];
+		stamps[counter] = frames[1].stamp;
+		if (Spread(stamps) <= _tolerance)
+			chosen[counter] = 1;
+		else
+			stamps[counter] = before;
+	}
+
+	frameSet.stamp = *std::min_element(stamps.begin(), stamps.end());
+	frameSet.skew = Spread(stamps);
+	frameSet.frames.clear();
+	unsigned long long unmatched = 0;
+	for (std::size_t counter = 0; counter < _devices.size(); counter++)
+	{
+		std::deque<Frame>& frames = _devices[counter].frames;
+		frameSet.frames.push_back(frames[chosen[counter]].pointCloud);
+		unmatched += chosen[counter];
+		frames.erase(frames.begin(), frames.begin() + chosen[counter] + 1);
+	}
+	if (unmatched > 0)
+	{
+		_stats.unmatchedFrames += unmatched;
+		TRACE_COUNT("CaptureSession unmatched frames", "grabber", unmatched);
+	}
+	_stats.sets++;
+	_stats.maxSkew = std::max(_stats.maxSkew, frameSet.skew);
+	TRACE_COUNT("CaptureSession sets", "grabber", 1);
+	TRACE_GAUGE("CaptureSession skew (us)", "grabber", (double)frameSet.skew);
+	return true;
+}
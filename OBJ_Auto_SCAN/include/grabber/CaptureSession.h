@@ -0,0 +1,104 @@
+#ifndef CAPTURE_SESSION
+#define CAPTURE_SESSION
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "grabber/Grabber.h"
+#include "observer/Subject.h"
+
+#define CAPTURE_SESSION_DEFAULT_TOLERANCE 15000		//	(us), half a frame at 30 fps
+#define CAPTURE_SESSION_QUEUE_SIZE 4					//	frames held per device, below the grabbers' pool size
+
+//		One frame per device, in the order the devices were added
+struct FrameSet
+{
+	unsigned long long stamp;			//	(us) FrameClock, earliest frame of the set
+	unsigned long long skew;			//	(us) latest - earliest
+	std::vector<pcl::PointCloud<PointT>::Ptr> frames;
+};
+
+struct CaptureSessionStats
+{
+	unsigned long long sets;
+	unsigned long long unmatchedFrames;		//	dropped without a partner within the tolerance
+	unsigned long long maxSkew;				//	(us)
+};
+
+//		*****************************************************************
+//				Capture Session
+//				Several grabbers at once. The devices are started in parallel,
+//				their frames arrive on each subject's FrameBus worker, are
+//				queued per device by FrameClock stamp and paired : a frame set
+//				is made as soon as every device has a frame within the tolerance
+//				of the others, frames that cannot be paired any more are dropped.
+//		*****************************************************************
+class CaptureSession
+{
+public:
+	CaptureSession();
+	~CaptureSession();
+	//		Not while running. The subject must be the one the grabber publishes to
+	void AddDevice(std::string name, IGrabber* grabber, ISubject* subject);
+	void RemoveAllDevices();
+	int GetNumberOfDevices();
+	std::string GetDeviceName(int index);
+	void SetTolerance(unsigned long long tolerance);
+	//		Called on the FrameBus worker that completed the set, it must not block
+	void SetFrameSetCallback(std::function<void(const FrameSet&)> callback);
+	void Start();
+	void Stop();
+	bool IsRunning();
+	//		The newest set since the last call, false if none
+	bool TakeLatestFrameSet(FrameSet& frameSet);
+	CaptureSessionStats GetStats();
+
+private:
+	//		ISubject cannot unregister, so one observer per subject is kept for the
+	//		lifetime of the session and only pointed at a device index (-1 : none)
+	class DeviceObserver : public IObserver
+	{
+	public:
+		DeviceObserver(CaptureSession* session, ISubject* subject) : session(session), subject(subject), index(-1) {}
+		void Update(pcl::PointCloud<PointT>::Ptr pointCloud);
+
+		CaptureSession* session;
+		ISubject* subject;
+		std::atomic<int> index;
+	};
+
+	struct Frame
+	{
+		unsigned long long stamp;
+		pcl::PointCloud<PointT>::Ptr pointCloud;
+	};
+
+	struct Device
+	{
+		std::string name;
+		IGrabber* grabber;
+		DeviceObserver* observer;
+		std::deque<Frame> frames;
+	};
+
+	CaptureSession(const CaptureSession&);
+	CaptureSession& operator=(const CaptureSession&);
+	void Push(int index, pcl::PointCloud<PointT>::Ptr pointCloud);
+	bool Match(FrameSet& frameSet);
+	void StopDevices();
+
+	std::mutex _mutex;
+	std::vector<Device> _devices;
+	std::vector<DeviceObserver*> _observers;
+	std::function<void(const FrameSet&)> _frameSetCallback;
+	unsigned long long _tolerance;
+	bool _isRunning;
+	bool _hasLatest;
+	FrameSet _latest;
+	CaptureSessionStats _stats;
+};
+
+#endif
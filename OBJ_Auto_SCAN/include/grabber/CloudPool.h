@@ -0,0 +1,102 @@
+#ifndef CLOUD_POOL
+#define CLOUD_POOL
+
+#include <pcl/point_cloud.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <mutex>
+#include <vector>
+
+//		*****************************************************************
+//				Cloud Pool
+//				Fixed number of organized clouds, allocated once and handed out
+//				as shared pointers. A buffer returns to the pool when the last
+//				observer releases it, so a frame is never rewritten while in use.
+//		*****************************************************************
+template <typename PointType>
+class CloudPool
+{
+public:
+	typedef pcl::PointCloud<PointType> Cloud;
+	typedef typename Cloud::Ptr CloudPtr;
+
+	CloudPool(std::size_t capacity) : _shared(boost::make_shared<Shared>()), _capacity(capacity)
+	{
+		_shared->freeClouds.reserve(capacity);
+		for (std::size_t counter = 0; counter < capacity; counter++)
+			_shared->freeClouds.push_back(new Cloud());
+	}
+
+	~CloudPool()
+	{
+		std::unique_lock<std::mutex> lock(_shared->mutex);
+		_shared->isAlive = false;
+		for (std::size_t counter = 0; counter < _shared->freeClouds.size(); counter++)
+			delete _shared->freeClouds[counter];
+		_shared->freeClouds.clear();
+	}
+
+	//		Return an organized width x height cloud, or NULL if every buffer is still held
+	CloudPtr Acquire(uint32_t width, uint32_t height)
+	{
+		Cloud* cloud = NULL;
+		{
+			std::unique_lock<std::mutex> lock(_shared->mutex);
+			if (_shared->freeClouds.empty())
+				return CloudPtr();
+			cloud = _shared->freeClouds.back();
+			_shared->freeClouds.pop_back();
+		}
+		if (cloud->width != width || cloud->height != height || cloud->points.size() != width * height)
+		{
+			cloud->points.resize(width * height);
+			cloud->width = width;
+			cloud->height = height;
+		}
+		cloud->is_dense = false;
+		return CloudPtr(cloud, Recycler(_shared));
+	}
+
+	std::size_t GetCapacity()
+	{
+		return _capacity;
+	}
+
+	std::size_t GetAvailable()
+	{
+		std::unique_lock<std::mutex> lock(_shared->mutex);
+		return _shared->freeClouds.size();
+	}
+
+private:
+	struct Shared
+	{
+		Shared() : isAlive(true) {}
+		std::mutex mutex;
+		std::vector<Cloud*> freeClouds;
+		bool isAlive;
+	};
+
+	//		Deleter of the handed-out pointer, keeps the pool state alive until the last buffer comes back
+	struct Recycler
+	{
+		Recycler(const boost::shared_ptr<Shared>& shared) : shared(shared) {}
+		void operator()(Cloud* cloud)
+		{
+			std::unique_lock<std::mutex> lock(shared->mutex);
+			if (shared->isAlive)
+				shared->freeClouds.push_back(cloud);
+			else
+				delete cloud;
+		}
+		boost::shared_ptr<Shared> shared;
+	};
+
+	CloudPool(const CloudPool&);
+	CloudPool& operator=(const CloudPool&);
+
+	boost::shared_ptr<Shared> _shared;
+	std::size_t _capacity;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef FRAME_CLOCK
+#define FRAME_CLOCK
+
+#include <chrono>
+
+//		*****************************************************************
+//				Frame Clock
+//				Monotonic microseconds for pcl header.stamp. Every grabber
+//				stamps with it when the frame arrives, so frames of different
+//				devices can be compared. 0 stays "not stamped".
+//		*****************************************************************
+class FrameClock
+{
+public:
+	static unsigned long long Now()
+	{
+		static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+		return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count() + 1;
+	}
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define GRABBER
 
 #include <mutex>
+#include "grabber/CaptureGovernor.h"
 
 class IGrabber
 {
@@ -10,6 +11,13 @@ public:
 	virtual void StopCamera() = 0;
 	virtual void SetDepthConfidence(int depthConfidence) = 0;
 	virtual std::mutex& GetMutex() = 0;
+	CaptureGovernor& GetCaptureGovernor()
+	{
+		return _governor;
+	}
+
+protected:
+	CaptureGovernor _governor;			//	checked in the frame callback, before the frame is converted or published
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "grabber/GrabberFactory.h"
 
-GrabberFactory::GrabberFactory() : _flexx(NULL), _rs(NULL), _openni(NULL)
+GrabberFactory::GrabberFactory() : _flexx(NULL), _rs(NULL), _openni(NULL), _replay(NULL)
 {
 }
 
@@ -12,6 +12,8 @@ GrabberFactory::~GrabberFactory()
 		delete _rs;
 	if (_openni = NULL)
 		delete _openni;
+	if (_replay != NULL)
+		delete _replay;
 }
 
 IGrabber* GrabberFactory::GetFlexxGrabber(ISubject* subject)
@@ -42,4 +44,15 @@ IGrabber* GrabberFactory::GetOpenNI2Grabber(ISubject* subject)
 			_openni = new OpenNI2Grabber(subject);
 	}
 	return (IGrabber*)_openni;
+}
+
+//		Returned as ReplayGrabber, the source and speed are set on it before StartCamera
+ReplayGrabber* GrabberFactory::GetReplayGrabber(ISubject* subject)
+{
+	if (_replay == NULL)
+	{
+		if (subject != NULL)
+			_replay = new ReplayGrabber(subject);
+	}
+	return _replay;
 }
\ No newline at end of file
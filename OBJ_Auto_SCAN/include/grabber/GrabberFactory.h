@@ -5,11 +5,13 @@
 #include "flexx/Flexx.h"
 #include "rs/RS.h"
 #include "openni/OpenNI2Grabber.h"
+#include "replay/ReplayGrabber.h"
 
 class IGrabber;
 class Flexx;
 class Realsense;
 class OpenNI2Grabber;
+class ReplayGrabber;
 
 class GrabberFactory
 {
@@ -19,11 +21,13 @@ public:
 	IGrabber* GetFlexxGrabber(ISubject* subject = NULL);
 	IGrabber* GetRSGrabber(ISubject* subject = NULL);
 	IGrabber* GetOpenNI2Grabber(ISubject* subject = NULL);
+	ReplayGrabber* GetReplayGrabber(ISubject* subject = NULL);
 
 private:
 	Flexx* _flexx;
 	Realsense* _rs;
 	OpenNI2Grabber* _openni;
+	ReplayGrabber* _replay;
 };
 
 #endif
\ No newline at end of file
@@ -1,38 +1,50 @@
 #include "Flexx.h"
+#include "trace/Tracer.h"
+#include "grabber/FrameClock.h"
 
 //		*****************************************************************
 //				Flexx Listener
 //		*****************************************************************
 
-FlexxListener::FlexxListener(const royale::Vector<royale::StreamId> &streamIds, ISubject* subject) : _streamIds(streamIds), _subject(subject)
+FlexxListener::FlexxListener(const royale::Vector<royale::StreamId> &streamIds, ISubject* subject, CaptureGovernor* governor) : _streamIds(streamIds), _subject(subject), _governor(governor), _cloudPool(CLOUD_POOL_SIZE)
 {
-	_pointCloud.reset(new pcl::PointCloud<PointT>());
 	_depthConfidence = 230;		// default
 }
 
 void FlexxListener::onNewData(const royale::DepthData* data)
 {
+	TRACE_SCOPE("FlexxListener::onNewData", "grabber");
+	unsigned long long stamp = FrameClock::Now();		//	before waiting on the lock
 	std::unique_lock<std::mutex> lock(_lockForReceivedData);
-	if (_pointCloud != nullptr)
-		_pointCloud->clear();
-	//			Copy depth data
+	if (!_governor->Admit())
+	{
+		TRACE_COUNT("Flexx rejected frames", "grabber", 1);
+		return;
+	}
 	_width = data->width;
 	_height = data->height;
-	unsigned int counter = 0;
-	for (; counter < _width * _height; counter++)
+	pcl::PointCloud<PointT>::Ptr pointCloud = _cloudPool.Acquire(data->width, data->height);
+	if (pointCloud == NULL)		//	every buffer is still held by observers, drop this frame
+	{
+		TRACE_COUNT("Flexx pool exhausted", "grabber", 1);
+		return;
+	}
+	//			Copy depth data, keep the organized layout
+	const royale::DepthPoint* source = &data->points[0];
+	PointT* target = &pointCloud->points[0];
+	const uint8_t depthConfidence = (uint8_t)_depthConfidence;
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const std::size_t size = _width * _height;
+	for (std::size_t counter = 0; counter < size; counter++)
 	{
-		if (data->points[counter].depthConfidence < _depthConfidence)		//	Ƥia
-			continue;
-		boost::shared_ptr<PointT> point(new PointT);
-		point->r = 255;
-		point->g = 255;
-		point->b = 255;
-		point->x = data->points[counter].x;
-		point->y = data->points[counter].y;
-		point->z = data->points[counter].z;
-		_pointCloud->push_back(*point);
+		const bool isValid = source[counter].depthConfidence >= depthConfidence;
+		target[counter].x = isValid ? source[counter].x : nan;		//	Ƥia -> NaN
+		target[counter].y = isValid ? source[counter].y : nan;
+		target[counter].z = isValid ? source[counter].z : nan;
+		target[counter].rgba = 0xffffffff;
 	}
-	_subject->NotifyObservers(_pointCloud);
+	pointCloud->header.stamp = stamp;
+	_subject->NotifyObservers(pointCloud);
 }
 
 void FlexxListener::SetDepthConfidence(int depthConfidence)
@@ -76,7 +88,7 @@ void Flexx::StartCamera()
 {
 	if (_cameraDevice->setUseCase(_useCases.at(_selectedUseCaseId)) != royale::CameraStatus::SUCCESS)
 		throw std::string("Flexx: Error setting use case");
-	_listener.reset(new FlexxListener(_streamIds, _subject));
+	_listener.reset(new FlexxListener(_streamIds, _subject, &_governor));
 	if (_cameraDevice->registerDataListener(_listener.get()) != royale::CameraStatus::SUCCESS)
 		throw std::string("Flexx: Error registering flexx listener");
 	if (_cameraDevice->startCapture() != royale::CameraStatus::SUCCESS)
@@ -8,11 +8,15 @@
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <limits>
 #include "grabber/Grabber.h"
+#include "grabber/CloudPool.h"
 #include "observer/IObserver.h"
 
 class ISubject;
 
+#define CLOUD_POOL_SIZE 8
+
 //		*****************************************************************
 //				Flexx Listener
 //				When the frame arrived, onNewData get depth data
@@ -20,7 +24,7 @@ class ISubject;
 class FlexxListener : public royale::IDepthDataListener
 {
 public:
-	explicit FlexxListener(const royale::Vector<royale::StreamId> &streamIds, ISubject* subject);
+	explicit FlexxListener(const royale::Vector<royale::StreamId> &streamIds, ISubject* subject, CaptureGovernor* governor);
 	void onNewData(const royale::DepthData* data) override;
 	void SetDepthConfidence(int depthConfidence);
 	std::mutex& GetMutex();
@@ -33,7 +37,8 @@ private:
 	const royale::Vector<royale::StreamId> _streamIds;
 	std::mutex _lockForReceivedData;
 	ISubject* _subject;
-	pcl::PointCloud<PointT>::Ptr _pointCloud;
+	CaptureGovernor* _governor;
+	CloudPool<PointT> _cloudPool;
 };
 
 //		*****************************************************************
@@ -1,10 +1,13 @@
 #include "OpenNI2Grabber.h"
+#include "trace/Tracer.h"
+#include "grabber/FrameClock.h"
 
 OpenNI2Grabber::OpenNI2Grabber(ISubject* subject) : _subject(subject)
 {
 	_grabber = new pcl::io::OpenNI2Grabber();
 	_f = boost::bind(&OpenNI2Grabber::CloudCallback, this, _1);
 	_connection = _grabber->registerCallback(_f);
+	_governor.SetUnlimited();		//	every frame, Keep Continue has its own pitch. Change it through GetCaptureGovernor
 }
 
 void OpenNI2Grabber::StartCamera()
@@ -29,8 +32,16 @@ std::mutex& OpenNI2Grabber::GetMutex()
 
 void OpenNI2Grabber::CloudCallback(const pcl::PointCloud<PointT>::ConstPtr &cloud)
 {
+	TRACE_SCOPE("OpenNI2Grabber::CloudCallback", "grabber");
+	unsigned long long stamp = FrameClock::Now();
+	if (!_governor.Admit())
+	{
+		TRACE_COUNT("OpenNI2Grabber rejected frames", "grabber", 1);
+		return;
+	}
 	std::unique_lock<std::mutex> lock(_mutex);
 	pcl::PointCloud<PointT>::Ptr cpyCloud = boost::const_pointer_cast<pcl::PointCloud<PointT>>(cloud);
+	cpyCloud->header.stamp = stamp;		//	one clock for every device, drivers stamp with their own
 	/*
 	int width = cloud->width;
 	int height = cloud->height;
@@ -45,5 +56,4 @@ void OpenNI2Grabber::CloudCallback(const pcl::PointCloud<PointT>::ConstPtr &clou
 		} 
 	}*/
 	_subject->NotifyObservers(cpyCloud);
-	boost::this_thread::sleep(boost::posix_time::milliseconds(300));
 }
\ No newline at end of file
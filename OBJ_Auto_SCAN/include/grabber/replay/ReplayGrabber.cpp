@@ -0,0 +1,300 @@
+#include "grabber/replay/ReplayGrabber.h"
+
+#include <cctype>
+#include <exception>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include "file/FrameFiles.h"
+#include "trace/Tracer.h"
+
+static std::string ToLower(std::string str)
+{
+	std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)tolower(c); });
+	return str;
+}
+
+ReplayGrabber::ReplayGrabber(ISubject* subject) : _subject(subject), _isStopping(false), _isFinished(true), _pendingSteps(0), _isScanLog(false)
+{
+	_mode.store((int)ReplayMode::RealTime);
+	_speed.store(1.0);
+	_framePeriod.store(1.0 / 30);
+	_isLoop.store(false);
+	_published.store(0);
+}
+
+ReplayGrabber::~ReplayGrabber()
+{
+	StopCamera();
+}
+
+void ReplayGrabber::StartCamera()
+{
+	if (_thread.joinable())
+	{
+		if (!IsFinished())
+			return;
+		_thread.join();
+	}
+	if (GetNumberOfFrames() == 0)
+		throw std::string("ReplayGrabber: No frames to replay");
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_isStopping = false;
+		_isFinished = false;
+		_pendingSteps = 0;
+		_error.clear();
+	}
+	_published.store(0);
+	_thread = std::thread(&ReplayGrabber::Play, this);
+}
+
+void ReplayGrabber::StopCamera()
+{
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_isStopping = true;
+	}
+	_condition.notify_all();
+	if (_thread.joinable())
+		_thread.join();
+}
+
+void ReplayGrabber::SetDepthConfidence(int depthConfidence)
+{
+	return;
+}
+
+std::mutex& ReplayGrabber::GetMutex()
+{
+	return _mutex;
+}
+
+//		*****************************************************************
+//				Source
+//		*****************************************************************
+
+void ReplayGrabber::SetSource(std::string path)
+{
+	if (_thread.joinable())
+	{
+		if (!IsFinished())
+			throw std::string("ReplayGrabber: Stop the replay before changing the source");
+		_thread.join();
+	}
+	_scanLog.Close();
+	_paths.clear();
+	_isScanLog = false;
+	boost::filesystem::path source(path);
+	std::string extension = ToLower(source.extension().string());
+	if (boost::filesystem::is_directory(source))
+	{
+		const char* extensions[] = { ".obj", ".ply", ".pcd" };
+		for (int counter = 0; counter < 3 && _paths.empty(); counter++)
+		{
+			_paths = ListFrameFiles(path, extensions[counter]);
+			_extension = extensions[counter];
+		}
+		if (_paths.empty())
+			throw std::string("ReplayGrabber: No OBJ / PLY / PCD frames in ") + path;
+	}
+	else if (extension == ".scanlog")
+	{
+		_scanLog.Open(path);
+		_isScanLog = true;
+	}
+	else if (extension == ".obj" || extension == ".ply" || extension == ".pcd")
+	{
+		_paths = ListFrameFiles(source.parent_path().empty() ? std::string(".") : source.parent_path().string(), extension);
+		_extension = extension;
+	}
+	else
+		throw std::string("ReplayGrabber: Unsupported source ") + path;
+}
+
+void ReplayGrabber::SetMode(ReplayMode mode)
+{
+	_mode.store((int)mode);
+	_condition.notify_all();
+}
+
+void ReplayGrabber::SetSpeed(double speed)
+{
+	if (speed <= 0)
+		throw std::string("ReplayGrabber: speed must be positive");
+	_speed.store(speed);
+}
+
+void ReplayGrabber::SetFramePeriod(double seconds)
+{
+	if (seconds < 0)
+		throw std::string("ReplayGrabber: frame period must not be negative");
+	_framePeriod.store(seconds);
+}
+
+void ReplayGrabber::SetLoop(bool isLoop)
+{
+	_isLoop.store(isLoop);
+}
+
+void ReplayGrabber::Step()
+{
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_pendingSteps++;
+	}
+	_condition.notify_all();
+}
+
+int ReplayGrabber::GetNumberOfFrames()
+{
+	return _isScanLog ? _scanLog.GetNumberOfFrames() : (int)_paths.size();
+}
+
+unsigned long long ReplayGrabber::GetPublishedFrames()
+{
+	return _published.load();
+}
+
+bool ReplayGrabber::IsFinished()
+{
+	std::unique_lock<std::mutex> lock(_controlMutex);
+	return _isFinished;
+}
+
+//		Returns once the last frame is published (never in loop mode) or the replay is stopped
+void ReplayGrabber::WaitUntilFinished()
+{
+	std::unique_lock<std::mutex> lock(_controlMutex);
+	_condition.wait(lock, [this] { return _isFinished; });
+}
+
+std::string ReplayGrabber::GetError()
+{
+	std::unique_lock<std::mutex> lock(_controlMutex);
+	return _error;
+}
+
+//		*****************************************************************
+//				Play
+//		*****************************************************************
+
+ScanLogFrame ReplayGrabber::ReadFrame(int index)
+{
+	if (_isScanLog)
+		return _scanLog.ReadFrame(index);
+	MyFile* file = NULL;
+	if (_extension == ".obj")
+		file = _fileFactory.GetObjFile(_paths[index]);
+	else if (_extension == ".ply")
+		file = _fileFactory.GetPlyFile(_paths[index]);
+	else
+		file = _fileFactory.GetPcdFile(_paths[index]);
+	ScanLogFrame frame;
+	frame.timestamp = 0;
+	frame.angle = 0;
+	try
+	{
+		file->LoadFile();
+		frame.pointCloud = file->GetPointCloud();
+	}
+	catch (...)
+	{
+		delete file;
+		throw;
+	}
+	delete file;
+	if (frame.pointCloud.get() == NULL)
+		throw std::string("ReplayGrabber: Cannot read ") + _paths[index];
+	return frame;
+}
+
+//		false when the replay was stopped while waiting
+bool ReplayGrabber::WaitUntil(std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(_controlMutex);
+	_condition.wait_until(lock, deadline, [this] { return _isStopping; });
+	return !_isStopping;
+}
+
+//		RealTime deadlines are chained frame to frame, so a speed change takes effect
+//		on the next frame and a slow read is caught up instead of shifting the rest
+void ReplayGrabber::Play()
+{
+	int numberOfFrames = GetNumberOfFrames();
+	std::chrono::steady_clock::time_point deadline;
+	unsigned long long previousTimestamp = 0;
+	bool isRestart = true;
+	int index = 0;
+	try
+	{
+		while (true)
+		{
+			if (index == numberOfFrames)
+			{
+				if (!_isLoop.load())
+					break;
+				index = 0;
+				isRestart = true;
+			}
+			if ((ReplayMode)_mode.load() == ReplayMode::Stepped)
+			{
+				std::unique_lock<std::mutex> lock(_controlMutex);
+				_condition.wait(lock, [this] { return _isStopping || _pendingSteps > 0 || (ReplayMode)_mode.load() != ReplayMode::Stepped; });
+				if (_pendingSteps > 0)
+					_pendingSteps--;
+				isRestart = true;
+			}
+			if (!WaitUntil(std::chrono::steady_clock::time_point()))
+				break;
+
+			ScanLogFrame frame = ReadFrame(index);
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (isRestart)
+				deadline = now;
+			else
+			{
+				double seconds = _framePeriod.load();
+				if (_isScanLog)
+					seconds = frame.timestamp > previousTimestamp ? (frame.timestamp - previousTimestamp) * 1e-6 : 0;
+				deadline += std::chrono::nanoseconds((long long)(seconds / _speed.load() * 1e9));
+			}
+			previousTimestamp = frame.timestamp;
+			isRestart = false;
+			if ((ReplayMode)_mode.load() == ReplayMode::RealTime && !WaitUntil(deadline))
+				break;
+			if ((ReplayMode)_mode.load() != ReplayMode::RealTime)
+				isRestart = true;
+			index++;
+			if (!_governor.Admit())
+			{
+				TRACE_COUNT("Replay rejected frames", "grabber", 1);
+				continue;
+			}
+			TRACE_SCOPE("ReplayGrabber::Publish", "grabber");
+			std::unique_lock<std::mutex> lock(_mutex);
+			_subject->NotifyObservers(frame.pointCloud);
+			_published++;
+		}
+	}
+	//		Nothing may escape the replay thread, std::terminate would close the application
+	catch (std::string& error)
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_error = error;
+	}
+	catch (std::exception& error)
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_error = std::string("ReplayGrabber: ") + error.what();
+	}
+	catch (...)
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_error = std::string("ReplayGrabber: Unknown error while reading a frame");
+	}
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		_isFinished = true;
+	}
+	_condition.notify_all();
+}
@@ -0,0 +1,82 @@
+#ifndef REPLAY_GRABBER
+#define REPLAY_GRABBER
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+#include "grabber/Grabber.h"
+#include "observer/Subject.h"
+#include "file/FileFactory.h"
+#include "file/ScanLog.h"
+#include "Typedef.h"
+
+enum class ReplayMode
+{
+	RealTime,				//	keep the recorded spacing, scaled by the speed
+	AsFastAsPossible,		//	publish as soon as the previous frame is read
+	Stepped					//	publish one frame per Step()
+};
+
+//		*****************************************************************
+//				Replay Grabber
+//				Plays a scan log or a directory of OBJ / PLY / PCD frames
+//				through a subject like a camera does, on its own thread.
+//				File frames have no timestamps, they are spaced by the frame
+//				period in RealTime mode.
+//		*****************************************************************
+class ReplayGrabber : public IGrabber
+{
+public:
+	ReplayGrabber(ISubject* subject);
+	~ReplayGrabber();
+	void StartCamera();
+	void StopCamera();
+	void SetDepthConfidence(int depthConfidence);
+	std::mutex& GetMutex();
+
+	//		A .scanlog file, a frame directory, or one frame file (replays its directory)
+	void SetSource(std::string path);
+	void SetMode(ReplayMode mode);
+	void SetSpeed(double speed);
+	void SetFramePeriod(double seconds);
+	void SetLoop(bool isLoop);
+	void Step();
+	int GetNumberOfFrames();
+	unsigned long long GetPublishedFrames();
+	bool IsFinished();
+	void WaitUntilFinished();
+	std::string GetError();
+
+private:
+	void Play();
+	ScanLogFrame ReadFrame(int index);
+	bool WaitUntil(std::chrono::steady_clock::time_point deadline);
+
+	ISubject* _subject;
+	std::mutex _mutex;
+	std::thread _thread;
+
+	std::mutex _controlMutex;			//	guards the flags below
+	std::condition_variable _condition;
+	bool _isStopping;
+	bool _isFinished;
+	int _pendingSteps;
+	std::string _error;
+
+	std::atomic<int> _mode;
+	std::atomic<double> _speed;
+	std::atomic<double> _framePeriod;
+	std::atomic<bool> _isLoop;
+	std::atomic<unsigned long long> _published;
+
+	bool _isScanLog;
+	std::string _extension;
+	std::vector<std::string> _paths;
+	ScanLogReader _scanLog;
+	FileFactory _fileFactory;
+};
+
+#endif
@@ -1,4 +1,6 @@
 #include "RS.h"
+#include "trace/Tracer.h"
+#include "grabber/FrameClock.h"
 
 Realsense::Realsense(ISubject* subject, std::string deviceId) : _subject(subject)
 {
@@ -24,8 +26,16 @@ void Realsense::StopCamera()
 
 void Realsense::CloudCallback(boost::shared_ptr<const pcl::PointCloud<PointT>> cloud)
 {
+	TRACE_SCOPE("Realsense::CloudCallback", "grabber");
+	unsigned long long stamp = FrameClock::Now();
+	if (!_governor.Admit())
+	{
+		TRACE_COUNT("Realsense rejected frames", "grabber", 1);
+		return;
+	}
 	std::unique_lock<std::mutex> lock(_mutex);
 	pcl::PointCloud<PointT>::Ptr cpyCloud = boost::const_pointer_cast<pcl::PointCloud<PointT>>(cloud);
+	cpyCloud->header.stamp = stamp;		//	one clock for every device, drivers stamp with their own
 	_subject->NotifyObservers(cpyCloud);
 }
 
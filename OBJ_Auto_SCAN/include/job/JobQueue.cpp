@@ -0,0 +1,285 @@
+#include "job/JobQueue.h"
+
+#include <exception>
+
+//		*****************************************************************
+//				Job Token
+//		*****************************************************************
+
+JobToken::JobToken(JobQueue* queue, int id, std::atomic<bool>& isCancelled, std::atomic<float>& progress) : _queue(queue), _id(id), _isCancelled(isCancelled), _progress(progress)
+{
+}
+
+bool JobToken::IsCancelled()
+{
+	return _isCancelled.load();
+}
+
+void JobToken::SetProgress(float progress)
+{
+	_progress.store(progress);
+	_queue->ReportProgress(_id, progress);
+}
+
+//		*****************************************************************
+//				Job
+//		*****************************************************************
+
+JobQueue::Job::Job(int id, std::string name, JobFunction function) : id(id), name(name), function(function), state(JobState::Queued)
+{
+	isCancelled.store(false);
+	progress.store(0);
+}
+
+JobStatus JobQueue::Job::GetStatus()
+{
+	JobStatus status;
+	status.id = id;
+	status.name = name;
+	status.state = state;
+	status.progress = progress.load();
+	status.error = error;
+	return status;
+}
+
+//		*****************************************************************
+//				Job Queue
+//		*****************************************************************
+
+JobQueue::JobQueue(unsigned int numberOfThreads) : _nextId(0), _isStopped(false)
+{
+	if (numberOfThreads == 0)
+		numberOfThreads = std::thread::hardware_concurrency();
+	if (numberOfThreads == 0)
+		numberOfThreads = 1;
+	for (unsigned int counter = 0; counter < numberOfThreads; counter++)
+		_workers.push_back(std::thread(&JobQueue::Run, this));
+}
+
+//		Queued jobs are dropped, running ones are cancelled and waited for
+JobQueue::~JobQueue()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_isStopped = true;
+		_finishedCallback = std::function<void(int)>();
+		_progressCallback = std::function<void(int, float)>();
+		for (std::map<int, Job*>::iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+			it->second->isCancelled.store(true);
+		_condition.notify_all();
+	}
+	for (std::size_t counter = 0; counter < _workers.size(); counter++)
+		_workers[counter].join();
+	for (std::map<int, Job*>::iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+	{
+		DeleteResults(it->second);
+		delete it->second;
+	}
+}
+
+int JobQueue::Submit(std::string name, JobFunction function)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_isStopped)
+		throw std::string("JobQueue: Submit after the queue was stopped");
+	int id = _nextId++;
+	Job* job = new Job(id, name, function);
+	_jobs[id] = job;
+	_queue.push_back(job);
+	_condition.notify_one();
+	return id;
+}
+
+void JobQueue::Cancel(int id)
+{
+	bool isDequeued = false;
+	std::function<void(int)> finishedCallback;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::map<int, Job*>::iterator it = _jobs.find(id);
+		if (it == _jobs.end())
+			return;
+		Job* job = it->second;
+		job->isCancelled.store(true);
+		if (job->state == JobState::Queued)
+		{
+			for (std::deque<Job*>::iterator queued = _queue.begin(); queued != _queue.end(); ++queued)
+			{
+				if (*queued == job)
+				{
+					_queue.erase(queued);
+					break;
+				}
+			}
+			job->state = JobState::Cancelled;
+			job->function = JobFunction();
+			isDequeued = true;
+			finishedCallback = _finishedCallback;
+		}
+	}
+	//		A running job reports through Execute once its current step returns
+	if (isDequeued && finishedCallback)
+		finishedCallback(id);
+}
+
+void JobQueue::CancelAll()
+{
+	std::vector<int> ids;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (std::map<int, Job*>::iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+			ids.push_back(it->first);
+	}
+	for (std::size_t counter = 0; counter < ids.size(); counter++)
+		Cancel(ids[counter]);
+}
+
+JobStatus JobQueue::GetStatus(int id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::map<int, Job*>::iterator it = _jobs.find(id);
+	if (it == _jobs.end())
+		throw std::string("JobQueue: No such job");
+	return it->second->GetStatus();
+}
+
+std::vector<JobStatus> JobQueue::GetActiveJobs()
+{
+	std::vector<JobStatus> statuses;
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (std::map<int, Job*>::iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+	{
+		if (it->second->state == JobState::Queued || it->second->state == JobState::Running)
+			statuses.push_back(it->second->GetStatus());
+	}
+	return statuses;
+}
+
+std::vector<PointCloudElement*> JobQueue::TakeResults(int id)
+{
+	std::vector<PointCloudElement*> results;
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::map<int, Job*>::iterator it = _jobs.find(id);
+	if (it == _jobs.end())
+		return results;
+	Job* job = it->second;
+	if (job->state == JobState::Queued || job->state == JobState::Running)
+		return results;
+	results.swap(job->results);
+	_jobs.erase(it);
+	delete job;
+	return results;
+}
+
+void JobQueue::SetFinishedCallback(std::function<void(int)> finishedCallback)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_finishedCallback = finishedCallback;
+}
+
+void JobQueue::SetProgressCallback(std::function<void(int, float)> progressCallback)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_progressCallback = progressCallback;
+}
+
+unsigned int JobQueue::GetNumberOfThreads()
+{
+	return (unsigned int)_workers.size();
+}
+
+void JobQueue::Run()
+{
+	while (true)
+	{
+		Job* job;
+		JobFunction function;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this]()
+			{
+				return _isStopped || !_queue.empty();
+			});
+			if (_isStopped)
+				return;
+			job = _queue.front();
+			_queue.pop_front();
+			job->state = JobState::Running;
+			function.swap(job->function);
+		}
+		Execute(job, function);
+	}
+}
+
+//		The job function is released here, not in TakeResults, so the input clouds it captured
+//		are no longer shared once the result reaches the GUI
+void JobQueue::Execute(Job* job, JobFunction function)
+{
+	int id = job->id;
+	JobToken token(this, id, job->isCancelled, job->progress);
+	std::vector<PointCloudElement*> results;
+	std::string error;
+	bool isFailed = false;
+	try
+	{
+		results = function(token);
+	}
+	catch (std::string& message)
+	{
+		error = message;
+		isFailed = true;
+	}
+	catch (std::exception& exception)
+	{
+		error = exception.what();
+		isFailed = true;
+	}
+	catch (...)
+	{
+		error = "JobQueue: Unknown exception";
+		isFailed = true;
+	}
+	function = JobFunction();
+
+	std::function<void(int)> finishedCallback;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		job->results = results;
+		if (isFailed)
+		{
+			job->state = JobState::Failed;
+			job->error = error;
+		}
+		else if (job->isCancelled.load())
+			job->state = JobState::Cancelled;
+		else
+		{
+			job->state = JobState::Finished;
+			job->progress.store(1);
+		}
+		if (job->state != JobState::Finished)
+			DeleteResults(job);
+		finishedCallback = _finishedCallback;
+	}
+	//		The GUI may take the job as soon as the lock is released, only the id is used from here
+	if (finishedCallback)
+		finishedCallback(id);
+}
+
+void JobQueue::ReportProgress(int id, float progress)
+{
+	std::function<void(int, float)> progressCallback;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		progressCallback = _progressCallback;
+	}
+	if (progressCallback)
+		progressCallback(id, progress);
+}
+
+void JobQueue::DeleteResults(Job* job)
+{
+	for (std::size_t counter = 0; counter < job->results.size(); counter++)
+		delete job->results[counter];
+	job->results.clear();
+}
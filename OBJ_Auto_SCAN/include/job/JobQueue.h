@@ -0,0 +1,114 @@
+#ifndef JOB_QUEUE
+#define JOB_QUEUE
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pointCloud/PointCloudElement.h"
+
+enum class JobState
+{
+	Queued,
+	Running,
+	Finished,
+	Cancelled,
+	Failed
+};
+
+struct JobStatus
+{
+	int id;
+	std::string name;
+	JobState state;
+	float progress;			//	0 to 1, as reported by the job
+	std::string error;
+};
+
+class JobQueue;
+
+//		Handed to the running job : cancellation is cooperative, a job checks
+//		IsCancelled between its steps (a PCL call itself cannot be interrupted)
+class JobToken
+{
+public:
+	JobToken(JobQueue* queue, int id, std::atomic<bool>& isCancelled, std::atomic<float>& progress);
+	bool IsCancelled();
+	void SetProgress(float progress);
+
+private:
+	JobQueue* _queue;
+	int _id;
+	std::atomic<bool>& _isCancelled;
+	std::atomic<float>& _progress;
+};
+
+//		The elements a job creates, added to PointCloudElements by the GUI thread
+typedef std::function<std::vector<PointCloudElement*>(JobToken& token)> JobFunction;
+
+//		*****************************************************************
+//				Job Queue
+//				Worker pool for the long processing slots (filter, reconstruct,
+//				smoothing, regestration). The callbacks run on a worker thread,
+//				the UI forwards them with a queued invoke and collects the
+//				elements with TakeResults on its own thread.
+//		*****************************************************************
+class JobQueue
+{
+public:
+	//		0 : one worker per core
+	JobQueue(unsigned int numberOfThreads = 0);
+	~JobQueue();
+	int Submit(std::string name, JobFunction function);
+	void Cancel(int id);
+	void CancelAll();
+	JobStatus GetStatus(int id);
+	std::vector<JobStatus> GetActiveJobs();
+	//		Removes a finished, cancelled or failed job; only a finished job has elements
+	std::vector<PointCloudElement*> TakeResults(int id);
+	void SetFinishedCallback(std::function<void(int)> finishedCallback);
+	void SetProgressCallback(std::function<void(int, float)> progressCallback);
+	unsigned int GetNumberOfThreads();
+
+private:
+	friend class JobToken;
+
+	struct Job
+	{
+		Job(int id, std::string name, JobFunction function);
+		JobStatus GetStatus();
+
+		int id;
+		std::string name;
+		JobFunction function;
+		JobState state;
+		std::atomic<bool> isCancelled;
+		std::atomic<float> progress;
+		std::vector<PointCloudElement*> results;
+		std::string error;
+	};
+
+	JobQueue(const JobQueue&);
+	JobQueue& operator=(const JobQueue&);
+	void Run();
+	void Execute(Job* job, JobFunction function);
+	void ReportProgress(int id, float progress);
+	void DeleteResults(Job* job);
+
+	std::map<int, Job*> _jobs;
+	std::deque<Job*> _queue;
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::function<void(int)> _finishedCallback;
+	std::function<void(int, float)> _progressCallback;
+	int _nextId;
+	bool _isStopped;
+};
+
+#endif
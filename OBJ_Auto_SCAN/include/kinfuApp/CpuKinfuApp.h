@@ -0,0 +1,188 @@
+#ifndef CPU_KINFU_APP
+#define CPU_KINFU_APP
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <pcl/PolygonMesh.h>
+#include "Typedef.h"
+#include "kinfuApp/CpuKinfuTracker.h"
+#include "pcl/gpu/kinfu/tools/camera_pose.h"
+
+//		*****************************************************************
+//				CPU KinFu App
+//				Same surface as KinFuApp (source_cb3, execute, scan_, scan_mesh_,
+//				GetPointCloud, GetMesh, GetR / GetT, SetRMatrix / SetTVector)
+//				on top of CpuKinfuTracker, for machines without CUDA.
+//				There is no visualization, viz is ignored.
+//		*****************************************************************
+struct CpuKinFuApp
+{
+	CpuKinFuApp(float vsz, int icp, int viz, boost::shared_ptr<CameraPoseProcessor> pose_processor = boost::shared_ptr<CameraPoseProcessor>()) : scan_(false), scan_mesh_(false), has_intrinsics_(false), kinfu_(vsz), pose_processor_(pose_processor)
+	{
+		Eigen::Vector3f volume_size = Eigen::Vector3f::Constant(vsz/*meters*/);
+		Eigen::Matrix3f R = Eigen::Matrix3f::Identity();
+		Eigen::Vector3f t = volume_size * 0.5f - Eigen::Vector3f(0, 0, volume_size(2) / 2 * 1.2f);
+		kinfu_.SetInitialCameraPose(Eigen::Translation3f(t) * Eigen::AngleAxisf(R));
+		kinfu_.SetTruncationDistance(0.030f/*meters*/);
+		kinfu_.SetIcpCorrespondenceFilteringParams(0.1f/*meters*/, std::sin(20.f * 3.14159254f / 180.f));
+		kinfu_.SetIcp(icp != 0);
+
+		cloud_ptr_ = pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>);
+		mesh_ptr_ = pcl::PolygonMeshPtr(new pcl::PolygonMesh);
+	}
+
+	void SetInitalCameraPose(Eigen::Matrix3f R, Eigen::Vector3f t)
+	{
+		kinfu_.SetInitialCameraPose(Eigen::Translation3f(t) * Eigen::AngleAxisf(R));
+	}
+
+	//		Same meaning as KinFuApp::SetICP : true disables the tracking
+	void SetICP(bool flag)
+	{
+		kinfu_.SetIcp(!flag);
+	}
+
+	void setDepthIntrinsics(std::vector<float> depth_intrinsics)
+	{
+		if (depth_intrinsics.size() == 4)
+			kinfu_.SetDepthIntrinsics(depth_intrinsics[0], depth_intrinsics[1], depth_intrinsics[2], depth_intrinsics[3]);
+		else
+			kinfu_.SetDepthIntrinsics(depth_intrinsics[0], depth_intrinsics[1]);
+		has_intrinsics_ = true;
+	}
+
+	void SetNumberOfThreads(unsigned int numberOfThreads)
+	{
+		kinfu_.SetNumberOfThreads(numberOfThreads);
+	}
+
+	bool execute()
+	{
+		bool has_image = kinfu_.Process(frame_);
+		if (pose_processor_)
+			pose_processor_->processPose(kinfu_.GetCameraPose());
+
+		if (scan_)
+		{
+			scan_ = false;
+			cloud_ptr_ = pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>);
+			kinfu_.GetVolume().ExtractPointCloud(*cloud_ptr_);
+			std::cout << "Done.  Cloud size: " << cloud_ptr_->size() / 1000 << "K, " << kinfu_.GetVolume().GetNumberOfBlocks() << " blocks" << std::endl;
+		}
+		if (scan_mesh_)
+		{
+			scan_mesh_ = false;
+			mesh_ptr_ = pcl::PolygonMeshPtr(new pcl::PolygonMesh);
+			kinfu_.GetVolume().ExtractMesh(*mesh_ptr_);
+			std::cout << "Done.  Triangles: " << mesh_ptr_->polygons.size() / 1000 << "K" << std::endl;
+		}
+		return has_image;
+	}
+
+	void source_cb3(const pcl::PointCloud<pcl::PointXYZRGB>::Ptr & DC3)
+	{
+		int width = DC3->width;
+		int height = DC3->height;
+		frame_.width = width;
+		frame_.height = height;
+		frame_.depth.resize(width * height);
+		frame_.rgb.resize(3 * width * height);
+		for (int i = 0; i < width * height; i++)
+		{
+			const pcl::PointXYZRGB& pt = DC3->points[i];
+			frame_.rgb[3 * i + 0] = pt.r;
+			frame_.rgb[3 * i + 1] = pt.g;
+			frame_.rgb[3 * i + 2] = pt.b;
+			frame_.depth[i] = pt.z == pt.z ? pt.z : 0;
+		}
+		if (!has_intrinsics_ && height > 1)
+			EstimateIntrinsics(*DC3);
+	}
+
+	pcl::PointCloud<PointT>::Ptr GetPointCloud()
+	{
+		return cloud_ptr_;
+	}
+
+	pcl::PolygonMeshPtr GetMesh()
+	{
+		return mesh_ptr_;
+	}
+
+	Eigen::Matrix<float, 3, 3, Eigen::RowMajor> GetR()
+	{
+		return kinfu_.GetR();
+	}
+
+	Eigen::Vector3f GetT()
+	{
+		return kinfu_.GetT();
+	}
+
+	void SetRMatrix(std::vector<Eigen::Matrix<float, 3, 3, Eigen::RowMajor>> rMatrix)
+	{
+		r_matrix_ = rMatrix;
+		if (r_matrix_.size() == t_vector_.size())
+			kinfu_.SetPoses(r_matrix_, t_vector_);
+	}
+
+	void SetTVector(std::vector<Eigen::Vector3f> tVector)
+	{
+		t_vector_ = tVector;
+		if (r_matrix_.size() == t_vector_.size())
+			kinfu_.SetPoses(r_matrix_, t_vector_);
+	}
+
+	//		An organized cloud already holds x = (u - cx) * z / fx, fitting u against x / z
+	//		gives the real intrinsics instead of the Kinect defaults the GPU app keeps
+	void EstimateIntrinsics(const pcl::PointCloud<pcl::PointXYZRGB>& cloud)
+	{
+		Eigen::Matrix2d horizontal = Eigen::Matrix2d::Zero();
+		Eigen::Matrix2d vertical = Eigen::Matrix2d::Zero();
+		Eigen::Vector2d horizontalSum = Eigen::Vector2d::Zero();
+		Eigen::Vector2d verticalSum = Eigen::Vector2d::Zero();
+		int count = 0;
+		for (int v = 0; v < (int)cloud.height; v++)
+		{
+			for (int u = 0; u < (int)cloud.width; u++)
+			{
+				const pcl::PointXYZRGB& pt = cloud.points[v * cloud.width + u];
+				if (!(pt.z > 0))
+					continue;
+				Eigen::Vector2d x(pt.x / pt.z, 1);
+				Eigen::Vector2d y(pt.y / pt.z, 1);
+				horizontal += x * x.transpose();
+				vertical += y * y.transpose();
+				horizontalSum += x * u;
+				verticalSum += y * v;
+				count++;
+			}
+		}
+		if (count < 100 || std::fabs(horizontal.determinant()) < 1e-12 || std::fabs(vertical.determinant()) < 1e-12)
+			return;
+		Eigen::Vector2d fx = horizontal.ldlt().solve(horizontalSum);
+		Eigen::Vector2d fy = vertical.ldlt().solve(verticalSum);
+		kinfu_.SetDepthIntrinsics((float)fx(0), (float)fy(0), (float)fx(1), (float)fy(1));
+		has_intrinsics_ = true;
+		std::cout << "Depth intrinsics estimated fx=" << fx(0) << " fy=" << fy(0) << " cx=" << fx(1) << " cy=" << fy(1) << std::endl;
+	}
+
+	bool scan_;
+	bool scan_mesh_;
+	bool has_intrinsics_;
+
+	CpuKinfuTracker kinfu_;
+	CpuDepthFrame frame_;
+
+	pcl::PointCloud<PointT>::Ptr cloud_ptr_;
+	pcl::PolygonMeshPtr mesh_ptr_;
+
+	std::vector<Eigen::Matrix<float, 3, 3, Eigen::RowMajor>> r_matrix_;
+	std::vector<Eigen::Vector3f> t_vector_;
+
+	boost::shared_ptr<CameraPoseProcessor> pose_processor_;
+};
+
+#endif
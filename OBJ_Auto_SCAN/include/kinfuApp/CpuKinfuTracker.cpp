@@ -0,0 +1,287 @@
+#include "CpuKinfuTracker.h"
+
+#include <cmath>
+#include <limits>
+#include "kinfuApp/CpuParallelFor.h"
+
+CpuKinfuTracker::CpuKinfuTracker(float volumeSize, int resolution) : _volume(volumeSize, volumeSize / resolution, 0.03f)
+{
+	//	default, same as pcl::gpu::KinfuTracker
+	_fx = 585.f;
+	_fy = 585.f;
+	_cx = -1;
+	_cy = -1;
+	_distanceThreshold = 0.10f;
+	_angleThreshold = std::sin(20.f * 3.14159254f / 180.f);
+	_isIcpEnabled = true;
+	_numberOfThreads = 0;
+	_width = 0;
+	_height = 0;
+
+	_initialRotation = Matrix3frm::Identity();
+	_initialTranslation = Eigen::Vector3f::Constant(volumeSize * 0.5f) - Eigen::Vector3f(0, 0, volumeSize / 2 * 1.2f);
+	Reset();
+}
+
+void CpuKinfuTracker::SetDepthIntrinsics(float fx, float fy, float cx, float cy)
+{
+	_fx = fx;
+	_fy = fy;
+	_cx = cx;
+	_cy = cy;
+}
+
+void CpuKinfuTracker::GetDepthIntrinsics(float& fx, float& fy, float& cx, float& cy)
+{
+	fx = _fx;
+	fy = _fy;
+	cx = _cx;
+	cy = _cy;
+}
+
+void CpuKinfuTracker::SetInitialCameraPose(const Eigen::Affine3f& pose)
+{
+	_initialRotation = pose.rotation();
+	_initialTranslation = pose.translation();
+	Reset();
+}
+
+void CpuKinfuTracker::SetIcpCorrespondenceFilteringParams(float distanceThreshold, float sineOfAngleThreshold)
+{
+	_distanceThreshold = distanceThreshold;
+	_angleThreshold = sineOfAngleThreshold;
+}
+
+void CpuKinfuTracker::SetTruncationDistance(float truncationDistance)
+{
+	_volume.SetTruncationDistance(truncationDistance);
+}
+
+void CpuKinfuTracker::SetIcp(bool isEnabled)
+{
+	_isIcpEnabled = isEnabled;
+}
+
+//		Known poses (e.g. the turntable), frame i is integrated at pose i
+void CpuKinfuTracker::SetPoses(const std::vector<Matrix3frm>& rotations, const std::vector<Eigen::Vector3f>& translations)
+{
+	if (rotations.size() != translations.size() || rotations.empty())
+		throw std::string("CpuKinfuTracker: rotations and translations must have the same, non zero size");
+	_rotations = rotations;
+	_translations = translations;
+}
+
+void CpuKinfuTracker::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	_numberOfThreads = numberOfThreads;
+	_volume.SetNumberOfThreads(numberOfThreads);
+}
+
+void CpuKinfuTracker::Reset()
+{
+	_time = 0;
+	_rotations.assign(1, _initialRotation);
+	_translations.assign(1, _initialTranslation);
+	_volume.Reset();
+}
+
+bool CpuKinfuTracker::Process(const CpuDepthFrame& frame)
+{
+	CpuCameraIntrinsics intrinsics = GetIntrinsics(frame);
+	Matrix3frm rotation;
+	Eigen::Vector3f translation;
+
+	if (!_isIcpEnabled)
+	{
+		if (_time >= (int)_rotations.size())
+		{
+			_rotations.push_back(_rotations.back());
+			_translations.push_back(_translations.back());
+		}
+		rotation = _rotations[_time];
+		translation = _translations[_time];
+	}
+	else
+	{
+		CreateMaps(frame, intrinsics);
+		if (_time == 0)
+		{
+			rotation = _rotations[0];
+			translation = _translations[0];
+		}
+		else
+		{
+			if (!EstimatePose(intrinsics, rotation, translation))
+			{
+				Reset();
+				return false;
+			}
+			_rotations.push_back(rotation);
+			_translations.push_back(translation);
+		}
+	}
+
+	Eigen::Affine3f pose = Eigen::Translation3f(translation) * Eigen::AngleAxisf(Eigen::Matrix3f(rotation));
+	_volume.Integrate(frame, intrinsics, pose);
+	if (_isIcpEnabled)
+		_volume.Raycast(intrinsics, pose, frame.width, frame.height, _modelVertices, _modelNormals);
+	_time++;
+	//		Nothing to track against on the first frame
+	return !_isIcpEnabled || _time > 1;
+}
+
+CpuCameraIntrinsics CpuKinfuTracker::GetIntrinsics(const CpuDepthFrame& frame)
+{
+	CpuCameraIntrinsics intrinsics;
+	intrinsics.fx = _fx;
+	intrinsics.fy = _fy;
+	intrinsics.cx = _cx == -1 ? frame.width / 2 - 0.5f : _cx;
+	intrinsics.cy = _cy == -1 ? frame.height / 2 - 0.5f : _cy;
+	return intrinsics;
+}
+
+//		Vertex and normal maps of the current frame, normals face the camera like the raycast ones
+void CpuKinfuTracker::CreateMaps(const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics)
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	_width = frame.width;
+	_height = frame.height;
+	_vertices.resize(_width * _height);
+	_normals.assign(_width * _height, Eigen::Vector3f::Constant(nan));
+	CpuParallelFor(_height, 8, _numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int v = begin; v < end; v++)
+		{
+			for (int u = 0; u < _width; u++)
+			{
+				float depth = frame.depth[v * _width + u];
+				_vertices[v * _width + u] = depth > 0 ? Eigen::Vector3f((u - intrinsics.cx) / intrinsics.fx * depth, (v - intrinsics.cy) / intrinsics.fy * depth, depth) : Eigen::Vector3f::Constant(nan);
+			}
+		}
+	});
+	CpuParallelFor(_height - 1, 8, _numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int v = begin; v < end; v++)
+		{
+			for (int u = 0; u + 1 < _width; u++)
+			{
+				const Eigen::Vector3f& vertex = _vertices[v * _width + u];
+				Eigen::Vector3f normal = (_vertices[v * _width + u + 1] - vertex).cross(_vertices[(v + 1) * _width + u] - vertex);
+				if (!normal.allFinite() || normal.squaredNorm() == 0)
+					continue;
+				normal.normalize();
+				_normals[v * _width + u] = normal.dot(vertex) > 0 ? -normal : normal;
+			}
+		}
+	});
+}
+
+//		Coarse to fine on strided pixels (the GPU uses a depth pyramid), 4, 5 and 10 iterations
+bool CpuKinfuTracker::EstimatePose(const CpuCameraIntrinsics& intrinsics, Matrix3frm& rotation, Eigen::Vector3f& translation)
+{
+	typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+	typedef Eigen::Matrix<double, 6, 1> Vector6d;
+	const int strides[LEVELS] = { 1, 2, 4 };
+	const int iterations[LEVELS] = { 10, 5, 4 };
+
+	Matrix3frm previousRotation = _rotations[_time - 1];
+	Eigen::Vector3f previousTranslation = _translations[_time - 1];
+	Eigen::Matrix3f previousRotationInverse = previousRotation.transpose();
+	rotation = previousRotation;
+	translation = previousTranslation;
+	unsigned int numberOfThreads = CpuThreadCount(_numberOfThreads);
+
+	for (int level = LEVELS - 1; level >= 0; level--)
+	{
+		int stride = strides[level];
+		int rows = (_height + stride - 1) / stride;
+		for (int iteration = 0; iteration < iterations[level]; iteration++)
+		{
+			Eigen::Matrix3f currentRotation = rotation;
+			std::vector<Matrix6d> threadA(numberOfThreads, Matrix6d::Zero());
+			std::vector<Vector6d> threadB(numberOfThreads, Vector6d::Zero());
+			CpuParallelFor(rows, 4, numberOfThreads, [&](int begin, int end, unsigned int thread)
+			{
+				Matrix6d& A = threadA[thread];
+				Vector6d& b = threadB[thread];
+				for (int row = begin; row < end; row++)
+				{
+					int v = row * stride;
+					for (int u = 0; u < _width; u += stride)
+					{
+						const Eigen::Vector3f& normal = _normals[v * _width + u];
+						if (!normal.allFinite())
+							continue;
+						Eigen::Vector3f vertexGlobal = currentRotation * _vertices[v * _width + u] + translation;
+						Eigen::Vector3f normalGlobal = currentRotation * normal;
+						//		Projective association in the previous frame
+						Eigen::Vector3f previous = previousRotationInverse * (vertexGlobal - previousTranslation);
+						if (previous.z() <= 0)
+							continue;
+						int modelU = (int)std::floor(intrinsics.fx * previous.x() / previous.z() + intrinsics.cx + 0.5f);
+						int modelV = (int)std::floor(intrinsics.fy * previous.y() / previous.z() + intrinsics.cy + 0.5f);
+						if (modelU < 0 || modelV < 0 || modelU >= _width || modelV >= _height)
+							continue;
+						const Eigen::Vector3f& modelVertex = _modelVertices[modelV * _width + modelU];
+						const Eigen::Vector3f& modelNormal = _modelNormals[modelV * _width + modelU];
+						if (!modelVertex.allFinite() || !modelNormal.allFinite())
+							continue;
+						if ((modelVertex - vertexGlobal).norm() > _distanceThreshold || normalGlobal.cross(modelNormal).norm() >= _angleThreshold)
+							continue;
+						Vector6d jacobian;
+						jacobian.head<3>() = vertexGlobal.cross(modelNormal).cast<double>();
+						jacobian.tail<3>() = modelNormal.cast<double>();
+						double residual = modelNormal.dot(modelVertex - vertexGlobal);
+						A.noalias() += jacobian * jacobian.transpose();
+						b += jacobian * residual;
+					}
+				}
+			});
+			Matrix6d A = Matrix6d::Zero();
+			Vector6d b = Vector6d::Zero();
+			for (unsigned int thread = 0; thread < numberOfThreads; thread++)
+			{
+				A += threadA[thread];
+				b += threadB[thread];
+			}
+
+			//		Degenerate system : tracking is lost
+			double determinant = A.determinant();
+			if (std::fabs(determinant) < 1e-15 || determinant != determinant)
+				return false;
+			Eigen::Matrix<float, 6, 1> result = A.llt().solve(b).cast<float>();
+			Eigen::Matrix3f incrementRotation = (Eigen::Matrix3f)(Eigen::AngleAxisf(result(2), Eigen::Vector3f::UnitZ()) * Eigen::AngleAxisf(result(1), Eigen::Vector3f::UnitY()) * Eigen::AngleAxisf(result(0), Eigen::Vector3f::UnitX()));
+			translation = incrementRotation * translation + result.tail<3>();
+			rotation = incrementRotation * currentRotation;
+		}
+	}
+	return true;
+}
+
+Eigen::Affine3f CpuKinfuTracker::GetCameraPose()
+{
+	Eigen::Affine3f pose;
+	pose.linear() = GetR();
+	pose.translation() = GetT();
+	return pose;
+}
+
+CpuKinfuTracker::Matrix3frm CpuKinfuTracker::GetR()
+{
+	return _rotations[std::max(0, std::min(_time, (int)_rotations.size()) - 1)];
+}
+
+Eigen::Vector3f CpuKinfuTracker::GetT()
+{
+	return _translations[std::max(0, std::min(_time, (int)_translations.size()) - 1)];
+}
+
+int CpuKinfuTracker::GetNumberOfFrames()
+{
+	return _time;
+}
+
+CpuTsdfVolume& CpuKinfuTracker::GetVolume()
+{
+	return _volume;
+}
@@ -0,0 +1,70 @@
+#ifndef CPU_KINFU_TRACKER
+#define CPU_KINFU_TRACKER
+
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "kinfuApp/CpuTsdfVolume.h"
+
+//		*****************************************************************
+//				CPU Kinfu Tracker
+//				Stand-in for pcl::gpu::KinfuTracker : projective point-to-plane ICP
+//				against the raycast of the previous pose, then TSDF integration.
+//				Without ICP the poses given by SetPoses are used frame by frame.
+//		*****************************************************************
+class CpuKinfuTracker
+{
+public:
+	typedef Eigen::Matrix<float, 3, 3, Eigen::RowMajor> Matrix3frm;
+	enum { LEVELS = 3 };
+
+	CpuKinfuTracker(float volumeSize = 3.0f, int resolution = 256);
+	void SetDepthIntrinsics(float fx, float fy, float cx = -1, float cy = -1);
+	void GetDepthIntrinsics(float& fx, float& fy, float& cx, float& cy);
+	void SetInitialCameraPose(const Eigen::Affine3f& pose);
+	void SetIcpCorrespondenceFilteringParams(float distanceThreshold, float sineOfAngleThreshold);
+	void SetTruncationDistance(float truncationDistance);
+	void SetIcp(bool isEnabled);
+	void SetPoses(const std::vector<Matrix3frm>& rotations, const std::vector<Eigen::Vector3f>& translations);
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+	void Reset();
+	//		false on the first frame and when tracking is lost (the volume is reset), as the GPU tracker
+	bool Process(const CpuDepthFrame& frame);
+
+	Eigen::Affine3f GetCameraPose();
+	Matrix3frm GetR();
+	Eigen::Vector3f GetT();
+	int GetNumberOfFrames();
+	CpuTsdfVolume& GetVolume();
+
+private:
+	CpuCameraIntrinsics GetIntrinsics(const CpuDepthFrame& frame);
+	void CreateMaps(const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics);
+	bool EstimatePose(const CpuCameraIntrinsics& intrinsics, Matrix3frm& rotation, Eigen::Vector3f& translation);
+
+	CpuTsdfVolume _volume;
+	float _fx;
+	float _fy;
+	float _cx;
+	float _cy;
+	float _distanceThreshold;
+	float _angleThreshold;
+	bool _isIcpEnabled;
+	unsigned int _numberOfThreads;
+	int _time;
+
+	Matrix3frm _initialRotation;
+	Eigen::Vector3f _initialTranslation;
+	std::vector<Matrix3frm> _rotations;
+	std::vector<Eigen::Vector3f> _translations;
+
+	//		current frame (camera coordinates) and the model raycast at the previous pose (volume coordinates)
+	std::vector<Eigen::Vector3f> _vertices;
+	std::vector<Eigen::Vector3f> _normals;
+	std::vector<Eigen::Vector3f> _modelVertices;
+	std::vector<Eigen::Vector3f> _modelNormals;
+	int _width;
+	int _height;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef CPU_PARALLEL_FOR
+#define CPU_PARALLEL_FOR
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//		0 means one thread per core
+inline unsigned int CpuThreadCount(unsigned int numberOfThreads)
+{
+	if (numberOfThreads == 0)
+		numberOfThreads = std::thread::hardware_concurrency();
+	return std::max(1u, numberOfThreads);
+}
+
+//		Runs body(begin, end, thread) over [0, count) in chunks of "grain" items.
+//		Chunks are handed out dynamically, "thread" indexes per thread accumulators.
+inline void CpuParallelFor(int count, int grain, unsigned int numberOfThreads, const std::function<void(int, int, unsigned int)>& body)
+{
+	if (count <= 0)
+		return;
+	grain = std::max(1, grain);
+	int numberOfChunks = (count + grain - 1) / grain;
+	numberOfThreads = std::min<unsigned int>(CpuThreadCount(numberOfThreads), numberOfChunks);
+	std::atomic<int> next(0);
+	auto worker = [&](unsigned int thread)
+	{
+		for (int chunk = next++; chunk < numberOfChunks; chunk = next++)
+			body(chunk * grain, std::min(count, (chunk + 1) * grain), thread);
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int counter = 1; counter < numberOfThreads; counter++)
+		threads.push_back(std::thread(worker, counter));
+	worker(0);
+	for (std::size_t counter = 0; counter < threads.size(); counter++)
+		threads[counter].join();
+}
+
+#endif
@@ -0,0 +1,456 @@
+#include "CpuTsdfVolume.h"
+
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <pcl/conversions.h>
+#include <pcl/surface/marching_cubes.h>
+#include "kinfuApp/CpuParallelFor.h"
+
+CpuTsdfVolume::CpuTsdfVolume(float volumeSize, float voxelSize, float truncationDistance)
+{
+	_volumeSize = volumeSize;
+	_voxelSize = voxelSize;
+	_truncationDistance = truncationDistance;
+	_resolution = (int)std::ceil(volumeSize / voxelSize);
+	_numberOfThreads = 0;
+}
+
+void CpuTsdfVolume::Reset()
+{
+	_blockIndices.clear();
+	_blockPositions.clear();
+	_blocks.clear();
+}
+
+void CpuTsdfVolume::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	_numberOfThreads = numberOfThreads;
+}
+
+void CpuTsdfVolume::SetTruncationDistance(float truncationDistance)
+{
+	_truncationDistance = truncationDistance;
+}
+
+//		*****************************************************************
+//				Integration
+//		*****************************************************************
+
+void CpuTsdfVolume::Integrate(const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& pose)
+{
+	unsigned int numberOfThreads = CpuThreadCount(_numberOfThreads);
+	float blockExtent = BLOCK_SIZE * _voxelSize;
+
+	//		Blocks crossed by the truncation band of every depth pixel, gathered per thread
+	std::vector<std::unordered_set<BlockKey> > touched(numberOfThreads);
+	CpuParallelFor(frame.height, 4, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int v = begin; v < end; v++)
+		{
+			for (int u = 0; u < frame.width; u++)
+			{
+				float depth = frame.depth[v * frame.width + u];
+				if (!(depth > 0))
+					continue;
+				Eigen::Vector3f ray((u - intrinsics.cx) / intrinsics.fx, (v - intrinsics.cy) / intrinsics.fy, 1);
+				float step = blockExtent * 0.5f / ray.norm();
+				for (float z = std::max(depth - _truncationDistance, step); z <= depth + _truncationDistance + step; z += step)
+				{
+					Eigen::Vector3f point = pose * (ray * z);
+					Eigen::Vector3i voxel = (point / _voxelSize).array().floor().cast<int>();
+					if ((voxel.array() < 0).any() || (voxel.array() >= _resolution).any())
+						continue;
+					touched[thread].insert(GetBlockKey(voxel.x() / BLOCK_SIZE, voxel.y() / BLOCK_SIZE, voxel.z() / BLOCK_SIZE));
+				}
+			}
+		}
+	});
+
+	//		Allocation is the only serial part, the hash map is not touched afterwards
+	CpuTsdfVoxel empty = { 1.0f, 0.0f, 0, 0, 0 };
+	std::vector<char> isVisible(_blocks.size(), 0);
+	std::vector<int> visible;
+	for (unsigned int thread = 0; thread < numberOfThreads; thread++)
+	{
+		for (std::unordered_set<BlockKey>::const_iterator it = touched[thread].begin(); it != touched[thread].end(); ++it)
+		{
+			std::unordered_map<BlockKey, int>::iterator found = _blockIndices.find(*it);
+			int index;
+			if (found == _blockIndices.end())
+			{
+				index = (int)_blocks.size();
+				_blockIndices[*it] = index;
+				long long key = *it;
+				_blockPositions.push_back(Eigen::Vector3i((int)((key >> 42) & 0x1FFFFF), (int)((key >> 21) & 0x1FFFFF), (int)(key & 0x1FFFFF)));
+				_blocks.push_back(std::vector<CpuTsdfVoxel>(BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE, empty));
+				isVisible.push_back(0);
+			}
+			else
+				index = found->second;
+			if (!isVisible[index])
+			{
+				isVisible[index] = 1;
+				visible.push_back(index);
+			}
+		}
+	}
+
+	Eigen::Affine3f inversePose = pose.inverse(Eigen::Isometry);
+	CpuParallelFor((int)visible.size(), 8, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int counter = begin; counter < end; counter++)
+			UpdateBlock(visible[counter], frame, intrinsics, inversePose);
+	});
+}
+
+void CpuTsdfVolume::UpdateBlock(int blockIndex, const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& inversePose)
+{
+	std::vector<CpuTsdfVoxel>& block = _blocks[blockIndex];
+	Eigen::Vector3i origin = _blockPositions[blockIndex] * (int)BLOCK_SIZE;
+	bool hasColor = !frame.rgb.empty();
+	for (int z = 0; z < BLOCK_SIZE; z++)
+	{
+		for (int y = 0; y < BLOCK_SIZE; y++)
+		{
+			for (int x = 0; x < BLOCK_SIZE; x++)
+			{
+				Eigen::Vector3i index = origin + Eigen::Vector3i(x, y, z);
+				if ((index.array() >= _resolution).any())
+					continue;
+				Eigen::Vector3f center = (index.cast<float>().array() + 0.5f) * _voxelSize;
+				Eigen::Vector3f point = inversePose * center;
+				if (point.z() <= 0)
+					continue;
+				int u = (int)std::floor(intrinsics.fx * point.x() / point.z() + intrinsics.cx + 0.5f);
+				int v = (int)std::floor(intrinsics.fy * point.y() / point.z() + intrinsics.cy + 0.5f);
+				if (u < 0 || v < 0 || u >= frame.width || v >= frame.height)
+					continue;
+				int pixel = v * frame.width + u;
+				float depth = frame.depth[pixel];
+				if (!(depth > 0))
+					continue;
+				float sdf = depth - point.z();
+				if (sdf < -_truncationDistance)
+					continue;
+				float tsdf = std::min(1.0f, sdf / _truncationDistance);
+
+				CpuTsdfVoxel& voxel = block[x + BLOCK_SIZE * (y + BLOCK_SIZE * z)];
+				float weight = voxel.weight;
+				voxel.tsdf = (voxel.tsdf * weight + tsdf) / (weight + 1);
+				if (hasColor && std::fabs(sdf) < _truncationDistance)
+				{
+					const unsigned char* rgb = &frame.rgb[3 * pixel];
+					voxel.r = (unsigned char)((voxel.r * weight + rgb[0]) / (weight + 1) + 0.5f);
+					voxel.g = (unsigned char)((voxel.g * weight + rgb[1]) / (weight + 1) + 0.5f);
+					voxel.b = (unsigned char)((voxel.b * weight + rgb[2]) / (weight + 1) + 0.5f);
+				}
+				voxel.weight = std::min(weight + 1, (float)MAX_WEIGHT);
+			}
+		}
+	}
+}
+
+//		*****************************************************************
+//				Raycast
+//		*****************************************************************
+
+void CpuTsdfVolume::Raycast(const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& pose, int width, int height, std::vector<Eigen::Vector3f>& vertices, std::vector<Eigen::Vector3f>& normals) const
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	vertices.assign(width * height, Eigen::Vector3f::Constant(nan));
+	normals.assign(width * height, Eigen::Vector3f::Constant(nan));
+	Eigen::Vector3f origin = pose.translation();
+	Eigen::Matrix3f rotation = pose.linear();
+	float blockExtent = BLOCK_SIZE * _voxelSize;
+
+	CpuParallelFor(height, 4, _numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int v = begin; v < end; v++)
+		{
+			for (int u = 0; u < width; u++)
+			{
+				Eigen::Vector3f direction = rotation * Eigen::Vector3f((u - intrinsics.cx) / intrinsics.fx, (v - intrinsics.cy) / intrinsics.fy, 1).normalized();
+				//		Clip the ray to the volume cube
+				float rayStart = 0;
+				float rayEnd = std::numeric_limits<float>::max();
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (std::fabs(direction(axis)) < 1e-9f)
+					{
+						if (origin(axis) < 0 || origin(axis) > _volumeSize)
+							rayEnd = -1;
+						continue;
+					}
+					float t0 = (0 - origin(axis)) / direction(axis);
+					float t1 = (_volumeSize - origin(axis)) / direction(axis);
+					rayStart = std::max(rayStart, std::min(t0, t1));
+					rayEnd = std::min(rayEnd, std::max(t0, t1));
+				}
+
+				float previousT = 0;
+				float previousTsdf = 0;
+				bool hasPrevious = false;
+				for (float t = rayStart + _voxelSize; t < rayEnd; )
+				{
+					Eigen::Vector3f point = origin + direction * t;
+					Eigen::Vector3i index = (point / _voxelSize).array().floor().cast<int>();
+					int block = FindBlock(index.x() / BLOCK_SIZE, index.y() / BLOCK_SIZE, index.z() / BLOCK_SIZE);
+					if ((index.array() < 0).any() || block < 0)
+					{
+						//		Empty space, jump half a block
+						hasPrevious = false;
+						t += blockExtent * 0.5f;
+						continue;
+					}
+					Eigen::Vector3i local = index - _blockPositions[block] * (int)BLOCK_SIZE;
+					const CpuTsdfVoxel& voxel = _blocks[block][local.x() + BLOCK_SIZE * (local.y() + BLOCK_SIZE * local.z())];
+					if (voxel.weight == 0)
+					{
+						hasPrevious = false;
+						t += _voxelSize;
+						continue;
+					}
+					float tsdf = voxel.tsdf;
+					if (hasPrevious && previousTsdf < 0 && tsdf > 0)
+						break;		//	back face
+					if (hasPrevious && previousTsdf > 0 && tsdf < 0)
+					{
+						float previousInterpolated;
+						float interpolated;
+						if (GetInterpolatedTsdf(origin + direction * previousT, previousInterpolated) && GetInterpolatedTsdf(point, interpolated) && previousInterpolated != interpolated)
+						{
+							previousTsdf = previousInterpolated;
+							tsdf = interpolated;
+						}
+						float hit = previousT + (t - previousT) * previousTsdf / (previousTsdf - tsdf);
+						Eigen::Vector3f vertex = origin + direction * hit;
+						Eigen::Vector3f gradient;
+						int pixel = v * width + u;
+						vertices[pixel] = vertex;
+						if (GetGradient(vertex, gradient))
+							normals[pixel] = gradient.normalized();
+						break;
+					}
+					previousT = t;
+					previousTsdf = tsdf;
+					hasPrevious = true;
+					t += tsdf > 0 ? std::max(_voxelSize, tsdf * _truncationDistance * 0.8f) : _voxelSize;
+				}
+			}
+		}
+	});
+}
+
+//		*****************************************************************
+//				Extraction
+//		*****************************************************************
+
+//		Zero crossings towards the +x, +y and +z neighbours (like TsdfVolume::fetchCloudHost, connected 6)
+void CpuTsdfVolume::ExtractPointCloud(pcl::PointCloud<PointT>& cloud) const
+{
+	std::vector<std::vector<PointT> > blockPoints(_blocks.size());
+	CpuParallelFor((int)_blocks.size(), 16, _numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int blockIndex = begin; blockIndex < end; blockIndex++)
+		{
+			Eigen::Vector3i origin = _blockPositions[blockIndex] * (int)BLOCK_SIZE;
+			for (int voxelIndex = 0; voxelIndex < BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE; voxelIndex++)
+			{
+				const CpuTsdfVoxel& voxel = _blocks[blockIndex][voxelIndex];
+				if (voxel.weight == 0)
+					continue;
+				Eigen::Vector3i index = origin + Eigen::Vector3i(voxelIndex % BLOCK_SIZE, (voxelIndex / BLOCK_SIZE) % BLOCK_SIZE, voxelIndex / (BLOCK_SIZE * BLOCK_SIZE));
+				for (int axis = 0; axis < 3; axis++)
+				{
+					Eigen::Vector3i neighbourIndex = index;
+					neighbourIndex(axis)++;
+					const CpuTsdfVoxel* neighbour = FindVoxel(neighbourIndex.x(), neighbourIndex.y(), neighbourIndex.z());
+					if (neighbour == NULL || !((voxel.tsdf > 0 && neighbour->tsdf < 0) || (voxel.tsdf < 0 && neighbour->tsdf > 0)))
+						continue;
+					float a = std::fabs(voxel.tsdf);
+					float b = std::fabs(neighbour->tsdf);
+					float t = a / (a + b);
+					Eigen::Vector3f position = ((index.cast<float>() + Eigen::Vector3f::Constant(0.5f)) * (1 - t) + (neighbourIndex.cast<float>() + Eigen::Vector3f::Constant(0.5f)) * t) * _voxelSize;
+					PointT point;
+					point.x = position.x();
+					point.y = position.y();
+					point.z = position.z();
+					point.r = (unsigned char)(voxel.r * (1 - t) + neighbour->r * t + 0.5f);
+					point.g = (unsigned char)(voxel.g * (1 - t) + neighbour->g * t + 0.5f);
+					point.b = (unsigned char)(voxel.b * (1 - t) + neighbour->b * t + 0.5f);
+					blockPoints[blockIndex].push_back(point);
+				}
+			}
+		}
+	});
+	cloud.clear();
+	for (std::size_t counter = 0; counter < blockPoints.size(); counter++)
+		cloud.points.insert(cloud.points.end(), blockPoints[counter].begin(), blockPoints[counter].end());
+	cloud.width = (int)cloud.points.size();
+	cloud.height = 1;
+	cloud.is_dense = true;
+}
+
+//		Marching cubes over the allocated blocks, each cube belongs to the block of its first corner
+void CpuTsdfVolume::ExtractMesh(pcl::PolygonMesh& mesh) const
+{
+	static const int corners[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+	static const int edges[12][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+	std::vector<std::vector<PointT> > blockVertices(_blocks.size());
+	CpuParallelFor((int)_blocks.size(), 16, _numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int blockIndex = begin; blockIndex < end; blockIndex++)
+		{
+			Eigen::Vector3i origin = _blockPositions[blockIndex] * (int)BLOCK_SIZE;
+			for (int voxelIndex = 0; voxelIndex < BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE; voxelIndex++)
+			{
+				Eigen::Vector3i index = origin + Eigen::Vector3i(voxelIndex % BLOCK_SIZE, (voxelIndex / BLOCK_SIZE) % BLOCK_SIZE, voxelIndex / (BLOCK_SIZE * BLOCK_SIZE));
+				const CpuTsdfVoxel* cube[8];
+				int cubeIndex = 0;
+				bool isValid = true;
+				for (int corner = 0; corner < 8 && isValid; corner++)
+				{
+					cube[corner] = FindVoxel(index.x() + corners[corner][0], index.y() + corners[corner][1], index.z() + corners[corner][2]);
+					//		Truncated corners are far from any surface, a sign change there is not a crossing
+					isValid = cube[corner] != NULL && std::fabs(cube[corner]->tsdf) < 0.999f;
+					if (isValid && cube[corner]->tsdf < 0)
+						cubeIndex |= 1 << corner;
+				}
+				if (!isValid || pcl::edgeTable[cubeIndex] == 0)
+					continue;
+
+				PointT edgePoints[12];
+				for (int edge = 0; edge < 12; edge++)
+				{
+					if (!(pcl::edgeTable[cubeIndex] & (1 << edge)))
+						continue;
+					const CpuTsdfVoxel& a = *cube[edges[edge][0]];
+					const CpuTsdfVoxel& b = *cube[edges[edge][1]];
+					float t = a.tsdf / (a.tsdf - b.tsdf);
+					Eigen::Vector3f from(corners[edges[edge][0]][0], corners[edges[edge][0]][1], corners[edges[edge][0]][2]);
+					Eigen::Vector3f to(corners[edges[edge][1]][0], corners[edges[edge][1]][1], corners[edges[edge][1]][2]);
+					Eigen::Vector3f position = (index.cast<float>() + Eigen::Vector3f::Constant(0.5f) + from + (to - from) * t) * _voxelSize;
+					PointT& point = edgePoints[edge];
+					point.x = position.x();
+					point.y = position.y();
+					point.z = position.z();
+					point.r = (unsigned char)(a.r * (1 - t) + b.r * t + 0.5f);
+					point.g = (unsigned char)(a.g * (1 - t) + b.g * t + 0.5f);
+					point.b = (unsigned char)(a.b * (1 - t) + b.b * t + 0.5f);
+				}
+				//		Negative corners set the bits, so the table winding faces inside : flipped
+				for (int counter = 0; pcl::triTable[cubeIndex][counter] != -1; counter += 3)
+				{
+					blockVertices[blockIndex].push_back(edgePoints[pcl::triTable[cubeIndex][counter]]);
+					blockVertices[blockIndex].push_back(edgePoints[pcl::triTable[cubeIndex][counter + 2]]);
+					blockVertices[blockIndex].push_back(edgePoints[pcl::triTable[cubeIndex][counter + 1]]);
+				}
+			}
+		}
+	});
+
+	//		Triangle soup, three consecutive vertices per polygon (as the GPU marching cubes)
+	pcl::PointCloud<PointT> vertices;
+	for (std::size_t counter = 0; counter < blockVertices.size(); counter++)
+		vertices.points.insert(vertices.points.end(), blockVertices[counter].begin(), blockVertices[counter].end());
+	vertices.width = (int)vertices.points.size();
+	vertices.height = 1;
+	vertices.is_dense = true;
+	pcl::toPCLPointCloud2(vertices, mesh.cloud);
+	mesh.polygons.resize(vertices.size() / 3);
+	for (std::size_t counter = 0; counter < mesh.polygons.size(); counter++)
+	{
+		mesh.polygons[counter].vertices.resize(3);
+		for (int corner = 0; corner < 3; corner++)
+			mesh.polygons[counter].vertices[corner] = (uint32_t)(counter * 3 + corner);
+	}
+}
+
+//		*****************************************************************
+//				Lookup
+//		*****************************************************************
+
+CpuTsdfVolume::BlockKey CpuTsdfVolume::GetBlockKey(int x, int y, int z)
+{
+	return ((BlockKey)(x & 0x1FFFFF) << 42) | ((BlockKey)(y & 0x1FFFFF) << 21) | (BlockKey)(z & 0x1FFFFF);
+}
+
+int CpuTsdfVolume::FindBlock(int x, int y, int z) const
+{
+	std::unordered_map<BlockKey, int>::const_iterator found = _blockIndices.find(GetBlockKey(x, y, z));
+	return found == _blockIndices.end() ? -1 : found->second;
+}
+
+//		NULL outside the cube, in unallocated blocks and for voxels never observed
+const CpuTsdfVoxel* CpuTsdfVolume::FindVoxel(int x, int y, int z) const
+{
+	if (x < 0 || y < 0 || z < 0 || x >= _resolution || y >= _resolution || z >= _resolution)
+		return NULL;
+	int block = FindBlock(x / BLOCK_SIZE, y / BLOCK_SIZE, z / BLOCK_SIZE);
+	if (block < 0)
+		return NULL;
+	const CpuTsdfVoxel& voxel = _blocks[block][x % BLOCK_SIZE + BLOCK_SIZE * (y % BLOCK_SIZE + BLOCK_SIZE * (z % BLOCK_SIZE))];
+	return voxel.weight > 0 ? &voxel : NULL;
+}
+
+bool CpuTsdfVolume::GetInterpolatedTsdf(const Eigen::Vector3f& point, float& tsdf) const
+{
+	Eigen::Vector3f grid = point / _voxelSize - Eigen::Vector3f::Constant(0.5f);
+	Eigen::Vector3f base = grid.array().floor();
+	Eigen::Vector3f fraction = grid - base;
+	Eigen::Vector3i index = base.cast<int>();
+	tsdf = 0;
+	for (int corner = 0; corner < 8; corner++)
+	{
+		int dx = corner & 1;
+		int dy = (corner >> 1) & 1;
+		int dz = (corner >> 2) & 1;
+		const CpuTsdfVoxel* voxel = FindVoxel(index.x() + dx, index.y() + dy, index.z() + dz);
+		if (voxel == NULL)
+			return false;
+		tsdf += voxel->tsdf * (dx ? fraction.x() : 1 - fraction.x()) * (dy ? fraction.y() : 1 - fraction.y()) * (dz ? fraction.z() : 1 - fraction.z());
+	}
+	return true;
+}
+
+bool CpuTsdfVolume::GetGradient(const Eigen::Vector3f& point, Eigen::Vector3f& gradient) const
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		Eigen::Vector3f offset = Eigen::Vector3f::Zero();
+		offset(axis) = _voxelSize;
+		float plus;
+		float minus;
+		if (!GetInterpolatedTsdf(point + offset, plus) || !GetInterpolatedTsdf(point - offset, minus))
+			return false;
+		gradient(axis) = plus - minus;
+	}
+	return gradient.squaredNorm() > 0;
+}
+
+float CpuTsdfVolume::GetVolumeSize() const
+{
+	return _volumeSize;
+}
+
+float CpuTsdfVolume::GetVoxelSize() const
+{
+	return _voxelSize;
+}
+
+float CpuTsdfVolume::GetTruncationDistance() const
+{
+	return _truncationDistance;
+}
+
+std::size_t CpuTsdfVolume::GetNumberOfBlocks() const
+{
+	return _blocks.size();
+}
+
+std::size_t CpuTsdfVolume::GetBytes() const
+{
+	return _blocks.size() * (BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE * sizeof(CpuTsdfVoxel) + sizeof(Eigen::Vector3i) + sizeof(BlockKey) + sizeof(int));
+}
@@ -0,0 +1,87 @@
+#ifndef CPU_TSDF_VOLUME
+#define CPU_TSDF_VOLUME
+
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <pcl/PolygonMesh.h>
+#include "Typedef.h"
+
+struct CpuCameraIntrinsics
+{
+	float fx;
+	float fy;
+	float cx;
+	float cy;
+};
+
+//		An organized depth image, depth in meters (0 when invalid) and 3 bytes of rgb per pixel
+struct CpuDepthFrame
+{
+	int width;
+	int height;
+	std::vector<float> depth;
+	std::vector<unsigned char> rgb;
+};
+
+struct CpuTsdfVoxel
+{
+	float tsdf;
+	float weight;
+	unsigned char r;
+	unsigned char g;
+	unsigned char b;
+};
+
+//		*****************************************************************
+//				CPU TSDF Volume
+//				Same cube as pcl::gpu::TsdfVolume (origin at the corner, voxel
+//				centers at (i + 0.5) * voxelSize), but only the 8x8x8 voxel blocks
+//				near an observed surface are allocated, found through a hash map.
+//				Integrate, Raycast and the extractions run on a thread pool.
+//		*****************************************************************
+class CpuTsdfVolume
+{
+public:
+	enum { BLOCK_SIZE = 8, MAX_WEIGHT = 128 };
+
+	CpuTsdfVolume(float volumeSize, float voxelSize, float truncationDistance);
+	void Reset();
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+	void SetTruncationDistance(float truncationDistance);
+	//		pose : camera -> volume
+	void Integrate(const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& pose);
+	//		vertices and normals in volume coordinates, NaN where the ray hits nothing
+	void Raycast(const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& pose, int width, int height, std::vector<Eigen::Vector3f>& vertices, std::vector<Eigen::Vector3f>& normals) const;
+	void ExtractPointCloud(pcl::PointCloud<PointT>& cloud) const;
+	void ExtractMesh(pcl::PolygonMesh& mesh) const;
+
+	float GetVolumeSize() const;
+	float GetVoxelSize() const;
+	float GetTruncationDistance() const;
+	std::size_t GetNumberOfBlocks() const;
+	std::size_t GetBytes() const;
+
+private:
+	typedef long long BlockKey;
+
+	static BlockKey GetBlockKey(int x, int y, int z);
+	int FindBlock(int x, int y, int z) const;
+	const CpuTsdfVoxel* FindVoxel(int x, int y, int z) const;
+	bool GetInterpolatedTsdf(const Eigen::Vector3f& point, float& tsdf) const;
+	bool GetGradient(const Eigen::Vector3f& point, Eigen::Vector3f& gradient) const;
+	void UpdateBlock(int blockIndex, const CpuDepthFrame& frame, const CpuCameraIntrinsics& intrinsics, const Eigen::Affine3f& inversePose);
+
+	float _volumeSize;
+	float _voxelSize;
+	float _truncationDistance;
+	int _resolution;
+	unsigned int _numberOfThreads;
+
+	std::unordered_map<BlockKey, int> _blockIndices;
+	std::vector<Eigen::Vector3i> _blockPositions;
+	std::vector<std::vector<CpuTsdfVoxel> > _blocks;
+};
+
+#endif
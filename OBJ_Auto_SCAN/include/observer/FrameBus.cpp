@@ -0,0 +1,238 @@
+#include "observer/FrameBus.h"
+#include "observer/Subject.h"
+#include "trace/Tracer.h"
+
+#include <algorithm>
+
+//		*****************************************************************
+//				Subscriber
+//				Slots are only ever exchanged, so a frame is owned by exactly one
+//				side: the ring, the worker (delivering) or the producer (dropping)
+//		*****************************************************************
+
+FrameBus::Subscriber::Subscriber(IObserver* observer, OverflowPolicy policy, std::size_t capacity) : observer(observer), policy(policy), slots(capacity)
+{
+	for (std::size_t counter = 0; counter < slots.size(); counter++)
+		slots[counter].store(NULL);
+	writeCursor.store(0);
+	readCursor.store(0);
+	published.store(0);
+	delivered.store(0);
+	dropped.store(0);
+	isWaiting.store(false);
+	isStopped.store(false);
+	worker = std::thread(&FrameBus::Subscriber::Run, this);
+}
+
+FrameBus::Subscriber::~Subscriber()
+{
+	isStopped.store(true);
+	{
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		wakeCondition.notify_one();
+	}
+	if (worker.joinable())
+		worker.join();
+	for (std::size_t counter = 0; counter < slots.size(); counter++)
+		delete slots[counter].exchange(NULL);
+}
+
+void FrameBus::Subscriber::Run()
+{
+	while (!isStopped.load())
+	{
+		Frame* frame = Take();
+		if (frame == NULL)
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			isWaiting.store(true);
+			wakeCondition.wait_for(lock, std::chrono::milliseconds(20), [this]()
+			{
+				return isStopped.load() || readCursor.load() < writeCursor.load();
+			});
+			isWaiting.store(false);
+			continue;
+		}
+		{
+			TRACE_SCOPE("IObserver::Update", "observer");
+			observer->Update(frame->pointCloud);
+		}
+		delivered++;
+		delete frame;
+	}
+}
+
+//		The cursor only moves forward : an empty slot was taken through an earlier lap and is
+//		stepped over, a frame older than the cursor was overtaken and is dropped, so frames are
+//		delivered in order and NULL is only returned once the ring is drained
+FrameBus::Frame* FrameBus::Subscriber::Take()
+{
+	while (true)
+	{
+		unsigned long long read = readCursor.load();
+		if (read >= writeCursor.load())
+			return NULL;
+		Frame* frame = slots[read % slots.size()].exchange(NULL);
+		if (frame == NULL)
+		{
+			readCursor.store(read + 1);
+			continue;
+		}
+		if (frame->sequence < read)
+		{
+			dropped++;
+			TRACE_COUNT("FrameBus dropped frames", "observer", 1);
+			delete frame;
+			readCursor.store(read + 1);
+			continue;
+		}
+		//		The producer may have lapped this slot (DropOldest), skip ahead to the frame we got
+		readCursor.store(std::max(read, frame->sequence) + 1);
+		return frame;
+	}
+}
+
+void FrameBus::Subscriber::Wake()
+{
+	if (!isWaiting.load())
+		return;
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	wakeCondition.notify_one();
+}
+
+//		*****************************************************************
+//				Frame Bus
+//		*****************************************************************
+
+FrameBus::FrameBus()
+{
+	for (int counter = 0; counter < FRAME_BUS_MAX_SUBSCRIBERS; counter++)
+		_subscribers[counter] = NULL;
+	_subscriberCount.store(0);
+	_publishers.store(0);
+	_isStopped.store(false);
+}
+
+FrameBus::~FrameBus()
+{
+	Stop();
+}
+
+int FrameBus::Subscribe(IObserver* observer, OverflowPolicy policy, std::size_t capacity)
+{
+	if (_isStopped.load())
+		throw std::string("FrameBus: Bus is stopped");
+	int id = _subscriberCount.load();
+	if (id >= FRAME_BUS_MAX_SUBSCRIBERS)
+		throw std::string("FrameBus: Too many subscribers");
+	if (capacity == 0)
+		throw std::string("FrameBus: Capacity must be positive");
+	_subscribers[id] = new Subscriber(observer, policy, capacity);
+	_subscriberCount.store(id + 1);
+	return id;
+}
+
+void FrameBus::Publish(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	TRACE_SCOPE("FrameBus::Publish", "observer");
+	//		Stop waits for the publishers counted here before it frees the subscribers
+	_publishers++;
+	if (!_isStopped.load())
+	{
+		int count = _subscriberCount.load();
+		for (int counter = 0; counter < count; counter++)
+			Push(_subscribers[counter], pointCloud);
+	}
+	_publishers--;
+}
+
+void FrameBus::Push(Subscriber* subscriber, pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	subscriber->published++;
+	unsigned long long write = subscriber->writeCursor.load();
+	std::atomic<Frame*>& slot = subscriber->slots[write % subscriber->slots.size()];
+	if (subscriber->policy == OverflowPolicy::DropNewest && slot.load() != NULL)
+	{
+		subscriber->dropped++;
+		TRACE_COUNT("FrameBus dropped frames", "observer", 1);
+		return;
+	}
+	if (subscriber->policy == OverflowPolicy::Block)
+	{
+		while (slot.load() != NULL)
+		{
+			if (subscriber->isStopped.load())
+			{
+				subscriber->dropped++;
+				TRACE_COUNT("FrameBus dropped frames", "observer", 1);
+				return;
+			}
+			std::this_thread::yield();
+		}
+	}
+	Frame* frame = new Frame();
+	frame->pointCloud = pointCloud;
+	frame->sequence = write;
+	Frame* oldest = slot.exchange(frame);
+	if (oldest != NULL)
+	{
+		subscriber->dropped++;
+		TRACE_COUNT("FrameBus dropped frames", "observer", 1);
+		delete oldest;
+	}
+	subscriber->writeCursor.store(write + 1);
+	subscriber->Wake();
+}
+
+FrameBusStats FrameBus::GetStats(int subscriberId)
+{
+	FrameBusStats stats = { 0, 0, 0, 0 };
+	if (subscriberId < 0 || subscriberId >= _subscriberCount.load())
+		return stats;
+	Subscriber* subscriber = _subscribers[subscriberId];
+	stats.published = subscriber->published.load();
+	stats.delivered = subscriber->delivered.load();
+	stats.dropped = subscriber->dropped.load();
+	unsigned long long write = subscriber->writeCursor.load();
+	unsigned long long read = subscriber->readCursor.load();
+	stats.lag = write > read ? write - read : 0;
+	return stats;
+}
+
+int FrameBus::GetSubscriberId(IObserver* observer)
+{
+	int count = _subscriberCount.load();
+	for (int counter = 0; counter < count; counter++)
+	{
+		if (_subscribers[counter]->observer == observer)
+			return counter;
+	}
+	return -1;
+}
+
+int FrameBus::GetSubscriberCount()
+{
+	return _subscriberCount.load();
+}
+
+//		New publishers return at once, a publisher blocked on a full ring (Block) is released
+//		by the stopped subscribers, then the workers are joined and everything is freed
+void FrameBus::Stop()
+{
+	if (_isStopped.exchange(true))
+		return;
+	int count = _subscriberCount.load();
+	for (int counter = 0; counter < count; counter++)
+	{
+		_subscribers[counter]->isStopped.store(true);
+		_subscribers[counter]->Wake();
+	}
+	while (_publishers.load() > 0)
+		std::this_thread::yield();
+	_subscriberCount.store(0);
+	for (int counter = 0; counter < count; counter++)
+	{
+		delete _subscribers[counter];
+		_subscribers[counter] = NULL;
+	}
+}
@@ -0,0 +1,91 @@
+#ifndef FRAME_BUS
+#define FRAME_BUS
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Typedef.h"
+
+class IObserver;
+
+#define FRAME_BUS_MAX_SUBSCRIBERS 8
+#define FRAME_BUS_DEFAULT_CAPACITY 4
+
+//		What the producer does when a subscriber's ring is full
+enum class OverflowPolicy
+{
+	DropOldest,			//	overwrite the oldest undelivered frame
+	DropNewest,			//	discard the frame being published
+	Block					//	wait for the subscriber (stalls the grabber)
+};
+
+struct FrameBusStats
+{
+	unsigned long long published;
+	unsigned long long delivered;
+	unsigned long long dropped;
+	unsigned long long lag;				//	frames published but not yet delivered
+};
+
+//		*****************************************************************
+//				Frame Bus
+//				Single producer (grabber thread), many consumers.
+//				Every subscriber owns a ring of atomic slots and a worker thread
+//				calling IObserver::Update, so a slow observer never blocks capture.
+//		*****************************************************************
+class FrameBus
+{
+public:
+	FrameBus();
+	~FrameBus();
+	int Subscribe(IObserver* observer, OverflowPolicy policy = OverflowPolicy::DropOldest, std::size_t capacity = FRAME_BUS_DEFAULT_CAPACITY);
+	void Publish(pcl::PointCloud<PointT>::Ptr pointCloud);
+	FrameBusStats GetStats(int subscriberId);
+	int GetSubscriberId(IObserver* observer);
+	int GetSubscriberCount();
+	void Stop();
+
+private:
+	struct Frame
+	{
+		pcl::PointCloud<PointT>::Ptr pointCloud;
+		unsigned long long sequence;
+	};
+
+	struct Subscriber
+	{
+		Subscriber(IObserver* observer, OverflowPolicy policy, std::size_t capacity);
+		~Subscriber();
+		void Run();
+		Frame* Take();
+		void Wake();
+
+		IObserver* observer;
+		OverflowPolicy policy;
+		std::vector<std::atomic<Frame*> > slots;
+		std::atomic<unsigned long long> writeCursor;			//	written by the producer only
+		std::atomic<unsigned long long> readCursor;			//	written by the worker only
+		std::atomic<unsigned long long> published;
+		std::atomic<unsigned long long> delivered;
+		std::atomic<unsigned long long> dropped;
+		std::atomic<bool> isWaiting;
+		std::atomic<bool> isStopped;
+		std::mutex wakeMutex;
+		std::condition_variable wakeCondition;
+		std::thread worker;
+	};
+
+	FrameBus(const FrameBus&);
+	FrameBus& operator=(const FrameBus&);
+	void Push(Subscriber* subscriber, pcl::PointCloud<PointT>::Ptr pointCloud);
+
+	Subscriber* _subscribers[FRAME_BUS_MAX_SUBSCRIBERS];
+	std::atomic<int> _subscriberCount;
+	std::atomic<int> _publishers;			//	Publish calls in flight
+	std::atomic<bool> _isStopped;
+};
+
+#endif
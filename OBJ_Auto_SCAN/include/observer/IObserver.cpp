@@ -1,30 +1,126 @@
 #include "observer/IObserver.h"
+#include "trace/Tracer.h"
 
 //		*****************************************************************
 //				Observer
-//				UI
+//				UI, Recorder
 //		*****************************************************************
 
 void UIObserver::Update(pcl::PointCloud<PointT>::Ptr pointCloud)
 {
-	emit UIObserver::UpdateViewer(pointCloud);
-	emit UIObserver::KeepFrameArrived(pointCloud);
+	std::unique_lock<std::mutex> lock(_latestMutex);
+	if (_latestFrame != NULL)
+	{
+		_skippedFrames++;
+		TRACE_COUNT("Viewer skipped frames", "viewer", 1);
+	}
+	_latestFrame = pointCloud;
+	if (_keepGovernor == NULL)
+		return;
+	//		A rejected frame is not held at all, so it goes back to the grabber's pool right away
+	bool isAdmitted = _keepGovernor->Admit();
+	if (!isAdmitted || _keepFrame != NULL)
+	{
+		_skippedKeepFrames++;
+		TRACE_COUNT("Keep skipped frames", "viewer", 1);
+	}
+	if (isAdmitted)
+		_keepFrame = pointCloud;
 }
 
-//		*****************************************************************
-//				Subject
-//				Grabber(Flexx, RS)
-//		*****************************************************************
+pcl::PointCloud<PointT>::Ptr UIObserver::TakeLatestFrame()
+{
+	std::unique_lock<std::mutex> lock(_latestMutex);
+	pcl::PointCloud<PointT>::Ptr pointCloud = _latestFrame;
+	_latestFrame.reset();
+	return pointCloud;
+}
+
+unsigned long long UIObserver::GetSkippedFrames()
+{
+	return _skippedFrames;
+}
+
+void UIObserver::StartKeeping(CaptureGovernor* governor)
+{
+	std::unique_lock<std::mutex> lock(_latestMutex);
+	_keepGovernor = governor;
+}
+
+void UIObserver::StopKeeping()
+{
+	std::unique_lock<std::mutex> lock(_latestMutex);
+	_keepGovernor = NULL;
+	_keepFrame.reset();
+}
+
+pcl::PointCloud<PointT>::Ptr UIObserver::TakeKeepFrame()
+{
+	std::unique_lock<std::mutex> lock(_latestMutex);
+	pcl::PointCloud<PointT>::Ptr pointCloud = _keepFrame;
+	_keepFrame.reset();
+	return pointCloud;
+}
 
-void GrabberSubject::RegisterObserver(IObserver* observer)
+unsigned long long UIObserver::GetSkippedKeepFrames()
 {
-	_observers.push_back(observer);
+	return _skippedKeepFrames;
 }
 
-void GrabberSubject::NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud)
+RecorderObserver::RecorderObserver() : _isRecording(false), _turntableAngle(0)
 {
-	for each (IObserver* observer in _observers)
+}
+
+void RecorderObserver::Update(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	if (!_isRecording)
+		return;
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_writer.IsOpen())
+		return;
+	unsigned long long timestamp = pointCloud->header.stamp;
+	if (timestamp == 0)
+		timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	try
+	{
+		_writer.Append(*pointCloud, timestamp, _turntableAngle);
+	}
+	catch (std::string& error)
 	{
-		observer->Update(pointCloud);
+		_error = error;
+		_isRecording = false;
+		_writer.Close();
 	}
+}
+
+void RecorderObserver::StartRecording(std::string path)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_writer.Open(path);
+	_error.clear();
+	_isRecording = true;
+}
+
+ScanLogStats RecorderObserver::StopRecording()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_isRecording = false;
+	_writer.Close();
+	return _writer.GetStats();
+}
+
+bool RecorderObserver::IsRecording()
+{
+	return _isRecording;
+}
+
+void RecorderObserver::SetTurntableAngle(float angle)
+{
+	_turntableAngle = angle;
+}
+
+std::string RecorderObserver::GetError()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _error;
 }
\ No newline at end of file
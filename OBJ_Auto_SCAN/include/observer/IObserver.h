@@ -2,6 +2,9 @@
 #define UI_OBSERVER
 
 #include "ui/MainWindow.h"
+#include "observer/Subject.h"
+#include "grabber/CaptureGovernor.h"
+#include "file/ScanLog.h"
 
 class MainWindow;
 
@@ -10,47 +13,58 @@ class MainWindow;
 //				UI, 
 //		*****************************************************************
 
-class IObserver
-{
-public:
-	virtual void Update(pcl::PointCloud<PointT>::Ptr pointCloud) = 0;
-};
-
+//		The viewer does not get a signal per frame : Update only keeps the newest frame,
+//		the window takes it on its refresh timer. A frame replaced before it was taken
+//		is skipped, so a slow render never queues frames in the event loop.
+//		Keep Continue works the same way : the keep governor is checked here, on the
+//		FrameBus worker, and an admitted frame waits in a second slot for the timer.
 class UIObserver : public QObject, public IObserver
 {
 	Q_OBJECT
 public:
-	UIObserver(MainWindow* window) : _mainWindow(window){}
+	UIObserver(MainWindow* window) : _mainWindow(window), _keepGovernor(NULL), _skippedFrames(0), _skippedKeepFrames(0){}
 	void Update(pcl::PointCloud<PointT>::Ptr pointCloud);
-
-signals:
-	void UpdateViewer(pcl::PointCloud<PointT>::Ptr pointCloud);
-	void KeepFrameArrived(pcl::PointCloud<PointT>::Ptr pointCloud);
+	//		NULL when no frame arrived since the last call
+	pcl::PointCloud<PointT>::Ptr TakeLatestFrame();
+	unsigned long long GetSkippedFrames();
+	//		The governor must outlive the keeping
+	void StartKeeping(CaptureGovernor* governor);
+	void StopKeeping();
+	//		NULL when no frame was admitted since the last call
+	pcl::PointCloud<PointT>::Ptr TakeKeepFrame();
+	//		Rejected by the keep governor or replaced before they were taken
+	unsigned long long GetSkippedKeepFrames();
 
 private:
 	MainWindow* _mainWindow;
+	std::mutex _latestMutex;
+	pcl::PointCloud<PointT>::Ptr _latestFrame;
+	CaptureGovernor* _keepGovernor;
+	pcl::PointCloud<PointT>::Ptr _keepFrame;
+	std::atomic<unsigned long long> _skippedFrames;
+	std::atomic<unsigned long long> _skippedKeepFrames;
 };
 
-//		*****************************************************************
-//				Subject
-//				Flexx, 
-//		*****************************************************************
-
-class ISubject
+//		Writes the frames to a scan log while recording. Registered like the UI observer,
+//		so the frames arrive on its own FrameBus worker and a slow disk only drops frames.
+class RecorderObserver : public IObserver
 {
 public:
-	virtual void RegisterObserver(IObserver* observer) = 0;
-	virtual void NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud) = 0;
-
-protected:
-	std::vector<IObserver*> _observers;
-};
+	RecorderObserver();
+	void Update(pcl::PointCloud<PointT>::Ptr pointCloud);
+	void StartRecording(std::string path);
+	ScanLogStats StopRecording();
+	bool IsRecording();
+	void SetTurntableAngle(float angle);
+	//		Empty unless a write failed, which stops the recording
+	std::string GetError();
 
-class GrabberSubject : ISubject
-{
-public:
-	void RegisterObserver(IObserver* observer);
-	void NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud);
+private:
+	std::mutex _mutex;
+	ScanLogWriter _writer;
+	std::atomic<bool> _isRecording;
+	std::atomic<float> _turntableAngle;
+	std::string _error;
 };
 
 #endif
\ No newline at end of file
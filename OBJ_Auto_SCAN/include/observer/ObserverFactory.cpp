@@ -13,6 +13,12 @@ ISubject* SubjectFactory::GetRSSubject()
 }
 
 ISubject* SubjectFactory::GetOpenNI2Subject()
+{
+	static GrabberSubject* subject = new GrabberSubject();
+	return (ISubject*)subject;
+}
+
+ISubject* SubjectFactory::GetReplaySubject()
 {
 	static GrabberSubject* subject = new GrabberSubject();
 	return (ISubject*)subject;
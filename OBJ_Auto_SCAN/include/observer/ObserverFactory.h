@@ -14,6 +14,7 @@ public:
 	ISubject* GetFlexxSubject();
 	ISubject* GetRSSubject();
 	ISubject* GetOpenNI2Subject();
+	ISubject* GetReplaySubject();
 };
 
 #endif
\ No newline at end of file
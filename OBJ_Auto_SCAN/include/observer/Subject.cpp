@@ -0,0 +1,22 @@
+#include "observer/Subject.h"
+
+//		*****************************************************************
+//				Subject
+//				Grabber(Flexx, RS, OpenNI2, Replay)
+//		*****************************************************************
+
+void GrabberSubject::RegisterObserver(IObserver* observer, OverflowPolicy policy)
+{
+	_observers.push_back(observer);
+	_frameBus.Subscribe(observer, policy);
+}
+
+void GrabberSubject::NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	_frameBus.Publish(pointCloud);
+}
+
+FrameBusStats GrabberSubject::GetObserverStats(IObserver* observer)
+{
+	return _frameBus.GetStats(_frameBus.GetSubscriberId(observer));
+}
\ No newline at end of file
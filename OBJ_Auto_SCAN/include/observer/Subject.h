@@ -0,0 +1,43 @@
+#ifndef SUBJECT
+#define SUBJECT
+
+#include <vector>
+#include "Typedef.h"
+#include "observer/FrameBus.h"
+
+//		Observer / subject interfaces without any UI, the batch runner replays through them too
+class IObserver
+{
+public:
+	virtual void Update(pcl::PointCloud<PointT>::Ptr pointCloud) = 0;
+};
+
+//		*****************************************************************
+//				Subject
+//				Flexx, RS, OpenNI2, Replay
+//		*****************************************************************
+
+class ISubject
+{
+public:
+	virtual void RegisterObserver(IObserver* observer, OverflowPolicy policy = OverflowPolicy::DropOldest) = 0;
+	virtual void NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud) = 0;
+	virtual FrameBusStats GetObserverStats(IObserver* observer) = 0;
+
+protected:
+	std::vector<IObserver*> _observers;
+};
+
+//		Observers are fed through a FrameBus, NotifyObservers only publishes and never waits on Update
+class GrabberSubject : ISubject
+{
+public:
+	void RegisterObserver(IObserver* observer, OverflowPolicy policy = OverflowPolicy::DropOldest);
+	void NotifyObservers(pcl::PointCloud<PointT>::Ptr pointCloud);
+	FrameBusStats GetObserverStats(IObserver* observer);
+
+private:
+	FrameBus _frameBus;
+};
+
+#endif
\ No newline at end of file
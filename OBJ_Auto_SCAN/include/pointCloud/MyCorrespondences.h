@@ -1,6 +1,8 @@
 #ifndef MY_CORRESPONDENCES
 #define MY_CORRESPONDENCES
 
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include "Typedef.h"
 #include "PointCloudElement.h"
 
@@ -11,7 +13,17 @@ public:
 	{
 		_source = source;
 		_target = target;
-		_correspondences.reset(new pcl::Correspondences(*correspondences));
+		_correspondences = SharedCorrespondences::Copy(correspondences);
+		_name = name;
+		_isSelected = false;		//default
+	}
+
+	//		No copy, the buffer may be deferred (session file)
+	MyCorrespondences(MyKeyPoint* source, MyKeyPoint* target, SharedCorrespondences correspondences, std::string name = "Name")
+	{
+		_source = source;
+		_target = target;
+		_correspondences = correspondences;
 		_name = name;
 		_isSelected = false;		//default
 	}
@@ -34,7 +46,7 @@ public:
 	{
 		_source->Show(viewer);
 		_target->Show(viewer);
-		viewer.Show(_source->GetKeyPoint(), _target->GetKeyPoint(), _correspondences, _name);
+		viewer.Show(_source->GetKeyPoint(), _target->GetKeyPoint(), _correspondences.Read(), _name);
 	}
 
 	void Delete(Viewer& viewer)
@@ -44,6 +56,7 @@ public:
 		viewer.DeleteCorrespondence(_name);
 	}
 
+	//		Lines have no OBJ / PLY / PCD form, a session file keeps them
 	void Save(MyFile* file)
 	{
 	}
@@ -63,10 +76,48 @@ public:
 		return NULL;
 	}
 
+	MyKeyPoint* GetSource()
+	{
+		return _source;
+	}
+
+	MyKeyPoint* GetTarget()
+	{
+		return _target;
+	}
+
+	SharedCorrespondences GetSharedCorrespondences()
+	{
+		return _correspondences;
+	}
+
+	//		The keypoint clouds are not part of the element list, so they are counted here
+	const void* GetBufferId()
+	{
+		return _correspondences.GetId();
+	}
+
+	std::size_t GetBytes()
+	{
+		return _correspondences.GetBytes() + _source->GetBytes() + _target->GetBytes();
+	}
+
+	SpatialIndex::Ptr GetSpatialIndex(SpatialIndexType type = SpatialIndexType::FlatKdTree)
+	{
+		return SpatialIndex::Ptr();
+	}
+
+	//		For keypoints outside the element list (session file), freed with the last correspondences using them
+	void AdoptKeyPoint(boost::shared_ptr<PointCloudElement> keypoint)
+	{
+		_ownedKeyPoints.push_back(keypoint);
+	}
+
 private:
 	MyKeyPoint* _source;
 	MyKeyPoint* _target;
-	pcl::CorrespondencesPtr _correspondences;
+	SharedCorrespondences _correspondences;
+	std::vector<boost::shared_ptr<PointCloudElement> > _ownedKeyPoints;
 
 };
 
@@ -13,7 +13,18 @@ public:
 	MyKeyPoint(pcl::PointCloud<KeypointT>::Ptr cloud, std::string name = "Name")
 	{
 		_name = name;
-		_cloud.reset(new pcl::PointCloud<KeypointT>(*cloud));
+		_cloud = SharedKeypointCloud::Copy(cloud);
+		_isSelected = false;		//default
+		_r = 255;
+		_g = 0;
+		_b = 0;
+	}
+
+	//		No copy, the buffer may be deferred (session file)
+	MyKeyPoint(SharedKeypointCloud cloud, std::string name = "Name")
+	{
+		_name = name;
+		_cloud = cloud;
 		_isSelected = false;		//default
 		_r = 255;
 		_g = 0;
@@ -35,21 +46,23 @@ public:
 		viewer.DeletePointCloud(_name);
 	}
 
+	//		Positions only, in the keypoint colour
 	void Save(MyFile* file)
 	{
-
+		file->SaveFile(GetPointCloud());
 	}
 
 	pcl::PointCloud<PointT>::Ptr GetPointCloud()
 	{
 		pcl::PointCloud<PointT>::Ptr tmpCloud;
 		tmpCloud.reset(new pcl::PointCloud<PointT>());
-		for (int counter = 0; counter < _cloud->size(); counter++)
+		pcl::PointCloud<KeypointT>::Ptr cloud = _cloud.Read();
+		for (int counter = 0; counter < cloud->size(); counter++)
 		{
 			PointT point;
-			point.x = _cloud->points[counter].x;
-			point.y = _cloud->points[counter].y;
-			point.z = _cloud->points[counter].z;
+			point.x = cloud->points[counter].x;
+			point.y = cloud->points[counter].y;
+			point.z = cloud->points[counter].z;
 
 			point.r = _r;
 			point.g = _g;
@@ -60,6 +73,11 @@ public:
 	}
 
 	pcl::PointCloud<KeypointT>::Ptr GetKeyPoint()
+	{
+		return _cloud.Read();
+	}
+
+	SharedKeypointCloud GetSharedKeyPoint()
 	{
 		return _cloud;
 	}
@@ -79,12 +97,27 @@ public:
 		return _isSelected;
 	}
 
+	const void* GetBufferId()
+	{
+		return _cloud.GetId();
+	}
+
+	std::size_t GetBytes()
+	{
+		return _cloud.GetBytes();
+	}
+
+	SpatialIndex::Ptr GetSpatialIndex(SpatialIndexType type = SpatialIndexType::FlatKdTree)
+	{
+		return SpatialIndex::Ptr();
+	}
+
 private:
 	int _r;
 	int _g;
 	int _b;
 
-	pcl::PointCloud<KeypointT>::Ptr _cloud;
+	SharedKeypointCloud _cloud;
 };
 
 #endif
\ No newline at end of file
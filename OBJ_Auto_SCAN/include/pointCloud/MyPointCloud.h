@@ -13,13 +13,16 @@ public:
 	MyPointCloud(pcl::PointCloud<PointT>::Ptr cloud, std::string name = "Name")
 	{
 		_name = name;
-		_cloud.reset(new pcl::PointCloud<PointT>(*cloud));
+		_cloud = SharedPointCloud::Copy(cloud);
 		_isSelected = false;		//default
 	}
 
-	~MyPointCloud()
+	//		No copy, the buffer may be shared with the element it was derived from
+	MyPointCloud(SharedPointCloud cloud, std::string name = "Name")
 	{
-		_cloud.reset();
+		_name = name;
+		_cloud = cloud;
+		_isSelected = false;		//default
 	}
 
 	std::string GetName()
@@ -29,7 +32,7 @@ public:
 
 	void Show(Viewer& viewer)
 	{
-		viewer.ShowPointCloud(GetPointCloud(), GetName());
+		viewer.ShowLevelOfDetail(GetPointCloud(), GetName());
 	}
 
 	void Delete(Viewer& viewer)
@@ -39,7 +42,7 @@ public:
 
 	void Save(MyFile* file)
 	{
-		file->SaveFile(_cloud);
+		file->SaveFile(_cloud.Read());
 	}
 
 	pcl::PointCloud<KeypointT>::Ptr GetKeyPoint()
@@ -48,6 +51,11 @@ public:
 	}
 
 	pcl::PointCloud<PointT>::Ptr GetPointCloud()
+	{
+		return _cloud.Read();
+	}
+
+	SharedPointCloud GetSharedPointCloud()
 	{
 		return _cloud;
 	}
@@ -67,8 +75,25 @@ public:
 		return _isSelected;
 	}
 
+	const void* GetBufferId()
+	{
+		return _cloud.GetId();
+	}
+
+	std::size_t GetBytes()
+	{
+		return _cloud.GetBytes();
+	}
+
+	//		Borrowed from the cache so the stages searching this buffer find the same index.
+	//		Not kept here : the cache drops it when SharedCloud::Write modifies the buffer.
+	SpatialIndex::Ptr GetSpatialIndex(SpatialIndexType type = SpatialIndexType::FlatKdTree)
+	{
+		return SpatialIndexCache::GetInstance()->GetIndex(_cloud.Read(), type);
+	}
+
 private:
-	pcl::PointCloud<PointT>::Ptr _cloud;
+	SharedPointCloud _cloud;
 };
 
 #endif
\ No newline at end of file
@@ -15,7 +15,15 @@ class MySurface : public PointCloudElement
 public:
 	MySurface(pcl::PolygonMeshPtr surface, std::string name = "Name")
 	{
-		_surface.reset(new pcl::PolygonMesh(*surface));
+		_surface = SharedMesh::Copy(surface);
+		_name = name;
+		_isSelected = false;		//default
+	}
+
+	//		No copy, the buffer may be deferred (session file)
+	MySurface(SharedMesh surface, std::string name = "Name")
+	{
+		_surface = surface;
 		_name = name;
 		_isSelected = false;		//default
 	}
@@ -28,7 +36,7 @@ public:
 	void Show(Viewer& viewer)
 	{
 		//viewer.ShowPointCloud(GetPointCloud(), GetName());
-		viewer.ShowSurface(_surface, _name);
+		viewer.ShowSurface(_surface.Read(), _name);
 	}
 
 	void Delete(Viewer& viewer)
@@ -38,7 +46,7 @@ public:
 	
 	void Save(MyFile* file)
 	{
-		file->SaveFile(_surface);
+		file->SaveFile(_surface.Read());
 	}
 
 	pcl::PointCloud<KeypointT>::Ptr GetKeyPoint()
@@ -52,6 +60,11 @@ public:
 	}
 
 	pcl::PolygonMeshPtr GetMesh()
+	{
+		return _surface.Read();
+	}
+
+	SharedMesh GetSharedMesh()
 	{
 		return _surface;
 	}
@@ -66,8 +79,23 @@ public:
 		return _isSelected;
 	}
 
+	const void* GetBufferId()
+	{
+		return _surface.GetId();
+	}
+
+	std::size_t GetBytes()
+	{
+		return _surface.GetBytes();
+	}
+
+	SpatialIndex::Ptr GetSpatialIndex(SpatialIndexType type = SpatialIndexType::FlatKdTree)
+	{
+		return SpatialIndex::Ptr();
+	}
+
 private:
-	pcl::PolygonMeshPtr _surface;
+	SharedMesh _surface;
 };
 
 #endif
\ No newline at end of file
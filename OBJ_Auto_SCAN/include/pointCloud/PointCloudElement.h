@@ -3,10 +3,22 @@
 
 #include "ui/Viewer.h"
 #include "file/MyFile.h"
+#include "pointCloud/SharedCloud.h"
+#include "pointCloud/SpatialIndexCache.h"
 
 class PointCloudElement
 {
 public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	PointCloudElement() : _transform(Eigen::Matrix4f::Identity())
+	{
+	}
+
+	virtual ~PointCloudElement()
+	{
+	}
+
 	virtual std::string GetName() = 0;
 	virtual void SetIsSelected(bool isSelected) = 0;
 	virtual bool GetIsSelected() = 0;
@@ -16,10 +28,27 @@ public:
 	virtual pcl::PointCloud<PointT>::Ptr GetPointCloud() = 0;
 	virtual pcl::PolygonMeshPtr GetMesh() = 0;
 	virtual pcl::PointCloud<KeypointT>::Ptr GetKeyPoint() = 0;
+	//		Memory accounting, elements returning the same id share one buffer
+	virtual const void* GetBufferId() = 0;
+	virtual std::size_t GetBytes() = 0;
+	//		Borrowed from SpatialIndexCache, rebuilt after a SharedCloud::Write, NULL without a point cloud
+	virtual SpatialIndex::Ptr GetSpatialIndex(SpatialIndexType type = SpatialIndexType::FlatKdTree) = 0;
+
+	//		Transform the element was registered with (ICP, pose graph), identity otherwise
+	Eigen::Matrix4f GetTransform()
+	{
+		return _transform;
+	}
+
+	void SetTransform(const Eigen::Matrix4f& transform)
+	{
+		_transform = transform;
+	}
 
 protected:
 	std::string _name;
 	bool _isSelected;
+	Eigen::Matrix4f _transform;
 };
 
 #endif
\ No newline at end of file
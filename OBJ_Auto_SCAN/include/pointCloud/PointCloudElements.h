@@ -1,6 +1,7 @@
 #ifndef POINT_CLOUD_ELEMENTS
 #define POINT_CLOUD_ELEMENTS
 
+#include <map>
 #include <vector>
 #include "PointCloudElement.h"
 #include "MyPointCloud.h"
@@ -8,17 +9,49 @@
 #include "MySurface.h"
 #include "MyCorrespondences.h"
 
+//		Told about every change of the list (the table model of the window). Rows are
+//		element ids, Begin is called before the list changes and End after.
+class PointCloudElementsListener
+{
+public:
+	virtual ~PointCloudElementsListener()
+	{
+	}
+	virtual void BeginInsertElements(int first, int last) = 0;
+	virtual void EndInsertElements() = 0;
+	virtual void BeginRemoveElements(int first, int last) = 0;
+	virtual void EndRemoveElements() = 0;
+	virtual void ElementsChanged(int first, int last) = 0;
+};
+
 class PointCloudElements
 {
 public:
 	PointCloudElements()
 	{
 		_elements = std::vector<PointCloudElement*>();
+		_listener = NULL;
+		_totalBytes = 0;
+	}
+
+	//		NULL to stop the notifications
+	void SetListener(PointCloudElementsListener* listener)
+	{
+		_listener = listener;
 	}
 
 	void AddPointCloudElement(PointCloudElement* element)
 	{
+		int id = GetNumberOfElements();
+		if (_listener != NULL)
+			_listener->BeginInsertElements(id, id);
 		_elements.push_back(element);
+		_counted.push_back(Counted());
+		bool isShared = Count(id);
+		if (_listener != NULL)
+			_listener->EndInsertElements();
+		if (isShared)
+			NotifySharedChanged(_counted[id].bufferId);
 	}
 
 	void ShowPointCloudElementById(Viewer& viewer, int id)
@@ -26,21 +59,25 @@ public:
 		_elements[id]->Show(viewer);
 	}
 
+	//		Removed in runs of consecutive selected elements, from the back so the ids before stay valid
 	void RemoveSelectedPointCloud()
 	{
-		for (int counter = 0; counter < GetNumberOfElements(); counter++)
+		for (int last = GetNumberOfElements() - 1; last >= 0; last--)
 		{
-			if (_elements[counter]->GetIsSelected())
-			{
-				_elements.erase(_elements.begin() + counter);
-				counter--;
-			}
+			if (!_elements[last]->GetIsSelected())
+				continue;
+			int first = last;
+			while (first > 0 && _elements[first - 1]->GetIsSelected())
+				first--;
+			RemoveElements(first, last);
+			last = first;
 		}
 	}
 
 	void RemoveAllPointCloud()
 	{
-		_elements.clear();
+		if (GetNumberOfElements() > 0)
+			RemoveElements(0, GetNumberOfElements() - 1);
 	}
 
 	void SelectAllPointCloud()
@@ -49,6 +86,7 @@ public:
 		{
 			_elements[counter]->SetIsSelected(true);
 		}
+		NotifyChanged(0, GetNumberOfElements() - 1);
 	}
 
 	void UnselectAllPointCloud()
@@ -57,6 +95,7 @@ public:
 		{
 			_elements[counter]->SetIsSelected(false);
 		}
+		NotifyChanged(0, GetNumberOfElements() - 1);
 	}
 
 	bool IsNameExist(std::string name)
@@ -91,6 +130,7 @@ public:
 	void SetIsSelectedById(int id, bool isSelected)
 	{
 		_elements[id]->SetIsSelected(isSelected);
+		NotifyChanged(id, id);
 	}
 
 	bool GetIsSelectedById(int id)
@@ -108,8 +148,129 @@ public:
 		return _elements[id];
 	}
 
+	std::size_t GetBytesById(int id)
+	{
+		return _elements[id]->GetBytes();
+	}
+
+	//		True if another element holds the same buffer
+	bool IsSharedById(int id)
+	{
+		const void* bufferId = _counted[id].bufferId;
+		if (bufferId == NULL)
+			return false;
+		std::map<const void*, BufferReference>::iterator buffer = _buffers.find(bufferId);
+		return buffer != _buffers.end() && buffer->second.count > 1;
+	}
+
+	//		Shared buffers are counted once
+	std::size_t GetTotalBytes()
+	{
+		return _totalBytes;
+	}
+
+	//		The totals follow Add / Remove, elements whose buffer was loaded, replaced or
+	//		written since they were added are only seen again after a recount
+	void RecountBytes()
+	{
+		_buffers.clear();
+		_totalBytes = 0;
+		for (int counter = 0; counter < GetNumberOfElements(); counter++)
+			Count(counter);
+	}
+
 private:
+	//		What an element was counted with, so it is uncounted the same way after its buffer changed
+	struct Counted
+	{
+		Counted() : bufferId(NULL), bytes(0) {}
+		const void* bufferId;
+		std::size_t bytes;
+	};
+
+	struct BufferReference
+	{
+		BufferReference() : count(0), bytes(0) {}
+		int count;
+		std::size_t bytes;
+	};
+
+	//		True if the element made its buffer shared
+	bool Count(int id)
+	{
+		_counted[id].bufferId = _elements[id]->GetBufferId();
+		_counted[id].bytes = _elements[id]->GetBytes();
+		if (_counted[id].bufferId == NULL)
+		{
+			_totalBytes += _counted[id].bytes;
+			return false;
+		}
+		BufferReference& buffer = _buffers[_counted[id].bufferId];
+		if (buffer.count++ == 0)
+		{
+			buffer.bytes = _counted[id].bytes;
+			_totalBytes += buffer.bytes;
+		}
+		return buffer.count == 2;
+	}
+
+	//		True if one element is left holding the buffer
+	bool Uncount(int id)
+	{
+		if (_counted[id].bufferId == NULL)
+		{
+			_totalBytes -= _counted[id].bytes;
+			return false;
+		}
+		std::map<const void*, BufferReference>::iterator buffer = _buffers.find(_counted[id].bufferId);
+		if (buffer == _buffers.end())
+			return false;
+		if (--buffer->second.count > 0)
+			return buffer->second.count == 1;
+		_totalBytes -= buffer->second.bytes;
+		_buffers.erase(buffer);
+		return false;
+	}
+
+	void RemoveElements(int first, int last)
+	{
+		std::vector<const void*> unshared;
+		for (int counter = first; counter <= last; counter++)
+		{
+			if (Uncount(counter))
+				unshared.push_back(_counted[counter].bufferId);
+		}
+		if (_listener != NULL)
+			_listener->BeginRemoveElements(first, last);
+		_elements.erase(_elements.begin() + first, _elements.begin() + last + 1);
+		_counted.erase(_counted.begin() + first, _counted.begin() + last + 1);
+		if (_listener != NULL)
+			_listener->EndRemoveElements();
+		for (std::size_t counter = 0; counter < unshared.size(); counter++)
+			NotifySharedChanged(unshared[counter]);
+	}
+
+	//		Only when a buffer becomes (un)shared, which a plain keep never does, so adding stays O(1)
+	void NotifySharedChanged(const void* bufferId)
+	{
+		for (int counter = 0; counter < GetNumberOfElements(); counter++)
+		{
+			if (_counted[counter].bufferId == bufferId)
+				NotifyChanged(counter, counter);
+		}
+	}
+
+	void NotifyChanged(int first, int last)
+	{
+		if (_listener != NULL && first <= last)
+			_listener->ElementsChanged(first, last);
+	}
+
 	std::vector<PointCloudElement*> _elements;
+	std::vector<Counted> _counted;								//	parallel to _elements
+	std::map<const void*, BufferReference> _buffers;		//	elements per buffer
+	std::size_t _totalBytes;
+	PointCloudElementsListener* _listener;
 };
 
 #endif
\ No newline at end of file
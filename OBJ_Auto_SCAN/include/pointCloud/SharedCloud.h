@@ -0,0 +1,216 @@
+#ifndef SHARED_CLOUD
+#define SHARED_CLOUD
+
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <pcl/point_cloud.h>
+#include <pcl/PolygonMesh.h>
+#include <pcl/correspondence.h>
+#include "Typedef.h"
+
+//		Caches keyed on a buffer (spatial index, normals) register here to drop
+//		their entries when a buffer is modified in place
+class SharedCloudListeners
+{
+public:
+	typedef void(*Listener)(const void* id);
+
+	static void Add(Listener listener)
+	{
+		std::unique_lock<std::mutex> lock(GetMutex());
+		GetListeners().push_back(listener);
+	}
+
+	static void Notify(const void* id)
+	{
+		std::vector<Listener> listeners;
+		{
+			std::unique_lock<std::mutex> lock(GetMutex());
+			listeners = GetListeners();
+		}
+		for (std::size_t counter = 0; counter < listeners.size(); counter++)
+			listeners[counter](id);
+	}
+
+private:
+	static std::vector<Listener>& GetListeners()
+	{
+		static std::vector<Listener> listeners;
+		return listeners;
+	}
+
+	static std::mutex& GetMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+};
+
+//		Buffer of a SharedCloud that is read on first use (session files).
+//		Loading drops the loader, and with it the file mapping it holds.
+template <typename DataT>
+class SharedCloudSource
+{
+public:
+	typedef boost::shared_ptr<DataT> Ptr;
+
+	SharedCloudSource(std::function<Ptr()> load) : _load(load)
+	{
+	}
+
+	Ptr Get()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_load)
+		{
+			_data = _load();
+			_load = std::function<Ptr()>();
+		}
+		return _data;
+	}
+
+	bool IsLoaded()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		return !_load;
+	}
+
+	//		The source stands for the buffer until it is loaded
+	const void* GetId()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		return _load ? (const void*)this : (const void*)_data.get();
+	}
+
+private:
+	std::mutex _mutex;
+	std::function<Ptr()> _load;
+	Ptr _data;
+};
+
+//		*****************************************************************
+//				Shared Cloud
+//				Copy-on-write handle around a cloud / mesh buffer.
+//				Elements that derive from each other share one buffer until
+//				one of them asks for Write(), which detaches a private copy.
+//				A deferred buffer is loaded by the first Read() / Write().
+//		*****************************************************************
+template <typename DataT>
+class SharedCloud
+{
+public:
+	typedef boost::shared_ptr<DataT> Ptr;
+
+	SharedCloud()
+	{
+	}
+
+	//		Takes the buffer without copying; the caller must not modify it afterwards
+	static SharedCloud Adopt(Ptr data)
+	{
+		SharedCloud shared;
+		shared._data = data;
+		return shared;
+	}
+
+	//		For buffers the producer keeps reusing (processing results, grabber frames)
+	static SharedCloud Copy(Ptr data)
+	{
+		SharedCloud shared;
+		if (data.get() != NULL)
+			shared._data.reset(new DataT(*data));
+		return shared;
+	}
+
+	//		Nothing is read until the buffer is first used
+	static SharedCloud Defer(std::function<Ptr()> load)
+	{
+		SharedCloud shared;
+		shared._source.reset(new SharedCloudSource<DataT>(load));
+		return shared;
+	}
+
+	//		Treat the result as read only, it may be shared with other elements
+	Ptr Read() const
+	{
+		if (_source.get() != NULL)
+			return _source->Get();
+		return _data;
+	}
+
+	//		A detached copy is a new buffer; writing a buffer in place invalidates its caches
+	Ptr Write()
+	{
+		if (_source.get() != NULL)
+		{
+			_data = _source->Get();
+			_source.reset();
+		}
+		if (_data.get() != NULL && !_data.unique())
+			_data.reset(new DataT(*_data));
+		else if (_data.get() != NULL)
+			SharedCloudListeners::Notify(_data.get());
+		return _data;
+	}
+
+	bool IsShared() const
+	{
+		if (_source.get() != NULL)
+			return !_source.unique();
+		return _data.get() != NULL && !_data.unique();
+	}
+
+	bool IsLoaded() const
+	{
+		return _source.get() == NULL || _source->IsLoaded();
+	}
+
+	//		Identifies the buffer, elements with the same id share memory
+	const void* GetId() const
+	{
+		if (_source.get() != NULL)
+			return _source->GetId();
+		return _data.get();
+	}
+
+	//		A deferred buffer takes no memory until it is loaded
+	std::size_t GetBytes() const
+	{
+		if (!IsLoaded())
+			return 0;
+		Ptr data = Read();
+		return data.get() == NULL ? 0 : ByteSize(*data);
+	}
+
+private:
+	template <typename PointType>
+	static std::size_t ByteSize(const pcl::PointCloud<PointType>& cloud)
+	{
+		return cloud.points.capacity() * sizeof(PointType);
+	}
+
+	static std::size_t ByteSize(const pcl::PolygonMesh& mesh)
+	{
+		std::size_t bytes = mesh.cloud.data.capacity();
+		for (std::size_t counter = 0; counter < mesh.polygons.size(); counter++)
+			bytes += mesh.polygons[counter].vertices.capacity() * sizeof(uint32_t);
+		return bytes;
+	}
+
+	static std::size_t ByteSize(const pcl::Correspondences& correspondences)
+	{
+		return correspondences.capacity() * sizeof(pcl::Correspondence);
+	}
+
+	Ptr _data;
+	boost::shared_ptr<SharedCloudSource<DataT> > _source;
+};
+
+typedef SharedCloud<pcl::PointCloud<PointT> > SharedPointCloud;
+typedef SharedCloud<pcl::PointCloud<KeypointT> > SharedKeypointCloud;
+typedef SharedCloud<pcl::PolygonMesh> SharedMesh;
+typedef SharedCloud<pcl::Correspondences> SharedCorrespondences;
+
+#endif
@@ -0,0 +1,468 @@
+#include "pointCloud/SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
+
+//		*****************************************************************
+//				Spatial Index
+//		*****************************************************************
+
+SpatialIndex::Ptr SpatialIndex::Create(SpatialIndexType type, float voxelSize)
+{
+	switch (type)
+	{
+	case SpatialIndexType::FlatKdTree:
+		return Ptr(new FlatKdTree());
+	case SpatialIndexType::VoxelHash:
+		return Ptr(new VoxelHashIndex(voxelSize));
+	}
+	throw std::string("SpatialIndex: Unknown index type");
+}
+
+void SpatialIndex::Permute(const std::vector<int>& order)
+{
+	std::vector<float> xyz(_xyz.size());
+	std::vector<int> ids(_ids.size());
+	for (std::size_t counter = 0; counter < order.size(); counter++)
+	{
+		int old = order[counter];
+		xyz[3 * counter] = _xyz[3 * old];
+		xyz[3 * counter + 1] = _xyz[3 * old + 1];
+		xyz[3 * counter + 2] = _xyz[3 * old + 2];
+		ids[counter] = _ids[old];
+	}
+	_xyz.swap(xyz);
+	_ids.swap(ids);
+}
+
+void SpatialIndex::SortResults(std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN)
+{
+	std::vector<std::pair<float, int> > results(indices.size());
+	for (std::size_t counter = 0; counter < indices.size(); counter++)
+		results[counter] = std::make_pair(sqrDistances[counter], indices[counter]);
+	std::sort(results.begin(), results.end());
+	if (maxNN > 0 && results.size() > maxNN)
+		results.resize(maxNN);
+	indices.resize(results.size());
+	sqrDistances.resize(results.size());
+	for (std::size_t counter = 0; counter < results.size(); counter++)
+	{
+		sqrDistances[counter] = results[counter].first;
+		indices[counter] = results[counter].second;
+	}
+}
+
+//		*****************************************************************
+//				Flat Kd Tree
+//		*****************************************************************
+
+FlatKdTree::FlatKdTree()
+{
+}
+
+void FlatKdTree::BuildIndex()
+{
+	_nodes.clear();
+	int size = (int)_ids.size();
+	if (size == 0)
+		return;
+	std::vector<int> order(size);
+	std::iota(order.begin(), order.end(), 0);
+
+	Node root = { 0, size, -1, 0, 0 };
+	_nodes.push_back(root);
+	std::vector<std::pair<int, int> > stack(1, std::make_pair(0, 0));		//	node, depth
+	while (!stack.empty())
+	{
+		int current = stack.back().first;
+		int depth = stack.back().second;
+		stack.pop_back();
+		int begin = _nodes[current].begin;
+		int end = _nodes[current].end;
+		if (end - begin <= LEAF_SIZE || depth + 1 >= MAX_DEPTH)
+			continue;
+
+		float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		float max[3] = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+		for (int counter = begin; counter < end; counter++)
+		{
+			const float* point = &_xyz[3 * order[counter]];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				min[axis] = std::min(min[axis], point[axis]);
+				max[axis] = std::max(max[axis], point[axis]);
+			}
+		}
+		int axis = 0;
+		for (int counter = 1; counter < 3; counter++)
+		{
+			if (max[counter] - min[counter] > max[axis] - min[axis])
+				axis = counter;
+		}
+		//		All points equal, nothing to split
+		if (max[axis] - min[axis] <= 0)
+			continue;
+
+		int middle = begin + (end - begin) / 2;
+		std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [this, axis](int first, int second)
+		{
+			return _xyz[3 * first + axis] < _xyz[3 * second + axis];
+		});
+		int left = (int)_nodes.size();
+		_nodes[current].left = left;
+		_nodes[current].axis = axis;
+		_nodes[current].split = _xyz[3 * order[middle] + axis];
+		Node leftNode = { begin, middle, -1, 0, 0 };
+		Node rightNode = { middle, end, -1, 0, 0 };
+		_nodes.push_back(leftNode);
+		_nodes.push_back(rightNode);
+		stack.push_back(std::make_pair(left, depth + 1));
+		stack.push_back(std::make_pair(left + 1, depth + 1));
+	}
+	Permute(order);
+}
+
+//		Left holds the coordinates <= split, right the ones >= split
+int FlatKdTree::RadiusSearch(const Eigen::Vector3f& query, double radius, std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN, bool isSorted) const
+{
+	indices.clear();
+	sqrDistances.clear();
+	if (_nodes.empty())
+		return 0;
+	const float sqrRadius = (float)(radius * radius);
+	const float q[3] = { query[0], query[1], query[2] };
+	int stack[MAX_DEPTH + 1];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = _nodes[stack[--top]];
+		if (node.left < 0)
+		{
+			for (int counter = node.begin; counter < node.end; counter++)
+			{
+				const float* point = &_xyz[3 * counter];
+				float dx = point[0] - q[0];
+				float dy = point[1] - q[1];
+				float dz = point[2] - q[2];
+				float sqrDistance = dx * dx + dy * dy + dz * dz;
+				if (sqrDistance > sqrRadius)
+					continue;
+				indices.push_back(_ids[counter]);
+				sqrDistances.push_back(sqrDistance);
+				if (!isSorted && maxNN > 0 && indices.size() == maxNN)
+					return (int)indices.size();
+			}
+			continue;
+		}
+		float diff = q[node.axis] - node.split;
+		int nearChild = diff < 0 ? node.left : node.left + 1;
+		if (diff * diff <= sqrRadius)
+			stack[top++] = diff < 0 ? node.left + 1 : node.left;
+		stack[top++] = nearChild;
+	}
+	if (isSorted)
+		SortResults(indices, sqrDistances, maxNN);
+	return (int)indices.size();
+}
+
+int FlatKdTree::NearestKSearch(const Eigen::Vector3f& query, int k, std::vector<int>& indices, std::vector<float>& sqrDistances) const
+{
+	indices.clear();
+	sqrDistances.clear();
+	if (_nodes.empty() || k <= 0)
+		return 0;
+	const float q[3] = { query[0], query[1], query[2] };
+	std::vector<std::pair<float, int> > heap;		//	max heap on the distance
+	heap.reserve(k);
+	struct Item
+	{
+		int node;
+		float sqrBound;
+	};
+	Item stack[MAX_DEPTH + 1];
+	int top = 0;
+	Item root = { 0, 0 };
+	stack[top++] = root;
+	while (top > 0)
+	{
+		Item item = stack[--top];
+		if ((int)heap.size() == k && item.sqrBound > heap.front().first)
+			continue;
+		const Node& node = _nodes[item.node];
+		if (node.left < 0)
+		{
+			for (int counter = node.begin; counter < node.end; counter++)
+			{
+				const float* point = &_xyz[3 * counter];
+				float dx = point[0] - q[0];
+				float dy = point[1] - q[1];
+				float dz = point[2] - q[2];
+				float sqrDistance = dx * dx + dy * dy + dz * dz;
+				if ((int)heap.size() < k)
+				{
+					heap.push_back(std::make_pair(sqrDistance, counter));
+					std::push_heap(heap.begin(), heap.end());
+				}
+				else if (sqrDistance < heap.front().first)
+				{
+					std::pop_heap(heap.begin(), heap.end());
+					heap.back() = std::make_pair(sqrDistance, counter);
+					std::push_heap(heap.begin(), heap.end());
+				}
+			}
+			continue;
+		}
+		float diff = q[node.axis] - node.split;
+		Item nearItem = { diff < 0 ? node.left : node.left + 1, item.sqrBound };
+		Item farItem = { diff < 0 ? node.left + 1 : node.left, std::max(item.sqrBound, diff * diff) };
+		stack[top++] = farItem;
+		stack[top++] = nearItem;
+	}
+	std::sort_heap(heap.begin(), heap.end());
+	indices.resize(heap.size());
+	sqrDistances.resize(heap.size());
+	for (std::size_t counter = 0; counter < heap.size(); counter++)
+	{
+		sqrDistances[counter] = heap[counter].first;
+		indices[counter] = _ids[heap[counter].second];
+	}
+	return (int)indices.size();
+}
+
+SpatialIndexType FlatKdTree::GetType() const
+{
+	return SpatialIndexType::FlatKdTree;
+}
+
+SpatialIndex* FlatKdTree::CreateEmpty() const
+{
+	return new FlatKdTree();
+}
+
+std::size_t FlatKdTree::GetBytes() const
+{
+	return SpatialIndex::GetBytes() + _nodes.capacity() * sizeof(Node);
+}
+
+//		*****************************************************************
+//				Voxel Hash Index
+//		*****************************************************************
+
+VoxelHashIndex::VoxelHashIndex(float voxelSize) : _voxelSize(voxelSize)
+{
+	if (!(voxelSize > 0))
+		throw std::string("VoxelHashIndex: Voxel size must be positive");
+	for (int axis = 0; axis < 3; axis++)
+	{
+		_min[axis] = 0;
+		_max[axis] = -1;
+	}
+}
+
+int VoxelHashIndex::GetVoxel(float coordinate) const
+{
+	return (int)std::floor(coordinate / _voxelSize);
+}
+
+//		21 bits per axis; voxels further apart than that alias, which only adds candidates
+unsigned long long VoxelHashIndex::GetKey(int x, int y, int z)
+{
+	const unsigned long long mask = (1ull << 21) - 1;
+	const int offset = 1 << 20;
+	return (((unsigned long long)(x + offset) & mask) << 42) | (((unsigned long long)(y + offset) & mask) << 21) | ((unsigned long long)(z + offset) & mask);
+}
+
+const VoxelHashIndex::Range* VoxelHashIndex::FindVoxel(int x, int y, int z) const
+{
+	std::unordered_map<unsigned long long, Range>::const_iterator it = _voxels.find(GetKey(x, y, z));
+	return it == _voxels.end() ? NULL : &it->second;
+}
+
+void VoxelHashIndex::BuildIndex()
+{
+	_voxels.clear();
+	int size = (int)_ids.size();
+	for (int axis = 0; axis < 3; axis++)
+	{
+		_min[axis] = std::numeric_limits<int>::max();
+		_max[axis] = std::numeric_limits<int>::min();
+	}
+	if (size == 0)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			_min[axis] = 0;
+			_max[axis] = -1;
+		}
+		return;
+	}
+	std::vector<unsigned long long> keys(size);
+	for (int counter = 0; counter < size; counter++)
+	{
+		int voxel[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			voxel[axis] = GetVoxel(_xyz[3 * counter + axis]);
+			_min[axis] = std::min(_min[axis], voxel[axis]);
+			_max[axis] = std::max(_max[axis], voxel[axis]);
+		}
+		keys[counter] = GetKey(voxel[0], voxel[1], voxel[2]);
+	}
+	std::vector<int> order(size);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&keys](int first, int second)
+	{
+		return keys[first] < keys[second];
+	});
+	Permute(order);
+
+	_voxels.reserve(size / 4 + 1);
+	int begin = 0;
+	for (int counter = 1; counter <= size; counter++)
+	{
+		if (counter < size && keys[order[counter]] == keys[order[begin]])
+			continue;
+		Range range = { begin, counter };
+		_voxels[keys[order[begin]]] = range;
+		begin = counter;
+	}
+}
+
+int VoxelHashIndex::RadiusSearch(const Eigen::Vector3f& query, double radius, std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN, bool isSorted) const
+{
+	indices.clear();
+	sqrDistances.clear();
+	if (_voxels.empty())
+		return 0;
+	const float sqrRadius = (float)(radius * radius);
+	int first[3], last[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		first[axis] = std::max(_min[axis], GetVoxel(query[axis] - (float)radius));
+		last[axis] = std::min(_max[axis], GetVoxel(query[axis] + (float)radius));
+	}
+	for (int x = first[0]; x <= last[0]; x++)
+	{
+		for (int y = first[1]; y <= last[1]; y++)
+		{
+			for (int z = first[2]; z <= last[2]; z++)
+			{
+				const Range* range = FindVoxel(x, y, z);
+				if (range == NULL)
+					continue;
+				for (int counter = range->begin; counter < range->end; counter++)
+				{
+					const float* point = &_xyz[3 * counter];
+					float dx = point[0] - query[0];
+					float dy = point[1] - query[1];
+					float dz = point[2] - query[2];
+					float sqrDistance = dx * dx + dy * dy + dz * dz;
+					if (sqrDistance > sqrRadius)
+						continue;
+					indices.push_back(_ids[counter]);
+					sqrDistances.push_back(sqrDistance);
+					if (!isSorted && maxNN > 0 && indices.size() == maxNN)
+						return (int)indices.size();
+				}
+			}
+		}
+	}
+	if (isSorted)
+		SortResults(indices, sqrDistances, maxNN);
+	return (int)indices.size();
+}
+
+//		Visits the voxels ring by ring around the query voxel. After ring r every
+//		unvisited point is at least r voxels away, which bounds the search.
+int VoxelHashIndex::NearestKSearch(const Eigen::Vector3f& query, int k, std::vector<int>& indices, std::vector<float>& sqrDistances) const
+{
+	indices.clear();
+	sqrDistances.clear();
+	if (_voxels.empty() || k <= 0)
+		return 0;
+	int center[3];
+	int maxRing = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		center[axis] = GetVoxel(query[axis]);
+		maxRing = std::max(maxRing, std::max(std::abs(center[axis] - _min[axis]), std::abs(_max[axis] - center[axis])));
+	}
+	std::vector<std::pair<float, int> > heap;
+	heap.reserve(k);
+	for (int ring = 0; ring <= maxRing; ring++)
+	{
+		for (int x = std::max(_min[0], center[0] - ring); x <= std::min(_max[0], center[0] + ring); x++)
+		{
+			for (int y = std::max(_min[1], center[1] - ring); y <= std::min(_max[1], center[1] + ring); y++)
+			{
+				//		Inside the shell only the two z faces belong to this ring
+				bool isOnShell = std::abs(x - center[0]) == ring || std::abs(y - center[1]) == ring;
+				int step = isOnShell || ring == 0 ? 1 : 2 * ring;
+				for (int z = center[2] - ring; z <= center[2] + ring; z += step)
+				{
+					if (z < _min[2] || z > _max[2])
+						continue;
+					const Range* range = FindVoxel(x, y, z);
+					if (range == NULL)
+						continue;
+					for (int counter = range->begin; counter < range->end; counter++)
+					{
+						const float* point = &_xyz[3 * counter];
+						float dx = point[0] - query[0];
+						float dy = point[1] - query[1];
+						float dz = point[2] - query[2];
+						float sqrDistance = dx * dx + dy * dy + dz * dz;
+						if ((int)heap.size() < k)
+						{
+							heap.push_back(std::make_pair(sqrDistance, counter));
+							std::push_heap(heap.begin(), heap.end());
+						}
+						else if (sqrDistance < heap.front().first)
+						{
+							std::pop_heap(heap.begin(), heap.end());
+							heap.back() = std::make_pair(sqrDistance, counter);
+							std::push_heap(heap.begin(), heap.end());
+						}
+					}
+				}
+			}
+		}
+		float reach = ring * _voxelSize;
+		if ((int)heap.size() == k && heap.front().first <= reach * reach)
+			break;
+	}
+	std::sort_heap(heap.begin(), heap.end());
+	indices.resize(heap.size());
+	sqrDistances.resize(heap.size());
+	for (std::size_t counter = 0; counter < heap.size(); counter++)
+	{
+		sqrDistances[counter] = heap[counter].first;
+		indices[counter] = _ids[heap[counter].second];
+	}
+	return (int)indices.size();
+}
+
+SpatialIndexType VoxelHashIndex::GetType() const
+{
+	return SpatialIndexType::VoxelHash;
+}
+
+SpatialIndex* VoxelHashIndex::CreateEmpty() const
+{
+	return new VoxelHashIndex(_voxelSize);
+}
+
+std::size_t VoxelHashIndex::GetBytes() const
+{
+	return SpatialIndex::GetBytes() + _voxels.size() * (sizeof(unsigned long long) + sizeof(Range) + 2 * sizeof(void*));
+}
+
+float VoxelHashIndex::GetVoxelSize() const
+{
+	return _voxelSize;
+}
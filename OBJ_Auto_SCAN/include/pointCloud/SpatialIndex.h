@@ -0,0 +1,167 @@
+#ifndef SPATIAL_INDEX
+#define SPATIAL_INDEX
+
+#include <unordered_map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <pcl/point_cloud.h>
+#include <pcl/common/point_tests.h>
+#include "Typedef.h"
+
+enum class SpatialIndexType
+{
+	FlatKdTree,
+	VoxelHash
+};
+
+//		*****************************************************************
+//				Spatial Index
+//				Radius and k nearest search over the xyz of a cloud. The points
+//				are copied into one flat array in search order (non finite points
+//				are left out), results are indices into the original cloud.
+//				Searching is const and may run on several threads at once.
+//		*****************************************************************
+class SpatialIndex
+{
+public:
+	typedef boost::shared_ptr<SpatialIndex> Ptr;
+
+	//		voxelSize is only used by VoxelHash
+	static Ptr Create(SpatialIndexType type, float voxelSize);
+	virtual ~SpatialIndex()
+	{
+	}
+
+	template <typename PointType>
+	void Build(const pcl::PointCloud<PointType>& cloud, const std::vector<int>* indices = NULL)
+	{
+		std::size_t size = indices == NULL ? cloud.size() : indices->size();
+		_xyz.clear();
+		_ids.clear();
+		_xyz.reserve(size * 3);
+		_ids.reserve(size);
+		for (std::size_t counter = 0; counter < size; counter++)
+		{
+			int index = indices == NULL ? (int)counter : (*indices)[counter];
+			const PointType& point = cloud.points[index];
+			if (!pcl::isFinite(point))
+				continue;
+			_xyz.push_back(point.x);
+			_xyz.push_back(point.y);
+			_xyz.push_back(point.z);
+			_ids.push_back(index);
+		}
+		_cloudSize = cloud.size();
+		BuildIndex();
+	}
+
+	//		At most maxNN results when maxNN > 0, the closest ones when isSorted
+	virtual int RadiusSearch(const Eigen::Vector3f& query, double radius, std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN = 0, bool isSorted = true) const = 0;
+	//		Always sorted by distance
+	virtual int NearestKSearch(const Eigen::Vector3f& query, int k, std::vector<int>& indices, std::vector<float>& sqrDistances) const = 0;
+	virtual SpatialIndexType GetType() const = 0;
+	//		Same type and parameters, nothing built
+	virtual SpatialIndex* CreateEmpty() const = 0;
+
+	std::size_t GetNumberOfPoints() const
+	{
+		return _ids.size();
+	}
+
+	std::size_t GetCloudSize() const
+	{
+		return _cloudSize;
+	}
+
+	virtual std::size_t GetBytes() const
+	{
+		return _xyz.capacity() * sizeof(float) + _ids.capacity() * sizeof(int);
+	}
+
+protected:
+	SpatialIndex() : _cloudSize(0)
+	{
+	}
+
+	virtual void BuildIndex() = 0;
+	//		Reorders _xyz and _ids, order[new position] = old position
+	void Permute(const std::vector<int>& order);
+	//		Sorts by distance and keeps the first maxNN (0 : all)
+	static void SortResults(std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN);
+
+	std::vector<float> _xyz;
+	std::vector<int> _ids;
+	std::size_t _cloudSize;
+};
+
+//		*****************************************************************
+//				Flat Kd Tree
+//				Median split on the widest axis, nodes in one array and the
+//				points of each leaf contiguous in _xyz.
+//		*****************************************************************
+class FlatKdTree : public SpatialIndex
+{
+public:
+	FlatKdTree();
+	int RadiusSearch(const Eigen::Vector3f& query, double radius, std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN = 0, bool isSorted = true) const;
+	int NearestKSearch(const Eigen::Vector3f& query, int k, std::vector<int>& indices, std::vector<float>& sqrDistances) const;
+	SpatialIndexType GetType() const;
+	SpatialIndex* CreateEmpty() const;
+	std::size_t GetBytes() const;
+
+protected:
+	void BuildIndex();
+
+private:
+	static const int LEAF_SIZE = 16;
+	static const int MAX_DEPTH = 64;
+
+	struct Node
+	{
+		int begin;
+		int end;
+		int left;			//	-1 for a leaf, the right child is left + 1
+		int axis;
+		float split;
+	};
+
+	std::vector<Node> _nodes;
+};
+
+//		*****************************************************************
+//				Voxel Hash Index
+//				Points sorted by voxel, a hash map from voxel to its range.
+//				Best when the search radius is close to the voxel size.
+//		*****************************************************************
+class VoxelHashIndex : public SpatialIndex
+{
+public:
+	VoxelHashIndex(float voxelSize);
+	int RadiusSearch(const Eigen::Vector3f& query, double radius, std::vector<int>& indices, std::vector<float>& sqrDistances, unsigned int maxNN = 0, bool isSorted = true) const;
+	int NearestKSearch(const Eigen::Vector3f& query, int k, std::vector<int>& indices, std::vector<float>& sqrDistances) const;
+	SpatialIndexType GetType() const;
+	SpatialIndex* CreateEmpty() const;
+	std::size_t GetBytes() const;
+	float GetVoxelSize() const;
+
+protected:
+	void BuildIndex();
+
+private:
+	struct Range
+	{
+		int begin;
+		int end;
+	};
+
+	int GetVoxel(float coordinate) const;
+	static unsigned long long GetKey(int x, int y, int z);
+	const Range* FindVoxel(int x, int y, int z) const;
+
+	float _voxelSize;
+	std::unordered_map<unsigned long long, Range> _voxels;
+	int _min[3];
+	int _max[3];
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "pointCloud/SpatialIndexCache.h"
+
+SpatialIndexCache::SpatialIndexCache()
+{
+	_capacity = SPATIAL_INDEX_CACHE_DEFAULT_CAPACITY;
+	_voxelSize = SPATIAL_INDEX_CACHE_DEFAULT_VOXEL_SIZE;
+	_clock = 0;
+	_hits = 0;
+	_misses = 0;
+	SharedCloudListeners::Add(&SpatialIndexCache::OnWrite);
+}
+
+SpatialIndexCache* SpatialIndexCache::GetInstance()
+{
+	static SpatialIndexCache* cache = new SpatialIndexCache();
+	return cache;
+}
+
+void SpatialIndexCache::OnWrite(const void* id)
+{
+	GetInstance()->Invalidate(id);
+}
+
+//		Built outside the lock, two callers missing on the same key both build and the first insert wins
+SpatialIndex::Ptr SpatialIndexCache::GetIndex(pcl::PointCloud<PointT>::Ptr cloud, SpatialIndexType type)
+{
+	if (cloud.get() == NULL)
+		throw std::string("SpatialIndexCache: No input cloud");
+	float voxelSize;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		RemoveExpired();
+		for (std::size_t counter = 0; counter < _entries.size(); counter++)
+		{
+			Entry& entry = _entries[counter];
+			if (entry.id == cloud.get() && entry.type == type && entry.size == cloud->size())
+			{
+				entry.lastUse = ++_clock;
+				_hits++;
+				return entry.index;
+			}
+		}
+		_misses++;
+		voxelSize = _voxelSize;
+	}
+
+	SpatialIndex::Ptr index = SpatialIndex::Create(type, voxelSize);
+	index->Build(*cloud);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_capacity == 0 || (type == SpatialIndexType::VoxelHash && voxelSize != _voxelSize))
+		return index;
+	for (std::size_t counter = 0; counter < _entries.size(); counter++)
+	{
+		if (_entries[counter].id == cloud.get() && _entries[counter].type == type && _entries[counter].size == cloud->size())
+			return _entries[counter].index;
+	}
+	if (_entries.size() >= _capacity)
+		RemoveOldest();
+	Entry entry;
+	entry.cloud = cloud;
+	entry.id = cloud.get();
+	entry.size = cloud->size();
+	entry.type = type;
+	entry.index = index;
+	entry.lastUse = ++_clock;
+	_entries.push_back(entry);
+	return index;
+}
+
+void SpatialIndexCache::Invalidate(const void* id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (std::size_t counter = _entries.size(); counter > 0; counter--)
+	{
+		if (_entries[counter - 1].id == id)
+			_entries.erase(_entries.begin() + (counter - 1));
+	}
+}
+
+void SpatialIndexCache::SetVoxelSize(float voxelSize)
+{
+	if (!(voxelSize > 0))
+		throw std::string("SpatialIndexCache: Voxel size must be positive");
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (voxelSize == _voxelSize)
+		return;
+	_voxelSize = voxelSize;
+	for (std::size_t counter = _entries.size(); counter > 0; counter--)
+	{
+		if (_entries[counter - 1].type == SpatialIndexType::VoxelHash)
+			_entries.erase(_entries.begin() + (counter - 1));
+	}
+}
+
+float SpatialIndexCache::GetVoxelSize()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _voxelSize;
+}
+
+void SpatialIndexCache::SetCapacity(std::size_t capacity)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_capacity = capacity;
+	while (_entries.size() > _capacity)
+		RemoveOldest();
+}
+
+void SpatialIndexCache::Clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_entries.clear();
+}
+
+SpatialIndexCacheStats SpatialIndexCache::GetStats()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	RemoveExpired();
+	SpatialIndexCacheStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.entries = _entries.size();
+	stats.bytes = 0;
+	for (std::size_t counter = 0; counter < _entries.size(); counter++)
+		stats.bytes += _entries[counter].index->GetBytes();
+	return stats;
+}
+
+//		A freed buffer can come back at the same address, the weak reference tells them apart
+void SpatialIndexCache::RemoveExpired()
+{
+	for (std::size_t counter = _entries.size(); counter > 0; counter--)
+	{
+		if (_entries[counter - 1].cloud.expired())
+			_entries.erase(_entries.begin() + (counter - 1));
+	}
+}
+
+void SpatialIndexCache::RemoveOldest()
+{
+	if (_entries.empty())
+		return;
+	std::size_t oldest = 0;
+	for (std::size_t counter = 1; counter < _entries.size(); counter++)
+	{
+		if (_entries[counter].lastUse < _entries[oldest].lastUse)
+			oldest = counter;
+	}
+	_entries.erase(_entries.begin() + oldest);
+}
@@ -0,0 +1,68 @@
+#ifndef SPATIAL_INDEX_CACHE
+#define SPATIAL_INDEX_CACHE
+
+#include <mutex>
+#include <vector>
+#include <boost/weak_ptr.hpp>
+#include "pointCloud/SharedCloud.h"
+#include "pointCloud/SpatialIndex.h"
+
+#define SPATIAL_INDEX_CACHE_DEFAULT_CAPACITY 16
+#define SPATIAL_INDEX_CACHE_DEFAULT_VOXEL_SIZE 0.01f
+
+struct SpatialIndexCacheStats
+{
+	unsigned long long hits;
+	unsigned long long misses;
+	std::size_t entries;
+	std::size_t bytes;
+};
+
+//		*****************************************************************
+//				Spatial Index Cache
+//				Built on first use per cloud buffer and index type, then lent
+//				to every stage that searches the same buffer. Entries hold a
+//				weak reference to the buffer and are dropped with it, or when
+//				SharedCloud::Write modifies it in place.
+//		*****************************************************************
+class SpatialIndexCache
+{
+public:
+	static SpatialIndexCache* GetInstance();
+	SpatialIndex::Ptr GetIndex(pcl::PointCloud<PointT>::Ptr cloud, SpatialIndexType type = SpatialIndexType::FlatKdTree);
+	void Invalidate(const void* id);
+	//		Drops the voxel hash entries built with the previous size
+	void SetVoxelSize(float voxelSize);
+	float GetVoxelSize();
+	void SetCapacity(std::size_t capacity);
+	void Clear();
+	SpatialIndexCacheStats GetStats();
+
+private:
+	struct Entry
+	{
+		boost::weak_ptr<pcl::PointCloud<PointT> > cloud;
+		const void* id;
+		std::size_t size;
+		SpatialIndexType type;
+		SpatialIndex::Ptr index;
+		unsigned long long lastUse;
+	};
+
+	SpatialIndexCache();
+	SpatialIndexCache(const SpatialIndexCache&);
+	SpatialIndexCache& operator=(const SpatialIndexCache&);
+	static void OnWrite(const void* id);
+	void RemoveExpired();
+	void RemoveOldest();
+
+	std::mutex _mutex;
+	std::vector<Entry> _entries;
+	std::size_t _capacity;
+	float _voxelSize;
+	unsigned long long _clock;
+	unsigned long long _hits;
+	unsigned long long _misses;
+};
+
+#endif
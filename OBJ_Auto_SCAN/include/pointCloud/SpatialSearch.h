@@ -0,0 +1,61 @@
+#ifndef SPATIAL_SEARCH
+#define SPATIAL_SEARCH
+
+#include <pcl/search/search.h>
+#include "pointCloud/SpatialIndex.h"
+
+//		*****************************************************************
+//				Spatial Search
+//				pcl::search::Search over a borrowed SpatialIndex, for the PCL
+//				classes that take a search method. The cloud may be of another
+//				point type than the index was built on (e.g. the same points
+//				with normals) as long as the points are the same, in order.
+//				When PCL hands it a different cloud or a subset of indices it
+//				builds a private index of the same kind instead.
+//		*****************************************************************
+template <typename PointType>
+class SpatialSearch : public pcl::search::Search<PointType>
+{
+public:
+	typedef boost::shared_ptr<SpatialSearch<PointType> > Ptr;
+	typedef typename pcl::search::Search<PointType>::PointCloud PointCloud;
+	typedef typename pcl::search::Search<PointType>::PointCloudConstPtr PointCloudConstPtr;
+	typedef typename pcl::search::Search<PointType>::IndicesConstPtr IndicesConstPtr;
+	using pcl::search::Search<PointType>::nearestKSearch;
+	using pcl::search::Search<PointType>::radiusSearch;
+
+	SpatialSearch(SpatialIndex::Ptr index, const PointCloudConstPtr& cloud) : pcl::search::Search<PointType>("SpatialSearch", true), _index(index)
+	{
+		if (index.get() == NULL || cloud.get() == NULL || index->GetCloudSize() != cloud->size())
+			throw std::string("SpatialSearch: Index does not match the cloud");
+		this->input_ = cloud;
+	}
+
+	void setInputCloud(const PointCloudConstPtr& cloud, const IndicesConstPtr& indices = IndicesConstPtr())
+	{
+		bool isAllPoints = indices.get() == NULL || indices->size() == cloud->size();
+		if (cloud != this->input_ || !isAllPoints || _index->GetCloudSize() != cloud->size())
+		{
+			SpatialIndex::Ptr index(_index->CreateEmpty());
+			index->Build(*cloud, indices.get());
+			_index = index;
+		}
+		this->input_ = cloud;
+		this->indices_ = indices;
+	}
+
+	int nearestKSearch(const PointType& point, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const
+	{
+		return _index->NearestKSearch(point.getVector3fMap(), k, k_indices, k_sqr_distances);
+	}
+
+	int radiusSearch(const PointType& point, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const
+	{
+		return _index->RadiusSearch(point.getVector3fMap(), radius, k_indices, k_sqr_distances, max_nn, this->sorted_results_);
+	}
+
+private:
+	SpatialIndex::Ptr _index;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "DescriptorMatcher.h"
+
+#include <limits>
+#include <string>
+#include <utility>
+#include "kinfuApp/CpuParallelFor.h"
+#include "pointCloudProcessing/transform/TransformKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DESCRIPTOR_MATCHER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+static const int SOURCE_TILE = 8;
+static const int TARGET_TILE_BYTES = 64 * 1024;
+
+typedef float(*DistanceFunction)(const float* first, const float* second, int stride);
+
+//		*****************************************************************
+//				Squared Distance Kernels (stride is a multiple of 8)
+//		*****************************************************************
+static float DistanceScalar(const float* first, const float* second, int stride)
+{
+	float sum = 0;
+	for (int counter = 0; counter < stride; counter++)
+	{
+		float diff = first[counter] - second[counter];
+		sum += diff * diff;
+	}
+	return sum;
+}
+
+#ifdef DESCRIPTOR_MATCHER_X86
+static float DistanceSSE(const float* first, const float* second, int stride)
+{
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+	for (int counter = 0; counter < stride; counter += 8)
+	{
+		__m128 diff0 = _mm_sub_ps(_mm_loadu_ps(first + counter), _mm_loadu_ps(second + counter));
+		__m128 diff1 = _mm_sub_ps(_mm_loadu_ps(first + counter + 4), _mm_loadu_ps(second + counter + 4));
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(diff0, diff0));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(diff1, diff1));
+	}
+	__m128 sum = _mm_add_ps(sum0, sum1);
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(sum);
+}
+
+TARGET_AVX2 static float DistanceAVX2(const float* first, const float* second, int stride)
+{
+	__m256 sum = _mm256_setzero_ps();
+	for (int counter = 0; counter < stride; counter += 8)
+	{
+		__m256 diff = _mm256_sub_ps(_mm256_loadu_ps(first + counter), _mm256_loadu_ps(second + counter));
+		sum = _mm256_fmadd_ps(diff, diff, sum);
+	}
+	__m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+	half = _mm_add_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(half);
+}
+#endif
+
+static DistanceFunction GetDistanceFunction()
+{
+#ifdef DESCRIPTOR_MATCHER_X86
+	switch (TransformKernels::GetInstructionSet())
+	{
+	case InstructionSet::AVX2:
+		return &DistanceAVX2;
+	case InstructionSet::SSE:
+		return &DistanceSSE;
+	default:
+		break;
+	}
+#endif
+	return &DistanceScalar;
+}
+
+//		*****************************************************************
+//				Descriptor Matcher
+//		*****************************************************************
+
+DescriptorMatcher::DescriptorMatcher(unsigned int numberOfThreads) : _numberOfThreads(numberOfThreads)
+{
+}
+
+void DescriptorMatcher::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	_numberOfThreads = numberOfThreads;
+}
+
+//		Ties go to the lower index in both directions, as a serial scan would give
+void DescriptorMatcher::Match(const DescriptorMatrix& source, const DescriptorMatrix& target, std::vector<int>& source2Target, std::vector<int>& target2Source) const
+{
+	if (source.stride != target.stride)
+		throw std::string("DescriptorMatcher: Descriptors of different size");
+	source2Target.assign(source.rows, -1);
+	target2Source.assign(target.rows, -1);
+	if (source.rows == 0 || target.rows == 0)
+		return;
+
+	const DistanceFunction distance = GetDistanceFunction();
+	const int stride = source.stride;
+	const int targetTile = std::max(8, TARGET_TILE_BYTES / (int)(stride * sizeof(float)));
+	const unsigned int numberOfThreads = CpuThreadCount(_numberOfThreads);
+	//		Per thread best source for every target row, merged afterwards
+	std::vector<std::vector<std::pair<float, int> > > columnBest(numberOfThreads, std::vector<std::pair<float, int> >(target.rows, std::make_pair(std::numeric_limits<float>::infinity(), -1)));
+
+	CpuParallelFor(source.rows, 4 * SOURCE_TILE, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		std::vector<std::pair<float, int> >& columns = columnBest[thread];
+		for (int sourceBegin = begin; sourceBegin < end; sourceBegin += SOURCE_TILE)
+		{
+			int sourceEnd = std::min(end, sourceBegin + SOURCE_TILE);
+			std::pair<float, int> rowBest[SOURCE_TILE];
+			for (int row = 0; row < SOURCE_TILE; row++)
+				rowBest[row] = std::make_pair(std::numeric_limits<float>::infinity(), -1);
+			for (int targetBegin = 0; targetBegin < target.rows; targetBegin += targetTile)
+			{
+				int targetEnd = std::min(target.rows, targetBegin + targetTile);
+				for (int sourceRow = sourceBegin; sourceRow < sourceEnd; sourceRow++)
+				{
+					const float* sourceData = &source.data[(std::size_t)sourceRow * stride];
+					std::pair<float, int>& best = rowBest[sourceRow - sourceBegin];
+					for (int targetRow = targetBegin; targetRow < targetEnd; targetRow++)
+					{
+						float sqrDistance = distance(sourceData, &target.data[(std::size_t)targetRow * stride], stride);
+						if (sqrDistance < best.first || best.second < 0)
+							best = std::make_pair(sqrDistance, targetRow);
+						if (sqrDistance < columns[targetRow].first || columns[targetRow].second < 0)
+							columns[targetRow] = std::make_pair(sqrDistance, sourceRow);
+					}
+				}
+			}
+			for (int sourceRow = sourceBegin; sourceRow < sourceEnd; sourceRow++)
+				source2Target[sourceRow] = rowBest[sourceRow - sourceBegin].second;
+		}
+	});
+
+	for (int targetRow = 0; targetRow < target.rows; targetRow++)
+	{
+		std::pair<float, int> best = columnBest[0][targetRow];
+		for (unsigned int thread = 1; thread < numberOfThreads; thread++)
+		{
+			const std::pair<float, int>& candidate = columnBest[thread][targetRow];
+			if (candidate.second < 0)
+				continue;
+			if (best.second < 0 || candidate.first < best.first || (candidate.first == best.first && candidate.second < best.second))
+				best = candidate;
+		}
+		target2Source[targetRow] = best.second;
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef DESCRIPTOR_MATCHER
+#define DESCRIPTOR_MATCHER
+
+#include <algorithm>
+#include <vector>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+//		Histogram access for the descriptor types used by the correspondences
+inline const float* GetDescriptorData(const pcl::FPFHSignature33& descriptor) { return descriptor.histogram; }
+inline const float* GetDescriptorData(const pcl::PFHSignature125& descriptor) { return descriptor.histogram; }
+inline const float* GetDescriptorData(const pcl::PFHRGBSignature250& descriptor) { return descriptor.histogram; }
+inline const float* GetDescriptorData(const pcl::SHOT1344& descriptor) { return descriptor.descriptor; }
+inline float* GetDescriptorData(pcl::FPFHSignature33& descriptor) { return descriptor.histogram; }
+inline float* GetDescriptorData(pcl::PFHSignature125& descriptor) { return descriptor.histogram; }
+inline float* GetDescriptorData(pcl::PFHRGBSignature250& descriptor) { return descriptor.histogram; }
+inline float* GetDescriptorData(pcl::SHOT1344& descriptor) { return descriptor.descriptor; }
+inline int GetDescriptorSize(const pcl::FPFHSignature33&) { return 33; }
+inline int GetDescriptorSize(const pcl::PFHSignature125&) { return 125; }
+inline int GetDescriptorSize(const pcl::PFHRGBSignature250&) { return 250; }
+inline int GetDescriptorSize(const pcl::SHOT1344&) { return 1344; }
+
+//		Descriptors as one row major array, rows zero padded to a multiple of 8 floats
+struct DescriptorMatrix
+{
+	std::vector<float> data;
+	int rows;
+	int dimension;
+	int stride;
+
+	template <typename DescriptorT>
+	static DescriptorMatrix FromCloud(const pcl::PointCloud<DescriptorT>& descriptors)
+	{
+		DescriptorMatrix matrix;
+		matrix.rows = (int)descriptors.size();
+		matrix.dimension = GetDescriptorSize(DescriptorT());
+		matrix.stride = (matrix.dimension + 7) / 8 * 8;
+		matrix.data.assign((std::size_t)matrix.rows * matrix.stride, 0.0f);
+		for (int row = 0; row < matrix.rows; row++)
+		{
+			const float* source = GetDescriptorData(descriptors.points[row]);
+			std::copy(source, source + matrix.dimension, matrix.data.begin() + (std::size_t)row * matrix.stride);
+		}
+		return matrix;
+	}
+};
+
+//		*****************************************************************
+//				Descriptor Matcher
+//				Exact nearest neighbour in descriptor space by brute force.
+//				Both directions come from one pass over the distance matrix,
+//				computed in tiles on all threads with the instruction set
+//				TransformKernels selected (SSE / AVX2).
+//		*****************************************************************
+class DescriptorMatcher
+{
+public:
+	//		0 : one thread per core
+	DescriptorMatcher(unsigned int numberOfThreads = 0);
+	//		source2Target[i] is the nearest target row of source row i, target2Source the reverse; -1 when the other side is empty
+	void Match(const DescriptorMatrix& source, const DescriptorMatrix& target, std::vector<int>& source2Target, std::vector<int>& target2Source) const;
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+
+private:
+	unsigned int _numberOfThreads;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "MyFPFH.h"
+#include "trace/Tracer.h"
 
 MyFPFH::MyFPFH()
 {
@@ -13,77 +14,45 @@ MyFPFH::MyFPFH()
 
 void MyFPFH::Processing(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<PointT>::Ptr target, pcl::PointCloud<KeypointT>::Ptr targetKpts)
 {
+	TRACE_SCOPE("MyFPFH::Processing", "processing");
 	pcl::PointCloud<pcl::FPFHSignature33>::Ptr sourceDescriptor = ProessingDescriptor(source, sourceKpts);
 	pcl::PointCloud<pcl::FPFHSignature33>::Ptr targetDescriptor = ProessingDescriptor(target, targetKpts);
-	std::vector<int> source2Target = ProcessingCorrespondences(sourceDescriptor, targetDescriptor);
-	std::vector<int> target2Source = ProcessingCorrespondences(targetDescriptor, sourceDescriptor);
+	std::vector<int> source2Target;
+	std::vector<int> target2Source;
+	ProcessingCorrespondences(sourceDescriptor, targetDescriptor, source2Target, target2Source);
 	pcl::CorrespondencesPtr correspondences = ProcessingFilterCorrespondences(sourceKpts, targetKpts, source2Target, target2Source);
 	DetermineInitialTransformation(source, sourceKpts, targetKpts, correspondences);
 }
 
 pcl::PointCloud<pcl::FPFHSignature33>::Ptr MyFPFH::ProessingDescriptor(pcl::PointCloud<PointT>::Ptr cloud, pcl::PointCloud<KeypointT>::Ptr keypoints)
 {
-	pcl::Feature<PointT, pcl::FPFHSignature33>::Ptr featureExtractor;
 	pcl::PointCloud<pcl::FPFHSignature33>::Ptr descriptor;
 	descriptor.reset(new pcl::PointCloud<pcl::FPFHSignature33>());
 
-	featureExtractor.reset(new pcl::FPFHEstimation<PointT, pcl::Normal, pcl::FPFHSignature33>());
-	featureExtractor->setSearchMethod(pcl::search::Search<PointT>::Ptr(new pcl::search::KdTree<PointT>));
-	featureExtractor->setRadiusSearch(_descriptorRadiusSearch);
 	pcl::PointCloud<PointT>::Ptr kpts(new pcl::PointCloud<PointT>);
 	kpts->points.resize(keypoints->points.size());
 	pcl::copyPointCloud(*keypoints, *kpts);
-	pcl::FeatureFromNormals<PointT, pcl::Normal, pcl::FPFHSignature33>::Ptr featureFromNormals = boost::dynamic_pointer_cast<pcl::FeatureFromNormals<PointT, pcl::Normal, pcl::FPFHSignature33> > (featureExtractor);
-	featureExtractor->setSearchSurface(cloud);
-	featureExtractor->setInputCloud(kpts);
-	if (featureFromNormals)
+	ComputeDescriptorsParallel<pcl::FPFHSignature33>([this]()
 	{
-		pcl::PointCloud<pcl::Normal>::Ptr normals(new  pcl::PointCloud<pcl::Normal>);
-		pcl::NormalEstimation<PointT, pcl::Normal> normalEstimation;
-		normalEstimation.setSearchMethod(pcl::search::Search<PointT>::Ptr(new pcl::search::KdTree<PointT>));
-		normalEstimation.setRadiusSearch(_normalRadiusSearch);
-		normalEstimation.setInputCloud(cloud);
-		normalEstimation.compute(*normals);
-		featureFromNormals->setInputNormals(normals);
-	}
-	featureExtractor->compute(*descriptor);
-	for (int j = 0, i = static_cast<int> (descriptor->size()) - 1; i >= 0; --i)
-	{
-		if (!pcl_isfinite(descriptor->at(i).histogram[0])) //skipping NaNs
-		{
-			descriptor->erase(descriptor->begin() + i);
-			keypoints->erase(keypoints->begin() + i);
-			j++;
-			//cout << "erase" << std::flush;
-			continue;
-		}
-	}
+		pcl::Feature<PointT, pcl::FPFHSignature33>::Ptr featureExtractor(new pcl::FPFHEstimation<PointT, pcl::Normal, pcl::FPFHSignature33>());
+		featureExtractor->setRadiusSearch(_descriptorRadiusSearch);
+		return featureExtractor;
+	}, cloud, NormalsService::GetInstance()->GetNormals(cloud, _normalRadiusSearch), kpts, *descriptor);
+	RemoveNaNDescriptors(*descriptor, *keypoints);
 	return descriptor;
 }
 
-std::vector<int> MyFPFH::ProcessingCorrespondences(pcl::PointCloud<pcl::FPFHSignature33>::Ptr source, pcl::PointCloud<pcl::FPFHSignature33>::Ptr target)
+void MyFPFH::ProcessingCorrespondences(pcl::PointCloud<pcl::FPFHSignature33>::Ptr source, pcl::PointCloud<pcl::FPFHSignature33>::Ptr target, std::vector<int>& source2Target, std::vector<int>& target2Source)
 {
-	std::vector<int> correspondences;
-	correspondences.resize(source->size());
-	// Use a KdTree to search for the nearest matches in feature space
-	pcl::KdTreeFLANN<pcl::FPFHSignature33> descriptorKdtree;
-	descriptorKdtree.setInputCloud(target);
-	// Find the index of the best match for each keypoint, and store it in "correspondences_out"
-	std::vector<int> kIndices(_correspondencesK);
-	std::vector<float> kSquaredDistances(_correspondencesK);
-	for (int i = 0; i < static_cast<int> (source->size()); ++i)
-	{
-		descriptorKdtree.nearestKSearch(*source, i, _correspondencesK, kIndices, kSquaredDistances);
-		correspondences[i] = kIndices[0];
-	}
-	return correspondences;
+	DescriptorMatcher matcher;
+	matcher.Match(DescriptorMatrix::FromCloud(*source), DescriptorMatrix::FromCloud(*target), source2Target, target2Source);
 }
 
 pcl::CorrespondencesPtr MyFPFH::ProcessingFilterCorrespondences(pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<KeypointT>::Ptr targetKpts, std::vector<int> source2Target, std::vector<int> target2Source)
 {
 	std::vector<std::pair<unsigned, unsigned> > correspondences;
 	for (unsigned cIdx = 0; cIdx < source2Target.size(); ++cIdx)
-		if (target2Source[source2Target[cIdx]] == static_cast<int> (cIdx))
+		if (source2Target[cIdx] >= 0 && target2Source[source2Target[cIdx]] == static_cast<int> (cIdx))
 			correspondences.push_back(std::make_pair(cIdx, source2Target[cIdx]));
 
 	_correspondencesResult->resize(correspondences.size());
@@ -11,6 +11,8 @@
 #include <pcl/filters/filter.h>
 
 #include "CorrespondencesProcessing.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
+#include "ParallelDescriptor.h"
 
 class MyFPFH : public CorrespondencesProcessing
 {
@@ -27,7 +29,7 @@ public:
 
 private:
 	pcl::PointCloud<pcl::FPFHSignature33>::Ptr ProessingDescriptor(pcl::PointCloud<PointT>::Ptr cloud, pcl::PointCloud<KeypointT>::Ptr keypoints);
-	std::vector<int> ProcessingCorrespondences(pcl::PointCloud<pcl::FPFHSignature33>::Ptr source, pcl::PointCloud<pcl::FPFHSignature33>::Ptr target);
+	void ProcessingCorrespondences(pcl::PointCloud<pcl::FPFHSignature33>::Ptr source, pcl::PointCloud<pcl::FPFHSignature33>::Ptr target, std::vector<int>& source2Target, std::vector<int>& target2Source);
 	pcl::CorrespondencesPtr ProcessingFilterCorrespondences(pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<KeypointT>::Ptr targetKpts, std::vector<int> source2Target, std::vector<int> target2Source);
 	void DetermineInitialTransformation(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<KeypointT>::Ptr targetKpts, pcl::CorrespondencesPtr correspondences);
 
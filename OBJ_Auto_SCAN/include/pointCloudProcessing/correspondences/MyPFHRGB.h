@@ -10,6 +10,8 @@
 #include <pcl/filters/filter.h>
 
 #include "CorrespondencesProcessing.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
+#include "ParallelDescriptor.h"
 
 class MyPFHRGB : public CorrespondencesProcessing
 {
@@ -26,7 +28,7 @@ public:
 
 private:
 	pcl::PointCloud<pcl::PFHRGBSignature250>::Ptr ProessingDescriptor(pcl::PointCloud<PointT>::Ptr cloud, pcl::PointCloud<KeypointT>::Ptr keypoints);
-	std::vector<int> ProcessingCorrespondences(pcl::PointCloud<pcl::PFHRGBSignature250>::Ptr source, pcl::PointCloud<pcl::PFHRGBSignature250>::Ptr target);
+	void ProcessingCorrespondences(pcl::PointCloud<pcl::PFHRGBSignature250>::Ptr source, pcl::PointCloud<pcl::PFHRGBSignature250>::Ptr target, std::vector<int>& source2Target, std::vector<int>& target2Source);
 	pcl::CorrespondencesPtr ProcessingFilterCorrespondences(pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<KeypointT>::Ptr targetKpts, std::vector<int> source2Target, std::vector<int> target2Source);
 	void DetermineInitialTransformation(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<KeypointT>::Ptr sourceKpts, pcl::PointCloud<KeypointT>::Ptr targetKpts, pcl::CorrespondencesPtr correspondences);
 
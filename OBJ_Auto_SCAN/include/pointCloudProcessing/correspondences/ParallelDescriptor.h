@@ -0,0 +1,75 @@
+#ifndef PARALLEL_DESCRIPTOR
+#define PARALLEL_DESCRIPTOR
+
+#include <functional>
+#include <limits>
+#include <pcl/features/feature.h>
+#include "Typedef.h"
+#include "kinfuApp/CpuParallelFor.h"
+#include "pointCloud/SpatialIndexCache.h"
+#include "pointCloud/SpatialSearch.h"
+#include "DescriptorMatcher.h"
+
+//		Descriptors of the keypoints, split over the threads. Every share gets its own
+//		estimator (createFeature sets the search radius / k) over the same surface,
+//		normals and spatial index; a share that fails to compute comes back as NaN.
+template <typename DescriptorT>
+void ComputeDescriptorsParallel(const std::function<typename pcl::Feature<PointT, DescriptorT>::Ptr()>& createFeature, pcl::PointCloud<PointT>::Ptr surface, pcl::PointCloud<NormalT>::Ptr normals, pcl::PointCloud<PointT>::Ptr keypoints, pcl::PointCloud<DescriptorT>& descriptors, unsigned int numberOfThreads = 0)
+{
+	int size = (int)keypoints->size();
+	descriptors.points.resize(size);
+	descriptors.width = size;
+	descriptors.height = 1;
+	descriptors.is_dense = false;
+	SpatialIndex::Ptr index = SpatialIndexCache::GetInstance()->GetIndex(surface);
+	int grain = std::max(8, size / (int)(4 * CpuThreadCount(numberOfThreads)) + 1);
+	CpuParallelFor(size, grain, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		typename pcl::Feature<PointT, DescriptorT>::Ptr feature = createFeature();
+		feature->setSearchMethod(typename SpatialSearch<PointT>::Ptr(new SpatialSearch<PointT>(index, surface)));
+		feature->setSearchSurface(surface);
+		feature->setInputCloud(keypoints);
+		boost::shared_ptr<std::vector<int> > indices(new std::vector<int>());
+		for (int counter = begin; counter < end; counter++)
+			indices->push_back(counter);
+		feature->setIndices(indices);
+		typename pcl::FeatureFromNormals<PointT, NormalT, DescriptorT>::Ptr featureFromNormals = boost::dynamic_pointer_cast<pcl::FeatureFromNormals<PointT, NormalT, DescriptorT> >(feature);
+		if (featureFromNormals)
+			featureFromNormals->setInputNormals(normals);
+		pcl::PointCloud<DescriptorT> share;
+		feature->compute(share);
+		for (int counter = begin; counter < end; counter++)
+		{
+			if ((int)share.size() == end - begin)
+				descriptors.points[counter] = share.points[counter - begin];
+			else
+				GetDescriptorData(descriptors.points[counter])[0] = std::numeric_limits<float>::quiet_NaN();
+		}
+	});
+}
+
+//		Drops the NaN descriptors and their keypoints in one pass
+template <typename DescriptorT>
+void RemoveNaNDescriptors(pcl::PointCloud<DescriptorT>& descriptors, pcl::PointCloud<KeypointT>& keypoints)
+{
+	std::size_t kept = 0;
+	for (std::size_t counter = 0; counter < descriptors.size(); counter++)
+	{
+		if (!pcl_isfinite(GetDescriptorData(descriptors.points[counter])[0]))
+			continue;
+		if (kept != counter)
+		{
+			descriptors.points[kept] = descriptors.points[counter];
+			keypoints.points[kept] = keypoints.points[counter];
+		}
+		kept++;
+	}
+	descriptors.points.resize(kept);
+	descriptors.width = (uint32_t)kept;
+	descriptors.height = 1;
+	keypoints.points.resize(kept);
+	keypoints.width = (uint32_t)kept;
+	keypoints.height = 1;
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "BoundingBoxFilter.h"
+#include "trace/Tracer.h"
 
 BoundingBoxFilter::BoundingBoxFilter()
 {
@@ -15,6 +16,7 @@ BoundingBoxFilter::BoundingBoxFilter()
 
 void BoundingBoxFilter::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("BoundingBoxFilter::Processing", "processing");
 	_boxFilter.setMin(Eigen::Vector4f(_minX, _minY, _minZ, 1.0));
 	_boxFilter.setMax(Eigen::Vector4f(_maxX, _maxY, _maxZ, 1.0));
 	_boxFilter.setInputCloud(cloud);
@@ -70,4 +72,16 @@ void BoundingBoxFilter::SetMeanK(int meanK)
 void BoundingBoxFilter::SetStddevMulThresh(float stddevMulThresh)
 {
 	return;
+}
+
+void BoundingBoxFilter::SetKeepOrganized(bool isKeepOrganized)
+{
+	return;
+}
+
+FilterProcessing* BoundingBoxFilter::Clone()
+{
+	BoundingBoxFilter* filter = new BoundingBoxFilter(*this);
+	filter->_filteredCloud.reset(new pcl::PointCloud<PointT>());
+	return filter;
 }
\ No newline at end of file
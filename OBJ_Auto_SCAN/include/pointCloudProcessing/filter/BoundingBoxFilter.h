@@ -3,19 +3,20 @@
 
 #include "Typedef.h"
 #include "FilterProcessing.h"
-#include "Conversion.h"
 #include <pcl/filters/crop_box.h>
 
 class BoundingBoxFilter : public FilterProcessing
 {
 public:
 	BoundingBoxFilter();
+	FilterProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PointCloud<PointT>::Ptr GetResult();
 	void SetLeafSize(float x, float y, float z);
 	void SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	void SetMeanK(int meanK);
 	void SetStddevMulThresh(float stddevMulThresh);
+	void SetKeepOrganized(bool isKeepOrganized);
 
 private:
 	pcl::PointCloud<PointT>::Ptr _filteredCloud;
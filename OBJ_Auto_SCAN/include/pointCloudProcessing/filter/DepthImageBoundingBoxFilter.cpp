@@ -1,32 +1,59 @@
 #include "DepthImageBoundingBoxFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include "trace/Tracer.h"
+
+DepthImageBoundingBoxFilter::DepthImageBoundingBoxFilter()
+{
+	_filteredCloud.reset(new pcl::PointCloud<PointT>());
+
+	//	default : nothing is kept until SetBoundingBox
+	_minX = 0;
+	_maxX = 0;
+	_minY = 0;
+	_maxY = 0;
+	_minZ = 0;
+	_maxZ = 0;
+}
+
+//		Crops the pixels [minX, maxX) x [minY, maxY) and masks the depths outside [minZ, maxZ] with NaN,
+//		one row at a time into a pooled buffer
 void DepthImageBoundingBoxFilter::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
-	int width = _maxX - _minX;
-	int height = _maxY - _minY;
-	if (width == 1 || height == 1)
+	TRACE_SCOPE("DepthImageBoundingBoxFilter::Processing", "processing");
+	if (cloud->height <= 1)
+		throw std::string("DepthImageBoundingBoxFilter: Point cloud is not organized");
+	int beginX = std::max(0, (int)std::ceil(_minX));
+	int endX = std::min((int)cloud->width, (int)std::floor(_maxX));
+	int beginY = std::max(0, (int)std::ceil(_minY));
+	int endY = std::min((int)cloud->height, (int)std::floor(_maxY));
+	int width = endX - beginX;
+	int height = endY - beginY;
+	if (width <= 1 || height <= 1)
 		return;		//pcl 2D execption
-	//pcl::PointCloud<PointT>::Ptr cpyCloud;
-	//cpyCloud.reset(new pcl::PointCloud<PointT>(width / 2, height / 2));
-	_filteredCloud.reset(new pcl::PointCloud<PointT>(width, height));
-	for (int widthIndex = std::ceil(_minX); widthIndex < std::floor(_maxX); widthIndex++)
+	_filteredCloud.reset();
+	_filteredCloud = _buffers.Acquire(width, height);
+	_filteredCloud->header = cloud->header;
+	_filteredCloud->is_dense = false;
+
+	PointT invalid;
+	invalid.x = invalid.y = invalid.z = std::numeric_limits<float>::quiet_NaN();
+	invalid.r = invalid.g = invalid.b = 0;
+	const float minZ = (float)_minZ;
+	const float maxZ = (float)_maxZ;
+	for (int row = 0; row < height; row++)
 	{
-		for (int heightIndex = std::ceil(_minY); heightIndex < std::floor(_maxY); heightIndex++)
+		const PointT* source = &cloud->points[(std::size_t)(row + beginY) * cloud->width + beginX];
+		PointT* target = &_filteredCloud->points[(std::size_t)row * width];
+		for (int column = 0; column < width; column++)
 		{
-			int filteredWidthIndex = widthIndex - std::ceil(_minX);
-			int filteredHeightIndex = heightIndex - std::ceil(_minY);
-			PointT point(cloud->at(widthIndex, heightIndex));
-			if (point.z > _maxZ || point.z < _minZ)
-			{
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).x = -NAN;
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).y = -NAN;
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).z = -NAN;
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).r = -NAN;
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).g = -NAN;
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex).b = -NAN;
-			}
+			if (source[column].z > maxZ || source[column].z < minZ)
+				target[column] = invalid;
 			else
-				_filteredCloud->at(filteredWidthIndex, filteredHeightIndex) = point;
+				target[column] = source[column];
 		}
 	}
 }
@@ -62,4 +89,16 @@ void DepthImageBoundingBoxFilter::SetMeanK(int meanK)
 void DepthImageBoundingBoxFilter::SetStddevMulThresh(float stddevMulThresh)
 {
 	return;
+}
+
+void DepthImageBoundingBoxFilter::SetKeepOrganized(bool isKeepOrganized)
+{
+	return;
+}
+
+FilterProcessing* DepthImageBoundingBoxFilter::Clone()
+{
+	DepthImageBoundingBoxFilter* filter = new DepthImageBoundingBoxFilter(*this);
+	filter->_filteredCloud.reset(new pcl::PointCloud<PointT>());
+	return filter;
 }
\ No newline at end of file
@@ -3,19 +3,24 @@
 
 #include "Typedef.h"
 #include "FilterProcessing.h"
+#include "FilterBufferPool.h"
 
 class DepthImageBoundingBoxFilter : public FilterProcessing
 {
 public:
+	DepthImageBoundingBoxFilter();
+	FilterProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PointCloud<PointT>::Ptr GetResult();
 	void SetLeafSize(float x, float y, float z);
 	void SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	void SetMeanK(int meanK);
 	void SetStddevMulThresh(float stddevMulThresh);
+	void SetKeepOrganized(bool isKeepOrganized);
 
 private:
 	pcl::PointCloud<PointT>::Ptr _filteredCloud;
+	FilterBufferPool _buffers;
 	double _minX;
 	double _maxX;
 	double _minY;
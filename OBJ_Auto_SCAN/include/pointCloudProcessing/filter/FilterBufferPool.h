@@ -0,0 +1,63 @@
+#ifndef FILTER_BUFFER_POOL
+#define FILTER_BUFFER_POOL
+
+#include <vector>
+#include "Typedef.h"
+#include "pointCloud/SharedCloud.h"
+
+#define FILTER_BUFFER_POOL_SIZE 3
+
+//		*****************************************************************
+//				Filter Buffer Pool
+//				Result buffers of the filters that run on every camera frame.
+//				A buffer is handed out again only when the pool holds its last
+//				reference, so the viewer and _tmpPointCloud can keep the frame
+//				they show while the next one is written into another buffer.
+//				Copies of the pool (Clone) start empty.
+//		*****************************************************************
+class FilterBufferPool
+{
+public:
+	FilterBufferPool()
+	{
+	}
+
+	FilterBufferPool(const FilterBufferPool& pool)
+	{
+	}
+
+	FilterBufferPool& operator=(const FilterBufferPool& pool)
+	{
+		return *this;
+	}
+
+	//		Points are left as they were, the caller writes every one of them
+	pcl::PointCloud<PointT>::Ptr Acquire(uint32_t width, uint32_t height)
+	{
+		pcl::PointCloud<PointT>::Ptr buffer;
+		for (int counter = 0; counter < _buffers.size(); counter++)
+		{
+			if (_buffers[counter].unique())
+			{
+				buffer = _buffers[counter];
+				SharedCloudListeners::Notify(buffer.get());
+				break;
+			}
+		}
+		if (buffer.get() == NULL)
+		{
+			buffer.reset(new pcl::PointCloud<PointT>());
+			if (_buffers.size() < FILTER_BUFFER_POOL_SIZE)
+				_buffers.push_back(buffer);
+		}
+		buffer->points.resize((std::size_t)width * height);
+		buffer->width = width;
+		buffer->height = height;
+		return buffer;
+	}
+
+private:
+	std::vector<pcl::PointCloud<PointT>::Ptr> _buffers;
+};
+
+#endif
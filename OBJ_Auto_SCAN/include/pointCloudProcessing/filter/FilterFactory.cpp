@@ -26,4 +26,10 @@ FilterProcessing* FilterFactory::GetDepthImageBoundingBoxFilter()
 {
 	static DepthImageBoundingBoxFilter* filter = new DepthImageBoundingBoxFilter();
 	return filter;
+}
+
+FilterProcessing* FilterFactory::GetHashVoxelGridFilter()
+{
+	static HashVoxelGridFilter* filter = new HashVoxelGridFilter();
+	return filter;
 }
\ No newline at end of file
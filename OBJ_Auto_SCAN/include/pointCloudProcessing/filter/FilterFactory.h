@@ -6,6 +6,7 @@
 #include "BoundingBoxFilter.h"
 #include "OutlierRemovalFilter.h"
 #include "DepthImageBoundingBoxFilter.h"
+#include "HashVoxelGridFilter.h"
 
 class FilterFactory
 {
@@ -15,6 +16,7 @@ public:
 	FilterProcessing* GetBoundingBoxFilter();
 	FilterProcessing* GetOutlierRemovalFilter();
 	FilterProcessing* GetDepthImageBoundingBoxFilter();
+	FilterProcessing* GetHashVoxelGridFilter();
 
 private:
 
@@ -0,0 +1,292 @@
+#include "HashVoxelGridFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "kinfuApp/CpuParallelFor.h"
+#include "trace/Tracer.h"
+
+static const int POINTS_PER_CHUNK = 1 << 16;
+static const double MAX_VOXEL_COORDINATE = 4.0e18;
+
+struct HashVoxel
+{
+	long long key[3];
+	int first;
+	int count;
+	double sum[3];
+	unsigned long long color[4];		//	b g r a
+	PointT centroid;
+};
+
+static inline unsigned long long HashVoxelKey(const long long* key)
+{
+	unsigned long long hash = (unsigned long long)key[0] * 73856093ull ^ (unsigned long long)key[1] * 19349663ull ^ (unsigned long long)key[2] * 83492791ull;
+	return hash ^ (hash >> 29);
+}
+
+HashVoxelGridFilter::HashVoxelGridFilter()
+{
+	_filteredCloud.reset(new pcl::PointCloud<PointT>());
+
+	//	default
+	_x = 0.01f;
+	_y = 0.01f;
+	_z = 0.01f;
+	_isKeepOrganized = false;
+	_numberOfThreads = 0;
+}
+
+//		1. every point gets a bucket from the hash of its voxel, points are counting sorted by bucket
+//		2. each bucket is reduced on its own with an open addressing table, in point order
+//		3. voxels are written in the order of their first point
+void HashVoxelGridFilter::Processing(pcl::PointCloud<PointT>::Ptr cloud)
+{
+	TRACE_SCOPE("HashVoxelGridFilter::Processing", "processing");
+	if (!(_x > 0) || !(_y > 0) || !(_z > 0))
+		throw std::string("HashVoxelGridFilter: Leaf size must be positive");
+	const int size = (int)cloud->size();
+	const double inverse[3] = { 1.0 / _x, 1.0 / _y, 1.0 / _z };
+	const PointT* points = cloud->points.data();
+	auto getKey = [&inverse](const PointT& point, long long* key)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			double coordinate = std::floor(point.data[axis] * inverse[axis]);
+			if (std::abs(coordinate) > MAX_VOXEL_COORDINATE)
+				throw std::string("HashVoxelGridFilter: Leaf size too small for the cloud extent");
+			key[axis] = (long long)coordinate;
+		}
+	};
+
+	const unsigned int numberOfThreads = CpuThreadCount(_numberOfThreads);
+	const int numberOfChunks = (size + POINTS_PER_CHUNK - 1) / POINTS_PER_CHUNK;
+	const int numberOfBuckets = (int)std::min<unsigned int>(4 * numberOfThreads, 1024);
+
+	//		1. bucket of every point (-1 for non finite), counts per chunk and bucket
+	std::vector<short> buckets(size);
+	std::vector<int> counts((std::size_t)numberOfChunks * numberOfBuckets, 0);
+	std::vector<std::string> errors(numberOfChunks);
+	CpuParallelFor(numberOfChunks, 1, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int chunk = begin; chunk < end; chunk++)
+		{
+			int* chunkCounts = &counts[(std::size_t)chunk * numberOfBuckets];
+			int last = std::min(size, (chunk + 1) * POINTS_PER_CHUNK);
+			try
+			{
+				for (int index = chunk * POINTS_PER_CHUNK; index < last; index++)
+				{
+					const PointT& point = points[index];
+					if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z))
+					{
+						buckets[index] = -1;
+						continue;
+					}
+					long long key[3];
+					getKey(point, key);
+					short bucket = (short)(HashVoxelKey(key) % numberOfBuckets);
+					buckets[index] = bucket;
+					chunkCounts[bucket]++;
+				}
+			}
+			catch (std::string& error)
+			{
+				errors[chunk] = error;
+			}
+		}
+	});
+	for (int chunk = 0; chunk < numberOfChunks; chunk++)
+	{
+		if (!errors[chunk].empty())
+			throw errors[chunk];
+	}
+
+	//		Offsets : bucket major, chunk minor, so every bucket is one range in point order
+	std::vector<int> bucketBegin(numberOfBuckets + 1, 0);
+	std::vector<int> offsets((std::size_t)numberOfChunks * numberOfBuckets);
+	int total = 0;
+	for (int bucket = 0; bucket < numberOfBuckets; bucket++)
+	{
+		bucketBegin[bucket] = total;
+		for (int chunk = 0; chunk < numberOfChunks; chunk++)
+		{
+			offsets[(std::size_t)chunk * numberOfBuckets + bucket] = total;
+			total += counts[(std::size_t)chunk * numberOfBuckets + bucket];
+		}
+	}
+	bucketBegin[numberOfBuckets] = total;
+	std::vector<int> order(std::max(total, size));
+	CpuParallelFor(numberOfChunks, 1, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int chunk = begin; chunk < end; chunk++)
+		{
+			int* chunkOffsets = &offsets[(std::size_t)chunk * numberOfBuckets];
+			int last = std::min(size, (chunk + 1) * POINTS_PER_CHUNK);
+			for (int index = chunk * POINTS_PER_CHUNK; index < last; index++)
+			{
+				if (buckets[index] >= 0)
+					order[chunkOffsets[buckets[index]]++] = index;
+			}
+		}
+	});
+	std::vector<short>().swap(buckets);
+
+	//		2. reduce every bucket
+	std::vector<std::vector<HashVoxel> > voxels(numberOfBuckets);
+	CpuParallelFor(numberOfBuckets, 1, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		for (int bucket = begin; bucket < end; bucket++)
+		{
+			int count = bucketBegin[bucket + 1] - bucketBegin[bucket];
+			std::size_t tableSize = 16;
+			while (tableSize < (std::size_t)count * 2)
+				tableSize <<= 1;
+			std::vector<int> table(tableSize, -1);
+			std::vector<HashVoxel>& bucketVoxels = voxels[bucket];
+			for (int position = bucketBegin[bucket]; position < bucketBegin[bucket + 1]; position++)
+			{
+				int index = order[position];
+				const PointT& point = points[index];
+				long long key[3];
+				getKey(point, key);
+				std::size_t slot = (std::size_t)(HashVoxelKey(key) / numberOfBuckets) & (tableSize - 1);
+				while (table[slot] >= 0)
+				{
+					const HashVoxel& voxel = bucketVoxels[table[slot]];
+					if (voxel.key[0] == key[0] && voxel.key[1] == key[1] && voxel.key[2] == key[2])
+						break;
+					slot = (slot + 1) & (tableSize - 1);
+				}
+				if (table[slot] < 0)
+				{
+					HashVoxel voxel;
+					voxel.key[0] = key[0];
+					voxel.key[1] = key[1];
+					voxel.key[2] = key[2];
+					voxel.first = index;
+					voxel.count = 0;
+					voxel.sum[0] = voxel.sum[1] = voxel.sum[2] = 0;
+					voxel.color[0] = voxel.color[1] = voxel.color[2] = voxel.color[3] = 0;
+					table[slot] = (int)bucketVoxels.size();
+					bucketVoxels.push_back(voxel);
+				}
+				HashVoxel& voxel = bucketVoxels[table[slot]];
+				voxel.count++;
+				voxel.sum[0] += point.x;
+				voxel.sum[1] += point.y;
+				voxel.sum[2] += point.z;
+				voxel.color[0] += point.b;
+				voxel.color[1] += point.g;
+				voxel.color[2] += point.r;
+				voxel.color[3] += point.a;
+			}
+			for (std::size_t counter = 0; counter < bucketVoxels.size(); counter++)
+			{
+				HashVoxel& voxel = bucketVoxels[counter];
+				unsigned long long half = voxel.count / 2;
+				voxel.centroid.x = (float)(voxel.sum[0] / voxel.count);
+				voxel.centroid.y = (float)(voxel.sum[1] / voxel.count);
+				voxel.centroid.z = (float)(voxel.sum[2] / voxel.count);
+				voxel.centroid.b = (uint8_t)((voxel.color[0] + half) / voxel.count);
+				voxel.centroid.g = (uint8_t)((voxel.color[1] + half) / voxel.count);
+				voxel.centroid.r = (uint8_t)((voxel.color[2] + half) / voxel.count);
+				voxel.centroid.a = (uint8_t)((voxel.color[3] + half) / voxel.count);
+			}
+		}
+	});
+
+	//		3. order holds the voxel at its first point from here on
+	std::vector<int> voxelBegin(numberOfBuckets + 1, 0);
+	for (int bucket = 0; bucket < numberOfBuckets; bucket++)
+		voxelBegin[bucket + 1] = voxelBegin[bucket] + (int)voxels[bucket].size();
+	std::fill(order.begin(), order.begin() + size, -1);
+	std::vector<const HashVoxel*> voxelById(voxelBegin[numberOfBuckets]);
+	for (int bucket = 0; bucket < numberOfBuckets; bucket++)
+	{
+		for (std::size_t counter = 0; counter < voxels[bucket].size(); counter++)
+		{
+			int id = voxelBegin[bucket] + (int)counter;
+			voxelById[id] = &voxels[bucket][counter];
+			order[voxels[bucket][counter].first] = id;
+		}
+	}
+
+	pcl::PointCloud<PointT>::Ptr result(new pcl::PointCloud<PointT>());
+	result->header = cloud->header;
+	result->sensor_origin_ = cloud->sensor_origin_;
+	result->sensor_orientation_ = cloud->sensor_orientation_;
+	if (_isKeepOrganized)
+	{
+		PointT invalid;
+		invalid.x = invalid.y = invalid.z = std::numeric_limits<float>::quiet_NaN();
+		result->points.assign(size, invalid);
+		for (int index = 0; index < size; index++)
+		{
+			if (order[index] >= 0)
+				result->points[index] = voxelById[order[index]]->centroid;
+		}
+		result->width = cloud->width;
+		result->height = cloud->height;
+		result->is_dense = (int)voxelById.size() == size;
+	}
+	else
+	{
+		result->points.reserve(voxelById.size());
+		for (int index = 0; index < size; index++)
+		{
+			if (order[index] >= 0)
+				result->points.push_back(voxelById[order[index]]->centroid);
+		}
+		result->width = (uint32_t)result->points.size();
+		result->height = 1;
+		result->is_dense = true;
+	}
+	_filteredCloud = result;
+}
+
+pcl::PointCloud<PointT>::Ptr HashVoxelGridFilter::GetResult()
+{
+	return _filteredCloud;
+}
+
+void HashVoxelGridFilter::SetLeafSize(float x, float y, float z)
+{
+	_x = x;
+	_y = y;
+	_z = z;
+}
+
+void HashVoxelGridFilter::SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
+{
+	return;
+}
+
+void HashVoxelGridFilter::SetMeanK(int meanK)
+{
+	return;
+}
+
+void HashVoxelGridFilter::SetStddevMulThresh(float stddevMulThresh)
+{
+	return;
+}
+
+void HashVoxelGridFilter::SetKeepOrganized(bool isKeepOrganized)
+{
+	_isKeepOrganized = isKeepOrganized;
+}
+
+void HashVoxelGridFilter::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	_numberOfThreads = numberOfThreads;
+}
+
+FilterProcessing* HashVoxelGridFilter::Clone()
+{
+	HashVoxelGridFilter* filter = new HashVoxelGridFilter(*this);
+	filter->_filteredCloud.reset(new pcl::PointCloud<PointT>());
+	return filter;
+}
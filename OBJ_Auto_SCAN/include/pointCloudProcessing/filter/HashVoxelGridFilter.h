@@ -0,0 +1,43 @@
+#ifndef HASH_VOXEL_GRID_FILTER
+#define HASH_VOXEL_GRID_FILTER
+
+#include "Typedef.h"
+#include "FilterProcessing.h"
+
+//		*****************************************************************
+//				Hash Voxel Grid Filter
+//				Voxel grid downsampling without pcl::VoxelGrid's extent limit :
+//				voxels are found through a hash of their integer coordinates,
+//				so only occupied voxels cost memory. Linear in the number of
+//				points and split over the threads; the output does not depend
+//				on the number of threads. A voxel becomes the mean of its
+//				points, colour averaged per channel, placed in the order of
+//				the voxels' first points. With keep organized the output has
+//				the input's size : the centroid sits where the voxel's first
+//				point was and the other points are NaN.
+//		*****************************************************************
+class HashVoxelGridFilter : public FilterProcessing
+{
+public:
+	HashVoxelGridFilter();
+	FilterProcessing* Clone();
+	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
+	pcl::PointCloud<PointT>::Ptr GetResult();
+	void SetLeafSize(float x, float y, float z);
+	void SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
+	void SetMeanK(int meanK);
+	void SetStddevMulThresh(float stddevMulThresh);
+	void SetKeepOrganized(bool isKeepOrganized);
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+
+private:
+	pcl::PointCloud<PointT>::Ptr _filteredCloud;
+
+	float _x;
+	float _y;
+	float _z;
+	bool _isKeepOrganized;
+	unsigned int _numberOfThreads;
+};
+
+#endif
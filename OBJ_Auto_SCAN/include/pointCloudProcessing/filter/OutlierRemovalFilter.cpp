@@ -1,23 +1,139 @@
 #include "OutlierRemovalFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "kinfuApp/CpuParallelFor.h"
+#include "trace/Tracer.h"
+
 OutlierRemovalFilter::OutlierRemovalFilter()
 {
 	_filteredCloud.reset(new pcl::PointCloud<PointT>());
 
 	_meanK = 50;
 	_stddevMulThresh = 1.0;
+	_isKeepOrganized = true;
 }
 
 void OutlierRemovalFilter::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("OutlierRemovalFilter::Processing", "processing");
+	if (cloud->isOrganized())
+	{
+		ProcessingOrganized(cloud);
+		return;
+	}
 	pcl::StatisticalOutlierRemoval<PointT> sor;
 	sor.setInputCloud(cloud);
-	sor.setKeepOrganized(true);
-	sor.setMeanK(50);
-	sor.setStddevMulThresh(1.0);
+	sor.setKeepOrganized(_isKeepOrganized);
+	sor.setMeanK(_meanK);
+	sor.setStddevMulThresh(_stddevMulThresh);
+	_filteredCloud.reset(new pcl::PointCloud<PointT>());
 	sor.filter(*_filteredCloud);
 }
 
+//		Same statistics as pcl::StatisticalOutlierRemoval, but the meanK neighbours of a pixel
+//		are looked for in the smallest square window holding meanK other pixels, not in a KdTree.
+//		A point without any valid pixel in its window is removed.
+void OutlierRemovalFilter::ProcessingOrganized(pcl::PointCloud<PointT>::Ptr cloud)
+{
+	const int width = cloud->width;
+	const int height = cloud->height;
+	const int meanK = std::max(1, _meanK);
+	int radius = 1;
+	while ((2 * radius + 1) * (2 * radius + 1) - 1 < meanK)
+		radius++;
+	const PointT* points = cloud->points.data();
+	_meanDistances.resize(cloud->size());
+	CpuParallelFor(height, 8, 0, [&](int begin, int end, unsigned int thread)
+	{
+		std::vector<float> distances;
+		distances.reserve((2 * radius + 1) * (2 * radius + 1));
+		for (int row = begin; row < end; row++)
+		{
+			for (int column = 0; column < width; column++)
+			{
+				const int index = row * width + column;
+				const PointT& point = points[index];
+				if (!pcl::isFinite(point))
+				{
+					_meanDistances[index] = std::numeric_limits<float>::quiet_NaN();
+					continue;
+				}
+				distances.clear();
+				for (int neighbourRow = std::max(0, row - radius); neighbourRow <= std::min(height - 1, row + radius); neighbourRow++)
+				{
+					const PointT* neighbours = &points[neighbourRow * width];
+					for (int neighbourColumn = std::max(0, column - radius); neighbourColumn <= std::min(width - 1, column + radius); neighbourColumn++)
+					{
+						const PointT& neighbour = neighbours[neighbourColumn];
+						if (!pcl::isFinite(neighbour) || (neighbourRow == row && neighbourColumn == column))
+							continue;
+						float dx = neighbour.x - point.x;
+						float dy = neighbour.y - point.y;
+						float dz = neighbour.z - point.z;
+						distances.push_back(dx * dx + dy * dy + dz * dz);
+					}
+				}
+				if (distances.empty())
+				{
+					_meanDistances[index] = std::numeric_limits<float>::infinity();
+					continue;
+				}
+				int k = std::min(meanK, (int)distances.size());
+				std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+				double sum = 0;
+				for (int counter = 0; counter < k; counter++)
+					sum += std::sqrt(distances[counter]);
+				_meanDistances[index] = (float)(sum / k);
+			}
+		}
+	});
+
+	double sum = 0;
+	double squaredSum = 0;
+	int valid = 0;
+	for (std::size_t counter = 0; counter < _meanDistances.size(); counter++)
+	{
+		float distance = _meanDistances[counter];
+		if (!pcl_isfinite(distance))
+			continue;
+		sum += distance;
+		squaredSum += (double)distance * distance;
+		valid++;
+	}
+	double mean = valid > 0 ? sum / valid : 0;
+	double variance = valid > 1 ? (squaredSum - sum * sum / valid) / (valid - 1) : 0;
+	const float threshold = (float)(mean + _stddevMulThresh * std::sqrt(std::max(0.0, variance)));
+
+	PointT invalid;
+	invalid.x = invalid.y = invalid.z = std::numeric_limits<float>::quiet_NaN();
+	invalid.r = invalid.g = invalid.b = 0;
+	_filteredCloud.reset();
+	if (_isKeepOrganized)
+	{
+		_filteredCloud = _buffers.Acquire(width, height);
+		for (std::size_t counter = 0; counter < _meanDistances.size(); counter++)
+			_filteredCloud->points[counter] = _meanDistances[counter] <= threshold ? points[counter] : invalid;
+		_filteredCloud->is_dense = false;
+	}
+	else
+	{
+		int kept = 0;
+		for (std::size_t counter = 0; counter < _meanDistances.size(); counter++)
+			kept += _meanDistances[counter] <= threshold;
+		_filteredCloud = _buffers.Acquire(kept, 1);
+		PointT* target = _filteredCloud->points.data();
+		for (std::size_t counter = 0; counter < _meanDistances.size(); counter++)
+		{
+			if (_meanDistances[counter] <= threshold)
+				*target++ = points[counter];
+		}
+		_filteredCloud->is_dense = true;
+	}
+	_filteredCloud->header = cloud->header;
+}
+
 pcl::PointCloud<PointT>::Ptr OutlierRemovalFilter::GetResult()
 {
 	return _filteredCloud;
@@ -41,4 +157,16 @@ void OutlierRemovalFilter::SetMeanK(int meanK)
 void OutlierRemovalFilter::SetStddevMulThresh(float stddevMulThresh)
 {
 	_stddevMulThresh = stddevMulThresh;
+}
+
+void OutlierRemovalFilter::SetKeepOrganized(bool isKeepOrganized)
+{
+	_isKeepOrganized = isKeepOrganized;
+}
+
+FilterProcessing* OutlierRemovalFilter::Clone()
+{
+	OutlierRemovalFilter* filter = new OutlierRemovalFilter(*this);
+	filter->_filteredCloud.reset(new pcl::PointCloud<PointT>());
+	return filter;
 }
\ No newline at end of file
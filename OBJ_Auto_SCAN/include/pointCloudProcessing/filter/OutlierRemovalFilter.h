@@ -5,23 +5,32 @@
 #include <pcl/filters/statistical_outlier_removal.h>
 
 #include "FilterProcessing.h"
+#include "FilterBufferPool.h"
 
 class OutlierRemovalFilter : public FilterProcessing
 {
 public:
 	OutlierRemovalFilter();
+	FilterProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PointCloud<PointT>::Ptr GetResult();
 	void SetLeafSize(float x, float y, float z);
 	void SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	void SetMeanK(int meanK);
 	void SetStddevMulThresh(float stddevMulThresh);
+	void SetKeepOrganized(bool isKeepOrganized);
 
 private:
+	//		Organized clouds (camera frames) : pixel neighbourhoods instead of KdTree searches
+	void ProcessingOrganized(pcl::PointCloud<PointT>::Ptr cloud);
+
 	pcl::PointCloud<PointT>::Ptr _filteredCloud;
+	FilterBufferPool _buffers;
+	std::vector<float> _meanDistances;
 
 	int _meanK;
 	float _stddevMulThresh;
+	bool _isKeepOrganized;
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "VoxelGridFilter.h"
+#include "trace/Tracer.h"
 
 VoxelGridFilter::VoxelGridFilter()
 {
@@ -12,6 +13,7 @@ VoxelGridFilter::VoxelGridFilter()
 
 void VoxelGridFilter::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("VoxelGridFilter::Processing", "processing");
 	_voxelGrid.setInputCloud(cloud);
 	_voxelGrid.setLeafSize(_x, _y, _z);
 	_voxelGrid.filter(*_filteredCloud);
@@ -42,4 +44,16 @@ void VoxelGridFilter::SetMeanK(int meanK)
 void VoxelGridFilter::SetStddevMulThresh(float stddevMulThresh)
 {
 	return;
+}
+
+void VoxelGridFilter::SetKeepOrganized(bool isKeepOrganized)
+{
+	return;
+}
+
+FilterProcessing* VoxelGridFilter::Clone()
+{
+	VoxelGridFilter* filter = new VoxelGridFilter(*this);
+	filter->_filteredCloud.reset(new pcl::PointCloud<PointT>());
+	return filter;
 }
\ No newline at end of file
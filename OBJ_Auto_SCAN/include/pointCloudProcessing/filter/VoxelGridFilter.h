@@ -9,11 +9,13 @@ class VoxelGridFilter : public FilterProcessing
 {
 public:
 	VoxelGridFilter();
+	FilterProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	void SetLeafSize(float x, float y, float z);
 	void SetBoundingBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	void SetMeanK(int meanK);
 	void SetStddevMulThresh(float stddevMulThresh);
+	void SetKeepOrganized(bool isKeepOrganized);
 	pcl::PointCloud<PointT>::Ptr GetResult();
 
 private:
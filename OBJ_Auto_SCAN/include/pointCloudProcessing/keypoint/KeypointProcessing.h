@@ -7,6 +7,7 @@
 class KeypointProcessing
 {
 public:
+	virtual KeypointProcessing* Clone() = 0;
 	virtual void Processing(pcl::PointCloud<PointT>::Ptr cloud) = 0;
 	virtual pcl::PointCloud<KeypointT>::Ptr GetResult() = 0;
 	virtual void SetScales(float minScale, int nrOctaves, int nrScalesPerOctave) = 0;
@@ -1,4 +1,5 @@
 #include "MyHarris3D.h"
+#include "trace/Tracer.h"
 
 MyHarris::MyHarris()
 {
@@ -13,6 +14,7 @@ MyHarris::MyHarris()
 
 void MyHarris::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("MyHarris::Processing", "processing");
 	_harris3D = new pcl::HarrisKeypoint3D<PointT, KeypointT>();
 	_harris3D->setMethod(_method);
 	boost::shared_ptr<pcl::Keypoint<PointT, KeypointT> > keypointDetector;
@@ -52,4 +54,11 @@ void MyHarris::SetMethod(pcl::HarrisKeypoint3D<PointT, KeypointT>::ResponseMetho
 pcl::PointCloud<KeypointT>::Ptr MyHarris::GetResult()
 {
 	return _keypoints;
+}
+
+KeypointProcessing* MyHarris::Clone()
+{
+	MyHarris* keypoint = new MyHarris(*this);
+	keypoint->_keypoints.reset(new pcl::PointCloud<KeypointT>());
+	return keypoint;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ class MyHarris : public KeypointProcessing
 {
 public:
 	MyHarris();
+	KeypointProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	void SetScales(float minScale, int nrOctaves, int nrScalesPerOctave);
 	void SetMinContrast(float minContrast);
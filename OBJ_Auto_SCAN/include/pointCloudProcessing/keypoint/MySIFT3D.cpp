@@ -1,4 +1,5 @@
 #include "MySIFT3D.h"
+#include "trace/Tracer.h"
 
 MySIFT::MySIFT()
 {
@@ -14,6 +15,7 @@ MySIFT::MySIFT()
 
 void MySIFT::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("MySIFT::Processing", "processing");
 	_sift3D = new pcl::SIFTKeypoint<PointT, KeypointT>();
 	boost::shared_ptr<pcl::Keypoint<PointT, KeypointT> > keypointDetector;
 	_sift3D->setScales(_minScale, _nrOctaves, _nrScalesPerOctave);
@@ -48,4 +50,11 @@ void MySIFT::SetRadiusSearch(float radiusSearch)
 pcl::PointCloud<KeypointT>::Ptr MySIFT::GetResult()
 {
 	return _keypoints;
+}
+
+KeypointProcessing* MySIFT::Clone()
+{
+	MySIFT* keypoint = new MySIFT(*this);
+	keypoint->_keypoints.reset(new pcl::PointCloud<KeypointT>());
+	return keypoint;
 }
\ No newline at end of file
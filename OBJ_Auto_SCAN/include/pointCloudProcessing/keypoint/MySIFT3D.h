@@ -9,6 +9,7 @@ class MySIFT : public KeypointProcessing
 {
 public:
 	MySIFT();
+	KeypointProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	void SetScales(float minScale, int nrOctaves, int nrScalesPerOctave);
 	void SetMinContrast(float minContrast);
@@ -0,0 +1,192 @@
+#include "NormalsService.h"
+
+#include <atomic>
+#include <limits>
+#include "kinfuApp/CpuParallelFor.h"
+
+NormalsService::NormalsService()
+{
+	_capacity = NORMALS_SERVICE_DEFAULT_CAPACITY;
+	_numberOfThreads = 0;
+	_clock = 0;
+	_hits = 0;
+	_misses = 0;
+	SharedCloudListeners::Add(&NormalsService::OnWrite);
+}
+
+NormalsService* NormalsService::GetInstance()
+{
+	static NormalsService* service = new NormalsService();
+	return service;
+}
+
+//		Two callers missing on the same key both compute, the second insert is dropped;
+//		the lock is never held while computing
+pcl::PointCloud<NormalT>::Ptr NormalsService::GetNormals(pcl::PointCloud<PointT>::Ptr cloud, double radius)
+{
+	if (cloud.get() == NULL)
+		throw std::string("NormalsService: No input cloud");
+	pcl::PointCloud<NormalT>::Ptr normals = Find(cloud, radius);
+	if (normals.get() != NULL)
+		return normals;
+	normals = Compute(cloud, radius);
+	Insert(cloud, radius, normals);
+	return normals;
+}
+
+void NormalsService::OnWrite(const void* id)
+{
+	GetInstance()->Invalidate(id);
+}
+
+void NormalsService::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_numberOfThreads = numberOfThreads;
+}
+
+void NormalsService::SetCapacity(std::size_t capacity)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_capacity = capacity;
+	while (_entries.size() > _capacity)
+	{
+		std::size_t oldest = 0;
+		for (std::size_t counter = 1; counter < _entries.size(); counter++)
+		{
+			if (_entries[counter].lastUse < _entries[oldest].lastUse)
+				oldest = counter;
+		}
+		_entries.erase(_entries.begin() + oldest);
+	}
+}
+
+void NormalsService::Clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_entries.clear();
+}
+
+void NormalsService::Invalidate(const void* id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (std::size_t counter = _entries.size(); counter > 0; counter--)
+	{
+		if (_entries[counter - 1].id == id)
+			_entries.erase(_entries.begin() + (counter - 1));
+	}
+}
+
+NormalsServiceStats NormalsService::GetStats()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	RemoveExpired();
+	NormalsServiceStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.entries = _entries.size();
+	return stats;
+}
+
+pcl::PointCloud<NormalT>::Ptr NormalsService::Find(pcl::PointCloud<PointT>::Ptr cloud, double radius)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	RemoveExpired();
+	for (std::size_t counter = 0; counter < _entries.size(); counter++)
+	{
+		Entry& entry = _entries[counter];
+		if (entry.id == cloud.get() && entry.radius == radius && entry.size == cloud->size())
+		{
+			entry.lastUse = ++_clock;
+			_hits++;
+			return entry.normals;
+		}
+	}
+	_misses++;
+	return pcl::PointCloud<NormalT>::Ptr();
+}
+
+void NormalsService::Insert(pcl::PointCloud<PointT>::Ptr cloud, double radius, pcl::PointCloud<NormalT>::Ptr normals)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_capacity == 0)
+		return;
+	for (std::size_t counter = 0; counter < _entries.size(); counter++)
+	{
+		if (_entries[counter].id == cloud.get() && _entries[counter].radius == radius)
+			return;
+	}
+	if (_entries.size() >= _capacity)
+	{
+		std::size_t oldest = 0;
+		for (std::size_t counter = 1; counter < _entries.size(); counter++)
+		{
+			if (_entries[counter].lastUse < _entries[oldest].lastUse)
+				oldest = counter;
+		}
+		_entries.erase(_entries.begin() + oldest);
+	}
+	Entry entry;
+	entry.cloud = cloud;
+	entry.id = cloud.get();
+	entry.size = cloud->size();
+	entry.radius = radius;
+	entry.normals = normals;
+	entry.lastUse = ++_clock;
+	_entries.push_back(entry);
+}
+
+//		A freed buffer can come back at the same address, the weak reference tells them apart
+void NormalsService::RemoveExpired()
+{
+	for (std::size_t counter = _entries.size(); counter > 0; counter--)
+	{
+		if (_entries[counter - 1].cloud.expired())
+			_entries.erase(_entries.begin() + (counter - 1));
+	}
+}
+
+//		pcl::NormalEstimation::computeFeature, the cloud's shared index and the points split over the threads
+pcl::PointCloud<NormalT>::Ptr NormalsService::Compute(pcl::PointCloud<PointT>::Ptr cloud, double radius)
+{
+	unsigned int numberOfThreads;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		numberOfThreads = _numberOfThreads;
+	}
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	pcl::PointCloud<NormalT>::Ptr normals(new pcl::PointCloud<NormalT>());
+	normals->points.resize(cloud->size());
+	normals->width = cloud->width;
+	normals->height = cloud->height;
+	normals->header = cloud->header;
+
+	SpatialIndex::Ptr spatialIndex = SpatialIndexCache::GetInstance()->GetIndex(cloud);
+	std::atomic<bool> isDense(true);
+	CpuParallelFor((int)cloud->size(), 512, numberOfThreads, [&](int begin, int end, unsigned int thread)
+	{
+		std::vector<int> indices;
+		std::vector<float> distances;
+		for (int index = begin; index < end; index++)
+		{
+			const PointT& point = cloud->points[index];
+			NormalT& normal = normals->points[index];
+			Eigen::Vector4f plane;
+			float curvature;
+			if (!pcl::isFinite(point) || spatialIndex->RadiusSearch(point.getVector3fMap(), radius, indices, distances, 0, false) == 0 ||
+				!pcl::computePointNormal(*cloud, indices, plane, curvature))
+			{
+				normal.normal_x = normal.normal_y = normal.normal_z = normal.curvature = nan;
+				isDense.store(false);
+				continue;
+			}
+			pcl::flipNormalTowardsViewpoint(point, 0, 0, 0, plane);
+			normal.normal_x = plane[0];
+			normal.normal_y = plane[1];
+			normal.normal_z = plane[2];
+			normal.curvature = curvature;
+		}
+	});
+	normals->is_dense = isDense.load();
+	return normals;
+}
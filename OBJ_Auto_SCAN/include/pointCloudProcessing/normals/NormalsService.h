@@ -0,0 +1,72 @@
+#ifndef NORMALS_SERVICE
+#define NORMALS_SERVICE
+
+#include <mutex>
+#include <vector>
+#include <boost/weak_ptr.hpp>
+#include <pcl/common/io.h>
+#include <pcl/features/normal_3d.h>
+#include "Typedef.h"
+#include "pointCloud/SpatialIndexCache.h"
+
+#define NORMALS_SERVICE_DEFAULT_CAPACITY 8
+
+struct NormalsServiceStats
+{
+	unsigned long long hits;
+	unsigned long long misses;
+	std::size_t entries;
+};
+
+//		*****************************************************************
+//				Normals Service
+//				Radius search normals, same result as pcl::NormalEstimation
+//				(oriented towards the origin), computed on a thread pool.
+//				Cached per cloud buffer and radius : an entry only holds a weak
+//				reference to the buffer, so it lives as long as the elements
+//				sharing that buffer. Buffers are treated as read only once they
+//				are shared (SharedCloud), which is what makes the buffer a key;
+//				an in-place SharedCloud::Write drops the entry.
+//		*****************************************************************
+class NormalsService
+{
+public:
+	static NormalsService* GetInstance();
+	pcl::PointCloud<NormalT>::Ptr GetNormals(pcl::PointCloud<PointT>::Ptr cloud, double radius);
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+	//		Least recently used entries are dropped beyond the capacity
+	void SetCapacity(std::size_t capacity);
+	void Clear();
+	void Invalidate(const void* id);
+	NormalsServiceStats GetStats();
+
+private:
+	struct Entry
+	{
+		boost::weak_ptr<pcl::PointCloud<PointT> > cloud;
+		const void* id;
+		std::size_t size;
+		double radius;
+		pcl::PointCloud<NormalT>::Ptr normals;
+		unsigned long long lastUse;
+	};
+
+	NormalsService();
+	NormalsService(const NormalsService&);
+	NormalsService& operator=(const NormalsService&);
+	static void OnWrite(const void* id);
+	pcl::PointCloud<NormalT>::Ptr Find(pcl::PointCloud<PointT>::Ptr cloud, double radius);
+	void Insert(pcl::PointCloud<PointT>::Ptr cloud, double radius, pcl::PointCloud<NormalT>::Ptr normals);
+	void RemoveExpired();
+	pcl::PointCloud<NormalT>::Ptr Compute(pcl::PointCloud<PointT>::Ptr cloud, double radius);
+
+	std::mutex _mutex;
+	std::vector<Entry> _entries;
+	std::size_t _capacity;
+	unsigned int _numberOfThreads;
+	unsigned long long _clock;
+	unsigned long long _hits;
+	unsigned long long _misses;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "ConcaveHull.h"
+#include "trace/Tracer.h"
 
 ConcaveHull::ConcaveHull()
 {
@@ -8,6 +9,7 @@ ConcaveHull::ConcaveHull()
 
 void ConcaveHull::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("ConcaveHull::Processing", "processing");
 	// Create a concave Hull representation of the projected inliers
 	pcl::ConcaveHull<PointT> chull;
 	chull.setInputCloud(cloud);
@@ -84,4 +86,11 @@ void ConcaveHull::SetReconstructDepth(int depth)
 void ConcaveHull::SetReconstructAlpha(double alpha)
 {
 	_alpha = alpha;
+}
+
+ReconstructProcessing* ConcaveHull::Clone()
+{
+	ConcaveHull* reconstruct = new ConcaveHull(*this);
+	reconstruct->_cloud.reset(new pcl::PointCloud<PointT>());
+	return reconstruct;
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ class ConcaveHull : public ReconstructProcessing
 {
 public:
 	ConcaveHull();
+	ReconstructProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
 	pcl::PointCloud<PointT>::Ptr GetCloud();
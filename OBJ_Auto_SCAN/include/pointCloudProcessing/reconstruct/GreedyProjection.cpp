@@ -1,4 +1,5 @@
 #include "GreedyProjection.h"
+#include "trace/Tracer.h"
 
 GreedyProjection::GreedyProjection()
 {
@@ -15,6 +16,7 @@ GreedyProjection::GreedyProjection()
 
 void GreedyProjection::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("GreedyProjection::Processing", "processing");
 	boost::shared_ptr<pcl::PCLSurfaceBase<SurfacePointT> > surfaceReconstruction;
 	pcl::GreedyProjectionTriangulation<SurfacePointT>* gp3 = new pcl::GreedyProjectionTriangulation<SurfacePointT>;
 	gp3->setSearchRadius(_searchRadius);
@@ -27,16 +29,9 @@ void GreedyProjection::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 	surfaceReconstruction.reset(gp3);
 
 	pcl::PointCloud<SurfacePointT>::Ptr vertices(new pcl::PointCloud<SurfacePointT>);
-	pcl::copyPointCloud(*cloud, *vertices);
+	pcl::concatenateFields(*cloud, *NormalsService::GetInstance()->GetNormals(cloud, _normalSearchRadius), *vertices);
 
-	pcl::NormalEstimation<PointT, SurfacePointT> normalEstimation;
-	normalEstimation.setSearchMethod(pcl::search::Search<PointT>::Ptr(new pcl::search::KdTree<PointT>));
-	normalEstimation.setRadiusSearch(_normalSearchRadius);
-	normalEstimation.setInputCloud(cloud);
-	normalEstimation.compute(*vertices);
-
-	pcl::search::KdTree<SurfacePointT>::Ptr tree(new pcl::search::KdTree<SurfacePointT>);
-	tree->setInputCloud(vertices);
+	SpatialSearch<SurfacePointT>::Ptr tree(new SpatialSearch<SurfacePointT>(SpatialIndexCache::GetInstance()->GetIndex(cloud), vertices));
 
 	surfaceReconstruction->setSearchMethod(tree);
 	surfaceReconstruction->setInputCloud(vertices);
@@ -106,4 +101,11 @@ void GreedyProjection::SetReconstructDepth(int depth)
 void GreedyProjection::SetReconstructAlpha(double alpha)
 {
 	return;
+}
+
+ReconstructProcessing* GreedyProjection::Clone()
+{
+	GreedyProjection* reconstruct = new GreedyProjection(*this);
+	reconstruct->_surface.reset(new pcl::PolygonMesh());
+	return reconstruct;
 }
\ No newline at end of file
@@ -7,11 +7,14 @@
 #include <pcl/features/normal_3d.h>
 
 #include "ReconstructProcessing.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
+#include "pointCloud/SpatialSearch.h"
 
 class GreedyProjection : public ReconstructProcessing
 {
 public:
 	GreedyProjection();
+	ReconstructProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
 	pcl::PointCloud<PointT>::Ptr GetCloud();
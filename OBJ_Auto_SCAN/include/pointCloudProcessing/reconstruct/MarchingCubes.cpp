@@ -1,4 +1,5 @@
 #include "MarchingCubes.h"
+#include "trace/Tracer.h"
 
 MarchingCubes::MarchingCubes()
 {
@@ -12,6 +13,7 @@ MarchingCubes::MarchingCubes()
 
 void MarchingCubes::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("MarchingCubes::Processing", "processing");
 	boost::shared_ptr<pcl::PCLSurfaceBase<SurfacePointT> > surfaceReconstruction;
 	pcl::MarchingCubes<SurfacePointT>* mc = new pcl::MarchingCubesHoppe<SurfacePointT>;
 	mc->setIsoLevel(_isoLevel);
@@ -19,16 +21,9 @@ void MarchingCubes::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 	surfaceReconstruction.reset(mc);
 
 	pcl::PointCloud<SurfacePointT>::Ptr vertices(new pcl::PointCloud<SurfacePointT>);
-	pcl::copyPointCloud(*cloud, *vertices);
+	pcl::concatenateFields(*cloud, *NormalsService::GetInstance()->GetNormals(cloud, _normalSearchRadius), *vertices);
 
-	pcl::NormalEstimation<PointT, SurfacePointT> normalEstimation;
-	normalEstimation.setSearchMethod(pcl::search::Search<PointT>::Ptr(new pcl::search::KdTree<PointT>));
-	normalEstimation.setRadiusSearch(_normalSearchRadius);
-	normalEstimation.setInputCloud(cloud);
-	normalEstimation.compute(*vertices);
-
-	pcl::search::KdTree<SurfacePointT>::Ptr tree(new pcl::search::KdTree<SurfacePointT>);
-	tree->setInputCloud(vertices);
+	SpatialSearch<SurfacePointT>::Ptr tree(new SpatialSearch<SurfacePointT>(SpatialIndexCache::GetInstance()->GetIndex(cloud), vertices));
 
 	surfaceReconstruction->setSearchMethod(tree);
 	surfaceReconstruction->setInputCloud(vertices);
@@ -100,4 +95,11 @@ void MarchingCubes::SetReconstructDepth(int depth)
 void MarchingCubes::SetReconstructAlpha(double alpha)
 {
 	return;
+}
+
+ReconstructProcessing* MarchingCubes::Clone()
+{
+	MarchingCubes* reconstruct = new MarchingCubes(*this);
+	reconstruct->_surface.reset(new pcl::PolygonMesh());
+	return reconstruct;
 }
\ No newline at end of file
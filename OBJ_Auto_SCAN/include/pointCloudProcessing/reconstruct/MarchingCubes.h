@@ -6,11 +6,14 @@
 #include <pcl/features/normal_3d.h>
 
 #include "ReconstructProcessing.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
+#include "pointCloud/SpatialSearch.h"
 
 class MarchingCubes : public ReconstructProcessing
 {
 public:
 	MarchingCubes();
+	ReconstructProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
 	pcl::PointCloud<PointT>::Ptr GetCloud();
@@ -1,4 +1,5 @@
 #include "MyPoisson.h"
+#include "trace/Tracer.h"
 
 MyPoisson::MyPoisson()
 {
@@ -9,6 +10,7 @@ MyPoisson::MyPoisson()
 
 void MyPoisson::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("MyPoisson::Processing", "processing");
 	/*
 	pcl::PointCloud<SurfacePointT>::Ptr vertices(new pcl::PointCloud<SurfacePointT>);
 	pcl::copyPointCloud(*cloud, *vertices);
@@ -22,31 +24,21 @@ void MyPoisson::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 	poisson.setDepth(_depth);
 	poisson.setInputCloud(vertices);
 	poisson.reconstruct(*_surface);*/
-	pcl::PointCloud<PointT>::Ptr filtered(new pcl::PointCloud<PointT>());
-	pcl::PassThrough<PointT> filter;
-	filter.setInputCloud(cloud);
-	filter.filter(*filtered);
-	
-	pcl::NormalEstimation<PointT, NormalT> ne;
-	//ne.setNumberOfThreads(8);
-	ne.setInputCloud(filtered);
-	ne.setRadiusSearch(_normalSearchRadius);
-	Eigen::Vector4f centroid;
-	compute3DCentroid(*filtered, centroid);
-	ne.setViewPoint(centroid[0], centroid[1], centroid[2]);
-
-	pcl::PointCloud<NormalT>::Ptr cloudNormals(new pcl::PointCloud<NormalT>());
-	ne.compute(*cloudNormals);
+	//		The cached normals face the origin, Poisson wants them pointing away from the centroid
+	pcl::PointCloud<SurfacePointT>::Ptr vertices(new pcl::PointCloud<SurfacePointT>());
+	pcl::concatenateFields(*cloud, *NormalsService::GetInstance()->GetNormals(cloud, _normalSearchRadius), *vertices);
+	pcl::PointCloud<SurfacePointT>::Ptr cloudSmoothedNormals(new pcl::PointCloud<SurfacePointT>());
+	std::vector<int> mapping;
+	pcl::removeNaNFromPointCloud(*vertices, *cloudSmoothedNormals, mapping);
 
-	for (size_t i = 0; i < cloudNormals->size(); ++i) {
-		cloudNormals->points[i].normal_x *= -1;
-		cloudNormals->points[i].normal_y *= -1;
-		cloudNormals->points[i].normal_z *= -1;
+	Eigen::Vector4f centroid;
+	compute3DCentroid(*cloudSmoothedNormals, centroid);
+	for (size_t i = 0; i < cloudSmoothedNormals->size(); ++i) {
+		SurfacePointT& point = cloudSmoothedNormals->points[i];
+		if ((point.getVector3fMap() - centroid.head<3>()).dot(point.getNormalVector3fMap()) < 0)
+			point.getNormalVector3fMap() *= -1;
 	}
 
-	pcl::PointCloud<SurfacePointT>::Ptr cloudSmoothedNormals(new pcl::PointCloud<SurfacePointT>());
-	concatenateFields(*filtered, *cloudNormals, *cloudSmoothedNormals);
-
 	pcl::Poisson<SurfacePointT> poisson;
 	poisson.setDepth(9);
 	poisson.setInputCloud(cloudSmoothedNormals);
@@ -117,4 +109,11 @@ void MyPoisson::SetReconstructDepth(int depth)
 void MyPoisson::SetReconstructAlpha(double alpha)
 {
 	return;
+}
+
+ReconstructProcessing* MyPoisson::Clone()
+{
+	MyPoisson* reconstruct = new MyPoisson(*this);
+	reconstruct->_surface.reset(new pcl::PolygonMesh());
+	return reconstruct;
 }
\ No newline at end of file
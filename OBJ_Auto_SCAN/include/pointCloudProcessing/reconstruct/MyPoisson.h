@@ -2,15 +2,17 @@
 #define MY_POISSON
 
 #include "Typedef.h"
-#include <pcl/filters/passthrough.h>
+#include <pcl/filters/filter.h>
 #include <pcl/surface/poisson.h>
 
 #include "ReconstructProcessing.h"
+#include "pointCloudProcessing/normals/NormalsService.h"
 
 class MyPoisson : public ReconstructProcessing
 {
 public:
 	MyPoisson();
+	ReconstructProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
 	pcl::PointCloud<PointT>::Ptr GetCloud();
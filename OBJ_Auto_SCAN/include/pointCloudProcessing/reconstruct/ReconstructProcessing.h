@@ -9,6 +9,7 @@
 class ReconstructProcessing
 {
 public:
+	virtual ReconstructProcessing* Clone() = 0;
 	virtual void Processing(pcl::PointCloud<PointT>::Ptr cloud) = 0;
 	virtual pcl::PolygonMeshPtr GetMesh() = 0;
 	virtual pcl::PointCloud<PointT>::Ptr GetCloud() = 0;
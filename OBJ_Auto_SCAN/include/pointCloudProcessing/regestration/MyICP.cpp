@@ -1,4 +1,5 @@
 #include "MyICP.h"
+#include "trace/Tracer.h"
 
 MyICP::MyICP()
 {
@@ -13,14 +14,18 @@ MyICP::MyICP()
 
 void MyICP::Processing(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<PointT>::Ptr target)
 {
+	TRACE_SCOPE("MyICP::Processing", "processing");
 	std::vector<int> mapSource;
 	std::vector<int> mapTarget;
-	pcl::removeNaNFromPointCloud(*source, *source, mapSource);
-	pcl::removeNaNFromPointCloud(*target, *target, mapTarget);
+	//		The inputs may be shared with other elements, so NaNs are dropped into local copies
+	pcl::PointCloud<PointT>::Ptr validSource(new pcl::PointCloud<PointT>());
+	pcl::PointCloud<PointT>::Ptr validTarget(new pcl::PointCloud<PointT>());
+	pcl::removeNaNFromPointCloud(*source, *validSource, mapSource);
+	pcl::removeNaNFromPointCloud(*target, *validTarget, mapTarget);
 	pcl::Registration<PointT, PointT>::Ptr registration(new pcl::IterativeClosestPoint<PointT, PointT>);
-	registration->setInputSource(source);
+	registration->setInputSource(validSource);
 	//registration->setInputSource (source_segmented_);
-	registration->setInputTarget(target);
+	registration->setInputTarget(validTarget);
 	registration->setMaxCorrespondenceDistance(_maxCorrespondenceDistance);
 	registration->setRANSACOutlierRejectionThreshold(_ransacOutlierRejectionThreshold);
 	registration->setTransformationEpsilon(_transformationEpsilon);
@@ -28,7 +33,7 @@ void MyICP::Processing(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<Poin
 	registration->setMaximumIterations(_maximumIterations);
 	registration->align(*_registeredCloud);
 	_registeredMatrix = registration->getFinalTransformation();
-	*_registeredCloud += *target;
+	*_registeredCloud += *validTarget;
 	_hasConverged = registration->hasConverged();
 }
 
@@ -65,4 +70,11 @@ pcl::PointCloud<PointT>::Ptr MyICP::GetResult()
 bool MyICP::HasConverged()
 {
 	return _hasConverged;
+}
+
+RegestrationProcessing* MyICP::Clone()
+{
+	MyICP* regestration = new MyICP(*this);
+	regestration->_registeredCloud.reset(new pcl::PointCloud<PointT>());
+	return regestration;
 }
\ No newline at end of file
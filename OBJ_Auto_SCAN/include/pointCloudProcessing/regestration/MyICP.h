@@ -11,6 +11,7 @@ class MyICP : public RegestrationProcessing
 {
 public:
 	MyICP();
+	RegestrationProcessing* Clone();
 	void Processing(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<PointT>::Ptr target);
 	void SetCorrespondenceDistance(float maxCorrespondenceDistance);
 	void SetRansacOutlierRejectionThreshold(float ransacOutlierRejectionThreshold);
@@ -0,0 +1,142 @@
+#ifndef POSE_GRAPH_OPTIMIZER
+#define POSE_GRAPH_OPTIMIZER
+
+#include <cmath>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Sparse>
+
+//		Relative pose between two views : transform maps points of view "to" into view "from"
+struct PoseGraphEdge
+{
+	int from;
+	int to;
+	Eigen::Matrix4f transform;
+	double weight;
+	bool hasConverged;
+	bool isLoopClosure;
+};
+
+//		*****************************************************************
+//				Pose Graph Optimizer
+//				Gauss-Newton on SE(3), pose 0 is held fixed.
+//				The normal equations are sparse (one 6x6 block per edge), so a
+//				ring of N views with k neighbours costs O(N k) per iteration.
+//		*****************************************************************
+class PoseGraphOptimizer
+{
+public:
+	typedef Eigen::Matrix<double, 6, 1> Vector6d;
+	typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+	//		poses : view -> view 0, used as the initial guess and overwritten
+	//		returns the weighted squared error after the last iteration
+	static double Optimize(std::vector<Eigen::Matrix4f>& poses, const std::vector<PoseGraphEdge>& edges, int iterations = 10)
+	{
+		int numberOfPoses = (int)poses.size();
+		std::vector<Eigen::Matrix4d> estimates(numberOfPoses);
+		for (int counter = 0; counter < numberOfPoses; counter++)
+			estimates[counter] = poses[counter].cast<double>();
+		int size = 6 * (numberOfPoses - 1);
+		double error = GetError(estimates, edges);
+		for (int iteration = 0; iteration < iterations && size > 0; iteration++)
+		{
+			std::vector<Eigen::Triplet<double> > triplets;
+			triplets.reserve(edges.size() * 4 * 36 + size);
+			Eigen::VectorXd gradient = Eigen::VectorXd::Zero(size);
+			for (std::size_t counter = 0; counter < edges.size(); counter++)
+			{
+				const PoseGraphEdge& edge = edges[counter];
+				Eigen::Matrix4d measurement = edge.transform.cast<double>();
+				Vector6d residual = GetResidual(measurement, estimates[edge.from], estimates[edge.to]);
+				Matrix6d jacobianFrom = GetJacobian(measurement, estimates[edge.from], estimates[edge.to], true);
+				Matrix6d jacobianTo = GetJacobian(measurement, estimates[edge.from], estimates[edge.to], false);
+				//		Pose 0 is not a variable, its blocks are dropped
+				int index[2] = { edge.from - 1, edge.to - 1 };
+				const Matrix6d* jacobian[2] = { &jacobianFrom, &jacobianTo };
+				for (int a = 0; a < 2; a++)
+				{
+					if (index[a] < 0)
+						continue;
+					gradient.segment<6>(6 * index[a]) += edge.weight * jacobian[a]->transpose() * residual;
+					for (int b = 0; b < 2; b++)
+					{
+						if (index[b] < 0)
+							continue;
+						Matrix6d block = edge.weight * jacobian[a]->transpose() * *jacobian[b];
+						for (int row = 0; row < 6; row++)
+							for (int column = 0; column < 6; column++)
+								triplets.push_back(Eigen::Triplet<double>(6 * index[a] + row, 6 * index[b] + column, block(row, column)));
+					}
+				}
+			}
+			//		A tiny damping keeps views without edges solvable
+			for (int counter = 0; counter < size; counter++)
+				triplets.push_back(Eigen::Triplet<double>(counter, counter, 1e-9));
+			Eigen::SparseMatrix<double> hessian(size, size);
+			hessian.setFromTriplets(triplets.begin(), triplets.end());
+			Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > solver(hessian);
+			if (solver.info() != Eigen::Success)
+				break;
+			Eigen::VectorXd step = solver.solve(-gradient);
+			for (int counter = 1; counter < numberOfPoses; counter++)
+				estimates[counter] = estimates[counter] * Exp(step.segment<6>(6 * (counter - 1)));
+			error = GetError(estimates, edges);
+			if (step.norm() < 1e-10)
+				break;
+		}
+		for (int counter = 0; counter < numberOfPoses; counter++)
+			poses[counter] = estimates[counter].cast<float>();
+		return error;
+	}
+
+	static double GetError(const std::vector<Eigen::Matrix4d>& poses, const std::vector<PoseGraphEdge>& edges)
+	{
+		double error = 0;
+		for (std::size_t counter = 0; counter < edges.size(); counter++)
+			error += edges[counter].weight * GetResidual(edges[counter].transform.cast<double>(), poses[edges[counter].from], poses[edges[counter].to]).squaredNorm();
+		return error;
+	}
+
+private:
+	//		(translation, rotation vector) of measurement^-1 * from^-1 * to, zero when consistent
+	static Vector6d GetResidual(const Eigen::Matrix4d& measurement, const Eigen::Matrix4d& from, const Eigen::Matrix4d& to)
+	{
+		Eigen::Matrix4d difference = measurement.inverse() * from.inverse() * to;
+		Eigen::AngleAxisd rotation(Eigen::Matrix3d(difference.block<3, 3>(0, 0)));
+		Vector6d residual;
+		residual.head<3>() = difference.block<3, 1>(0, 3);
+		residual.tail<3>() = rotation.angle() * rotation.axis();
+		return residual;
+	}
+
+	//		Numeric derivative with respect to a right perturbation pose * Exp(delta)
+	static Matrix6d GetJacobian(const Eigen::Matrix4d& measurement, const Eigen::Matrix4d& from, const Eigen::Matrix4d& to, bool isFrom)
+	{
+		const double step = 1e-6;
+		Matrix6d jacobian;
+		for (int axis = 0; axis < 6; axis++)
+		{
+			Vector6d delta = Vector6d::Zero();
+			delta(axis) = step;
+			Vector6d plus = isFrom ? GetResidual(measurement, from * Exp(delta), to) : GetResidual(measurement, from, to * Exp(delta));
+			Vector6d minus = isFrom ? GetResidual(measurement, from * Exp(-delta), to) : GetResidual(measurement, from, to * Exp(-delta));
+			jacobian.col(axis) = (plus - minus) / (2 * step);
+		}
+		return jacobian;
+	}
+
+	static Eigen::Matrix4d Exp(const Vector6d& delta)
+	{
+		Eigen::Matrix4d transform = Eigen::Matrix4d::Identity();
+		Eigen::Vector3d rotation = delta.tail<3>();
+		double angle = rotation.norm();
+		if (angle > 1e-12)
+			transform.block<3, 3>(0, 0) = Eigen::AngleAxisd(angle, rotation / angle).toRotationMatrix();
+		transform.block<3, 1>(0, 3) = delta.head<3>();
+		return transform;
+	}
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "PoseGraphRegestration.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "MyICP.h"
+#include "pointCloudProcessing/transform/TransformKernels.h"
+#include "trace/Tracer.h"
+
+PoseGraphRegestration::PoseGraphRegestration()
+{
+	_error = 0;
+
+	//	default, same as MyICP
+	_maxCorrespondenceDistance = 0.05;
+	_ransacOutlierRejectionThreshold = 0.05;
+	_euclideanFitnessEpsilon = 1e-12;
+	_maximumIterations = 1000;
+	_neighbourRange = 2;
+	_hasLoopClosure = true;
+	_optimizationIterations = 10;
+	_numberOfThreads = 0;
+}
+
+void PoseGraphRegestration::Processing(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds)
+{
+	TRACE_SCOPE("PoseGraphRegestration::Processing", "processing");
+	int numberOfViews = (int)clouds.size();
+	_poses.assign(numberOfViews, Eigen::Matrix4f::Identity());
+	_edges.clear();
+	_error = 0;
+	if (numberOfViews < 2)
+		return;
+
+	//		Neighbouring views overlap the most, they are registered first without a guess
+	std::vector<PoseGraphEdge> neighbours;
+	for (int counter = 0; counter + 1 < numberOfViews; counter++)
+	{
+		PoseGraphEdge edge = { counter, counter + 1, Eigen::Matrix4f::Identity(), 1.0, false, false };
+		neighbours.push_back(edge);
+	}
+	RegisterEdges(clouds, neighbours, std::vector<Eigen::Matrix4f>(neighbours.size(), Eigen::Matrix4f::Identity()));
+	//		Chaining them gives the initial poses (what ProcessICP1Slot used to output)
+	for (int counter = 1; counter < numberOfViews; counter++)
+		_poses[counter] = _poses[counter - 1] * neighbours[counter - 1].transform;
+
+	//		Wider edges and the loop closure start from the chained guess
+	std::vector<PoseGraphEdge> others;
+	std::vector<Eigen::Matrix4f> guesses;
+	for (int range = 2; range <= _neighbourRange; range++)
+	{
+		for (int counter = 0; counter + range < numberOfViews; counter++)
+		{
+			PoseGraphEdge edge = { counter, counter + range, Eigen::Matrix4f::Identity(), 1.0, false, false };
+			others.push_back(edge);
+			guesses.push_back(_poses[counter].inverse() * _poses[counter + range]);
+		}
+	}
+	//		Skipped when the widest edges already connect the last view to the first
+	if (_hasLoopClosure && numberOfViews > 2 && numberOfViews - 1 > _neighbourRange)
+	{
+		PoseGraphEdge edge = { numberOfViews - 1, 0, Eigen::Matrix4f::Identity(), 1.0, false, true };
+		others.push_back(edge);
+		guesses.push_back(_poses[numberOfViews - 1].inverse());
+	}
+	RegisterEdges(clouds, others, guesses);
+
+	_edges = neighbours;
+	_edges.insert(_edges.end(), others.begin(), others.end());
+	_error = PoseGraphOptimizer::Optimize(_poses, _edges, _optimizationIterations);
+}
+
+//		One ICP per edge on a small thread pool, each worker owns its MyICP
+void PoseGraphRegestration::RegisterEdges(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds, std::vector<PoseGraphEdge>& edges, const std::vector<Eigen::Matrix4f>& guesses)
+{
+	std::atomic<std::size_t> next(0);
+	auto worker = [&]()
+	{
+		for (std::size_t index = next++; index < edges.size(); index = next++)
+			RegisterEdge(clouds, edges[index], guesses[index]);
+	};
+	unsigned int numberOfThreads = _numberOfThreads != 0 ? _numberOfThreads : std::thread::hardware_concurrency();
+	numberOfThreads = (unsigned int)std::min<std::size_t>(std::max(1u, numberOfThreads), edges.size());
+	std::vector<std::thread> threads;
+	for (unsigned int counter = 1; counter < numberOfThreads; counter++)
+		threads.push_back(std::thread(worker));
+	worker();
+	for (std::size_t counter = 0; counter < threads.size(); counter++)
+		threads[counter].join();
+}
+
+void PoseGraphRegestration::RegisterEdge(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds, PoseGraphEdge& edge, const Eigen::Matrix4f& guess)
+{
+	MyICP icp;
+	RegestrationProcessing* regestration = &icp;
+	regestration->SetCorrespondenceDistance(_maxCorrespondenceDistance);
+	regestration->SetRansacOutlierRejectionThreshold(_ransacOutlierRejectionThreshold);
+	regestration->SetEuclideanFitnessEpsilon(_euclideanFitnessEpsilon);
+	regestration->SetMaximumIterations(_maximumIterations);
+	//		Move view "to" near view "from" first, ICP only refines the guess
+	pcl::PointCloud<PointT>::Ptr source(new pcl::PointCloud<PointT>());
+	TransformKernels::Transform(*clouds[edge.to], *source, guess);
+	regestration->Processing(source, clouds[edge.from]);
+	edge.transform = regestration->GetMatrix() * guess;
+	edge.hasConverged = regestration->HasConverged();
+	//		A failed pair still constrains the graph, but much less than a good one
+	edge.weight = edge.hasConverged ? 1.0 : 0.01;
+}
+
+void PoseGraphRegestration::SetCorrespondenceDistance(float maxCorrespondenceDistance)
+{
+	_maxCorrespondenceDistance = maxCorrespondenceDistance;
+}
+
+void PoseGraphRegestration::SetRansacOutlierRejectionThreshold(float ransacOutlierRejectionThreshold)
+{
+	_ransacOutlierRejectionThreshold = ransacOutlierRejectionThreshold;
+}
+
+void PoseGraphRegestration::SetEuclideanFitnessEpsilon(float euclideanFitnessEpsilon)
+{
+	_euclideanFitnessEpsilon = euclideanFitnessEpsilon;
+}
+
+void PoseGraphRegestration::SetMaximumIterations(int maximumIterations)
+{
+	_maximumIterations = maximumIterations;
+}
+
+void PoseGraphRegestration::SetNeighbourRange(int neighbourRange)
+{
+	if (neighbourRange < 1)
+		throw std::string("PoseGraphRegestration: neighbour range must be at least 1");
+	_neighbourRange = neighbourRange;
+}
+
+void PoseGraphRegestration::SetLoopClosure(bool hasLoopClosure)
+{
+	_hasLoopClosure = hasLoopClosure;
+}
+
+void PoseGraphRegestration::SetOptimizationIterations(int optimizationIterations)
+{
+	_optimizationIterations = optimizationIterations;
+}
+
+void PoseGraphRegestration::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+	_numberOfThreads = numberOfThreads;
+}
+
+std::vector<Eigen::Matrix4f> PoseGraphRegestration::GetPoses()
+{
+	return _poses;
+}
+
+std::vector<PoseGraphEdge> PoseGraphRegestration::GetEdges()
+{
+	return _edges;
+}
+
+double PoseGraphRegestration::GetError()
+{
+	return _error;
+}
@@ -0,0 +1,52 @@
+#ifndef POSE_GRAPH_REGESTRATION
+#define POSE_GRAPH_REGESTRATION
+
+#include <vector>
+#include "Typedef.h"
+#include "PoseGraphOptimizer.h"
+#include "RegestrationProcessing.h"
+
+//		*****************************************************************
+//				Pose Graph Regestration
+//				Multi-view alignment for a turntable scan :
+//				1. pairwise ICP between each view and its next neighbours (in parallel)
+//				2. a loop closure edge from the last view back to the first
+//				3. a global Gauss-Newton solve over all edges
+//				Pose i maps view i into the frame of view 0.
+//		*****************************************************************
+class PoseGraphRegestration
+{
+public:
+	PoseGraphRegestration();
+	void Processing(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds);
+	void SetCorrespondenceDistance(float maxCorrespondenceDistance);
+	void SetRansacOutlierRejectionThreshold(float ransacOutlierRejectionThreshold);
+	void SetEuclideanFitnessEpsilon(float euclideanFitnessEpsilon);
+	void SetMaximumIterations(int maximumIterations);
+	void SetNeighbourRange(int neighbourRange);
+	void SetLoopClosure(bool hasLoopClosure);
+	void SetOptimizationIterations(int optimizationIterations);
+	void SetNumberOfThreads(unsigned int numberOfThreads);
+	std::vector<Eigen::Matrix4f> GetPoses();
+	std::vector<PoseGraphEdge> GetEdges();
+	double GetError();
+
+private:
+	void RegisterEdges(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds, std::vector<PoseGraphEdge>& edges, const std::vector<Eigen::Matrix4f>& guesses);
+	void RegisterEdge(const std::vector<pcl::PointCloud<PointT>::Ptr>& clouds, PoseGraphEdge& edge, const Eigen::Matrix4f& guess);
+
+	std::vector<Eigen::Matrix4f> _poses;
+	std::vector<PoseGraphEdge> _edges;
+	double _error;
+
+	float _maxCorrespondenceDistance;
+	float _ransacOutlierRejectionThreshold;
+	float _euclideanFitnessEpsilon;
+	int _maximumIterations;
+	int _neighbourRange;
+	bool _hasLoopClosure;
+	int _optimizationIterations;
+	unsigned int _numberOfThreads;
+};
+
+#endif
@@ -9,4 +9,10 @@ RegestrationProcessing* RegestrationFactory::GetICP()
 {
 	static MyICP* regestration = new MyICP();
 	return regestration;
+}
+
+PoseGraphRegestration* RegestrationFactory::GetPoseGraph()
+{
+	static PoseGraphRegestration* regestration = new PoseGraphRegestration();
+	return regestration;
 }
\ No newline at end of file
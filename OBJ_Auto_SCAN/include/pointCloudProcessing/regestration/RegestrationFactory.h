@@ -3,12 +3,14 @@
 
 #include "RegestrationProcessing.h"
 #include "MyICP.h"
+#include "PoseGraphRegestration.h"
 
 class RegestrationFactory
 {
 public:
 	RegestrationFactory();
 	RegestrationProcessing* GetICP();
+	PoseGraphRegestration* GetPoseGraph();
 
 private:
 
@@ -6,6 +6,7 @@
 class RegestrationProcessing
 {
 public:
+	virtual RegestrationProcessing* Clone() = 0;
 	virtual void Processing(pcl::PointCloud<PointT>::Ptr source, pcl::PointCloud<PointT>::Ptr target) = 0;
 	virtual void SetCorrespondenceDistance(float maxCorrespondenceDistance) = 0;
 	virtual void SetRansacOutlierRejectionThreshold(float ransacOutlierRejectionThreshold) = 0;
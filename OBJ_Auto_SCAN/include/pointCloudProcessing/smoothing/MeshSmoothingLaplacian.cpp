@@ -1,4 +1,5 @@
 #include "MeshSmoothingLaplacian.h"
+#include "trace/Tracer.h"
 
 MeshSmoothingLaplacian::MeshSmoothingLaplacian()
 {
@@ -13,6 +14,7 @@ MeshSmoothingLaplacian::MeshSmoothingLaplacian()
 
 void MeshSmoothingLaplacian::Processing(pcl::PolygonMeshPtr mesh)
 {
+	TRACE_SCOPE("MeshSmoothingLaplacian::Processing", "processing");
 	pcl::MeshSmoothingLaplacianVTK vtk;
 	vtk.setInputMesh(mesh);
 	vtk.setNumIter(_numItr);
@@ -26,6 +28,7 @@ void MeshSmoothingLaplacian::Processing(pcl::PolygonMeshPtr mesh)
 
 void MeshSmoothingLaplacian::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
+	TRACE_SCOPE("MeshSmoothingLaplacian::Processing", "processing");
 	return;
 }
 
@@ -72,4 +75,11 @@ void MeshSmoothingLaplacian::SetUpsamplingRadius(double upsamplingRadius)
 void MeshSmoothingLaplacian::SetUpsamplingStepSize(double upsamplingStepSize)
 {
 	return;
+}
+
+SmoothingProcessing* MeshSmoothingLaplacian::Clone()
+{
+	MeshSmoothingLaplacian* smoothing = new MeshSmoothingLaplacian(*this);
+	smoothing->_result.reset(new pcl::PolygonMesh());
+	return smoothing;
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ class MeshSmoothingLaplacian : public SmoothingProcessing
 {
 public:
 	MeshSmoothingLaplacian();
+	SmoothingProcessing* Clone();
 	void Processing(pcl::PolygonMeshPtr mesh);
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
@@ -1,4 +1,5 @@
 #include "MyResampling.h"
+#include "trace/Tracer.h"
 
 MyResampling::MyResampling()
 {
@@ -16,7 +17,8 @@ void MyResampling::Processing(pcl::PolygonMeshPtr mesh)
 
 void MyResampling::Processing(pcl::PointCloud<PointT>::Ptr cloud)
 {
-	pcl::search::KdTree<PointT>::Ptr tree(new pcl::search::KdTree<PointT>);
+	TRACE_SCOPE("MyResampling::Processing", "processing");
+	SpatialSearch<PointT>::Ptr tree(new SpatialSearch<PointT>(SpatialIndexCache::GetInstance()->GetIndex(cloud), cloud));
 	pcl::MovingLeastSquares<PointT, SurfacePointT> mls;
 
 	mls.setComputeNormals(true);
@@ -90,4 +92,11 @@ void MyResampling::SetUpsamplingRadius(double upsamplingRadius)
 void MyResampling::SetUpsamplingStepSize(double upsamplingStepSize)
 {
 	_upsamplingStepSize = upsamplingStepSize;
+}
+
+SmoothingProcessing* MyResampling::Clone()
+{
+	MyResampling* smoothing = new MyResampling(*this);
+	smoothing->_result.reset(new pcl::PointCloud<SurfacePointT>());
+	return smoothing;
 }
\ No newline at end of file
@@ -8,11 +8,14 @@
 #include <pcl/surface/mls.h>
 
 #include "SmoothingProcessing.h"
+#include "pointCloud/SpatialIndexCache.h"
+#include "pointCloud/SpatialSearch.h"
 
 class MyResampling : public SmoothingProcessing
 {
 public:
 	MyResampling();
+	SmoothingProcessing* Clone();
 	void Processing(pcl::PolygonMeshPtr mesh);
 	void Processing(pcl::PointCloud<PointT>::Ptr cloud);
 	pcl::PolygonMeshPtr GetMesh();
@@ -7,6 +7,7 @@
 class SmoothingProcessing
 {
 public:
+	virtual SmoothingProcessing* Clone() = 0;
 	virtual void Processing(pcl::PolygonMeshPtr mesh) = 0;
 	virtual void Processing(pcl::PointCloud<PointT>::Ptr cloud) = 0;
 	virtual pcl::PolygonMeshPtr GetMesh() = 0;
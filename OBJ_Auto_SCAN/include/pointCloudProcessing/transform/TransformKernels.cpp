@@ -0,0 +1,399 @@
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+//		*****************************************************************
+//				Instruction Set Selection
+//		*****************************************************************
+static InstructionSet DetectInstructionSet()
+{
+#ifdef TRANSFORM_KERNELS_X86
+	unsigned int info[4] = { 0, 0, 0, 0 };
+	unsigned int extended[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+	__cpuid((int*)info, 0);
+	unsigned int maxLeaf = info[0];
+	__cpuid((int*)info, 1);
+	if (maxLeaf >= 7)
+		__cpuidex((int*)extended, 7, 0);
+#else
+	unsigned int maxLeaf = __get_cpuid_max(0, NULL);
+	__cpuid(1, info[0], info[1], info[2], info[3]);
+	if (maxLeaf >= 7)
+		__cpuid_count(7, 0, extended[0], extended[1], extended[2], extended[3]);
+#endif
+	bool hasSSE2 = (info[3] & (1u << 26)) != 0;
+	bool hasFMA = (info[2] & (1u << 12)) != 0;
+	bool hasOSXSAVE = (info[2] & (1u << 27)) != 0;
+	bool hasAVX = (info[2] & (1u << 28)) != 0;
+	bool hasAVX2 = (extended[1] & (1u << 5)) != 0;
+	//		The OS has to save the ymm registers as well
+	bool hasYmmState = false;
+	if (hasOSXSAVE)
+	{
+#if defined(_MSC_VER)
+		hasYmmState = (_xgetbv(0) & 6) == 6;
+#else
+		unsigned int eax, edx;
+		__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		hasYmmState = (eax & 6) == 6;
+#endif
+	}
+	if (hasAVX && hasAVX2 && hasFMA && hasYmmState)
+		return InstructionSet::AVX2;
+	if (hasSSE2)
+		return InstructionSet::SSE;
+#endif
+	return InstructionSet::Scalar;
+}
+
+static InstructionSet g_supportedInstructionSet = DetectInstructionSet();
+static std::atomic<int> g_instructionSet((int)g_supportedInstructionSet);
+
+InstructionSet TransformKernels::GetSupportedInstructionSet()
+{
+	return g_supportedInstructionSet;
+}
+
+InstructionSet TransformKernels::GetInstructionSet()
+{
+	return (InstructionSet)g_instructionSet.load();
+}
+
+void TransformKernels::SetInstructionSet(InstructionSet instructionSet)
+{
+	if ((int)instructionSet > (int)g_supportedInstructionSet)
+		throw std::string("TransformKernels: ") + GetInstructionSetName(instructionSet) + " is not supported by this CPU";
+	g_instructionSet.store((int)instructionSet);
+}
+
+const char* TransformKernels::GetInstructionSetName(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::AVX2:
+		return "AVX2";
+	case InstructionSet::SSE:
+		return "SSE";
+	default:
+		return "Scalar";
+	}
+}
+
+//		*****************************************************************
+//				Scalar
+//		*****************************************************************
+static void TransformScalar(PointT* points, std::size_t size, const Eigen::Matrix4f& m)
+{
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		float x = points[counter].x;
+		float y = points[counter].y;
+		float z = points[counter].z;
+		points[counter].x = m(0, 0) * x + m(0, 1) * y + m(0, 2) * z + m(0, 3);
+		points[counter].y = m(1, 0) * x + m(1, 1) * y + m(1, 2) * z + m(1, 3);
+		points[counter].z = m(2, 0) * x + m(2, 1) * y + m(2, 2) * z + m(2, 3);
+	}
+}
+
+static void ScaleTranslateScalar(PointT* points, std::size_t size, const float* scale, const float* offset)
+{
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		points[counter].x = points[counter].x * scale[0] + offset[0];
+		points[counter].y = points[counter].y * scale[1] + offset[1];
+		points[counter].z = points[counter].z * scale[2] + offset[2];
+	}
+}
+
+static bool MinMaxScalar(const PointT* points, std::size_t size, float* min, float* max)
+{
+	bool hasPoint = false;
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		const PointT& point = points[counter];
+		if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z))
+			continue;
+		hasPoint = true;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (point.data[axis] < min[axis])
+				min[axis] = point.data[axis];
+			if (point.data[axis] > max[axis])
+				max[axis] = point.data[axis];
+		}
+	}
+	return hasPoint;
+}
+
+#ifdef TRANSFORM_KERNELS_X86
+//		*****************************************************************
+//				SSE : x y z w of a point are one aligned __m128
+//		*****************************************************************
+static void TransformSSE(PointT* points, std::size_t size, const Eigen::Matrix4f& m)
+{
+	//		Eigen is column major, each column is 4 contiguous floats
+	const __m128 column0 = _mm_loadu_ps(m.data());
+	const __m128 column1 = _mm_loadu_ps(m.data() + 4);
+	const __m128 column2 = _mm_loadu_ps(m.data() + 8);
+	const __m128 column3 = _mm_loadu_ps(m.data() + 12);
+	const __m128 keepW = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		float* data = points[counter].data;
+		__m128 v = _mm_loadu_ps(data);
+		__m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, x), _mm_mul_ps(column1, y)), _mm_add_ps(_mm_mul_ps(column2, z), column3));
+		result = _mm_or_ps(_mm_andnot_ps(keepW, result), _mm_and_ps(keepW, v));
+		_mm_storeu_ps(data, result);
+	}
+}
+
+//		w is multiplied by 1 and shifted by 0, so it survives unchanged
+static void ScaleTranslateSSE(PointT* points, std::size_t size, const float* scale, const float* offset)
+{
+	const __m128 scales = _mm_set_ps(1.0f, scale[2], scale[1], scale[0]);
+	const __m128 offsets = _mm_set_ps(0.0f, offset[2], offset[1], offset[0]);
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		float* data = points[counter].data;
+		_mm_storeu_ps(data, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data), scales), offsets));
+	}
+}
+
+static bool MinMaxSSE(const PointT* points, std::size_t size, float* min, float* max)
+{
+	const __m128 zero = _mm_setzero_ps();
+	__m128 minimum = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	__m128 maximum = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+	bool hasPoint = false;
+	for (std::size_t counter = 0; counter < size; counter++)
+	{
+		__m128 v = _mm_loadu_ps(points[counter].data);
+		//		v - v is 0 only for finite values
+		if ((_mm_movemask_ps(_mm_cmpeq_ps(_mm_sub_ps(v, v), zero)) & 7) != 7)
+			continue;
+		minimum = _mm_min_ps(minimum, v);
+		maximum = _mm_max_ps(maximum, v);
+		hasPoint = true;
+	}
+	float minValues[4];
+	float maxValues[4];
+	_mm_storeu_ps(minValues, minimum);
+	_mm_storeu_ps(maxValues, maximum);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (minValues[axis] < min[axis])
+			min[axis] = minValues[axis];
+		if (maxValues[axis] > max[axis])
+			max[axis] = maxValues[axis];
+	}
+	return hasPoint;
+}
+
+//		*****************************************************************
+//				AVX2 : two points per iteration, one in each 128 bit lane
+//		*****************************************************************
+TARGET_AVX2 static inline __m256 LoadPair(const float* first, const float* second)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(first)), _mm_loadu_ps(second), 1);
+}
+
+TARGET_AVX2 static inline void StorePair(float* first, float* second, __m256 value)
+{
+	_mm_storeu_ps(first, _mm256_castps256_ps128(value));
+	_mm_storeu_ps(second, _mm256_extractf128_ps(value, 1));
+}
+
+TARGET_AVX2 static void TransformAVX2(PointT* points, std::size_t size, const Eigen::Matrix4f& m)
+{
+	const __m256 column0 = _mm256_broadcast_ps((const __m128*)m.data());
+	const __m256 column1 = _mm256_broadcast_ps((const __m128*)(m.data() + 4));
+	const __m256 column2 = _mm256_broadcast_ps((const __m128*)(m.data() + 8));
+	const __m256 column3 = _mm256_broadcast_ps((const __m128*)(m.data() + 12));
+	std::size_t counter = 0;
+	for (; counter + 2 <= size; counter += 2)
+	{
+		float* first = points[counter].data;
+		float* second = points[counter + 1].data;
+		__m256 v = LoadPair(first, second);
+		__m256 result = _mm256_fmadd_ps(column0, _mm256_permute_ps(v, 0x00), column3);
+		result = _mm256_fmadd_ps(column1, _mm256_permute_ps(v, 0x55), result);
+		result = _mm256_fmadd_ps(column2, _mm256_permute_ps(v, 0xAA), result);
+		StorePair(first, second, _mm256_blend_ps(result, v, 0x88));
+	}
+	TransformSSE(points + counter, size - counter, m);
+}
+
+TARGET_AVX2 static void ScaleTranslateAVX2(PointT* points, std::size_t size, const float* scale, const float* offset)
+{
+	const __m256 scales = _mm256_set_ps(1.0f, scale[2], scale[1], scale[0], 1.0f, scale[2], scale[1], scale[0]);
+	const __m256 offsets = _mm256_set_ps(0.0f, offset[2], offset[1], offset[0], 0.0f, offset[2], offset[1], offset[0]);
+	std::size_t counter = 0;
+	for (; counter + 2 <= size; counter += 2)
+	{
+		float* first = points[counter].data;
+		float* second = points[counter + 1].data;
+		StorePair(first, second, _mm256_fmadd_ps(LoadPair(first, second), scales, offsets));
+	}
+	ScaleTranslateSSE(points + counter, size - counter, scale, offset);
+}
+
+TARGET_AVX2 static bool MinMaxAVX2(const PointT* points, std::size_t size, float* min, float* max)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	__m256 minimum = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+	__m256 maximum = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+	std::size_t counter = 0;
+	bool hasPoint = false;
+	for (; counter + 2 <= size; counter += 2)
+	{
+		__m256 v = LoadPair(points[counter].data, points[counter + 1].data);
+		int finite = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_sub_ps(v, v), zero, _CMP_EQ_OQ));
+		if ((finite & 0x77) == 0x77)
+		{
+			minimum = _mm256_min_ps(minimum, v);
+			maximum = _mm256_max_ps(maximum, v);
+			hasPoint = true;
+		}
+		else if ((finite & 0x77) != 0)
+		{
+			//		One of the pair is invalid, replace it by the other one
+			__m256 swapped = _mm256_permute2f128_ps(v, v, 0x01);
+			v = (finite & 0x07) == 0x07 ? _mm256_blend_ps(v, swapped, 0xF0) : _mm256_blend_ps(v, swapped, 0x0F);
+			if ((finite & 0x07) == 0x07 || (finite & 0x70) == 0x70)
+			{
+				minimum = _mm256_min_ps(minimum, v);
+				maximum = _mm256_max_ps(maximum, v);
+				hasPoint = true;
+			}
+		}
+	}
+	float minValues[8];
+	float maxValues[8];
+	_mm256_storeu_ps(minValues, minimum);
+	_mm256_storeu_ps(maxValues, maximum);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		min[axis] = std::min(min[axis], std::min(minValues[axis], minValues[axis + 4]));
+		max[axis] = std::max(max[axis], std::max(maxValues[axis], maxValues[axis + 4]));
+	}
+	if (MinMaxSSE(points + counter, size - counter, min, max))
+		hasPoint = true;
+	return hasPoint;
+}
+#endif
+
+//		*****************************************************************
+//				Transform Kernels
+//		*****************************************************************
+void TransformKernels::Transform(pcl::PointCloud<PointT>& cloud, const Eigen::Matrix4f& matrix)
+{
+	if (cloud.points.empty())
+		return;
+	switch (GetInstructionSet())
+	{
+#ifdef TRANSFORM_KERNELS_X86
+	case InstructionSet::AVX2:
+		TransformAVX2(&cloud.points[0], cloud.points.size(), matrix);
+		break;
+	case InstructionSet::SSE:
+		TransformSSE(&cloud.points[0], cloud.points.size(), matrix);
+		break;
+#endif
+	default:
+		TransformScalar(&cloud.points[0], cloud.points.size(), matrix);
+		break;
+	}
+}
+
+void TransformKernels::Transform(const pcl::PointCloud<PointT>& input, pcl::PointCloud<PointT>& output, const Eigen::Matrix4f& matrix)
+{
+	if (&input != &output)
+		output = input;
+	Transform(output, matrix);
+}
+
+void TransformKernels::Scale(pcl::PointCloud<PointT>& cloud, float x, float y, float z)
+{
+	const float scale[3] = { x, y, z };
+	const float offset[3] = { 0, 0, 0 };
+	ScaleTranslate(cloud, scale, offset);
+}
+
+void TransformKernels::Translate(pcl::PointCloud<PointT>& cloud, float x, float y, float z)
+{
+	const float scale[3] = { 1, 1, 1 };
+	const float offset[3] = { x, y, z };
+	ScaleTranslate(cloud, scale, offset);
+}
+
+void TransformKernels::ScaleTranslate(pcl::PointCloud<PointT>& cloud, const float* scale, const float* offset)
+{
+	if (cloud.points.empty())
+		return;
+	switch (GetInstructionSet())
+	{
+#ifdef TRANSFORM_KERNELS_X86
+	case InstructionSet::AVX2:
+		ScaleTranslateAVX2(&cloud.points[0], cloud.points.size(), scale, offset);
+		break;
+	case InstructionSet::SSE:
+		ScaleTranslateSSE(&cloud.points[0], cloud.points.size(), scale, offset);
+		break;
+#endif
+	default:
+		ScaleTranslateScalar(&cloud.points[0], cloud.points.size(), scale, offset);
+		break;
+	}
+}
+
+bool TransformKernels::GetMinMax(const pcl::PointCloud<PointT>& cloud, Eigen::Vector3f& min, Eigen::Vector3f& max)
+{
+	float minValues[3];
+	float maxValues[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		minValues[axis] = std::numeric_limits<float>::infinity();
+		maxValues[axis] = -std::numeric_limits<float>::infinity();
+	}
+	bool hasPoint = false;
+	if (!cloud.points.empty())
+	{
+		switch (GetInstructionSet())
+		{
+#ifdef TRANSFORM_KERNELS_X86
+		case InstructionSet::AVX2:
+			hasPoint = MinMaxAVX2(&cloud.points[0], cloud.points.size(), minValues, maxValues);
+			break;
+		case InstructionSet::SSE:
+			hasPoint = MinMaxSSE(&cloud.points[0], cloud.points.size(), minValues, maxValues);
+			break;
+#endif
+		default:
+			hasPoint = MinMaxScalar(&cloud.points[0], cloud.points.size(), minValues, maxValues);
+			break;
+		}
+	}
+	min = Eigen::Vector3f(minValues[0], minValues[1], minValues[2]);
+	max = Eigen::Vector3f(maxValues[0], maxValues[1], maxValues[2]);
+	return hasPoint;
+}
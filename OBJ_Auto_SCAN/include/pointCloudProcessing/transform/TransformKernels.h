@@ -0,0 +1,40 @@
+#ifndef TRANSFORM_KERNELS
+#define TRANSFORM_KERNELS
+
+#include <Eigen/Core>
+#include "Typedef.h"
+
+enum class InstructionSet
+{
+	Scalar,
+	SSE,				//	one point per iteration, xyz as one __m128
+	AVX2				//	two points per iteration
+};
+
+//		*****************************************************************
+//				Transform Kernels
+//				In-place point transforms on the 32 byte PointXYZRGB layout.
+//				Only x / y / z are written, colour and padding are left alone.
+//				The best instruction set is picked at runtime, SetInstructionSet
+//				forces a slower one (used by the benchmark).
+//		*****************************************************************
+class TransformKernels
+{
+public:
+	static void Transform(pcl::PointCloud<PointT>& cloud, const Eigen::Matrix4f& matrix);
+	static void Transform(const pcl::PointCloud<PointT>& input, pcl::PointCloud<PointT>& output, const Eigen::Matrix4f& matrix);
+	static void Scale(pcl::PointCloud<PointT>& cloud, float x, float y, float z);
+	static void Translate(pcl::PointCloud<PointT>& cloud, float x, float y, float z);
+	//		Non-finite points are skipped, returns false if there was no finite point
+	static bool GetMinMax(const pcl::PointCloud<PointT>& cloud, Eigen::Vector3f& min, Eigen::Vector3f& max);
+
+	static InstructionSet GetSupportedInstructionSet();
+	static InstructionSet GetInstructionSet();
+	static void SetInstructionSet(InstructionSet instructionSet);
+	static const char* GetInstructionSetName(InstructionSet instructionSet);
+
+private:
+	static void ScaleTranslate(pcl::PointCloud<PointT>& cloud, const float* scale, const float* offset);
+};
+
+#endif
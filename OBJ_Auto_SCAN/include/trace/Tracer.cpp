@@ -0,0 +1,186 @@
+#include "trace/Tracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+static void WriteJsonString(std::ostream& out, const char* text)
+{
+	out << '"';
+	for (const char* character = text; *character != '\0'; character++)
+	{
+		if (*character == '"' || *character == '\\')
+			out << '\\';
+		out << *character;
+	}
+	out << '"';
+}
+
+Tracer::Tracer()
+{
+	_isEnabled.store(false);
+	_origin = std::chrono::steady_clock::now();
+	_events.resize(TRACER_DEFAULT_CAPACITY);
+	_next = 0;
+	_size = 0;
+}
+
+Tracer* Tracer::GetInstance()
+{
+	static Tracer* tracer = new Tracer();
+	return tracer;
+}
+
+//		Small ids in order of first use, stable for the life of the thread
+int Tracer::GetThreadId()
+{
+	static std::atomic<int> nextId(1);
+	static thread_local int id = nextId++;
+	return id;
+}
+
+void Tracer::SetEnabled(bool isEnabled)
+{
+	_isEnabled.store(isEnabled);
+}
+
+void Tracer::SetCapacity(std::size_t capacity)
+{
+	if (capacity == 0)
+		throw std::string("Tracer: Capacity must be positive");
+	std::unique_lock<std::mutex> lock(_mutex);
+	_events.assign(capacity, Event());
+	_next = 0;
+	_size = 0;
+}
+
+Tracer::Aggregate& Tracer::GetAggregate(const char* name, const char* category, TraceType type)
+{
+	std::unordered_map<const char*, Aggregate>::iterator it = _aggregates.find(name);
+	if (it != _aggregates.end())
+		return it->second;
+	Aggregate aggregate = { category, type, 0, 0, 0, 0, 0 };
+	return _aggregates.insert(std::make_pair(name, aggregate)).first->second;
+}
+
+void Tracer::Push(const Event& event)
+{
+	_events[_next] = event;
+	_next = (_next + 1) % _events.size();
+	if (_size < _events.size())
+		_size++;
+}
+
+void Tracer::AddScope(const char* name, const char* category, long long startUs, long long durationUs)
+{
+	Event event = { name, category, TraceType::Scope, GetThreadId(), startUs, durationUs, 0 };
+	std::unique_lock<std::mutex> lock(_mutex);
+	Push(event);
+	Aggregate& aggregate = GetAggregate(name, category, TraceType::Scope);
+	aggregate.count++;
+	aggregate.totalUs += durationUs;
+	aggregate.lastUs = durationUs;
+	aggregate.maxUs = std::max(aggregate.maxUs, durationUs);
+}
+
+void Tracer::AddCount(const char* name, const char* category, double increment)
+{
+	long long now = Now();
+	int threadId = GetThreadId();
+	std::unique_lock<std::mutex> lock(_mutex);
+	Aggregate& aggregate = GetAggregate(name, category, TraceType::Counter);
+	aggregate.count++;
+	aggregate.value += increment;
+	Event event = { name, category, TraceType::Counter, threadId, now, 0, aggregate.value };
+	Push(event);
+}
+
+void Tracer::SetGauge(const char* name, const char* category, double value)
+{
+	Event event = { name, category, TraceType::Gauge, GetThreadId(), Now(), 0, value };
+	std::unique_lock<std::mutex> lock(_mutex);
+	Push(event);
+	Aggregate& aggregate = GetAggregate(name, category, TraceType::Gauge);
+	aggregate.count++;
+	aggregate.value = value;
+}
+
+//		The same literal may have several addresses (one per translation unit), merged by text here
+std::vector<TraceStat> Tracer::GetStats()
+{
+	std::map<std::pair<std::string, std::string>, TraceStat> merged;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (std::unordered_map<const char*, Aggregate>::iterator it = _aggregates.begin(); it != _aggregates.end(); ++it)
+		{
+			const Aggregate& aggregate = it->second;
+			std::pair<std::string, std::string> key(aggregate.category, it->first);
+			std::map<std::pair<std::string, std::string>, TraceStat>::iterator found = merged.find(key);
+			if (found == merged.end())
+			{
+				TraceStat stat = { it->first, aggregate.category, aggregate.type, 0, 0, 0, 0, 0 };
+				found = merged.insert(std::make_pair(key, stat)).first;
+			}
+			TraceStat& stat = found->second;
+			stat.count += aggregate.count;
+			stat.totalMilliseconds += aggregate.totalUs / 1000.0;
+			stat.lastMilliseconds = aggregate.lastUs / 1000.0;
+			stat.maxMilliseconds = std::max(stat.maxMilliseconds, aggregate.maxUs / 1000.0);
+			stat.value = aggregate.type == TraceType::Gauge ? aggregate.value : stat.value + aggregate.value;
+		}
+	}
+	std::vector<TraceStat> stats;
+	for (std::map<std::pair<std::string, std::string>, TraceStat>::iterator it = merged.begin(); it != merged.end(); ++it)
+		stats.push_back(it->second);
+	return stats;
+}
+
+std::size_t Tracer::GetNumberOfEvents()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _size;
+}
+
+void Tracer::Clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_next = 0;
+	_size = 0;
+	_aggregates.clear();
+}
+
+//		Copies the ring under the lock, formats without it
+void Tracer::ExportChromeTrace(std::ostream& out)
+{
+	std::vector<Event> events;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		events.reserve(_size);
+		std::size_t first = (_next + _events.size() - _size) % _events.size();
+		for (std::size_t counter = 0; counter < _size; counter++)
+			events.push_back(_events[(first + counter) % _events.size()]);
+	}
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (std::size_t counter = 0; counter < events.size(); counter++)
+	{
+		const Event& event = events[counter];
+		out << (counter == 0 ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(out, event.name);
+		out << ",\"cat\":";
+		WriteJsonString(out, event.category);
+		out << ",\"pid\":1,\"tid\":" << event.threadId << ",\"ts\":" << event.timestampUs;
+		if (event.type == TraceType::Scope)
+			out << ",\"ph\":\"X\",\"dur\":" << event.durationUs << "}";
+		else
+			out << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+	}
+	out << "\n]}\n";
+}
+
+void Tracer::ExportChromeTrace(std::string path)
+{
+	std::ofstream file(path.c_str());
+	if (!file.is_open())
+		throw std::string("Tracer: Cannot create ") + path;
+	ExportChromeTrace(file);
+}
@@ -0,0 +1,153 @@
+#ifndef TRACER
+#define TRACER
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define TRACER_DEFAULT_CAPACITY 65536
+
+enum class TraceType
+{
+	Scope,					//	a timed section, Chrome "X" event
+	Counter,				//	running total of increments, Chrome "C" event
+	Gauge					//	last set value, Chrome "C" event
+};
+
+struct TraceStat
+{
+	std::string name;
+	std::string category;
+	TraceType type;
+	unsigned long long count;			//	scopes ended, increments or sets
+	double totalMilliseconds;			//	scopes only
+	double lastMilliseconds;
+	double maxMilliseconds;
+	double value;						//	counter total or gauge value
+};
+
+//		*****************************************************************
+//				Tracer
+//				Scoped timers, counters and gauges of the hot paths. Events go
+//				to a fixed size ring, the oldest are overwritten, and are
+//				exported as Chrome trace JSON (chrome://tracing, Perfetto).
+//				Names and categories must be string literals : only the
+//				pointers are kept. Disabled, a probe costs one atomic load.
+//		*****************************************************************
+class Tracer
+{
+public:
+	static Tracer* GetInstance();
+	void SetEnabled(bool isEnabled);
+	bool IsEnabled()
+	{
+		return _isEnabled.load(std::memory_order_relaxed);
+	}
+	//		Drops the recorded events
+	void SetCapacity(std::size_t capacity);
+	void AddScope(const char* name, const char* category, long long startUs, long long durationUs);
+	void AddCount(const char* name, const char* category, double increment);
+	void SetGauge(const char* name, const char* category, double value);
+	//		Per name aggregates since the last Clear, sorted by category and name
+	std::vector<TraceStat> GetStats();
+	std::size_t GetNumberOfEvents();
+	void Clear();
+	void ExportChromeTrace(std::ostream& out);
+	void ExportChromeTrace(std::string path);
+
+	//		Microseconds since the tracer was created
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _origin).count();
+	}
+
+private:
+	struct Event
+	{
+		const char* name;
+		const char* category;
+		TraceType type;
+		int threadId;
+		long long timestampUs;
+		long long durationUs;
+		double value;
+	};
+
+	struct Aggregate
+	{
+		const char* category;
+		TraceType type;
+		unsigned long long count;
+		long long totalUs;
+		long long lastUs;
+		long long maxUs;
+		double value;
+	};
+
+	Tracer();
+	Tracer(const Tracer&);
+	Tracer& operator=(const Tracer&);
+	static int GetThreadId();
+	Aggregate& GetAggregate(const char* name, const char* category, TraceType type);
+	void Push(const Event& event);
+
+	std::atomic<bool> _isEnabled;
+	std::chrono::steady_clock::time_point _origin;
+	std::mutex _mutex;
+	std::vector<Event> _events;
+	std::size_t _next;
+	std::size_t _size;
+	std::unordered_map<const char*, Aggregate> _aggregates;
+};
+
+//		*****************************************************************
+//				Trace Scope
+//				Times the enclosing block when the tracer is enabled
+//		*****************************************************************
+class TraceScope
+{
+public:
+	TraceScope(const char* name, const char* category) : _name(name), _category(category), _startUs(-1)
+	{
+		Tracer* tracer = Tracer::GetInstance();
+		if (tracer->IsEnabled())
+			_startUs = tracer->Now();
+	}
+
+	~TraceScope()
+	{
+		if (_startUs < 0)
+			return;
+		Tracer* tracer = Tracer::GetInstance();
+		tracer->AddScope(_name, _category, _startUs, tracer->Now() - _startUs);
+	}
+
+private:
+	TraceScope(const TraceScope&);
+	TraceScope& operator=(const TraceScope&);
+
+	const char* _name;
+	const char* _category;
+	long long _startUs;
+};
+
+//		Define NO_TRACE to compile the probes out
+#ifdef NO_TRACE
+#define TRACE_SCOPE(name, category)
+#define TRACE_COUNT(name, category, increment)
+#define TRACE_GAUGE(name, category, value)
+#else
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+#define TRACE_COUNT(name, category, increment) \
+	do { if (Tracer::GetInstance()->IsEnabled()) Tracer::GetInstance()->AddCount(name, category, increment); } while (0)
+#define TRACE_GAUGE(name, category, value) \
+	do { if (Tracer::GetInstance()->IsEnabled()) Tracer::GetInstance()->SetGauge(name, category, value); } while (0)
+#endif
+
+#endif
@@ -9,6 +9,7 @@
 #include "pointCloud/PointCloudElements.h"
 #include "pointCloudProcessing/filter/FilterFactory.h"
 #include "pointCloudProcessing/filter/FilterProcessing.h"
+#include "Conversion.h"
 
 class BoundingBoxTestDialog : public QDialog
 {
@@ -0,0 +1,125 @@
+#include "ui/CloudBinding.h"
+#include "trace/Tracer.h"
+
+#include <pcl/common/point_tests.h>
+#include <vtkPointData.h>
+#include <vtkProperty.h>
+
+//		SetArray with save = 1 : VTK reads our buffers and never frees them
+#define CLOUD_BINDING_KEEP_BUFFER 1
+
+CloudBinding::CloudBinding() : _capacity(0)
+{
+	_xyzArray = vtkSmartPointer<vtkFloatArray>::New();
+	_xyzArray->SetNumberOfComponents(3);
+	_rgbArray = vtkSmartPointer<vtkUnsignedCharArray>::New();
+	_rgbArray->SetNumberOfComponents(3);
+	_rgbArray->SetName("RGB");
+	_vertexIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+
+	_points = vtkSmartPointer<vtkPoints>::New();
+	_points->SetData(_xyzArray);
+	_vertices = vtkSmartPointer<vtkCellArray>::New();
+	_polyData = vtkSmartPointer<vtkPolyData>::New();
+	_polyData->SetPoints(_points);
+	_polyData->SetVerts(_vertices);
+	_polyData->GetPointData()->SetScalars(_rgbArray);
+
+	_mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+	_mapper->SetInputData(_polyData);
+	_mapper->SetScalarModeToUsePointData();
+	_mapper->ScalarVisibilityOn();
+	_actor = vtkSmartPointer<vtkActor>::New();
+	_actor->SetMapper(_mapper);
+	_actor->GetProperty()->SetRepresentationToPoints();
+	_actor->GetProperty()->SetInterpolationToFlat();
+	_actor->SetVisibility(0);
+}
+
+//		The arrays may outlive this object inside VTK, they must not point at freed buffers
+CloudBinding::~CloudBinding()
+{
+	_xyzArray->Initialize();
+	_rgbArray->Initialize();
+	_vertexIdArray->Initialize();
+}
+
+//		The only place that allocates : a camera keeps its frame size, so this runs once per stream
+void CloudBinding::Reserve(std::size_t capacity)
+{
+	TRACE_COUNT("CloudBinding rebuilds", "viewer", 1);
+	_xyz.resize(capacity * 3);
+	_rgb.resize(capacity * 3);
+	_vertexIds.resize(capacity + 1);
+	for (std::size_t counter = 0; counter < capacity; counter++)
+		_vertexIds[counter + 1] = (vtkIdType)counter;
+	_capacity = capacity;
+}
+
+void CloudBinding::Update(const pcl::PointCloud<PointT>& cloud)
+{
+	if (cloud.size() > _capacity)
+		Reserve(cloud.size());
+	//		Finite points are packed to the front, the vertex cell then only lists 0 .. count - 1
+	vtkIdType count = 0;
+	for (std::size_t counter = 0; counter < cloud.size(); counter++)
+	{
+		const PointT& point = cloud.points[counter];
+		if (!cloud.is_dense && !pcl::isFinite(point))
+			continue;
+		float* xyz = &_xyz[count * 3];
+		xyz[0] = point.x;
+		xyz[1] = point.y;
+		xyz[2] = point.z;
+		unsigned char* rgb = &_rgb[count * 3];
+		rgb[0] = point.r;
+		rgb[1] = point.g;
+		rgb[2] = point.b;
+		count++;
+	}
+	Bind(count);
+}
+
+void CloudBinding::Update(const pcl::PointCloud<PointT>& cloud, const std::vector<int>& indices)
+{
+	if (indices.size() > _capacity)
+		Reserve(indices.size());
+	for (std::size_t counter = 0; counter < indices.size(); counter++)
+	{
+		const PointT& point = cloud.points[indices[counter]];
+		float* xyz = &_xyz[counter * 3];
+		xyz[0] = point.x;
+		xyz[1] = point.y;
+		xyz[2] = point.z;
+		unsigned char* rgb = &_rgb[counter * 3];
+		rgb[0] = point.r;
+		rgb[1] = point.g;
+		rgb[2] = point.b;
+	}
+	Bind((vtkIdType)indices.size());
+}
+
+//		Points the arrays at the first count points of the buffers, no allocation
+void CloudBinding::Bind(vtkIdType count)
+{
+	_actor->SetVisibility(count > 0);
+	if (count == 0)
+		return;
+	_vertexIds[0] = count;
+	_xyzArray->SetArray(&_xyz[0], count * 3, CLOUD_BINDING_KEEP_BUFFER);
+	_rgbArray->SetArray(&_rgb[0], count * 3, CLOUD_BINDING_KEEP_BUFFER);
+	_vertexIdArray->SetArray(&_vertexIds[0], count + 1, CLOUD_BINDING_KEEP_BUFFER);
+	_vertices->SetCells(1, _vertexIdArray);
+	_points->Modified();
+	_polyData->Modified();
+}
+
+vtkActor* CloudBinding::GetActor()
+{
+	return _actor;
+}
+
+std::size_t CloudBinding::GetCapacity()
+{
+	return _capacity;
+}
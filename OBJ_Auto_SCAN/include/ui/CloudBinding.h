@@ -0,0 +1,56 @@
+#ifndef CLOUD_BINDING
+#define CLOUD_BINDING
+
+#include <vector>
+#include <vtkSmartPointer.h>
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkUnsignedCharArray.h>
+#include "Typedef.h"
+
+//		*****************************************************************
+//				Cloud Binding
+//				One persistent vtkPolyData and actor per shown cloud. The VTK
+//				arrays are bound to buffers owned here, Update writes the
+//				finite points of a frame into them and rebinds the arrays to
+//				the new length : nothing is allocated unless a cloud has more
+//				points than any before it, a frame costs one copy pass.
+//		*****************************************************************
+class CloudBinding
+{
+public:
+	CloudBinding();
+	~CloudBinding();
+	void Update(const pcl::PointCloud<PointT>& cloud);
+	//		Only the given points, which must be finite (level of detail selections)
+	void Update(const pcl::PointCloud<PointT>& cloud, const std::vector<int>& indices);
+	vtkActor* GetActor();
+	//		Number of points the buffers are sized for
+	std::size_t GetCapacity();
+
+private:
+	CloudBinding(const CloudBinding&);
+	CloudBinding& operator=(const CloudBinding&);
+	void Reserve(std::size_t capacity);
+	void Bind(vtkIdType count);
+
+	std::vector<float> _xyz;
+	std::vector<unsigned char> _rgb;
+	std::vector<vtkIdType> _vertexIds;		//	one poly vertex : count, 0, 1, 2 ...
+	vtkSmartPointer<vtkFloatArray> _xyzArray;
+	vtkSmartPointer<vtkUnsignedCharArray> _rgbArray;
+	vtkSmartPointer<vtkIdTypeArray> _vertexIdArray;
+	vtkSmartPointer<vtkPoints> _points;
+	vtkSmartPointer<vtkCellArray> _vertices;
+	vtkSmartPointer<vtkPolyData> _polyData;
+	vtkSmartPointer<vtkPolyDataMapper> _mapper;
+	vtkSmartPointer<vtkActor> _actor;
+	std::size_t _capacity;
+};
+
+#endif
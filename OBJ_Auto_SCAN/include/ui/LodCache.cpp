@@ -0,0 +1,189 @@
+#include "ui/LodCache.h"
+#include "trace/Tracer.h"
+
+#include <algorithm>
+#include <pcl/surface/vtk_smoothing/vtk_utils.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkTriangleFilter.h>
+
+template <typename EntryT>
+static void RemoveExpiredEntries(std::vector<EntryT>& entries)
+{
+	for (std::size_t counter = entries.size(); counter > 0; counter--)
+	{
+		if (entries[counter - 1].buffer.expired())
+			entries.erase(entries.begin() + (counter - 1));
+	}
+}
+
+template <typename EntryT>
+static void RemoveOldestEntry(std::vector<EntryT>& entries)
+{
+	if (entries.empty())
+		return;
+	std::size_t oldest = 0;
+	for (std::size_t counter = 1; counter < entries.size(); counter++)
+	{
+		if (entries[counter].lastUse < entries[oldest].lastUse)
+			oldest = counter;
+	}
+	entries.erase(entries.begin() + oldest);
+}
+
+template <typename EntryT>
+static void RemoveEntries(std::vector<EntryT>& entries, const void* id)
+{
+	for (std::size_t counter = entries.size(); counter > 0; counter--)
+	{
+		if (entries[counter - 1].id == id)
+			entries.erase(entries.begin() + (counter - 1));
+	}
+}
+
+LodCache::LodCache()
+{
+	_capacity = LOD_CACHE_DEFAULT_CAPACITY;
+	_clock = 0;
+	SharedCloudListeners::Add(&LodCache::OnWrite);
+}
+
+LodCache* LodCache::GetInstance()
+{
+	static LodCache* cache = new LodCache();
+	return cache;
+}
+
+void LodCache::OnWrite(const void* id)
+{
+	GetInstance()->Invalidate(id);
+}
+
+//		Built outside the lock, two callers missing on the same buffer both build and the first insert wins
+PointCloudLod::Ptr LodCache::GetPointCloudLod(pcl::PointCloud<PointT>::Ptr cloud)
+{
+	if (cloud.get() == NULL)
+		throw std::string("LodCache: No input cloud");
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		RemoveExpired();
+		for (std::size_t counter = 0; counter < _clouds.size(); counter++)
+		{
+			if (_clouds[counter].id == cloud.get() && _clouds[counter].size == cloud->size())
+			{
+				_clouds[counter].lastUse = ++_clock;
+				return _clouds[counter].lod;
+			}
+		}
+	}
+
+	PointCloudLod::Ptr lod(new PointCloudLod());
+	{
+		TRACE_SCOPE("LodCache::BuildPointCloudLod", "viewer");
+		lod->Build(*cloud);
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_capacity == 0)
+		return lod;
+	for (std::size_t counter = 0; counter < _clouds.size(); counter++)
+	{
+		if (_clouds[counter].id == cloud.get() && _clouds[counter].size == cloud->size())
+			return _clouds[counter].lod;
+	}
+	if (_clouds.size() >= _capacity)
+		RemoveOldestEntry(_clouds);
+	CloudEntry entry;
+	entry.buffer = cloud;
+	entry.id = cloud.get();
+	entry.size = cloud->size();
+	entry.lod = lod;
+	entry.lastUse = ++_clock;
+	_clouds.push_back(entry);
+	return lod;
+}
+
+vtkSmartPointer<vtkPolyData> LodCache::GetMeshProxy(pcl::PolygonMeshPtr mesh, std::size_t triangleBudget)
+{
+	if (mesh.get() == NULL)
+		throw std::string("LodCache: No input mesh");
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		RemoveExpired();
+		for (std::size_t counter = 0; counter < _meshes.size(); counter++)
+		{
+			MeshEntry& entry = _meshes[counter];
+			if (entry.id == mesh.get() && entry.size == mesh->polygons.size() && entry.triangleBudget == triangleBudget)
+			{
+				entry.lastUse = ++_clock;
+				return entry.proxy;
+			}
+		}
+	}
+
+	vtkSmartPointer<vtkPolyData> proxy = Decimate(*mesh, triangleBudget);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_capacity == 0)
+		return proxy;
+	if (_meshes.size() >= _capacity)
+		RemoveOldestEntry(_meshes);
+	MeshEntry entry;
+	entry.buffer = mesh;
+	entry.id = mesh.get();
+	entry.size = mesh->polygons.size();
+	entry.triangleBudget = triangleBudget;
+	entry.proxy = proxy;
+	entry.lastUse = ++_clock;
+	_meshes.push_back(entry);
+	return proxy;
+}
+
+//		Quadric decimation keeps the silhouette of a scan far better than dropping triangles
+vtkSmartPointer<vtkPolyData> LodCache::Decimate(const pcl::PolygonMesh& mesh, std::size_t triangleBudget)
+{
+	TRACE_SCOPE("LodCache::Decimate", "viewer");
+	vtkSmartPointer<vtkPolyData> polyData;
+	if (pcl::VTKUtils::convertToVTK(mesh, polyData) < 0)
+		throw std::string("LodCache: Cannot convert the mesh");
+	vtkSmartPointer<vtkTriangleFilter> triangles = vtkSmartPointer<vtkTriangleFilter>::New();
+	triangles->SetInputData(polyData);
+	vtkSmartPointer<vtkQuadricDecimation> decimation = vtkSmartPointer<vtkQuadricDecimation>::New();
+	decimation->SetInputConnection(triangles->GetOutputPort());
+	double reduction = mesh.polygons.empty() ? 0 : 1.0 - (double)triangleBudget / mesh.polygons.size();
+	decimation->SetTargetReduction(std::max(reduction, 0.0));
+	decimation->Update();
+	vtkSmartPointer<vtkPolyData> proxy = vtkSmartPointer<vtkPolyData>::New();
+	proxy->ShallowCopy(decimation->GetOutput());
+	return proxy;
+}
+
+void LodCache::Invalidate(const void* id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	RemoveEntries(_clouds, id);
+	RemoveEntries(_meshes, id);
+}
+
+void LodCache::SetCapacity(std::size_t capacity)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_capacity = capacity;
+	while (_clouds.size() > _capacity)
+		RemoveOldestEntry(_clouds);
+	while (_meshes.size() > _capacity)
+		RemoveOldestEntry(_meshes);
+}
+
+void LodCache::Clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_clouds.clear();
+	_meshes.clear();
+}
+
+//		A freed buffer can come back at the same address, the weak reference tells them apart
+void LodCache::RemoveExpired()
+{
+	RemoveExpiredEntries(_clouds);
+	RemoveExpiredEntries(_meshes);
+}
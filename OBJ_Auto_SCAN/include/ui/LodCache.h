@@ -0,0 +1,67 @@
+#ifndef LOD_CACHE
+#define LOD_CACHE
+
+#include <mutex>
+#include <vector>
+#include <boost/weak_ptr.hpp>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include "pointCloud/SharedCloud.h"
+#include "ui/PointCloudLod.h"
+
+#define LOD_CACHE_DEFAULT_CAPACITY 8
+
+//		*****************************************************************
+//				LOD Cache
+//				Display octrees of large clouds and decimated proxies of large
+//				meshes, built once per buffer so that showing an element again
+//				(table check box, viewer refresh) does not rebuild them. Like the
+//				spatial index cache, entries hold a weak reference to the buffer
+//				and are dropped with it or when SharedCloud::Write modifies it.
+//		*****************************************************************
+class LodCache
+{
+public:
+	static LodCache* GetInstance();
+	PointCloudLod::Ptr GetPointCloudLod(pcl::PointCloud<PointT>::Ptr cloud);
+	//		At most about triangleBudget triangles
+	vtkSmartPointer<vtkPolyData> GetMeshProxy(pcl::PolygonMeshPtr mesh, std::size_t triangleBudget);
+	void Invalidate(const void* id);
+	void SetCapacity(std::size_t capacity);
+	void Clear();
+
+private:
+	struct CloudEntry
+	{
+		boost::weak_ptr<pcl::PointCloud<PointT> > buffer;
+		const void* id;
+		std::size_t size;
+		PointCloudLod::Ptr lod;
+		unsigned long long lastUse;
+	};
+
+	struct MeshEntry
+	{
+		boost::weak_ptr<pcl::PolygonMesh> buffer;
+		const void* id;
+		std::size_t size;
+		std::size_t triangleBudget;
+		vtkSmartPointer<vtkPolyData> proxy;
+		unsigned long long lastUse;
+	};
+
+	LodCache();
+	LodCache(const LodCache&);
+	LodCache& operator=(const LodCache&);
+	static void OnWrite(const void* id);
+	static vtkSmartPointer<vtkPolyData> Decimate(const pcl::PolygonMesh& mesh, std::size_t triangleBudget);
+	void RemoveExpired();
+
+	std::mutex _mutex;
+	std::vector<CloudEntry> _clouds;
+	std::vector<MeshEntry> _meshes;
+	std::size_t _capacity;
+	unsigned long long _clock;
+};
+
+#endif
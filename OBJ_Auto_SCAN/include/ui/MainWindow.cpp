@@ -1,5 +1,9 @@
 #include "ui/MainWindow.h"
 
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
 MainWindow::MainWindow(QWidget *parent) :
 	QMainWindow(parent), _ui(new Ui::MainWindowForm)
 {
@@ -8,6 +12,7 @@ MainWindow::MainWindow(QWidget *parent) :
 	InitialMemberVariable();
 	InitialPointCloudViewer();
 	InitialPointCloudTable();
+	InitialStatsTable();
 	InitialTabWidget();
 	RegisterObserver();
 	InitialConnectSlots();
@@ -16,16 +21,20 @@ MainWindow::MainWindow(QWidget *parent) :
 void MainWindow::InitialMemberVariable()
 {
 	_keepFrameNumber = 0;
-	_preFrameTime = clock();
+	_keepFrameGovernor.SetTimePitch(FRAME_PITCH);
 	_grabber = NULL;
 	_dialog = NULL;
 
 	_viewer = new Viewer();
 	_uiObserver = new UIObserver(this);
+	_recorderObserver = new RecorderObserver();
+	_turntableAngle = 0;
+	_recordDroppedFrames = 0;
 	_fileFactory = new FileFactory();
 	_arduino = new Arduino(COM_PORT);
 	_elements = new PointCloudElements();
 	_grabberFactory = new GrabberFactory();
+	_captureSession = new CaptureSession();
 	_subjectFactory = new SubjectFactory();
 	_keypointFactory = new KeypointFactory();
 	_filterFactory = new FilterFactory();
@@ -37,10 +46,25 @@ void MainWindow::InitialMemberVariable()
 	_keypointProcessing = _keypointFactory->GetSIFT();
 	_correspondencesProcessing = _correspondencesFactory->GetFPFH();
 	_regestrationProcessing = _regestrationFactory->GetICP();
+	_poseGraphRegestration = _regestrationFactory->GetPoseGraph();
 	_reconstructProcessing = _reconstructFactory->GetGreedyProjection();
 	_smoothingProcessing = _smoothingFactory->GetMeshSmoothingLaplacian();
+	//		Workers report back through queued invokes, the elements are only touched on the GUI thread
+	_jobQueue = new JobQueue();
+	_jobQueue->SetFinishedCallback([this](int id)
+	{
+		QMetaObject::invokeMethod(this, "JobFinishedSlot", Qt::QueuedConnection, Q_ARG(int, id));
+	});
+	_jobQueue->SetProgressCallback([this](int id, float progress)
+	{
+		QMetaObject::invokeMethod(this, "JobProgressSlot", Qt::QueuedConnection, Q_ARG(int, id), Q_ARG(float, progress));
+	});
+
+	_statsTimer = new QTimer(this);
+	_viewerTimer = new QTimer(this);
 
 	_isTestedKinfuBoundingBox = false;
+	_isLiveOutlierRemoval = false;
 }
 
 void MainWindow::InitialConnectSlots()
@@ -49,18 +73,31 @@ void MainWindow::InitialConnectSlots()
 	//		File
 	connect(_ui->_openFileAction, SIGNAL(triggered()), this, SLOT(OpenFileSlot()));
 	connect(_ui->_saveFileAction, SIGNAL(triggered()), this, SLOT(SaveFileSlot()));
+	connect(_ui->_openSessionAction, SIGNAL(triggered()), this, SLOT(OpenSessionSlot()));
+	connect(_ui->_saveSessionAction, SIGNAL(triggered()), this, SLOT(SaveSessionSlot()));
 	//		Viewer
 	connect(_ui->_setViewBackgroundToBlackAction, SIGNAL(triggered()), this, SLOT(SetViewBackgroundToBlackSlot()));
 	connect(_ui->_setViewBackgroundToWhiteAction, SIGNAL(triggered()), this, SLOT(SetViewWhiteBackgroundToWhiteSlot()));
+	connect(_ui->_showStatsAction, SIGNAL(triggered()), this, SLOT(ShowStatsSlot()));
+	connect(_ui->_startTraceAction, SIGNAL(triggered()), this, SLOT(StartTraceSlot()));
+	connect(_ui->_exportTraceAction, SIGNAL(triggered()), this, SLOT(ExportTraceSlot()));
+	connect(_statsTimer, SIGNAL(timeout()), this, SLOT(UpdateStatsSlot()));
 	//		Camera
 	connect(_ui->_startFlexxAction, SIGNAL(triggered()), this, SLOT(StartFlexxCameraSlot()));
 	connect(_ui->_stopFlexxAction, SIGNAL(triggered()), this, SLOT(StopCameraSlot()));
 	connect(_ui->_startRSAction, SIGNAL(triggered()), this, SLOT(StartRSCameraSlot()));
 	connect(_ui->_stopRSAction, SIGNAL(triggered()), this, SLOT(StopCameraSlot()));
 	connect(_ui->_setConfidenceAction, SIGNAL(triggered()), this, SLOT(SetCameraDepthConfidenceSlot()));
+	connect(_ui->_setCaptureRateAction, SIGNAL(triggered()), this, SLOT(SetCaptureRateSlot()));
+	connect(_ui->_liveOutlierRemovalAction, SIGNAL(triggered()), this, SLOT(LiveOutlierRemovalSlot()));
 	connect(_ui->_startXtionProAction, SIGNAL(triggered()), this, SLOT(StartXtionProCameraSlot()));
 	connect(_ui->_stopXtionProAction, SIGNAL(triggered()), this, SLOT(StopCameraSlot()));
-	connect(this->_uiObserver, SIGNAL(UpdateViewer(pcl::PointCloud<PointT>::Ptr)), this, SLOT(UpdateViewerSlot(pcl::PointCloud<PointT>::Ptr)));
+	connect(_ui->_startReplayAction, SIGNAL(triggered()), this, SLOT(StartReplaySlot()));
+	connect(_ui->_stepReplayAction, SIGNAL(triggered()), this, SLOT(StepReplaySlot()));
+	connect(_ui->_stopReplayAction, SIGNAL(triggered()), this, SLOT(StopCameraSlot()));
+	connect(_ui->_startMultiCameraAction, SIGNAL(triggered()), this, SLOT(StartMultiCameraSlot()));
+	connect(_viewerTimer, SIGNAL(timeout()), this, SLOT(RefreshViewerSlot()));
+	_viewerTimer->start(VIEWER_REFRESH_TIME);
 	//		Arduino
 	connect(_ui->_getNumberOfBytesAction, SIGNAL(triggered()), this, SLOT(GetNumberOfBytesSlot()));
 	connect(_ui->_getCharAction, SIGNAL(triggered()), this, SLOT(GetCharSlot()));
@@ -69,7 +106,7 @@ void MainWindow::InitialConnectSlots()
 	//		PointClouds
 	connect(_ui->_keepOneFrameAction, SIGNAL(triggered()), this, SLOT(KeepOneFrameSlot()));
 	connect(_ui->_keepContinueFrameAction, SIGNAL(triggered()), this, SLOT(KeepContinueFrameSlot()));
-	connect(_ui->_pointCloudTable, SIGNAL(itemChanged(QTableWidgetItem *)), this, SLOT(TableItemChangeSlot(QTableWidgetItem *)));
+	connect(_ui->_recordScanAction, SIGNAL(triggered()), this, SLOT(RecordScanSlot()));
 	connect(_ui->_removeSelectedPointCloudsAction, SIGNAL(triggered()), this, SLOT(RemoveSelectedPointCloudSlot()));
 	connect(_ui->_removeAllPointCloudsAction, SIGNAL(triggered()), this, SLOT(RemoveAllPointCloudSlot()));
 	connect(_ui->_selectAllPointCloudsAction, SIGNAL(triggered()), this, SLOT(SelectAllPointCloudSlot()));
@@ -83,6 +120,8 @@ void MainWindow::InitialConnectSlots()
 	connect(_ui->_processICP1Action, SIGNAL(triggered()), this, SLOT(ProcessICP1Slot()));
 	connect(_ui->_processICP2Action, SIGNAL(triggered()), this, SLOT(ProcessICP2Slot()));
 	connect(_ui->_processICP3Action, SIGNAL(triggered()), this, SLOT(ProcessICP3Slot()));
+	connect(_ui->_processPoseGraphAction, SIGNAL(triggered()), this, SLOT(ProcessPoseGraphSlot()));
+	connect(_ui->_cancelJobsAction, SIGNAL(triggered()), this, SLOT(CancelJobsSlot()));
 	//		Keypoint
 	connect(_ui->_keypointProcessingButton, SIGNAL(clicked()), this, SLOT(ProcessKeypointSlot()));
 	connect(_ui->_keypointTabWidget, SIGNAL(currentChanged(int)), this, SLOT(ChangeKeypointTabSlot(int)));
@@ -102,6 +141,8 @@ void MainWindow::InitialConnectSlots()
 	connect(_ui->_voxelGridXSpinBox, SIGNAL(valueChanged(double)), this, SLOT(SetFilterVoxelGridXYZSlot()));
 	connect(_ui->_voxelGridYSpinBox, SIGNAL(valueChanged(double)), this, SLOT(SetFilterVoxelGridXYZSlot()));
 	connect(_ui->_voxelGridZSpinBox, SIGNAL(valueChanged(double)), this, SLOT(SetFilterVoxelGridXYZSlot()));
+	connect(_ui->_voxelGridHashCheckBox, SIGNAL(toggled(bool)), this, SLOT(SetFilterVoxelGridHashSlot(bool)));
+	connect(_ui->_voxelGridKeepOrganizedCheckBox, SIGNAL(toggled(bool)), this, SLOT(SetFilterKeepOrganizedSlot(bool)));
 	//		Filter : Bounding Box
 	connect(_ui->_boundingBoxMinXSpinBox, SIGNAL(valueChanged(double)), this, SLOT(SetFilterBoundingBoxSlot()));
 	connect(_ui->_boundingBoxMaxXSpinBox, SIGNAL(valueChanged(double)), this, SLOT(SetFilterBoundingBoxSlot()));
@@ -188,17 +229,29 @@ void MainWindow::InitialPointCloudViewer()
 
 void MainWindow::InitialPointCloudTable()
 {
-	_ui->_pointCloudTable->setRowCount(0);
-	_ui->_pointCloudTable->setColumnCount(2);
+	_pointCloudTableModel = new PointCloudTableModel(_elements, this);
+	_pointCloudTableModel->SetVisibilityCallback([this](int id)
+	{
+		ShowElementById(id);
+	});
+	_ui->_pointCloudTable->setModel(_pointCloudTableModel);
 	_ui->_pointCloudTable->setColumnWidth(0, 400);
-	QStringList tableTitle;
-	tableTitle << QString("Name") << QString("Show");
 	for (int counter = 0; counter < _ui->_pointCloudTable->horizontalHeader()->count(); ++counter)
 	{
 		_ui->_pointCloudTable->horizontalHeader()->setSectionResizeMode(counter, QHeaderView::Stretch);
 	}
 	_ui->_pointCloudTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-	_ui->_pointCloudTable->setHorizontalHeaderLabels(tableTitle);
+}
+
+void MainWindow::InitialStatsTable()
+{
+	_ui->_statsTable->setRowCount(0);
+	_ui->_statsTable->setColumnCount(7);
+	QStringList tableTitle;
+	tableTitle << QString("Name") << QString("Category") << QString("Count") << QString("Last (ms)") << QString("Avg (ms)") << QString("Max (ms)") << QString("Value");
+	_ui->_statsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	_ui->_statsTable->setHorizontalHeaderLabels(tableTitle);
+	_ui->_statsDock->hide();
 }
 
 void MainWindow::InitialTabWidget()
@@ -212,54 +265,93 @@ void MainWindow::InitialTabWidget()
 	_ui->_smoothingTabWidget->setCurrentIndex(0);
 }
 
+//		Only the elements whose visibility changed since the last call touch the viewer.
+//		Removed elements are still valid here, PointCloudElements never deletes them.
 void MainWindow::UpdatePointCloudViewer()
 {
-	_viewer->Clear();
+	std::set<PointCloudElement*> shownElements;
 	for (int counter = 0; counter < _elements->GetNumberOfElements(); counter++)
 	{
-		if (_elements->GetIsSelectedById(counter))
-			_elements->ShowPointCloudElementById(*_viewer, counter);
+		PointCloudElement* element = _elements->GetPointCloudElementById(counter);
+		if (!element->GetIsSelected())
+			continue;
+		shownElements.insert(element);
+		if (_shownElements.count(element) == 0)
+			element->Show(*_viewer);
 	}
+	for (std::set<PointCloudElement*>::iterator it = _shownElements.begin(); it != _shownElements.end(); ++it)
+	{
+		if (shownElements.count(*it) == 0)
+			(*it)->Delete(*_viewer);
+	}
+	_shownElements.swap(shownElements);
 	_ui->_qvtkWidget->update();
 }
 
+//		Inserts and removes reach the table model by themselves, this repaints the rows
+//		for changes made on the elements directly
 void MainWindow::UpdatePointCloudTable()
 {
-	disconnect(_ui->_pointCloudTable, SIGNAL(itemChanged(QTableWidgetItem *)), this, SLOT(TableItemChangeSlot(QTableWidgetItem *)));
-	_ui->_pointCloudTable->setRowCount(_elements->GetNumberOfElements());
-	for (int counter = 0; counter < _elements->GetNumberOfElements(); counter++)
+	_pointCloudTableModel->Refresh();
+}
+
+//		Frame filters of the camera view, on the organized frame : the kinfu bounding box test
+//		crop, then the outlier removal with the parameters of the Outlier Removal tab.
+//		Both write into pooled buffers, MyPointCloud copies a frame it keeps.
+pcl::PointCloud<PointT>::Ptr MainWindow::FilterLiveFrame(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	if (_isTestedKinfuBoundingBox)
 	{
-		//		Name Column
-		QString name = QString::fromStdString(_elements->GetNameById(counter));
-		//		Show Column
-		QTableWidgetItem *showPointCloudItem = new QTableWidgetItem();
-		if (_elements->GetIsSelectedById(counter))
-			showPointCloudItem->setCheckState(Qt::Checked);
-		else
-			showPointCloudItem->setCheckState(Qt::Unchecked);
-		//		Add into Table
-		_ui->_pointCloudTable->setItem(counter, 0, new QTableWidgetItem(name));
-		_ui->_pointCloudTable->setItem(counter, 1, showPointCloudItem);
+		FilterProcessing* filter = _filterFactory->GetDepthImageBoundingBoxFilter();
+		filter->Processing(pointCloud);
+		pointCloud = filter->GetResult();
+	}
+	if (_isLiveOutlierRemoval)
+	{
+		FilterProcessing* filter = _filterFactory->GetOutlierRemovalFilter();
+		filter->Processing(pointCloud);
+		pointCloud = filter->GetResult();
 	}
-	connect(_ui->_pointCloudTable, SIGNAL(itemChanged(QTableWidgetItem *)), this, SLOT(TableItemChangeSlot(QTableWidgetItem *)));
+	return pointCloud;
+}
+
+//		Frames the recorder's FrameBus rings overflowed on, over all grabbers
+unsigned long long MainWindow::GetRecorderDroppedFrames()
+{
+	ISubject* subjects[] = { _subjectFactory->GetRSSubject(), _subjectFactory->GetFlexxSubject(), _subjectFactory->GetOpenNI2Subject() };
+	unsigned long long dropped = 0;
+	for (int counter = 0; counter < 3; counter++)
+		dropped += subjects[counter]->GetObserverStats(_recorderObserver).dropped;
+	return dropped;
 }
 
 void MainWindow::RegisterObserver()
 {
 	ISubject* rsSubject = _subjectFactory->GetRSSubject();
 	rsSubject->RegisterObserver(_uiObserver);
+	rsSubject->RegisterObserver(_recorderObserver, OverflowPolicy::DropNewest);
 	ISubject* flexxSubject = _subjectFactory->GetFlexxSubject();
 	flexxSubject->RegisterObserver(_uiObserver);
+	flexxSubject->RegisterObserver(_recorderObserver, OverflowPolicy::DropNewest);
 	ISubject* openNI2 = _subjectFactory->GetOpenNI2Subject();
 	openNI2->RegisterObserver(_uiObserver);
+	openNI2->RegisterObserver(_recorderObserver, OverflowPolicy::DropNewest);
+	ISubject* replaySubject = _subjectFactory->GetReplaySubject();
+	replaySubject->RegisterObserver(_uiObserver);
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
 	if (_grabber != NULL)
 		_grabber->StopCamera();
-	disconnect(this->_uiObserver, SIGNAL(UpdateViewer(pcl::PointCloud<PointT>::Ptr)), this, SLOT(UpdateViewerSlot(pcl::PointCloud<PointT>::Ptr)));
+	_captureSession->Stop();
+	_viewerTimer->stop();
 	delete _grabberFactory;
+	_recorderObserver->StopRecording();
+	//		Running jobs are not waited for, they must not call back into a closed window
+	_jobQueue->SetFinishedCallback(std::function<void(int)>());
+	_jobQueue->SetProgressCallback(std::function<void(int, float)>());
+	_jobQueue->CancelAll();
 }
 
 std::string MainWindow::ShowInputDialogSlot(bool* ok, const char* title, const char* label, const char* text)
@@ -286,16 +378,89 @@ void MainWindow::SetViewWhiteBackgroundToWhiteSlot()
 	_ui->_qvtkWidget->update();
 }
 
+//		The dock only shows what the tracer records : start a trace to fill it
+void MainWindow::ShowStatsSlot()
+{
+	if (!_ui->_statsDock->isVisible())
+	{
+		_ui->_statsDock->show();
+		UpdateStatsSlot();
+		_statsTimer->start(STATS_REFRESH_TIME);
+		_ui->_showStatsAction->setText(QString("Hide Stats"));
+	}
+	else
+	{
+		_ui->_statsDock->hide();
+		_statsTimer->stop();
+		_ui->_showStatsAction->setText(QString("Show Stats"));
+	}
+}
+
+void MainWindow::StartTraceSlot()
+{
+	Tracer* tracer = Tracer::GetInstance();
+	if (TypeConversion::QString2String(_ui->_startTraceAction->text()) == "Start Trace")
+	{
+		tracer->Clear();
+		tracer->SetEnabled(true);
+		_ui->_startTraceAction->setText(QString("Stop Trace"));
+	}
+	else
+	{
+		tracer->SetEnabled(false);
+		_ui->_startTraceAction->setText(QString("Start Trace"));
+	}
+}
+
+//		chrome://tracing or ui.perfetto.dev opens the file
+void MainWindow::ExportTraceSlot()
+{
+	QString dir = QFileDialog::getSaveFileName(this, tr("Export Trace"), "", tr("Chrome Trace(*.json)"));
+	if (dir.isEmpty())	return;
+	try
+	{
+		Tracer::GetInstance()->ExportChromeTrace(TypeConversion::QString2String(dir));
+	}
+	catch (std::string& error)
+	{
+		QMessageBox::about(this, tr("Export Trace"), tr(error.c_str()));
+	}
+}
+
+void MainWindow::UpdateStatsSlot()
+{
+	//		Closed from its title bar
+	if (!_ui->_statsDock->isVisible())
+	{
+		_statsTimer->stop();
+		_ui->_showStatsAction->setText(QString("Show Stats"));
+		return;
+	}
+	std::vector<TraceStat> stats = Tracer::GetInstance()->GetStats();
+	_ui->_statsTable->setRowCount((int)stats.size());
+	for (int counter = 0; counter < (int)stats.size(); counter++)
+	{
+		const TraceStat& stat = stats[counter];
+		bool isScope = stat.type == TraceType::Scope;
+		double average = stat.count == 0 ? 0 : stat.totalMilliseconds / stat.count;
+		_ui->_statsTable->setItem(counter, 0, new QTableWidgetItem(QString::fromStdString(stat.name)));
+		_ui->_statsTable->setItem(counter, 1, new QTableWidgetItem(QString::fromStdString(stat.category)));
+		_ui->_statsTable->setItem(counter, 2, new QTableWidgetItem(QString::number(stat.count)));
+		_ui->_statsTable->setItem(counter, 3, new QTableWidgetItem(isScope ? QString::number(stat.lastMilliseconds, 'f', 2) : QString()));
+		_ui->_statsTable->setItem(counter, 4, new QTableWidgetItem(isScope ? QString::number(average, 'f', 2) : QString()));
+		_ui->_statsTable->setItem(counter, 5, new QTableWidgetItem(isScope ? QString::number(stat.maxMilliseconds, 'f', 2) : QString()));
+		_ui->_statsTable->setItem(counter, 6, new QTableWidgetItem(isScope ? QString() : QString::number(stat.value, 'g', 10)));
+	}
+}
+
 //****************************************************************
 //								Slots : UI
 //****************************************************************
 void MainWindow::UpdateViewerSlot(pcl::PointCloud<PointT>::Ptr pointCloud)
 {
-	if (_isTestedKinfuBoundingBox)
-	{
-		_filterProcessing->Processing(pointCloud);
-		pointCloud = _filterProcessing->GetResult();
-	}
+	TRACE_SCOPE("MainWindow::UpdateViewerSlot", "viewer");
+	TRACE_GAUGE("Viewer points", "viewer", (double)pointCloud->size());
+	pointCloud = FilterLiveFrame(pointCloud);
 	_tmpPointCloud = pointCloud;
 	//std::unique_lock<std::mutex> lock(_grabber->GetMutex());
 	_viewer->ShowPointCloud(pointCloud);
@@ -303,19 +468,61 @@ void MainWindow::UpdateViewerSlot(pcl::PointCloud<PointT>::Ptr pointCloud)
 	_ui->_qvtkWidget->update();
 }
 
-void MainWindow::TableItemChangeSlot(QTableWidgetItem* item)
+//		Only the newest frame is drawn and kept, the ones that arrived since the last tick were skipped by the observer.
+//		Large elements follow the camera here too.
+void MainWindow::RefreshViewerSlot()
+{
+	CheckReplay();
+	bool isChanged = _viewer->UpdateLevelOfDetail();
+	pcl::PointCloud<PointT>::Ptr keepFrame = _uiObserver->TakeKeepFrame();
+	if (keepFrame != NULL)
+		KeepFrameArrivedSlot(keepFrame);
+	pcl::PointCloud<PointT>::Ptr pointCloud = _uiObserver->TakeLatestFrame();
+	FrameSet frameSet;
+	//		The session's devices publish to the UI observer too, their frames are drawn by set
+	if (_captureSession->IsRunning() && _captureSession->TakeLatestFrameSet(frameSet))
+		ShowFrameSet(frameSet);
+	else if (pointCloud != NULL && !_captureSession->IsRunning())
+		UpdateViewerSlot(pointCloud);
+	else if (isChanged)
+		_ui->_qvtkWidget->update();
+}
+
+//		One live cloud per device, in the device's own coordinates
+void MainWindow::ShowFrameSet(FrameSet& frameSet)
 {
-	//UpdatePointCloudViewer();
-	PointCloudElement* element = _elements->GetPointCloudElementById(item->row());
-	element->SetIsSelected(item->checkState() == Qt::Checked);
-	if (element->GetIsSelected())
+	TRACE_SCOPE("MainWindow::ShowFrameSet", "viewer");
+	for (std::size_t counter = 0; counter < frameSet.frames.size(); counter++)
 	{
-		element->Show(*_viewer);
+		frameSet.frames[counter] = FilterLiveFrame(frameSet.frames[counter]);
+		_viewer->ShowPointCloud(frameSet.frames[counter], std::string("live_") + _captureSession->GetDeviceName((int)counter));
 	}
-	else
-	{
+	_tmpFrameSet = frameSet;
+	_ui->_qvtkWidget->update();
+}
+
+//		A replay ends on its own thread, at the last frame or on a read error. The grabber is
+//		released before the message box, whose event loop keeps running this timer.
+void MainWindow::CheckReplay()
+{
+	ReplayGrabber* replay = _grabberFactory->GetReplayGrabber();
+	if (replay == NULL || _grabber != replay || !replay->IsFinished())
+		return;
+	_grabber = NULL;
+	replay->StopCamera();
+	std::string error = replay->GetError();
+	if (!error.empty())
+		QMessageBox::about(this, tr("Replay"), tr(error.c_str()));
+}
+
+//		Called by the table model when a show check box is toggled
+void MainWindow::ShowElementById(int id)
+{
+	PointCloudElement* element = _elements->GetPointCloudElementById(id);
+	if (element->GetIsSelected() && _shownElements.insert(element).second)
+		element->Show(*_viewer);
+	else if (!element->GetIsSelected() && _shownElements.erase(element) > 0)
 		element->Delete(*_viewer);
-	}
 	_ui->_qvtkWidget->update();
 }
 
@@ -326,8 +533,25 @@ void MainWindow::OpenFileSlot()
 {
 	QString filter;
 	QStringList filenames = QFileDialog::getOpenFileNames(this, tr("Open File"), "", tr("OBJ(*.obj);;PLY(*.ply);;PCD(*.pcd)"), &filter);
+	std::vector<std::string> paths;
 	for (int counter = 0; counter < filenames.count(); counter++)
-		OpenFile(TypeConversion::QString2String(filenames.at(counter)), TypeConversion::QString2String(filter));
+		paths.push_back(TypeConversion::QString2String(filenames.at(counter)));
+	//		Files are read concurrently but added in the order they were selected
+	ParallelFileLoader loader(_fileFactory);
+	std::vector<LoadedFile> files = loader.Load(paths, TypeConversion::QString2String(filter));
+	std::string errors;
+	for (int counter = 0; counter < files.size(); counter++)
+	{
+		if (!files[counter].error.empty())
+		{
+			errors += files[counter].path + " : " + files[counter].error + "\n";
+			continue;
+		}
+		MyPointCloud* cloud = new MyPointCloud(SharedPointCloud::Adopt(files[counter].cloud), files[counter].path);
+		_elements->AddPointCloudElement(cloud);
+	}
+	if (!errors.empty())
+		QMessageBox::about(this, tr("Open File"), tr(errors.c_str()));
 	UpdatePointCloudTable();
 	UpdatePointCloudViewer();
 }
@@ -369,11 +593,50 @@ void MainWindow::SaveFile(std::string dir, std::string filter)
 	}
 }
 
+//		Only the table of the session is read here, an element loads its buffer when it is first shown or processed
+void MainWindow::OpenSessionSlot()
+{
+	QString dir = QFileDialog::getOpenFileName(this, tr("Open Session"), "", tr("Session(*.session)"));
+	if (dir.isEmpty())	return;
+	try
+	{
+		SessionFile::Load(TypeConversion::QString2String(dir), *_elements);
+	}
+	catch (std::string& error)
+	{
+		QMessageBox::about(this, tr("Open Session"), tr(error.c_str()));
+		return;
+	}
+	UpdatePointCloudTable();
+	UpdatePointCloudViewer();
+}
+
+//		Every element of the table, selected or not
+void MainWindow::SaveSessionSlot()
+{
+	QString dir = QFileDialog::getSaveFileName(this, tr("Save Session"), "", tr("Session(*.session)"));
+	if (dir.isEmpty())	return;
+	try
+	{
+		SessionFile::Save(TypeConversion::QString2String(dir), *_elements);
+	}
+	catch (std::string& error)
+	{
+		QMessageBox::about(this, tr("Save Session"), tr(error.c_str()));
+	}
+	UpdatePointCloudTable();
+}
+
 //****************************************************************
 //								Slots : Camera
 //****************************************************************
 void MainWindow::StartFlexxCameraSlot()
 {
+	if (_captureSession->IsRunning())
+	{
+		QMessageBox::about(this, tr("Start Camera"), tr("Multi camera is running!"));
+		return;
+	}
 	ISubject* subject = _subjectFactory->GetFlexxSubject();
 	_grabber = _grabberFactory->GetFlexxGrabber(subject);
 	_grabber->StartCamera();
@@ -381,6 +644,11 @@ void MainWindow::StartFlexxCameraSlot()
 
 void MainWindow::StartRSCameraSlot()
 {
+	if (_captureSession->IsRunning())
+	{
+		QMessageBox::about(this, tr("Start Camera"), tr("Multi camera is running!"));
+		return;
+	}
 	ISubject* subject = _subjectFactory->GetRSSubject();
 	_grabber = _grabberFactory->GetRSGrabber(subject);
 	_grabber->StartCamera();
@@ -388,16 +656,74 @@ void MainWindow::StartRSCameraSlot()
 
 void MainWindow::StartXtionProCameraSlot()
 {
+	if (_captureSession->IsRunning())
+	{
+		QMessageBox::about(this, tr("Start Camera"), tr("Multi camera is running!"));
+		return;
+	}
 	ISubject* subject = _subjectFactory->GetOpenNI2Subject();
 	_grabber = _grabberFactory->GetOpenNI2Grabber(subject);
 	_grabber->StartCamera();
 }
 
+//		Recorded frames go through the same observers as a live camera
+void MainWindow::StartReplaySlot()
+{
+	QString dir = QFileDialog::getOpenFileName(this, tr("Start Replay"), "", tr("Scan Log(*.scanlog);;OBJ(*.obj);;PLY(*.ply);;PCD(*.pcd)"));
+	if (dir.isEmpty())	return;
+	bool ok;
+	emit std::string str = ShowDialog(&ok, "Start Replay", "1x / 0.5x / fast / step");
+	if (!ok)	return;
+	if (_grabber != NULL)
+		_grabber->StopCamera();
+	_grabber = NULL;
+	ReplayGrabber* replay = _grabberFactory->GetReplayGrabber(_subjectFactory->GetReplaySubject());
+	try
+	{
+		replay->StopCamera();
+		replay->SetSource(TypeConversion::QString2String(dir));
+		if (str == "fast")
+			replay->SetMode(ReplayMode::AsFastAsPossible);
+		else if (str == "step")
+			replay->SetMode(ReplayMode::Stepped);
+		else
+		{
+			replay->SetMode(ReplayMode::RealTime);
+			if (str.size() > 1 && str[str.size() - 1] == 'x')
+			{
+				double speed = TypeConversion::String2Double(str.substr(0, str.size() - 1));
+				if (speed > 0)	replay->SetSpeed(speed);
+			}
+		}
+		replay->StartCamera();
+	}
+	catch (std::string& error)
+	{
+		QMessageBox::about(this, tr("Start Replay"), tr(error.c_str()));
+		return;
+	}
+	_grabber = replay;
+}
+
+//		Pauses a running replay and publishes its next frame
+void MainWindow::StepReplaySlot()
+{
+	ReplayGrabber* replay = _grabberFactory->GetReplayGrabber();
+	if (replay == NULL || _grabber != replay)
+	{
+		QMessageBox::about(this, tr("Step Replay"), tr("Replay is not running!"));
+		return;
+	}
+	replay->SetMode(ReplayMode::Stepped);
+	replay->Step();
+}
+
 void MainWindow::StopCameraSlot()
 {
 	if (_grabber == NULL)	return;
 	_grabber->StopCamera();
-	_viewer->Clear();
+	//		The live frame, the elements stay as they are
+	_viewer->DeletePointCloud("");
 	UpdatePointCloudTable();
 	UpdatePointCloudViewer();
 	_grabber = NULL;
@@ -412,6 +738,122 @@ void MainWindow::SetCameraDepthConfidenceSlot()
 	_grabber->SetDepthConfidence(TypeConversion::String2Int(str));
 }
 
+//		The whole string must be a positive number, String2Double would accept "15 fps" or "3abc"
+static bool ParsePositive(const std::string& str, double& value)
+{
+	char* end = NULL;
+	value = std::strtod(str.c_str(), &end);
+	return !str.empty() && *end == '\0' && std::isfinite(value) && value > 0;
+}
+
+void MainWindow::SetCaptureRateSlot()
+{
+	if (_grabber == NULL)
+	{
+		QMessageBox::about(this, tr("Set Capture Rate"), tr("Grabber is not open!"));
+		return;
+	}
+	bool ok;
+	emit std::string str = ShowDialog(&ok, "Set Capture Rate", "15fps / 0.3s / 1/3 / 0 (unlimited)");
+	if (!ok)	return;
+	CaptureGovernor& governor = _grabber->GetCaptureGovernor();
+	double value;
+	if (str == "0")
+		governor.SetUnlimited();
+	else if (str.size() > 3 && str.substr(str.size() - 3) == "fps" && ParsePositive(str.substr(0, str.size() - 3), value))
+		governor.SetTargetFps(value);
+	else if (str.size() > 1 && str[str.size() - 1] == 's' && ParsePositive(str.substr(0, str.size() - 1), value))
+		governor.SetTimePitch(value);
+	else if (str.size() > 2 && str.substr(0, 2) == "1/" && ParsePositive(str.substr(2), value) && value == std::floor(value) && value <= UINT_MAX)
+		governor.SetKeepEveryNth((unsigned int)value);
+	else
+		QMessageBox::about(this, tr("Set Capture Rate"), tr("Capture rate must be like 15fps, 0.3s, 1/3 or 0 (unlimited)!"));
+}
+
+void MainWindow::LiveOutlierRemovalSlot()
+{
+	if (TypeConversion::QString2String(_ui->_liveOutlierRemovalAction->text()) == "Live Outlier Removal")
+	{
+		_isLiveOutlierRemoval = true;
+		_ui->_liveOutlierRemovalAction->setText(QString("Stop Outlier Removal"));
+	}
+	else
+	{
+		_isLiveOutlierRemoval = false;
+		_ui->_liveOutlierRemovalAction->setText(QString("Live Outlier Removal"));
+	}
+}
+
+//		Every camera that opens is started at once, their frames are paired into frame sets by stamp
+void MainWindow::StartMultiCameraSlot()
+{
+	if (TypeConversion::QString2String(_ui->_startMultiCameraAction->text()) == "Start Multi Camera")
+	{
+		if (_grabber != NULL)
+		{
+			QMessageBox::about(this, tr("Start Multi Camera"), tr("Stop the camera first!"));
+			return;
+		}
+		_captureSession->RemoveAllDevices();
+		ISubject* subjects[] = { _subjectFactory->GetFlexxSubject(), _subjectFactory->GetRSSubject(), _subjectFactory->GetOpenNI2Subject() };
+		const char* names[] = { "flexx", "rs", "xtion" };
+		std::string errors;
+		for (int counter = 0; counter < 3; counter++)
+		{
+			try
+			{
+				IGrabber* grabber = NULL;
+				if (counter == 0)
+					grabber = _grabberFactory->GetFlexxGrabber(subjects[counter]);
+				else if (counter == 1)
+					grabber = _grabberFactory->GetRSGrabber(subjects[counter]);
+				else
+					grabber = _grabberFactory->GetOpenNI2Grabber(subjects[counter]);
+				_captureSession->AddDevice(names[counter], grabber, subjects[counter]);
+			}
+			catch (std::string& error)
+			{
+				errors += error + std::string("\n");
+			}
+			catch (std::exception& error)
+			{
+				errors += names[counter] + std::string(": ") + error.what() + std::string("\n");
+			}
+		}
+		if (_captureSession->GetNumberOfDevices() < 2)
+		{
+			_captureSession->RemoveAllDevices();
+			QMessageBox::about(this, tr("Start Multi Camera"), tr((std::string("Two cameras are needed!\n") + errors).c_str()));
+			return;
+		}
+		try
+		{
+			_captureSession->Start();
+		}
+		catch (std::string& error)
+		{
+			_captureSession->RemoveAllDevices();
+			QMessageBox::about(this, tr("Start Multi Camera"), tr(error.c_str()));
+			return;
+		}
+		_ui->_startMultiCameraAction->setText(QString("Stop Multi Camera"));
+	}
+	else
+	{
+		CaptureSessionStats stats = _captureSession->GetStats();
+		for (int counter = 0; counter < _captureSession->GetNumberOfDevices(); counter++)
+			_viewer->DeletePointCloud(std::string("live_") + _captureSession->GetDeviceName(counter));
+		_captureSession->RemoveAllDevices();
+		_tmpFrameSet.frames.clear();
+		UpdatePointCloudViewer();
+		std::string message = TypeConversion::Int2String((int)stats.sets) + std::string(" frame sets, ") +
+			TypeConversion::Int2String((int)stats.unmatchedFrames) + std::string(" unmatched frames, max skew ") +
+			TypeConversion::Int2String((int)(stats.maxSkew / 1000)) + std::string(" ms");
+		QMessageBox::about(this, tr("Stop Multi Camera"), tr(message.c_str()));
+		_ui->_startMultiCameraAction->setText(QString("Start Multi Camera"));
+	}
+}
+
 //****************************************************************
 //								Slots : Arduino
 //****************************************************************
@@ -468,6 +910,8 @@ void MainWindow::ControlMotorSlot()
 	QMessageBox::about(this, tr("Control Motor"), tr(recMotorId));
 	char* recDegree = _arduino->ReceiveData(degreeLen);
 	QMessageBox::about(this, tr("Control Motor"), tr(recDegree));
+	_turntableAngle += (float)TypeConversion::String2Double(degree);
+	_recorderObserver->SetTurntableAngle(_turntableAngle);
 }
 
 //****************************************************************
@@ -476,6 +920,11 @@ void MainWindow::ControlMotorSlot()
 void MainWindow::KeepOneFrameSlot()
 {
 	_keepFrameNumber = 0;
+	if (_captureSession->IsRunning())
+	{
+		KeepFrameSet();
+		return;
+	}
 	if (_grabber == NULL)
 	{
 		QMessageBox::about(this, tr("Keep One Frame"), tr("Grabber is not open!"));
@@ -497,6 +946,38 @@ void MainWindow::KeepOneFrameSlot()
 	UpdatePointCloudViewer();
 }
 
+//		One element per device from the shown frame set, named <name>_<device>
+void MainWindow::KeepFrameSet()
+{
+	FrameSet frameSet = _tmpFrameSet;
+	if (frameSet.frames.empty())
+	{
+		QMessageBox::about(this, tr("Keep One Frame"), tr("No frame set yet!"));
+		return;
+	}
+	bool ok;
+	emit std::string cloudName = ShowDialog(&ok, "Keep PointCloud", "Cloud Name");
+	if (!ok)	return;
+	std::vector<std::string> names;
+	for (std::size_t counter = 0; counter < frameSet.frames.size(); counter++)
+	{
+		names.push_back(cloudName + std::string("_") + _captureSession->GetDeviceName((int)counter));
+		if (_elements->IsNameExist(names[counter]) || cloudName == "")
+		{
+			QMessageBox::about(this, tr("Keep PointCloud"), tr("Name is exist/empty!"));
+			return;
+		}
+	}
+	for (std::size_t counter = 0; counter < frameSet.frames.size(); counter++)
+	{
+		//		Copied, the frames may still be the grabbers' pool buffers
+		pcl::PointCloud<PointT>::Ptr copyCloud(new pcl::PointCloud<PointT>(*frameSet.frames[counter]));
+		_elements->AddPointCloudElement(new MyPointCloud(copyCloud, names[counter]));
+	}
+	UpdatePointCloudTable();
+	UpdatePointCloudViewer();
+}
+
 void MainWindow::KeepContinueFrameSlot()
 {
 	if (_grabber == NULL)
@@ -509,34 +990,64 @@ void MainWindow::KeepContinueFrameSlot()
 		bool ok;
 		emit _keepCloudName = ShowDialog(&ok, "Keep PointCloud", "Cloud Name");
 		if (!ok)	return;
-		connect(this->_uiObserver, SIGNAL(KeepFrameArrived(pcl::PointCloud<PointT>::Ptr)), this, SLOT(KeepFrameArrivedSlot(pcl::PointCloud<PointT>::Ptr)));
+		_uiObserver->StartKeeping(&_keepFrameGovernor);
 		_ui->_keepContinueFrameAction->setText(QString("Stop"));
 	}
 	else if (TypeConversion::QString2String(_ui->_keepContinueFrameAction->text()) == "Stop")
 	{
-		disconnect(this->_uiObserver, SIGNAL(KeepFrameArrived(pcl::PointCloud<PointT>::Ptr)), this, SLOT(KeepFrameArrivedSlot(pcl::PointCloud<PointT>::Ptr)));
+		_uiObserver->StopKeeping();
 		_ui->_keepContinueFrameAction->setText(QString("Continue Frame"));
 	}
 }
 
-void MainWindow::KeepFrameArrivedSlot(pcl::PointCloud<PointT>::Ptr pointCloud)
+//		Frames go to disk on the recorder's own thread instead of into the elements
+void MainWindow::RecordScanSlot()
 {
-	clock_t nowFrameTime = clock();
-	if ((double)(nowFrameTime - _preFrameTime) / (double)(CLOCKS_PER_SEC) <= FRAME_PITCH)
-		return;
-	std::string cloudName = _keepCloudName + std::string("_") + TypeConversion::Int2String(_keepFrameNumber);
-	if (_isTestedKinfuBoundingBox)
+	if (TypeConversion::QString2String(_ui->_recordScanAction->text()) == "Record Scan")
 	{
-		_filterProcessing->Processing(pointCloud);
-		pointCloud = _filterProcessing->GetResult();
+		if (_grabber == NULL)
+		{
+			QMessageBox::about(this, tr("Record Scan"), tr("Grabber is not open!"));
+			return;
+		}
+		QString dir = QFileDialog::getSaveFileName(this, tr("Record Scan"), "", tr("Scan Log(*.scanlog)"));
+		if (dir.isEmpty())	return;
+		try
+		{
+			_recorderObserver->StartRecording(TypeConversion::QString2String(dir));
+		}
+		catch (std::string& error)
+		{
+			QMessageBox::about(this, tr("Record Scan"), tr(error.c_str()));
+			return;
+		}
+		_recordDroppedFrames = GetRecorderDroppedFrames();
+		_ui->_recordScanAction->setText(QString("Stop Recording"));
 	}
+	else
+	{
+		ScanLogStats stats = _recorderObserver->StopRecording();
+		unsigned long long dropped = GetRecorderDroppedFrames() - _recordDroppedFrames;
+		std::string message = TypeConversion::Int2String((int)stats.frames) + std::string(" frames, ") +
+			TypeConversion::Int2String((int)(stats.writtenBytes >> 20)) + std::string(" MB, ") +
+			TypeConversion::Int2String((int)dropped) + std::string(" dropped");
+		if (!_recorderObserver->GetError().empty())
+			message += std::string("\n") + _recorderObserver->GetError();
+		QMessageBox::about(this, tr("Record Scan"), tr(message.c_str()));
+		_ui->_recordScanAction->setText(QString("Record Scan"));
+	}
+}
+
+//		The keep governor was already checked by the observer
+void MainWindow::KeepFrameArrivedSlot(pcl::PointCloud<PointT>::Ptr pointCloud)
+{
+	std::string cloudName = _keepCloudName + std::string("_") + TypeConversion::Int2String(_keepFrameNumber);
+	pointCloud = FilterLiveFrame(pointCloud);
 	MyPointCloud* cloud = new MyPointCloud(pointCloud, cloudName);
 	_elements->AddPointCloudElement(cloud);
 	_viewer->ShowPointCloud(pointCloud);
 	_ui->_qvtkWidget->update();
-	UpdatePointCloudTable();
 	_keepFrameNumber++;
-	_preFrameTime = nowFrameTime;
 }
 
 void MainWindow::RemoveSelectedPointCloudSlot()
@@ -581,7 +1092,7 @@ void MainWindow::CombinePointCloudSlot()
 		*combinedCloud += *clouds[counter]->GetPointCloud();
 	}
 	std::string name = std::string("Combine");
-	MyPointCloud* cloud = new MyPointCloud(combinedCloud, name);
+	MyPointCloud* cloud = new MyPointCloud(SharedPointCloud::Adopt(combinedCloud), name);
 	_elements->AddPointCloudElement(cloud);
 	UpdatePointCloudTable();
 }
@@ -592,16 +1103,10 @@ void MainWindow::GetMinNegativeNumberSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>(*clouds[counter]->GetPointCloud()));
-		for (int pointCounter = 0; pointCounter < temp->size(); pointCounter++)
-		{
-			if (temp->points[pointCounter].x < min)
-				min = temp->points[pointCounter].x;
-			if (temp->points[pointCounter].y < min)
-				min = temp->points[pointCounter].y;
-			if (temp->points[pointCounter].z < min)
-				min = temp->points[pointCounter].z;
-		}
+		Eigen::Vector3f minPoint;
+		Eigen::Vector3f maxPoint;
+		if (TransformKernels::GetMinMax(*clouds[counter]->GetPointCloud(), minPoint, maxPoint))
+			min = std::min(min, (double)minPoint.minCoeff());
 	}
 	QMessageBox::about(this, tr("Min Negative Number"), tr(TypeConversion::Double2String(std::abs(min)).c_str()));
 }
@@ -614,15 +1119,11 @@ void MainWindow::MultiplicationPointCloudSlot()
 	double magnificationZ = TypeConversion::QString2Double(_ui->_multiplicationZSpinBox->text());
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>(*clouds[counter]->GetPointCloud()));
-		for (int pointIndex = 0; pointIndex < temp->points.size(); pointIndex++)
-		{
-			temp->points[pointIndex].x *= magnificationX;
-			temp->points[pointIndex].y *= magnificationY;
-			temp->points[pointIndex].z *= magnificationZ;
-		}
+		//		Shares the source buffer, Write() detaches the one copy that gets scaled
+		SharedPointCloud derived = SharedPointCloud::Adopt(clouds[counter]->GetPointCloud());
+		TransformKernels::Scale(*derived.Write(), magnificationX, magnificationY, magnificationZ);
 		std::string name = clouds[counter]->GetName() + std::string("_Magnification");
-		MyPointCloud* cloud = new MyPointCloud(temp, name);
+		MyPointCloud* cloud = new MyPointCloud(derived, name);
 		_elements->AddPointCloudElement(cloud);
 	}
 	UpdatePointCloudTable();
@@ -636,15 +1137,10 @@ void MainWindow::ShiftPointCloudSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>(*clouds[counter]->GetPointCloud()));
-		for (int pointCounter = 0; pointCounter < temp->size(); pointCounter++)
-		{
-			temp->points[pointCounter].x += shiftX;
-			temp->points[pointCounter].y += shiftY;
-			temp->points[pointCounter].z += shiftZ;
-		}
+		SharedPointCloud derived = SharedPointCloud::Adopt(clouds[counter]->GetPointCloud());
+		TransformKernels::Translate(*derived.Write(), shiftX, shiftY, shiftZ);
 		std::string name = clouds[counter]->GetName() + std::string("_Shift");
-		MyPointCloud* cloud = new MyPointCloud(temp, name);
+		MyPointCloud* cloud = new MyPointCloud(derived, name);
 		_elements->AddPointCloudElement(cloud);
 	}
 	UpdatePointCloudTable();
@@ -655,11 +1151,21 @@ void MainWindow::RemoveNANSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>());
-		std::vector<int> map;
-		pcl::removeNaNFromPointCloud(*clouds[counter]->GetPointCloud(), *temp, map);
+		pcl::PointCloud<PointT>::Ptr source = clouds[counter]->GetPointCloud();
+		bool hasNaN = false;
+		for (int pointCounter = 0; pointCounter < source->size() && !hasNaN; pointCounter++)
+			hasNaN = !pcl::isFinite(source->points[pointCounter]);
+		//		Nothing to remove : share the source buffer instead of copying it
+		SharedPointCloud derived = SharedPointCloud::Adopt(source);
+		if (hasNaN)
+		{
+			pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>());
+			std::vector<int> map;
+			pcl::removeNaNFromPointCloud(*source, *temp, map);
+			derived = SharedPointCloud::Adopt(temp);
+		}
 		std::string name = clouds[counter]->GetName() + std::string("_NAN");
-		MyPointCloud* cloud = new MyPointCloud(temp, name);
+		MyPointCloud* cloud = new MyPointCloud(derived, name);
 		_elements->AddPointCloudElement(cloud);
 	}
 	UpdatePointCloudTable();
@@ -677,29 +1183,38 @@ void MainWindow::ProcessICP1Slot()
 		QMessageBox::about(this, tr("Process ICP"), tr("Selecct More Than Two Point Cloud!"));
 		return;
 	}
-	std::vector<Eigen::Matrix4f> matrices;
-	for (int counter = 1; counter < clouds.size(); counter++)
+	std::vector<pcl::PointCloud<PointT>::Ptr> views;
+	for (int counter = 0; counter < clouds.size(); counter++)
+		views.push_back(clouds[counter]->GetPointCloud());
+	boost::shared_ptr<RegestrationProcessing> regestration(_regestrationProcessing->Clone());
+	_jobQueue->Submit("ICP_1", [regestration, views](JobToken& token)
 	{
-		pcl::PointCloud<PointT>::Ptr corSource = clouds[counter - 1]->GetPointCloud();
-		pcl::PointCloud<PointT>::Ptr corTarget = clouds[counter]->GetPointCloud();
-		_regestrationProcessing->Processing(corSource, corTarget);
-		matrices.push_back(_regestrationProcessing->GetMatrix().inverse());
-		std::cout << "Process ICP : " << counter + 1 << " / " << clouds.size() << std::endl;
-		std::cout << "Has Converged : " << _regestrationProcessing->HasConverged() << std::endl;
-	}
-	//pcl::PointCloud<PointT>::Ptr result(new pcl::PointCloud<PointT>(*clouds[0]->GetPointCloud()));
-	Eigen::Matrix4f globalTransform = Eigen::Matrix4f::Identity();
-	for (int counter = 0; counter < matrices.size(); counter++)
-	{
-		pcl::PointCloud<PointT>::Ptr temp(new pcl::PointCloud<PointT>);
-		globalTransform *= matrices[counter];
-		pcl::transformPointCloud(*clouds[counter + 1]->GetPointCloud(), *temp, globalTransform);
-		//*result += *temp;
-		std::string name = std::string("ICP_1_Transform_") + TypeConversion::Int2String(counter);
-		MyPointCloud* cloud = new MyPointCloud(temp, name);
-		_elements->AddPointCloudElement(cloud);
-	}
-	UpdatePointCloudTable();
+		std::vector<PointCloudElement*> results;
+		std::vector<Eigen::Matrix4f> matrices;
+		for (int counter = 1; counter < views.size(); counter++)
+		{
+			if (token.IsCancelled())
+				return results;
+			regestration->Processing(views[counter - 1], views[counter]);
+			matrices.push_back(regestration->GetMatrix().inverse());
+			token.SetProgress((float)counter / (views.size() - 1));
+			std::cout << "Process ICP : " << counter + 1 << " / " << views.size() << std::endl;
+			std::cout << "Has Converged : " << regestration->HasConverged() << std::endl;
+		}
+		Eigen::Matrix4f globalTransform = Eigen::Matrix4f::Identity();
+		for (int counter = 0; counter < matrices.size(); counter++)
+		{
+			globalTransform *= matrices[counter];
+			SharedPointCloud derived = SharedPointCloud::Adopt(views[counter + 1]);
+			TransformKernels::Transform(*derived.Write(), globalTransform);
+			std::string name = std::string("ICP_1_Transform_") + TypeConversion::Int2String(counter);
+			MyPointCloud* result = new MyPointCloud(derived, name);
+			result->SetTransform(globalTransform);
+			results.push_back(result);
+		}
+		return results;
+	});
+	UpdateJobStatus();
 }
 
 void MainWindow::ProcessICP2Slot()
@@ -710,18 +1225,29 @@ void MainWindow::ProcessICP2Slot()
 		QMessageBox::about(this, tr("Process ICP"), tr("Selecct More Than Two Point Cloud!"));
 		return;
 	}
-	pcl::PointCloud<PointT>::Ptr result(new pcl::PointCloud<PointT>(*clouds[0]->GetPointCloud()));
-	for (int counter = 1; counter < clouds.size(); counter++)
+	std::vector<pcl::PointCloud<PointT>::Ptr> views;
+	for (int counter = 0; counter < clouds.size(); counter++)
+		views.push_back(clouds[counter]->GetPointCloud());
+	boost::shared_ptr<RegestrationProcessing> regestration(_regestrationProcessing->Clone());
+	_jobQueue->Submit("ICP_2", [regestration, views](JobToken& token)
 	{
-		_regestrationProcessing->Processing(result, clouds[counter]->GetPointCloud());
-		result.reset(new pcl::PointCloud<PointT>(*_regestrationProcessing->GetResult()));
-		std::cout << "Process ICP : " << counter + 1 << " / " << clouds.size() << std::endl;
-		std::cout << "Has Converged : " << _regestrationProcessing->HasConverged() << std::endl;
-		std::string name = std::string("ICP_2_Result_") + TypeConversion::Int2String(counter);
-		MyPointCloud* cloud = new MyPointCloud(result, name);
-		_elements->AddPointCloudElement(cloud);
-	}
-	UpdatePointCloudTable();
+		std::vector<PointCloudElement*> results;
+		pcl::PointCloud<PointT>::Ptr result = views[0];
+		for (int counter = 1; counter < views.size(); counter++)
+		{
+			if (token.IsCancelled())
+				return results;
+			regestration->Processing(result, views[counter]);
+			result.reset(new pcl::PointCloud<PointT>(*regestration->GetResult()));
+			token.SetProgress((float)counter / (views.size() - 1));
+			std::cout << "Process ICP : " << counter + 1 << " / " << views.size() << std::endl;
+			std::cout << "Has Converged : " << regestration->HasConverged() << std::endl;
+			std::string name = std::string("ICP_2_Result_") + TypeConversion::Int2String(counter);
+			results.push_back(new MyPointCloud(SharedPointCloud::Adopt(result), name));
+		}
+		return results;
+	});
+	UpdateJobStatus();
 }
 
 void MainWindow::ProcessICP3Slot()
@@ -766,6 +1292,46 @@ void MainWindow::ProcessICP3Slot()
 	UpdatePointCloudTable();
 }
 
+void MainWindow::ProcessPoseGraphSlot()
+{
+	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
+	if (clouds.size() < 2)
+	{
+		QMessageBox::about(this, tr("Process ICP"), tr("Selecct More Than Two Point Cloud!"));
+		return;
+	}
+	//		Selected views in turntable order, the last one closes the loop to the first
+	std::vector<pcl::PointCloud<PointT>::Ptr> views;
+	for (int counter = 0; counter < clouds.size(); counter++)
+		views.push_back(clouds[counter]->GetPointCloud());
+	boost::shared_ptr<PoseGraphRegestration> poseGraph(new PoseGraphRegestration(*_poseGraphRegestration));
+	_jobQueue->Submit("PoseGraph", [poseGraph, views](JobToken& token)
+	{
+		std::vector<PointCloudElement*> results;
+		poseGraph->Processing(views);
+		std::vector<PoseGraphEdge> edges = poseGraph->GetEdges();
+		for (int counter = 0; counter < edges.size(); counter++)
+		{
+			if (!edges[counter].hasConverged)
+				std::cout << "Edge " << edges[counter].from << " -> " << edges[counter].to << " has not converged" << std::endl;
+		}
+		std::cout << "Process Pose Graph : " << edges.size() << " edges, error " << poseGraph->GetError() << std::endl;
+		std::vector<Eigen::Matrix4f> poses = poseGraph->GetPoses();
+		for (int counter = 0; counter < poses.size(); counter++)
+		{
+			SharedPointCloud derived = SharedPointCloud::Adopt(views[counter]);
+			if (!poses[counter].isIdentity())
+				TransformKernels::Transform(*derived.Write(), poses[counter]);
+			std::string name = std::string("PoseGraph_Transform_") + TypeConversion::Int2String(counter);
+			MyPointCloud* result = new MyPointCloud(derived, name);
+			result->SetTransform(poses[counter]);
+			results.push_back(result);
+		}
+		return results;
+	});
+	UpdateJobStatus();
+}
+
 //****************************************************************
 //								Slots : Filter Processing
 //****************************************************************
@@ -773,7 +1339,10 @@ void MainWindow::ChangeFilterTabSlot(int index)
 {
 	if (index == 0)
 	{
-		_filterProcessing = _filterFactory->GetVoixelGridFilter();
+		if (_ui->_voxelGridHashCheckBox->isChecked())
+			_filterProcessing = _filterFactory->GetHashVoxelGridFilter();
+		else
+			_filterProcessing = _filterFactory->GetVoixelGridFilter();
 	}
 	else if (index == 1)
 	{
@@ -790,14 +1359,19 @@ void MainWindow::ProcessFilterSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		_filterProcessing->Processing(clouds[counter]->GetPointCloud());
+		//		One job and one filter per cloud, the selected clouds are filtered concurrently
+		boost::shared_ptr<FilterProcessing> filter(_filterProcessing->Clone());
+		pcl::PointCloud<PointT>::Ptr input = clouds[counter]->GetPointCloud();
 		std::string name = clouds[counter]->GetName() + std::string("_Filter");
-		MyPointCloud* cloud = new MyPointCloud(_filterProcessing->GetResult(), name);
-		_elements->AddPointCloudElement(cloud);
-		std::cout << "Process Filter : " << counter + 1 << " / " << clouds.size() << std::endl;
+		_jobQueue->Submit(name, [filter, input, name](JobToken& token)
+		{
+			std::vector<PointCloudElement*> results;
+			filter->Processing(input);
+			results.push_back(new MyPointCloud(SharedPointCloud::Adopt(filter->GetResult()), name));
+			return results;
+		});
 	}
-	UpdatePointCloudTable();
-	UpdatePointCloudViewer();
+	UpdateJobStatus();
 }
 
 void MainWindow::SetFilterVoxelGridXYZSlot()
@@ -808,6 +1382,20 @@ void MainWindow::SetFilterVoxelGridXYZSlot()
 	_filterProcessing->SetLeafSize(x, y, z);
 }
 
+void MainWindow::SetFilterVoxelGridHashSlot(bool isHash)
+{
+	//		Both voxel grid filters keep their own parameters, the new one gets the spin boxes' values
+	_ui->_voxelGridKeepOrganizedCheckBox->setEnabled(isHash);
+	ChangeFilterTabSlot(0);
+	SetFilterVoxelGridXYZSlot();
+	SetFilterKeepOrganizedSlot(_ui->_voxelGridKeepOrganizedCheckBox->isChecked());
+}
+
+void MainWindow::SetFilterKeepOrganizedSlot(bool isKeepOrganized)
+{
+	_filterProcessing->SetKeepOrganized(isKeepOrganized);
+}
+
 void MainWindow::SetFilterBoundingBoxSlot()
 {
 	float minX = TypeConversion::QString2Float(_ui->_boundingBoxMinXSpinBox->text());
@@ -859,20 +1447,21 @@ void MainWindow::GetDialogResultSlot(float minX, float maxX, float minY, float m
 //****************************************************************
 void MainWindow::ProcessKeypointSlot()
 {
-	//		default
-	int r = 255;
-	int g = 0;
-	int b = 0;
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		_keypointProcessing->Processing(clouds[counter]->GetPointCloud());
+		boost::shared_ptr<KeypointProcessing> keypoint(_keypointProcessing->Clone());
+		pcl::PointCloud<PointT>::Ptr input = clouds[counter]->GetPointCloud();
 		std::string name = clouds[counter]->GetName() + std::string("_Keypoint");
-		MyKeyPoint* cloud = new MyKeyPoint(_keypointProcessing->GetResult(), name);
-		_elements->AddPointCloudElement(cloud);
+		_jobQueue->Submit(name, [keypoint, input, name](JobToken& token)
+		{
+			std::vector<PointCloudElement*> results;
+			keypoint->Processing(input);
+			results.push_back(new MyKeyPoint(keypoint->GetResult(), name));
+			return results;
+		});
 	}
-	UpdatePointCloudTable();
-	UpdatePointCloudViewer();
+	UpdateJobStatus();
 }
 
 void MainWindow::ChangeKeypointTabSlot(int index)
@@ -1023,42 +1612,47 @@ void MainWindow::SetCorrespondenceDescriptorKSearchSpinBoxSlot(int kSearch)
 void MainWindow::ProcessRegestrationSlot()
 {
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
-	pcl::PointCloud<PointT>::Ptr sourceCloud = clouds[0]->GetPointCloud();
-	pcl::PointCloud<PointT>::Ptr targetCloud = clouds[1]->GetPointCloud();
 	if (clouds.size() != 2)
 	{
 		QMessageBox::about(this, tr("Process Regestration"), tr("Selecct Two Point Cloud!"));
 		return;
 	}
-	else
+	pcl::PointCloud<PointT>::Ptr sourceCloud = clouds[0]->GetPointCloud();
+	pcl::PointCloud<PointT>::Ptr targetCloud = clouds[1]->GetPointCloud();
+	boost::shared_ptr<RegestrationProcessing> regestration(_regestrationProcessing->Clone());
+	std::string name = clouds[0]->GetName() + "_" + clouds[1]->GetName() + std::string("_Regestration");
+	_jobQueue->Submit(name, [regestration, sourceCloud, targetCloud, name](JobToken& token)
 	{
-		_regestrationProcessing->Processing(sourceCloud, targetCloud);
-		std::string name = clouds[0]->GetName() + "_" + clouds[1]->GetName() + std::string("_Regestration");
-		MyPointCloud* cloud = new MyPointCloud(_regestrationProcessing->GetResult(), name);
-		_elements->AddPointCloudElement(cloud);
-	}
-	UpdatePointCloudTable();
-	UpdatePointCloudViewer();
+		std::vector<PointCloudElement*> results;
+		regestration->Processing(sourceCloud, targetCloud);
+		results.push_back(new MyPointCloud(SharedPointCloud::Adopt(regestration->GetResult()), name));
+		return results;
+	});
+	UpdateJobStatus();
 }
 
 void MainWindow::SetRegestrationCorrespondenceDistanceSlot(double correspondenceDistance)
 {
 	_regestrationProcessing->SetCorrespondenceDistance(correspondenceDistance);
+	_poseGraphRegestration->SetCorrespondenceDistance(correspondenceDistance);
 }
 
 void MainWindow::SetRegestrationOutlierThresholdSlot(double outlierThreshold)
 {
 	_regestrationProcessing->SetRansacOutlierRejectionThreshold(outlierThreshold);
+	_poseGraphRegestration->SetRansacOutlierRejectionThreshold(outlierThreshold);
 }
 
 void MainWindow::SetEuclideanFitnessEpsilonSlot(double euclideanFitnessEpsilon)
 {
 	_regestrationProcessing->SetEuclideanFitnessEpsilon(euclideanFitnessEpsilon);
+	_poseGraphRegestration->SetEuclideanFitnessEpsilon(euclideanFitnessEpsilon);
 }
 
 void MainWindow::SetRegestrationMaxIterationsSlot(int maxIterations)
 {
 	_regestrationProcessing->SetMaximumIterations(maxIterations);
+	_poseGraphRegestration->SetMaximumIterations(maxIterations);
 }
 
 //****************************************************************
@@ -1086,21 +1680,21 @@ void MainWindow::ProcessReconstructSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		_reconstructProcessing->Processing(clouds[counter]->GetPointCloud());
-		std::string name = clouds[0]->GetName() + "_" + std::string("_Reconstruct");
-		if (index == 0 || index == 1)
+		boost::shared_ptr<ReconstructProcessing> reconstruct(_reconstructProcessing->Clone());
+		pcl::PointCloud<PointT>::Ptr input = clouds[counter]->GetPointCloud();
+		std::string name = clouds[counter]->GetName() + "_" + std::string("_Reconstruct");
+		_jobQueue->Submit(name, [reconstruct, input, name, index](JobToken& token)
 		{
-			MySurface* surface = new MySurface(_reconstructProcessing->GetMesh(), name);
-			_elements->AddPointCloudElement(surface);
-		}
-		else
-		{
-			MyPointCloud* cloud = new MyPointCloud(_reconstructProcessing->GetCloud(), name);
-			_elements->AddPointCloudElement(cloud);
-		}
+			std::vector<PointCloudElement*> results;
+			reconstruct->Processing(input);
+			if (index == 0 || index == 1)
+				results.push_back(new MySurface(reconstruct->GetMesh(), name));
+			else
+				results.push_back(new MyPointCloud(SharedPointCloud::Adopt(reconstruct->GetCloud()), name));
+			return results;
+		});
 	}
-	UpdatePointCloudTable();
-	UpdatePointCloudViewer();
+	UpdateJobStatus();
 }
 
 void MainWindow::SetReconstructSearchRadiusSlot(double searchRadius)
@@ -1172,23 +1766,27 @@ void MainWindow::ProcessSmoothingSlot()
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
-		if (index == 0)
-		{
-			_smoothingProcessing->Processing(clouds[counter]->GetMesh());
-			std::string name = clouds[0]->GetName() + "_" + std::string("_Smoothing");
-			MySurface* surface = new MySurface(_smoothingProcessing->GetMesh(), name);
-			_elements->AddPointCloudElement(surface);
-		}
-		else
+		boost::shared_ptr<SmoothingProcessing> smoothing(_smoothingProcessing->Clone());
+		pcl::PolygonMeshPtr mesh = clouds[counter]->GetMesh();
+		pcl::PointCloud<PointT>::Ptr input = clouds[counter]->GetPointCloud();
+		std::string name = clouds[counter]->GetName() + "_" + std::string("_Smoothing");
+		_jobQueue->Submit(name, [smoothing, mesh, input, name, index](JobToken& token)
 		{
-			_smoothingProcessing->Processing(clouds[counter]->GetPointCloud());
-			std::string name = clouds[0]->GetName() + "_" + std::string("_Smoothing");
-			MyPointCloud* cloud = new MyPointCloud(_smoothingProcessing->GetCloud(), name);
-			_elements->AddPointCloudElement(cloud);
-		}
+			std::vector<PointCloudElement*> results;
+			if (index == 0)
+			{
+				smoothing->Processing(mesh);
+				results.push_back(new MySurface(smoothing->GetMesh(), name));
+			}
+			else
+			{
+				smoothing->Processing(input);
+				results.push_back(new MyPointCloud(SharedPointCloud::Adopt(smoothing->GetCloud()), name));
+			}
+			return results;
+		});
 	}
-	UpdatePointCloudTable();
-	UpdatePointCloudViewer();
+	UpdateJobStatus();
 }
 
 void MainWindow::ChangeSmoothingTabSlot(int index)
@@ -1228,6 +1826,58 @@ void MainWindow::SetSmoothingSearchRadiusSlot(double searchRadius)
 	_smoothingProcessing->SetSearchRadius(searchRadius);
 }
 
+//****************************************************************
+//								Slots : Jobs
+//****************************************************************
+void MainWindow::JobFinishedSlot(int id)
+{
+	JobStatus status = _jobQueue->GetStatus(id);
+	std::vector<PointCloudElement*> results = _jobQueue->TakeResults(id);
+	for (int counter = 0; counter < results.size(); counter++)
+		_elements->AddPointCloudElement(results[counter]);
+	if (status.state == JobState::Failed)
+		QMessageBox::about(this, tr("Process Job"), tr((status.name + " : " + status.error).c_str()));
+	else if (status.state == JobState::Cancelled)
+		std::cout << "Job Cancelled : " << status.name << std::endl;
+	if (!results.empty())
+	{
+		UpdatePointCloudTable();
+		UpdatePointCloudViewer();
+	}
+	UpdateJobStatus();
+}
+
+void MainWindow::JobProgressSlot(int id, float progress)
+{
+	UpdateJobStatus();
+}
+
+void MainWindow::CancelJobsSlot()
+{
+	_jobQueue->CancelAll();
+	UpdateJobStatus();
+}
+
+void MainWindow::UpdateJobStatus()
+{
+	std::vector<JobStatus> jobs = _jobQueue->GetActiveJobs();
+	if (jobs.empty())
+	{
+		_ui->statusBar->clearMessage();
+		return;
+	}
+	std::string message = std::string("Jobs : ") + TypeConversion::Int2String(jobs.size());
+	for (int counter = 0; counter < jobs.size(); counter++)
+	{
+		message += std::string("   ") + jobs[counter].name;
+		if (jobs[counter].state == JobState::Queued)
+			message += std::string(" (Queued)");
+		else
+			message += std::string(" ") + TypeConversion::Int2String(jobs[counter].progress * 100) + std::string("%");
+	}
+	_ui->statusBar->showMessage(QString::fromStdString(message));
+}
+
 //****************************************************************
 //								Slots : Kinfu
 //****************************************************************
@@ -1238,7 +1888,7 @@ void MainWindow::ProcessSegmentedKinfuCloudSlot()
 	float volumeSize = 1.f;
 	int icp = 1, visualization = 0;
 	boost::shared_ptr<CameraPoseProcessor> poseProcessor;
-	KinFuApp kinfu(volumeSize, icp, visualization, poseProcessor);
+	KinFuBackend kinfu(volumeSize, icp, visualization, poseProcessor);
 	//kinfu.startMainLoop();
 	std::vector<PointCloudElement*> clouds = _elements->GetElementsByIsSelected();
 	if (clouds.size() == 0)return;
@@ -1269,7 +1919,7 @@ void MainWindow::ProcessSegmentedKinfuCloudSlot()
 	{
 		if (resetFrames[resetIndex] + 1 == resetFrames[resetIndex + 1])
 			continue;
-		KinFuApp kinfuSeg(volumeSize, icp, visualization, poseProcessor);
+		KinFuBackend kinfuSeg(volumeSize, icp, visualization, poseProcessor);
 		for (int segIndex = resetFrames[resetIndex] + 1; segIndex < resetFrames[resetIndex + 1]; segIndex++)
 		{
 			std::cout << "Process Kinfu : Frame number " << segIndex + 1 << std::endl;
@@ -1309,7 +1959,7 @@ void MainWindow::ProcessIgnoreResetKinfuCloudSlot()
 	std::vector<Eigen::Matrix<float, 3, 3, Eigen::RowMajor>> rs;
 	std::vector<Eigen::Vector3f> ts;
 	
-	KinFuApp kinfu(volumeSize, icp, visualization, poseProcessor);
+	KinFuBackend kinfu(volumeSize, icp, visualization, poseProcessor);
 	for (int counter = 0; counter < clouds.size(); counter++)
 	{
 		kinfu.source_cb3(clouds[counter]->GetPointCloud());
@@ -1338,8 +1988,8 @@ void MainWindow::ProcessIgnoreResetKinfuCloudSlot()
 				Eigen::Matrix4f globalRT = RTConversion::RT(globalR, globalT);
 				pcl::PointCloud<PointT>::Ptr source(new pcl::PointCloud<PointT>);
 				pcl::PointCloud<PointT>::Ptr target(new pcl::PointCloud<PointT>);
-				pcl::transformPointCloud(*clouds[counter - 1]->GetPointCloud(), *source, globalRT);
-				pcl::transformPointCloud(*clouds[counter]->GetPointCloud(), *target, globalRT);
+				TransformKernels::Transform(*clouds[counter - 1]->GetPointCloud(), *source, globalRT);
+				TransformKernels::Transform(*clouds[counter]->GetPointCloud(), *target, globalRT);
 				_regestrationProcessing->Processing(source, target);
 				Eigen::Matrix4f rt = _regestrationProcessing->GetMatrix();
 				Eigen::Matrix<float, 3, 3, Eigen::RowMajor> r;
@@ -1362,7 +2012,7 @@ void MainWindow::ProcessIgnoreResetKinfuCloudSlot()
 	SaveRTMatrix(rs, ts);
 	
 	std::cout << "---------------------------------------------------------" << std::endl;
-	KinFuApp kinfuRes(volumeSize, 0, visualization, poseProcessor);
+	KinFuBackend kinfuRes(volumeSize, 0, visualization, poseProcessor);
 	kinfuRes.SetRMatrix(rs);
 	kinfuRes.SetTVector(ts);
 	for (int counter = 0; counter < clouds.size(); counter++)
@@ -1416,9 +2066,8 @@ void MainWindow::GetKinfuTestBoundingBoxSlot()
 
 void MainWindow::ProcessKinfuTestBoundingBoxSlot()
 {
-	_filterProcessing = _filterFactory->GetDepthImageBoundingBoxFilter();
 	if (_dialog != NULL)	delete _dialog;
-	_dialog = new BoundingBoxTestDialog(_filterProcessing, 1);
+	_dialog = new BoundingBoxTestDialog(_filterFactory->GetDepthImageBoundingBoxFilter(), 1);
 	_dialog->SetScrollBarX(0, _tmpPointCloud->width, 1, 1);
 	_dialog->SetScrollBarY(0, _tmpPointCloud->height, 1, 1);
 	_dialog->SetScrollBarZ(-200, 200, 1, 100);
@@ -18,6 +18,8 @@ Q_DECLARE_METATYPE(pcl::PointCloud<PointT>::Ptr);
 #include<QInputDialog>
 #include <QSpinBox>
 #include <QCloseEvent>
+#include <QTimer>
+#include <set>
 
 #include <pcl/filters/filter.h>
 
@@ -26,8 +28,13 @@ Q_DECLARE_METATYPE(pcl::PointCloud<PointT>::Ptr);
 #include "ui/Viewer.h"
 #include "observer/ObserverFactory.h"
 #include "file/FileFactory.h"
+#include "file/ParallelFileLoader.h"
+#include "file/SessionFile.h"
 #include "grabber/GrabberFactory.h"
+#include "grabber/CaptureGovernor.h"
+#include "grabber/CaptureSession.h"
 #include "pointCloud/PointCloudElements.h"
+#include "ui/PointCloudTableModel.h"
 #include "arduino/Arduino.h"
 #include "Conversion.h"
 #include "pointCloudProcessing/keypoint/KeypointFactory.h"
@@ -36,7 +43,17 @@ Q_DECLARE_METATYPE(pcl::PointCloud<PointT>::Ptr);
 #include "pointCloudProcessing/regestration/RegestrationFactory.h"
 #include "pointCloudProcessing/reconstruct/ReconstructFactory.h"
 #include "pointCloudProcessing/smoothing/SmoothingFactory.h"
+#include "pointCloudProcessing/transform/TransformKernels.h"
+#include "job/JobQueue.h"
+#include "trace/Tracer.h"
+//		KINFU_CPU : TSDF fusion on the CPU, for builds without CUDA
+#ifdef KINFU_CPU
+#include "kinfuApp/CpuKinfuApp.h"
+typedef CpuKinFuApp KinFuBackend;
+#else
 #include "kinfuApp/KinfuApp.h"
+typedef KinFuApp KinFuBackend;
+#endif
 //#include "kinfuApp/KinfuLSApp.h"
 
 class UIObserver;
@@ -62,7 +79,7 @@ public slots:
 	//										UI
 	//****************************************************************
 	void UpdateViewerSlot(pcl::PointCloud<PointT>::Ptr pointCloud);
-	void TableItemChangeSlot(QTableWidgetItem* item);
+	void RefreshViewerSlot();
 	std::string ShowInputDialogSlot(bool* ok, const char* title = "", const char* label = "", const char* text = "");
 	void GetDialogResultSlot(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	//****************************************************************
@@ -70,19 +87,30 @@ public slots:
 	//****************************************************************
 	void OpenFileSlot();
 	void SaveFileSlot();
+	void OpenSessionSlot();
+	void SaveSessionSlot();
 	//****************************************************************
 	//										Viewer
 	//****************************************************************
 	void SetViewBackgroundToBlackSlot();
 	void SetViewWhiteBackgroundToWhiteSlot();
+	void ShowStatsSlot();
+	void StartTraceSlot();
+	void ExportTraceSlot();
+	void UpdateStatsSlot();
 	//****************************************************************
 	//										Camera
 	//****************************************************************
 	void StartFlexxCameraSlot();
 	void StartRSCameraSlot();
 	void StartXtionProCameraSlot();
+	void StartReplaySlot();
+	void StepReplaySlot();
 	void StopCameraSlot();
 	void SetCameraDepthConfidenceSlot();
+	void SetCaptureRateSlot();
+	void LiveOutlierRemovalSlot();
+	void StartMultiCameraSlot();
 	//****************************************************************
 	//										Arduino
 	//****************************************************************
@@ -95,6 +123,7 @@ public slots:
 	//****************************************************************
 	void KeepOneFrameSlot();
 	void KeepContinueFrameSlot();
+	void RecordScanSlot();
 	void KeepFrameArrivedSlot(pcl::PointCloud<PointT>::Ptr pointCloud);
 	void RemoveSelectedPointCloudSlot();
 	void RemoveAllPointCloudSlot();
@@ -105,6 +134,7 @@ public slots:
 	void ProcessICP1Slot();
 	void ProcessICP2Slot();
 	void ProcessICP3Slot();
+	void ProcessPoseGraphSlot();
 	void ShiftPointCloudSlot();
 	void MultiplicationPointCloudSlot();
 	void RemoveNANSlot();
@@ -124,6 +154,8 @@ public slots:
 	void ChangeFilterTabSlot(int index);
 	void ProcessFilterSlot();
 	void SetFilterVoxelGridXYZSlot();
+	void SetFilterVoxelGridHashSlot(bool isHash);
+	void SetFilterKeepOrganizedSlot(bool isKeepOrganized);
 	void SetFilterBoundingBoxSlot();
 	void SetFilterMeanKSlot(int meanK);
 	void SetFilterStddevMulThreshSlot(double stddevMulThresh);
@@ -173,6 +205,12 @@ public slots:
 	void SetSmoothingFeatureAngleSlot(int featureAngle);
 	void SetSmoothingSearchRadiusSlot(double searchRadius);
 	//****************************************************************
+	//										Jobs
+	//****************************************************************
+	void JobFinishedSlot(int id);
+	void JobProgressSlot(int id, float progress);
+	void CancelJobsSlot();
+	//****************************************************************
 	//										Kinect Fusion
 	//****************************************************************
 	void ProcessKinfuTestBoundingBoxSlot();
@@ -186,25 +224,40 @@ private:
 	void InitialConnectSlots();
 	void InitialPointCloudViewer();
 	void InitialPointCloudTable();
+	void InitialStatsTable();
 	void InitialTabWidget();
 	void UpdatePointCloudViewer();
 	void UpdatePointCloudTable();
+	void ShowElementById(int id);
+	void ShowFrameSet(FrameSet& frameSet);
+	void CheckReplay();
+	void KeepFrameSet();
+	void UpdateJobStatus();
 	void RegisterObserver();
+	pcl::PointCloud<PointT>::Ptr FilterLiveFrame(pcl::PointCloud<PointT>::Ptr pointCloud);
+	unsigned long long GetRecorderDroppedFrames();
 	void closeEvent(QCloseEvent *event);
 	void OpenFile(std::string dir, std::string filter);
 	void SaveFile(std::string dir, std::string filter);
 
 	Viewer* _viewer;
 	UIObserver* _uiObserver;
+	RecorderObserver* _recorderObserver;
+	float _turntableAngle;				//	sum of the degrees sent to the motor (degree)
+	unsigned long long _recordDroppedFrames;
 	FileFactory* _fileFactory;
 	GrabberFactory* _grabberFactory;
 	IGrabber* _grabber;
+	CaptureSession* _captureSession;		//	several grabbers at once, _grabber stays NULL while it runs
 	SubjectFactory* _subjectFactory;
 	int _keepFrameNumber;
 	std::string _keepCloudName;
 	pcl::PointCloud<PointT>::Ptr _tmpPointCloud;
+	FrameSet _tmpFrameSet;
 	pcl::PointCloud<PointT>::Ptr _boundingBoxPointCloud;
 	PointCloudElements* _elements;
+	PointCloudTableModel* _pointCloudTableModel;
+	std::set<PointCloudElement*> _shownElements;		//	what the viewer shows, UpdatePointCloudViewer diffs against it
 	Arduino* _arduino;
 	Ui::MainWindowForm* _ui;
 
@@ -216,15 +269,24 @@ private:
 	CorrespondencesProcessing* _correspondencesProcessing;
 	RegestrationFactory* _regestrationFactory;
 	RegestrationProcessing* _regestrationProcessing;
+	PoseGraphRegestration* _poseGraphRegestration;
 	ReconstructFactory* _reconstructFactory;
 	ReconstructProcessing* _reconstructProcessing;
 	SmoothingFactory* _smoothingFactory;
 	SmoothingProcessing* _smoothingProcessing;
 
 	BoundingBoxTestDialog* _dialog;
+	JobQueue* _jobQueue;
+
+	const int STATS_REFRESH_TIME = 500;	//	(ms)
+	QTimer* _statsTimer;
+	const int VIEWER_REFRESH_TIME = 33;	//	(ms), live preview shows at most ~30 fps
+	QTimer* _viewerTimer;
 
 	const double FRAME_PITCH = 0.3;	//	(sec)
-	clock_t _preFrameTime;
+	CaptureGovernor _keepFrameGovernor;
+
+	bool _isLiveOutlierRemoval;
 
 	//		Kinfu
 	bool _isTestedKinfuBoundingBox;
@@ -0,0 +1,153 @@
+#include "ui/PointCloudLod.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <queue>
+#include <pcl/common/point_tests.h>
+
+PointCloudLod::PointCloudLod()
+{
+}
+
+void PointCloudLod::Build(const pcl::PointCloud<PointT>& cloud)
+{
+	_nodes.clear();
+	_order.clear();
+	std::vector<int> indices;
+	indices.reserve(cloud.size());
+	Eigen::Vector3f minPoint(FLT_MAX, FLT_MAX, FLT_MAX);
+	Eigen::Vector3f maxPoint(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (std::size_t counter = 0; counter < cloud.size(); counter++)
+	{
+		const PointT& point = cloud.points[counter];
+		if (!pcl::isFinite(point))
+			continue;
+		Eigen::Vector3f xyz(point.x, point.y, point.z);
+		minPoint = minPoint.cwiseMin(xyz);
+		maxPoint = maxPoint.cwiseMax(xyz);
+		indices.push_back((int)counter);
+	}
+	if (indices.empty())
+		return;
+	_order.reserve(indices.size());
+	//		Slightly larger than the bounds so the points on the max faces fall inside
+	float halfSize = std::max((maxPoint - minPoint).maxCoeff() * 0.5f, 1e-6f) * 1.001f;
+	BuildNode(cloud, indices, (minPoint + maxPoint) * 0.5f, halfSize, 0);
+}
+
+//		Consumes indices; the sample of the node is appended to _order before its children
+int PointCloudLod::BuildNode(const pcl::PointCloud<PointT>& cloud, std::vector<int>& indices, const Eigen::Vector3f& center, float halfSize, int depth)
+{
+	int id = (int)_nodes.size();
+	Node node;
+	node.center = center;
+	node.halfSize = halfSize;
+	node.begin = (int)_order.size();
+	node.count = 0;
+	std::fill(node.children, node.children + 8, -1);
+	_nodes.push_back(node);
+
+	if (indices.size() <= POINT_CLOUD_LOD_NODE_POINTS || depth >= POINT_CLOUD_LOD_MAX_DEPTH)
+	{
+		_order.insert(_order.end(), indices.begin(), indices.end());
+		_nodes[id].count = (int)indices.size();
+		return id;
+	}
+
+	const int grid = POINT_CLOUD_LOD_GRID;
+	float cellSize = halfSize * 2 / grid;
+	Eigen::Vector3f origin = center - Eigen::Vector3f::Constant(halfSize);
+	std::vector<char> isTaken(grid * grid * grid, 0);
+	std::vector<int> octants[8];
+	for (std::size_t counter = 0; counter < indices.size(); counter++)
+	{
+		const PointT& point = cloud.points[indices[counter]];
+		int x = std::min(std::max((int)((point.x - origin.x()) / cellSize), 0), grid - 1);
+		int y = std::min(std::max((int)((point.y - origin.y()) / cellSize), 0), grid - 1);
+		int z = std::min(std::max((int)((point.z - origin.z()) / cellSize), 0), grid - 1);
+		int cell = (z * grid + y) * grid + x;
+		if (!isTaken[cell])
+		{
+			isTaken[cell] = 1;
+			_order.push_back(indices[counter]);
+			continue;
+		}
+		int octant = (point.x >= center.x() ? 1 : 0) | (point.y >= center.y() ? 2 : 0) | (point.z >= center.z() ? 4 : 0);
+		octants[octant].push_back(indices[counter]);
+	}
+	_nodes[id].count = (int)_order.size() - _nodes[id].begin;
+	std::vector<int>().swap(indices);
+
+	float childHalfSize = halfSize * 0.5f;
+	for (int octant = 0; octant < 8; octant++)
+	{
+		if (octants[octant].empty())
+			continue;
+		Eigen::Vector3f childCenter(
+			center.x() + ((octant & 1) ? childHalfSize : -childHalfSize),
+			center.y() + ((octant & 2) ? childHalfSize : -childHalfSize),
+			center.z() + ((octant & 4) ? childHalfSize : -childHalfSize));
+		int child = BuildNode(cloud, octants[octant], childCenter, childHalfSize, depth + 1);
+		_nodes[id].children[octant] = child;
+	}
+	return id;
+}
+
+//		Priority is the size of a node over its distance to the eye, about its size on screen
+void PointCloudLod::Select(const Eigen::Vector3f& eye, std::size_t budget, std::vector<int>& indices) const
+{
+	indices.clear();
+	if (_nodes.empty())
+		return;
+	if (budget >= _order.size())
+	{
+		indices = _order;
+		return;
+	}
+	typedef std::pair<float, int> Candidate;
+	std::priority_queue<Candidate> candidates;
+	candidates.push(Candidate(FLT_MAX, 0));
+	while (!candidates.empty())
+	{
+		const Node& node = _nodes[candidates.top().second];
+		candidates.pop();
+		//		Skipped with its subtree, a smaller node may still fit
+		if (indices.size() + node.count > budget)
+			continue;
+		indices.insert(indices.end(), _order.begin() + node.begin, _order.begin() + node.begin + node.count);
+		for (int octant = 0; octant < 8; octant++)
+		{
+			if (node.children[octant] < 0)
+				continue;
+			const Node& child = _nodes[node.children[octant]];
+			float distance = std::max((eye - child.center).norm() - child.halfSize * 1.7320508f, child.halfSize * 1e-3f);
+			candidates.push(Candidate(child.halfSize / distance, node.children[octant]));
+		}
+	}
+}
+
+std::size_t PointCloudLod::GetNumberOfPoints() const
+{
+	return _order.size();
+}
+
+std::size_t PointCloudLod::GetNumberOfNodes() const
+{
+	return _nodes.size();
+}
+
+std::size_t PointCloudLod::GetBytes() const
+{
+	return _nodes.capacity() * sizeof(Node) + _order.capacity() * sizeof(int);
+}
+
+Eigen::Vector3f PointCloudLod::GetCenter() const
+{
+	return _nodes.empty() ? Eigen::Vector3f::Zero() : _nodes[0].center;
+}
+
+//		Half the diagonal of the root cube
+float PointCloudLod::GetRadius() const
+{
+	return _nodes.empty() ? 0 : _nodes[0].halfSize * 1.7320508f;
+}
@@ -0,0 +1,55 @@
+#ifndef POINT_CLOUD_LOD
+#define POINT_CLOUD_LOD
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Core>
+#include <pcl/point_cloud.h>
+#include "Typedef.h"
+
+#define POINT_CLOUD_LOD_NODE_POINTS 4096	//	a node with fewer points keeps them all
+#define POINT_CLOUD_LOD_GRID 16				//	sample cells per axis of a node
+#define POINT_CLOUD_LOD_MAX_DEPTH 16
+
+//		*****************************************************************
+//				Point Cloud LOD
+//				Octree of progressively sampled points for display. Every node
+//				keeps one point per cell of a coarse grid over its cube, the
+//				points left over go to its children, so a node and its parents
+//				together are an even sample of the node at a finer spacing.
+//				Only a permutation of the point indices is stored, the points
+//				are read from the cloud the octree was built from.
+//		*****************************************************************
+class PointCloudLod
+{
+public:
+	typedef boost::shared_ptr<PointCloudLod> Ptr;
+
+	PointCloudLod();
+	void Build(const pcl::PointCloud<PointT>& cloud);
+	//		Whole nodes, the ones that look largest from the eye first, at most budget points
+	void Select(const Eigen::Vector3f& eye, std::size_t budget, std::vector<int>& indices) const;
+	//		Finite points of the cloud
+	std::size_t GetNumberOfPoints() const;
+	std::size_t GetNumberOfNodes() const;
+	std::size_t GetBytes() const;
+	Eigen::Vector3f GetCenter() const;
+	float GetRadius() const;
+
+private:
+	struct Node
+	{
+		Eigen::Vector3f center;
+		float halfSize;
+		int begin;					//	first point of the node in _order
+		int count;
+		int children[8];			//	-1 when empty
+	};
+
+	int BuildNode(const pcl::PointCloud<PointT>& cloud, std::vector<int>& indices, const Eigen::Vector3f& center, float halfSize, int depth);
+
+	std::vector<Node> _nodes;
+	std::vector<int> _order;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "ui/PointCloudTableModel.h"
+#include "Conversion.h"
+
+PointCloudTableModel::PointCloudTableModel(PointCloudElements* elements, QObject* parent) : QAbstractTableModel(parent), _elements(elements)
+{
+	_elements->SetListener(this);
+}
+
+PointCloudTableModel::~PointCloudTableModel()
+{
+	_elements->SetListener(NULL);
+}
+
+void PointCloudTableModel::SetVisibilityCallback(std::function<void(int)> callback)
+{
+	_visibilityCallback = callback;
+}
+
+void PointCloudTableModel::Refresh()
+{
+	_elements->RecountBytes();
+	if (rowCount() > 0)
+		emit dataChanged(index(0, 0), index(rowCount() - 1, NumberOfColumns - 1));
+	emit headerDataChanged(Qt::Horizontal, MemoryColumn, MemoryColumn);
+}
+
+int PointCloudTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : _elements->GetNumberOfElements();
+}
+
+int PointCloudTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : NumberOfColumns;
+}
+
+QVariant PointCloudTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= _elements->GetNumberOfElements())
+		return QVariant();
+	int id = index.row();
+	if (index.column() == ShowColumn && role == Qt::CheckStateRole)
+		return _elements->GetIsSelectedById(id) ? Qt::Checked : Qt::Unchecked;
+	if (role != Qt::DisplayRole)
+		return QVariant();
+	if (index.column() == NameColumn)
+		return QString::fromStdString(_elements->GetNameById(id));
+	if (index.column() == MemoryColumn)
+	{
+		//		Buffers shared with another element are marked
+		std::string memory = TypeConversion::Bytes2String(_elements->GetBytesById(id));
+		if (_elements->IsSharedById(id))
+			memory += " (shared)";
+		return QString::fromStdString(memory);
+	}
+	return QVariant();
+}
+
+bool PointCloudTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+	if (!index.isValid() || index.column() != ShowColumn || role != Qt::CheckStateRole)
+		return false;
+	_elements->SetIsSelectedById(index.row(), value.toInt() == Qt::Checked);
+	if (_visibilityCallback)
+		_visibilityCallback(index.row());
+	return true;
+}
+
+Qt::ItemFlags PointCloudTableModel::flags(const QModelIndex& index) const
+{
+	if (!index.isValid())
+		return Qt::NoItemFlags;
+	if (index.column() == ShowColumn)
+		return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+	return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QVariant PointCloudTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+		return QAbstractTableModel::headerData(section, orientation, role);
+	if (section == NameColumn)
+		return QString("Name");
+	if (section == ShowColumn)
+		return QString("Show");
+	if (section == MemoryColumn)
+		return QString::fromStdString(std::string("Memory (") + TypeConversion::Bytes2String(_elements->GetTotalBytes()) + std::string(")"));
+	return QVariant();
+}
+
+void PointCloudTableModel::BeginInsertElements(int first, int last)
+{
+	beginInsertRows(QModelIndex(), first, last);
+}
+
+void PointCloudTableModel::EndInsertElements()
+{
+	endInsertRows();
+	TotalChanged();
+}
+
+void PointCloudTableModel::BeginRemoveElements(int first, int last)
+{
+	beginRemoveRows(QModelIndex(), first, last);
+}
+
+void PointCloudTableModel::EndRemoveElements()
+{
+	endRemoveRows();
+	TotalChanged();
+}
+
+void PointCloudTableModel::ElementsChanged(int first, int last)
+{
+	emit dataChanged(index(first, 0), index(last, NumberOfColumns - 1));
+}
+
+//		Rows whose shared mark changed are reported by the elements, only the header is left
+void PointCloudTableModel::TotalChanged()
+{
+	emit headerDataChanged(Qt::Horizontal, MemoryColumn, MemoryColumn);
+}
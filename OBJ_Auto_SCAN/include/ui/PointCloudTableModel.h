@@ -0,0 +1,54 @@
+#ifndef POINT_CLOUD_TABLE_MODEL
+#define POINT_CLOUD_TABLE_MODEL
+
+#include <functional>
+#include <QAbstractTableModel>
+#include "pointCloud/PointCloudElements.h"
+
+//		*****************************************************************
+//				Point Cloud Table Model
+//				The elements as rows of the point cloud table (name, show,
+//				memory). The view only asks for the rows it paints, and the
+//				elements report each insert / remove / change, so adding an
+//				element does not rebuild the table.
+//		*****************************************************************
+class PointCloudTableModel : public QAbstractTableModel, public PointCloudElementsListener
+{
+public:
+	enum Column
+	{
+		NameColumn,
+		ShowColumn,
+		MemoryColumn,
+		NumberOfColumns
+	};
+
+	PointCloudTableModel(PointCloudElements* elements, QObject* parent = NULL);
+	~PointCloudTableModel();
+	//		Called with the row once its show check box was toggled
+	void SetVisibilityCallback(std::function<void(int)> callback);
+	//		Recounts the memory and repaints every row, for changes made on the elements directly (buffer loaded, selection)
+	void Refresh();
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
+	Qt::ItemFlags flags(const QModelIndex& index) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+	void BeginInsertElements(int first, int last);
+	void EndInsertElements();
+	void BeginRemoveElements(int first, int last);
+	void EndRemoveElements();
+	void ElementsChanged(int first, int last);
+
+private:
+	//		The total in the header, kept up to date by the elements
+	void TotalChanged();
+
+	PointCloudElements* _elements;
+	std::function<void(int)> _visibilityCallback;
+};
+
+#endif
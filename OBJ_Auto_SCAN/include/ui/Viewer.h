@@ -7,6 +7,17 @@
 #include <pcl/surface/gp3.h>
 #include <pcl/features/normal_3d.h>
 #include <QVTKInteractor.h>
+#include <vtkRendererCollection.h>
+#include <vtkCamera.h>
+#include <map>
+#include "ui/CloudBinding.h"
+#include "ui/LodCache.h"
+#include "trace/Tracer.h"
+
+#define VIEWER_DEFAULT_POINT_BUDGET 1000000		//	per element
+#define VIEWER_DEFAULT_TRIANGLE_BUDGET 500000	//	per element
+#define VIEWER_LOD_MOVE_RATIO 0.05f				//	eye movement, relative to its distance, that reselects
+#define VIEWER_MESH_DETAIL_DISTANCE 2.0f		//	full meshes are drawn closer than this many radii
 
 class Viewer
 {
@@ -14,24 +25,99 @@ public:
 	Viewer(std::string title = "") : _title(title)
 	{
 		_viewer.reset(new pcl::visualization::PCLVisualizer(_title, false));
+		_pointBudget = VIEWER_DEFAULT_POINT_BUDGET;
+		_triangleBudget = VIEWER_DEFAULT_TRIANGLE_BUDGET;
 	}
 
 	~Viewer()
 	{
+		ClearBindings();
 		_viewer.reset();
 	}
 
+	//		Point clouds are drawn through a CloudBinding per name instead of updatePointCloud,
+	//		which rebuilt the vtkPolyData of the cloud on every frame
 	void ShowPointCloud(pcl::PointCloud<PointT>::Ptr cloud, std::string name = "")
 	{
-		if (!_viewer->updatePointCloud(cloud, name))
-			//_viewer->removeAllPointClouds();
-			_viewer->addPointCloud(cloud, name);
+		_lods.erase(name);
+		GetBinding(name)->Update(*cloud);
+	}
+
+	//		For elements : a cloud over the point budget is drawn from its octree, the nodes
+	//		nearest the camera first, and reselected by UpdateLevelOfDetail when the camera moves.
+	//		The cloud itself is left untouched for processing.
+	void ShowLevelOfDetail(pcl::PointCloud<PointT>::Ptr cloud, std::string name = "")
+	{
+		if (cloud->size() <= _pointBudget)
+		{
+			ShowPointCloud(cloud, name);
+			return;
+		}
+		LodEntry& entry = _lods[name];
+		entry.cloud = cloud;
+		entry.lod = LodCache::GetInstance()->GetPointCloudLod(cloud);
+		entry.eye = GetEye();
+		SelectLevelOfDetail(name, entry);
 	}
 
+	//		A mesh over the triangle budget also gets a decimated proxy, drawn instead of it from afar
 	void ShowSurface(pcl::PolygonMeshPtr surface, std::string name = "")
 	{
 		if (!_viewer->updatePolygonMesh(*surface, name))
 			_viewer->addPolygonMesh(*surface, name);
+		RemoveMeshProxy(name);
+		if (surface->polygons.size() <= _triangleBudget)
+			return;
+		vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+		mapper->SetInputData(LodCache::GetInstance()->GetMeshProxy(surface, _triangleBudget));
+		MeshProxyEntry& entry = _meshProxies[name];
+		entry.actor = vtkSmartPointer<vtkActor>::New();
+		entry.actor->SetMapper(mapper);
+		double bounds[6];
+		mapper->GetInput()->GetBounds(bounds);
+		entry.center = Eigen::Vector3f((float)(bounds[0] + bounds[1]) / 2, (float)(bounds[2] + bounds[3]) / 2, (float)(bounds[4] + bounds[5]) / 2);
+		entry.radius = Eigen::Vector3f((float)(bounds[1] - bounds[0]), (float)(bounds[3] - bounds[2]), (float)(bounds[5] - bounds[4])).norm() / 2;
+		GetRenderer()->AddActor(entry.actor);
+		SetMeshDetail(name, entry, IsMeshNear(entry, GetEye()));
+	}
+
+	//		Called on the viewer refresh timer, true when something has to be redrawn
+	bool UpdateLevelOfDetail()
+	{
+		if (_lods.empty() && _meshProxies.empty())
+			return false;
+		Eigen::Vector3f eye = GetEye();
+		bool isChanged = false;
+		for (std::map<std::string, LodEntry>::iterator it = _lods.begin(); it != _lods.end(); ++it)
+		{
+			LodEntry& entry = it->second;
+			float distance = std::max((eye - entry.lod->GetCenter()).norm(), entry.lod->GetRadius() * 0.01f);
+			if ((eye - entry.eye).norm() <= distance * VIEWER_LOD_MOVE_RATIO)
+				continue;
+			entry.eye = eye;
+			SelectLevelOfDetail(it->first, entry);
+			isChanged = true;
+		}
+		for (std::map<std::string, MeshProxyEntry>::iterator it = _meshProxies.begin(); it != _meshProxies.end(); ++it)
+		{
+			bool isNear = IsMeshNear(it->second, eye);
+			if (isNear == it->second.isDetailed)
+				continue;
+			SetMeshDetail(it->first, it->second, isNear);
+			isChanged = true;
+		}
+		return isChanged;
+	}
+
+	//		Takes effect the next time the elements are shown
+	void SetPointBudget(std::size_t pointBudget)
+	{
+		_pointBudget = pointBudget;
+	}
+
+	void SetTriangleBudget(std::size_t triangleBudget)
+	{
+		_triangleBudget = triangleBudget;
 	}
 
 	void Show(pcl::PointCloud<KeypointT>::Ptr sourceCloud, pcl::PointCloud<KeypointT>::Ptr targetCloud, pcl::CorrespondencesPtr correspondences, std::string name = "")
@@ -39,9 +125,19 @@ public:
 		_viewer->addCorrespondences<KeypointT>(sourceCloud, targetCloud, *correspondences, name);
 	}
 
+	//		Meshes are still PCLVisualizer clouds
 	void DeletePointCloud(std::string id)
 	{
-		_viewer->removePointCloud(id);
+		_lods.erase(id);
+		RemoveMeshProxy(id);
+		std::map<std::string, boost::shared_ptr<CloudBinding> >::iterator it = _bindings.find(id);
+		if (it == _bindings.end())
+		{
+			_viewer->removePointCloud(id);
+			return;
+		}
+		GetRenderer()->RemoveActor(it->second->GetActor());
+		_bindings.erase(it);
 	}
 
 	void DeleteCorrespondence(std::string id)
@@ -51,6 +147,7 @@ public:
 
 	void Clear()
 	{
+		ClearBindings();
 		_viewer->removeAllPointClouds();
 		_viewer->removeAllShapes();
 	}
@@ -76,8 +173,97 @@ public:
 	}
 
 private:
+	struct LodEntry
+	{
+		pcl::PointCloud<PointT>::Ptr cloud;
+		PointCloudLod::Ptr lod;
+		Eigen::Vector3f eye;				//	camera position of the last selection
+	};
+
+	struct MeshProxyEntry
+	{
+		vtkSmartPointer<vtkActor> actor;
+		Eigen::Vector3f center;
+		float radius;
+		bool isDetailed;
+	};
+
+	vtkRenderer* GetRenderer()
+	{
+		return _viewer->getRendererCollection()->GetFirstRenderer();
+	}
+
+	Eigen::Vector3f GetEye()
+	{
+		double position[3];
+		GetRenderer()->GetActiveCamera()->GetPosition(position);
+		return Eigen::Vector3f((float)position[0], (float)position[1], (float)position[2]);
+	}
+
+	boost::shared_ptr<CloudBinding> GetBinding(const std::string& name)
+	{
+		std::map<std::string, boost::shared_ptr<CloudBinding> >::iterator it = _bindings.find(name);
+		if (it == _bindings.end())
+		{
+			it = _bindings.insert(std::make_pair(name, boost::shared_ptr<CloudBinding>(new CloudBinding()))).first;
+			GetRenderer()->AddActor(it->second->GetActor());
+		}
+		return it->second;
+	}
+
+	void SelectLevelOfDetail(const std::string& name, LodEntry& entry)
+	{
+		TRACE_SCOPE("Viewer::SelectLevelOfDetail", "viewer");
+		entry.lod->Select(entry.eye, _pointBudget, _selection);
+		TRACE_GAUGE("LOD points", "viewer", (double)_selection.size());
+		GetBinding(name)->Update(*entry.cloud, _selection);
+	}
+
+	bool IsMeshNear(const MeshProxyEntry& entry, const Eigen::Vector3f& eye)
+	{
+		return (eye - entry.center).norm() < entry.radius * VIEWER_MESH_DETAIL_DISTANCE;
+	}
+
+	//		The full mesh stays loaded in VTK, only hidden, so coming closer costs no upload
+	void SetMeshDetail(const std::string& name, MeshProxyEntry& entry, bool isDetailed)
+	{
+		pcl::visualization::CloudActorMapPtr actors = _viewer->getCloudActorMap();
+		pcl::visualization::CloudActorMap::iterator it = actors->find(name);
+		if (it != actors->end())
+			it->second.actor->SetVisibility(isDetailed);
+		entry.actor->SetVisibility(!isDetailed);
+		entry.isDetailed = isDetailed;
+	}
+
+	void RemoveMeshProxy(const std::string& name)
+	{
+		std::map<std::string, MeshProxyEntry>::iterator it = _meshProxies.find(name);
+		if (it == _meshProxies.end())
+			return;
+		SetMeshDetail(name, it->second, true);
+		GetRenderer()->RemoveActor(it->second.actor);
+		_meshProxies.erase(it);
+	}
+
+	void ClearBindings()
+	{
+		for (std::map<std::string, boost::shared_ptr<CloudBinding> >::iterator it = _bindings.begin(); it != _bindings.end(); ++it)
+			GetRenderer()->RemoveActor(it->second->GetActor());
+		for (std::map<std::string, MeshProxyEntry>::iterator it = _meshProxies.begin(); it != _meshProxies.end(); ++it)
+			GetRenderer()->RemoveActor(it->second.actor);
+		_bindings.clear();
+		_lods.clear();
+		_meshProxies.clear();
+	}
+
 	std::string _title;
 	boost::shared_ptr<pcl::visualization::PCLVisualizer> _viewer;
+	std::map<std::string, boost::shared_ptr<CloudBinding> > _bindings;
+	std::map<std::string, LodEntry> _lods;
+	std::map<std::string, MeshProxyEntry> _meshProxies;
+	std::vector<int> _selection;
+	std::size_t _pointBudget;
+	std::size_t _triangleBudget;
 };
 
 #endif
\ No newline at end of file